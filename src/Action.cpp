@@ -36,6 +36,7 @@
 #include "PolyTransformAction.h"
 #include "HelpAction.h"
 #include "TestAction.h"
+#include "MicroBenchAction.h"
 #include "PrimaryDecomAction.h"
 #include "OptimizeAction.h"
 #include "MaximalStandardAction.h"
@@ -47,13 +48,36 @@ Action::Action(const char* name,
                const char* shortDescription,
                const char* description,
                bool acceptsNonParameterParam):
+  _in(stdin),
+  _out(stdout),
   _name(name),
   _shortDescription(shortDescription),
   _description(description),
   _acceptsNonParameter(acceptsNonParameterParam),
-  _printActions("time", "Display and time each subcomputation.", false) {
+  _printActions("time", "Display and time each subcomputation.", false),
+  _batchThreadCount
+  ("batch",
+   "Process each ideal of a list of ideals separately using the given\n"
+   "number of threads. The output for each ideal is written in the order\n"
+   "of the input. The value 0 turns batch mode off.",
+   0),
+  _progressInterval
+  ("progress",
+   "Report on the progress of the computation to standard error once every\n"
+   "given number of seconds. A report has the time spent in each phase, the\n"
+   "number of slices processed and processed per second, the number of base\n"
+   "cases, the number of pending tasks, the bytes of memory in arenas and the\n"
+   "number of output terms. The value 0 turns reports off.",
+   0),
+  _progressFile
+  ("progressFile",
+   "Write the reports of -progress to the given file with one line of JSON\n"
+   "per report instead of to standard error.",
+   "") {
 
   _params.add(_printActions);
+  _params.add(_progressInterval);
+  _params.add(_progressFile);
 }
 
 Action::~Action() {
@@ -102,11 +126,19 @@ const Parameter& Action::getParam(const string& name) const {
   return _params.getParam(name);
 }
 
+bool Action::hasParam(const string& name) const {
+  return _params.hasParam(name);
+}
+
 void Action::getActionNames(vector<string>& names) {
   getActionFactory().getNamesWithPrefix("", names);
 }
 
 unique_ptr<Action> Action::createActionWithPrefix(const string& prefix) {
+  // The micro benchmarks are for developers, so they have to be named
+  // in full and do not take up any prefix of the other actions.
+  if (prefix == MicroBenchAction::staticGetName())
+    return unique_ptr<Action>(new MicroBenchAction());
   return createWithPrefix(getActionFactory(), prefix);
 }
 
@@ -130,8 +162,35 @@ void Action::processNonParameter(const char*) {
   reportInternalError("Action::processNonParameter called.");
 }
 
+void Action::setInputOutput(FILE* in, FILE* out) {
+  ASSERT(in != 0);
+  ASSERT(out != 0);
+  _in = in;
+  _out = out;
+}
+
+bool Action::supportsBatch() const {
+  return false;
+}
+
+size_t Action::getBatchThreadCount() const {
+  if (!supportsBatch())
+    return 0;
+  return _batchThreadCount;
+}
+
+size_t Action::getProgressInterval() const {
+  return _progressInterval;
+}
+
+const string& Action::getProgressFile() const {
+  return _progressFile;
+}
+
 void Action::obtainParameters(vector<Parameter*>& parameters) {
   parameters.insert(parameters.end(), _params.begin(), _params.end());
+  if (supportsBatch())
+    parameters.push_back(&_batchThreadCount);
 }
 
 void Action::parseCommandLine(unsigned int tokenCount, const char** tokens) {
@@ -18,6 +18,8 @@
 #define ACTION_GUARD
 
 #include "BoolParameter.h"
+#include "IntegerParameter.h"
+#include "StringParameter.h"
 #include "CliParams.h"
 
 class Parameter;
@@ -46,11 +48,33 @@ class Action {
 
   virtual void perform() = 0;
 
+  /** Sets the files that perform() reads input from and writes
+   output to. These are stdin and stdout by default. */
+  void setInputOutput(FILE* in, FILE* out);
+
+  /** Returns whether this action can process a list of ideals in
+   batch mode, where perform() is run on each ideal of the list. The
+   default is false. */
+  virtual bool supportsBatch() const;
+
+  /** Returns the number of threads to use for batch mode. This is 0
+   if batch mode is off. */
+  size_t getBatchThreadCount() const;
+
+  /** Returns the number of seconds between reports on the progress
+   of perform(). This is 0 if there are no reports. */
+  size_t getProgressInterval() const;
+
+  /** Returns the file to write reports on progress to as JSON lines,
+   or the empty string to write them to standard error. */
+  const string& getProgressFile() const;
+
   /** Returns whether this action should be shown to the user by the
     help action.*/
   virtual bool displayAction() const;
 
   const Parameter& getParam(const string& name) const;
+  bool hasParam(const string& name) const;
 
   static void getActionNames(vector<string>& names);
   static unique_ptr<Action> createActionWithPrefix(const string& prefix);
@@ -58,7 +82,8 @@ class Action {
  protected:
   CliParams _params;
 
-
+  FILE* _in;
+  FILE* _out;
 
   const char* _name;
   const char* _shortDescription;
@@ -66,7 +91,9 @@ class Action {
   bool _acceptsNonParameter;
 
   BoolParameter _printActions;
-
+  IntegerParameter _batchThreadCount;
+  IntegerParameter _progressInterval;
+  StringParameter _progressFile;
 };
 
 #endif
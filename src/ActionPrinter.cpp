@@ -18,6 +18,8 @@
 #include "stdinc.h"
 #include "ActionPrinter.h"
 
+#include "ProgressReporter.h"
+
 ActionPrinter::ActionPrinter(bool printActions):
   _printActions(printActions),
   _actionBegun(false) {
@@ -26,6 +28,7 @@ ActionPrinter::ActionPrinter(bool printActions):
 ActionPrinter::ActionPrinter(bool printActions, const char* message):
   _printActions(printActions),
   _actionBegun(true) {
+  ProgressReporter::beginPhase(message);
   printMessage(message);
 }
 
@@ -43,6 +46,7 @@ void ActionPrinter::printMessage(const char* message) {
 
 void ActionPrinter::beginAction(const char* message) {
   ASSERT(!_actionBegun);
+  ProgressReporter::beginPhase(message);
   printMessage(message);
   _actionBegun = true;
   _timer.reset();
@@ -51,6 +55,7 @@ void ActionPrinter::beginAction(const char* message) {
 void ActionPrinter::endAction() {
   ASSERT(_actionBegun);
   _actionBegun = false;
+  ProgressReporter::endPhase();
   if (_printActions) {
     fputc(' ', stderr);
     _timer.print(stderr);
@@ -37,6 +37,7 @@ AlexanderDualAction::AlexanderDualAction():
  false),
 
   _io(DataType::getMonomialIdealType(), DataType::getMonomialIdealType()) {
+  addResultCacheParam(_params);
 }
 
 void AlexanderDualAction::obtainParameters(vector<Parameter*>& parameters) {
@@ -47,6 +48,8 @@ void AlexanderDualAction::obtainParameters(vector<Parameter*>& parameters) {
 
 void AlexanderDualAction::perform() {
   SliceParams params(_params);
+  params.setInputFile(_in);
+  params.setOutputFile(_out);
   validateSplit(params, true, false);
 
   BigIdeal ideal;
@@ -54,7 +57,7 @@ void AlexanderDualAction::perform() {
   bool pointSpecified;
 
   {
-    Scanner in(_io.getInputFormat(), stdin);
+    Scanner in(_io.getInputFormat(), _in);
     _io.autoDetectInputFormat(in);
     _io.validateFormats();
 
@@ -64,7 +67,7 @@ void AlexanderDualAction::perform() {
   }
 
   unique_ptr<BigTermConsumer> output =
-    _io.createOutputHandler()->createIdealWriter(stdout);
+    _io.createOutputHandler()->createIdealWriter(_out);
   SliceFacade facade(params, ideal, *output);
 
   if (pointSpecified)
@@ -73,6 +76,10 @@ void AlexanderDualAction::perform() {
     facade.computeAlexanderDual();
 }
 
+bool AlexanderDualAction::supportsBatch() const {
+  return true;
+}
+
 const char* AlexanderDualAction::staticGetName() {
   return "alexdual";
 }
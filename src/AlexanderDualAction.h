@@ -29,6 +29,8 @@ class AlexanderDualAction : public Action {
 
   virtual void perform();
 
+  virtual bool supportsBatch() const;
+
   static const char* staticGetName();
 
  private:
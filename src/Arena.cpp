@@ -20,8 +20,16 @@
 
 #include <new>
 #include <limits>
+#include <atomic>
 
-Arena Arena::_scratchArena;
+namespace {
+  /** The bytes of memory in the blocks of all arenas. Blocks are
+   allocated rarely, so keeping this up to date costs little. */
+  std::atomic<size_t> totalMemoryUse(0);
+}
+
+thread_local Arena Arena::_scratchArena;
+thread_local Arena* Arena::_threadArena = 0;
 
 Arena::Arena() {
 }
@@ -29,9 +37,21 @@ Arena::Arena() {
 Arena::~Arena() {
   while (_block.hasPreviousBlock())
 	discardPreviousBlock();
+  if (!_block.isNull())
+	totalMemoryUse -= _block.getSize() + sizeof(Block);
   delete[] _block._blockBegin;
 }
 
+Arena* Arena::setThreadArena(Arena* arena) {
+  Arena* previous = _threadArena;
+  _threadArena = arena;
+  return previous;
+}
+
+size_t Arena::getTotalMemoryUse() {
+  return totalMemoryUse.load(std::memory_order_relaxed);
+}
+
 Arena::Block::Block():
   _blockBegin(0),
   _freeBegin(0),
@@ -63,6 +83,7 @@ void Arena::growCapacity(const size_t needed) {
 
   // ** Allocate buffer and update _block
   char* buffer = new char[size + sizeof(Block)];
+  totalMemoryUse += size + sizeof(Block);
   _block._blockBegin = buffer;
   _block._freeBegin = buffer;
   _block._blockEnd = buffer + size;
@@ -98,6 +119,7 @@ void Arena::freeAndAllAfterFromOldBlock(void* ptr) {
 void Arena::discardPreviousBlock() {
   ASSERT(_block._previousBlock != 0);
   Block* before = _block._previousBlock->_previousBlock;
+  totalMemoryUse -= _block._previousBlock->getSize() + sizeof(Block);
   delete[] _block._previousBlock->_blockBegin;
   _block._previousBlock = before;
 }
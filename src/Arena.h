@@ -122,8 +122,24 @@ class Arena {
    exact same objects allocated as before the function was entered. It
    is fine for functions to collaborate for example by using the arena
    to return variable size objects without calling new, though care
-   should be used in such cases. */
-  static Arena& getArena() {return _scratchArena;}
+   should be used in such cases. Each thread has its own scratch
+   arena, so memory from this arena must not be freed on or shared
+   with another thread. */
+  static Arena& getArena() {
+    return _threadArena != 0 ? *_threadArena : _scratchArena;
+  }
+
+  /** Makes arena the scratch arena that getArena() returns on the
+   calling thread and returns the previous one, which is null for the
+   arena that the thread has by default. Passing null makes the
+   default arena current again. The library interface uses this to
+   let a Frobby::Context own the scratch memory of the calls made with
+   it. */
+  static Arena* setThreadArena(Arena* arena);
+
+  /** Returns the number of bytes of memory in the blocks of all the
+   arenas of the process. */
+  static size_t getTotalMemoryUse();
 
  private:
   /** Allocate a new block with at least needed bytes. */
@@ -160,7 +176,8 @@ class Arena {
 	Block* _previousBlock; /// null if none
   } _block;
 
-  static Arena _scratchArena;
+  static thread_local Arena _scratchArena;
+  static thread_local Arena* _threadArena;
 
   IF_DEBUG(stack<void*> _debugAllocs;)
 };
@@ -34,6 +34,7 @@ AssociatedPrimesAction::AssociatedPrimesAction():
  false),
 
   _io(DataType::getMonomialIdealType(), DataType::getMonomialIdealType()) {
+  addResultCacheParam(_params);
 }
 
 void AssociatedPrimesAction::obtainParameters(vector<Parameter*>& parameters) {
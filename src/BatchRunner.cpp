@@ -0,0 +1,251 @@
+/* Frobby: Software for monomial ideal computations.
+   Copyright (C) 2007 Bjarke Hammersholt Roune (www.broune.com)
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see http://www.gnu.org/licenses/.
+*/
+#include "stdinc.h"
+#include "BatchRunner.h"
+
+#include "Action.h"
+#include "BigIdeal.h"
+#include "BigTermConsumer.h"
+#include "BinaryIOHandler.h"
+#include "DataType.h"
+#include "ElementDeleter.h"
+#include "FrobbyStringStream.h"
+#include "IOHandler.h"
+#include "InputConsumer.h"
+#include "MemoryFile.h"
+#include "Scanner.h"
+#include "error.h"
+
+#include <cstdlib>
+#include <thread>
+
+namespace {
+  /** The most jobs per thread that can be read but not yet
+   written. This bounds the memory used for outputs that are waiting
+   on an earlier output that takes a long time to compute. */
+  const size_t MaxInFlightPerThread = 64;
+
+  /** Closes a FILE* on destruction. */
+  class FileCloser {
+  public:
+    FileCloser(FILE* file): _file(file) {}
+    ~FileCloser() {
+      fclose(_file);
+    }
+
+  private:
+    FILE* _file;
+  };
+}
+
+struct BatchRunner::Job {
+  Job(): input(0), inputSize(0), output(0), outputSize(0), done(false) {}
+  ~Job() {
+    free(input);
+    free(output);
+  }
+
+  char* input;
+  size_t inputSize;
+  char* output;
+  size_t outputSize;
+  bool done;
+};
+
+/** Turns each ideal into a job as soon as it has been read. */
+class BatchRunner::JobReader : public InputConsumer {
+public:
+  JobReader(BatchRunner& runner):
+    _runner(runner),
+    _handler(createIOHandler(IO::BinaryIOHandler::staticGetName())) {
+  }
+
+  virtual void endIdeal() {
+    InputConsumer::endIdeal();
+    unique_ptr<BigIdeal> ideal = releaseBigIdeal();
+
+    unique_ptr<Job> job(new Job());
+    IO::MemoryOutput input;
+    _handler->createIdealWriter(input.getFile())->consume(*ideal);
+    input.close();
+    job->inputSize = input.getSize();
+    job->input = input.releaseData();
+    _runner.submit(job.release());
+  }
+
+private:
+  BatchRunner& _runner;
+  unique_ptr<IOHandler> _handler;
+};
+
+BatchRunner::BatchRunner(const Action& action,
+                         unsigned int tokenCount,
+                         const char** tokens):
+  _action(action),
+  _tokens(tokens, tokens + tokenCount),
+  _out(0),
+  _maxInFlight(0),
+  _inputDone(false) {
+}
+
+BatchRunner::~BatchRunner() {
+  while (!_inFlight.empty()) {
+    delete _inFlight.front();
+    _inFlight.pop_front();
+  }
+}
+
+void BatchRunner::run(size_t threadCount, FILE* in, FILE* out) {
+  ASSERT(threadCount > 0);
+  ASSERT(_inFlight.empty());
+  _out = out;
+  _maxInFlight = threadCount * MaxInFlightPerThread;
+
+  Scanner scanner(_action.getParam("iformat").getValueAsString(), in);
+  unique_ptr<IOHandler> handler = scanner.createIOHandler();
+  if (!handler->supportsInput(DataType::getMonomialIdealListType())) {
+    FrobbyStringStream errorMsg;
+    errorMsg << "The " << handler->getName()
+             << " format does not support input of "
+             << DataType::getMonomialIdealListType().getName() << '.';
+    reportError(errorMsg);
+  }
+
+  // The workers read each ideal in the binary format and write the
+  // output in the format that the action would have used for the
+  // whole input. Later options take precedence over earlier ones.
+  const string inputFormat = IO::BinaryIOHandler::staticGetName();
+  string outputFormat;
+  vector<const char*> tokens(_tokens);
+  tokens.push_back("-iformat");
+  tokens.push_back(inputFormat.c_str());
+  if (_action.hasParam("oformat")) {
+    outputFormat = createOHandler
+      (scanner.getFormat(),
+       _action.getParam("oformat").getValueAsString())->getName();
+    tokens.push_back("-oformat");
+    tokens.push_back(outputFormat.c_str());
+  }
+
+  vector<Action*> actions;
+  ElementDeleter<vector<Action*> > actionsDeleter(actions);
+  for (size_t i = 0; i < threadCount; ++i) {
+    unique_ptr<Action> action =
+      Action::createActionWithPrefix(_action.getName());
+    action->parseCommandLine(tokens.size(), &tokens.front());
+    exceptionSafePushBack(actions, std::move(action));
+  }
+
+  vector<std::thread> threads;
+  try {
+    for (size_t i = 0; i < actions.size(); ++i)
+      threads.push_back(std::thread(&BatchRunner::workerLoop,
+                                    this, actions[i]));
+
+    JobReader reader(*this);
+    handler->readIdeals(scanner, reader);
+    scanner.expectEOF();
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    storeError();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _inputDone = true;
+  }
+  _workAvailable.notify_all();
+  for (size_t i = 0; i < threads.size(); ++i)
+    threads[i].join();
+
+  if (_error)
+    std::rethrow_exception(_error);
+  ASSERT(_pending.empty());
+  ASSERT(_inFlight.empty());
+  fflush(_out);
+}
+
+void BatchRunner::submit(Job* job) {
+  unique_ptr<Job> jobDeleter(job);
+  std::unique_lock<std::mutex> lock(_mutex);
+  _spaceAvailable.wait(lock, [this] {
+      return _inFlight.size() < _maxInFlight || _error;
+    });
+  if (_error)
+    std::rethrow_exception(_error);
+
+  exceptionSafePushBack(_inFlight, std::move(jobDeleter));
+  _pending.push_back(job);
+  lock.unlock();
+  _workAvailable.notify_one();
+}
+
+void BatchRunner::workerLoop(Action* action) {
+  while (true) {
+    Job* job;
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _workAvailable.wait(lock, [this] {
+          return !_pending.empty() || _inputDone || _error;
+        });
+      if (_error || _pending.empty())
+        return;
+      job = _pending.front();
+      _pending.pop_front();
+    }
+
+    try {
+      FILE* in = IO::openMemoryInput(job->input, job->inputSize);
+      FileCloser inCloser(in);
+      IO::MemoryOutput out;
+
+      action->setInputOutput(in, out.getFile());
+      action->perform();
+      out.close();
+      job->outputSize = out.getSize();
+      job->output = out.releaseData();
+
+      std::lock_guard<std::mutex> lock(_mutex);
+      job->done = true;
+      writeDoneJobs();
+    } catch (...) {
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        storeError();
+      }
+      _spaceAvailable.notify_all();
+      _workAvailable.notify_all();
+      return;
+    }
+    _spaceAvailable.notify_one();
+  }
+}
+
+void BatchRunner::writeDoneJobs() {
+  while (!_inFlight.empty() && _inFlight.front()->done) {
+    Job* job = _inFlight.front();
+    if (fwrite(job->output, 1, job->outputSize, _out) != job->outputSize)
+      reportError("Could not write output.");
+    _inFlight.pop_front();
+    delete job;
+  }
+}
+
+void BatchRunner::storeError() {
+  if (!_error)
+    _error = std::current_exception();
+}
@@ -0,0 +1,94 @@
+/* Frobby: Software for monomial ideal computations.
+   Copyright (C) 2007 Bjarke Hammersholt Roune (www.broune.com)
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see http://www.gnu.org/licenses/.
+*/
+#ifndef BATCH_RUNNER_GUARD
+#define BATCH_RUNNER_GUARD
+
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+
+class Action;
+
+/** Runs an action on each ideal of a list of ideals using a number
+ of threads. This is the implementation of the -batch option.
+
+ The calling thread reads the ideals one at a time and hands each one
+ to a worker thread as soon as it has been read, so the list is never
+ held in memory all at once. Each worker has its own instance of the
+ action that is configured from the same command line. The ideal is
+ passed to the action in the binary format in memory, and the output
+ of the action is collected in memory. Outputs are written in the
+ order of the input as soon as all the outputs before them have been
+ written.
+
+ If an action reports an error, then no more ideals are started and
+ the first error is reported once the workers have stopped. */
+class BatchRunner {
+ public:
+  /** The workers run actions of the same kind as action, and they
+   are configured from the given command line. */
+  BatchRunner(const Action& action,
+              unsigned int tokenCount,
+              const char** tokens);
+  ~BatchRunner();
+
+  /** Reads a list of ideals from in and writes the output for each
+   ideal to out. */
+  void run(size_t threadCount, FILE* in, FILE* out);
+
+ private:
+  struct Job;
+  class JobReader;
+
+  /** Hands job to the workers. Waits if too many jobs are in
+   flight. */
+  void submit(Job* job);
+
+  void workerLoop(Action* action);
+
+  /** Writes the output of the jobs at the front of _inFlight that are
+   done. The caller must hold _mutex. */
+  void writeDoneJobs();
+
+  /** Stores the current exception unless one is stored already. The
+   caller must hold _mutex. */
+  void storeError();
+
+  const Action& _action;
+  std::vector<const char*> _tokens;
+  FILE* _out;
+
+  /** The most jobs that can be read but not yet written. */
+  size_t _maxInFlight;
+
+  std::mutex _mutex;
+  std::condition_variable _workAvailable;
+  std::condition_variable _spaceAvailable;
+
+  /** Jobs that no worker has started yet. */
+  std::deque<Job*> _pending;
+
+  /** Jobs that have been read but not written, in input order. */
+  std::deque<Job*> _inFlight;
+
+  bool _inputDone;
+  std::exception_ptr _error;
+};
+
+#endif
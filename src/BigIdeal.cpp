@@ -23,6 +23,7 @@
 #include "VarSorter.h"
 #include "RawSquareFreeTerm.h"
 #include "SquareFreeIdeal.h"
+#include "CompactBigIdeal.h"
 #include <sstream>
 
 class OffsetTermCompare {
@@ -91,6 +92,17 @@ void BigIdeal::insert(const SquareFreeIdeal& ideal) {
   }
 }
 
+void BigIdeal::insert(const CompactBigIdeal& ideal) {
+  ASSERT(ideal.getVarCount() == getVarCount());
+  reserve(getGeneratorCount() + ideal.getGeneratorCount());
+
+  for (size_t term = 0; term < ideal.getGeneratorCount(); ++term) {
+    newLastTerm();
+    for (size_t var = 0; var < _names.getVarCount(); ++var)
+      ideal.getExponent(term, var, getLastTermExponentRef(var));
+  }
+}
+
 void BigIdeal::insert(const vector<mpz_class>& term) {
   newLastTerm();
   getLastTermRef() = term;
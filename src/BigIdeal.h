@@ -23,6 +23,7 @@
 class TermTranslator;
 class Ideal;
 class SquareFreeIdeal;
+class CompactBigIdeal;
 
 class BigIdeal {
 public:
@@ -32,6 +33,7 @@ public:
   void insert(const Ideal& ideal);
   void insert(const Ideal& ideal, const TermTranslator& translator);
   void insert(const SquareFreeIdeal& ideal);
+  void insert(const CompactBigIdeal& ideal);
   void insert(const vector<mpz_class>& term);
 
   void renameVars(const VarNames& names);
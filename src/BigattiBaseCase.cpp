@@ -20,6 +20,7 @@
 
 #include "BigattiState.h"
 #include "TermTranslator.h"
+#include "HilbertMemo.h"
 #include <algorithm>
 
 BigattiBaseCase::BigattiBaseCase(const TermTranslator& translator):
@@ -30,7 +31,10 @@ BigattiBaseCase::BigattiBaseCase(const TermTranslator& translator):
  _translator(translator),
  _totalBaseCasesEver(0),
  _totalTermsOutputEver(0),
- _printDebug(false) {
+ _printDebug(false),
+ _recorder(0),
+ _plusOne(1),
+ _minusOne(-1) {
 }
 
 bool BigattiBaseCase::genericBaseCase(const BigattiState& state) {
@@ -91,19 +95,60 @@ void BigattiBaseCase::output(bool plus, const Term& term) {
     fputs(".\n", stderr);
   }
 
+  if (_recorder != 0)
+    _recorder->record(plus ? _plusOne : _minusOne, term);
+
   ++_totalTermsOutputEver;
   if (_computeUnivariate) {
-    if (term.getVarCount() == 0)
-      _tmp = 0;
-    else
-      _tmp = _translator.getExponent(0, term);
-    for (size_t var = 1; var < term.getVarCount(); ++var)
-      _tmp += _translator.getExponent(var, term);
+    computeDegree(term);
     _outputUnivariate.add(plus, _tmp);
   } else
     _outputMultivariate.add(plus, term);
 }
 
+void BigattiBaseCase::output(const mpz_class& coef, const Term& term) {
+  if (_printDebug) {
+    fputs("Debug: Outputting term ", stderr);
+    gmp_fprintf(stderr, "%+Zd*", coef.get_mpz_t());
+    term.print(stderr);
+    fputs(".\n", stderr);
+  }
+
+  if (_recorder != 0)
+    _recorder->record(coef, term);
+
+  ++_totalTermsOutputEver;
+  if (_computeUnivariate) {
+    computeDegree(term);
+    _outputUnivariate.add(coef, _tmp);
+  } else
+    _outputMultivariate.add(coef, term);
+}
+
+void BigattiBaseCase::computeDegree(const Term& term) {
+  if (term.getVarCount() == 0)
+    _tmp = 0;
+  else
+    _tmp = _translator.getExponent(0, term);
+  for (size_t var = 1; var < term.getVarCount(); ++var)
+    _tmp += _translator.getExponent(var, term);
+}
+
+void BigattiBaseCase::setRecorder(HilbertMemoRecorder* recorder) {
+  _recorder = recorder;
+}
+
+void BigattiBaseCase::add(const BigattiBaseCase& baseCase) {
+  ASSERT(_computeUnivariate == baseCase._computeUnivariate);
+
+  if (_computeUnivariate)
+    _outputUnivariate.add(baseCase._outputUnivariate);
+  else
+    _outputMultivariate.add(baseCase._outputMultivariate);
+  _totalBaseCasesEver += baseCase._totalBaseCasesEver;
+  _totalTermsOutputEver += baseCase._totalTermsOutputEver;
+}
+
 void BigattiBaseCase::feedOutputTo
 (CoefBigTermConsumer& consumer,
  bool inCanonicalOrder) {
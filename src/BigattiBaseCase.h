@@ -20,6 +20,7 @@
 
 class BigattiState;
 class TermTranslator;
+class HilbertMemoRecorder;
 
 #include "Term.h"
 #include "Ideal.h"
@@ -50,6 +51,19 @@ class BigattiBaseCase {
    false respectively. */
   void output(bool plus, const Term& term);
 
+  /** Add coef*term to the output polynomial. */
+  void output(const mpz_class& coef, const Term& term);
+
+  /** Every term that is output is also recorded by recorder if it is
+   not null. */
+  void setRecorder(HilbertMemoRecorder* recorder);
+
+  /** Add the output polynomial computed so far by baseCase to the
+   output polynomial of this object, and add its statistics to the
+   statistics of this object. This is used to combine the results of
+   several threads. */
+  void add(const BigattiBaseCase& baseCase);
+
   /** Feed the output Hilbert-Poincare numerator polynomial computed
    so far to the consumer. This is done in canonical order if
    inCanonicalOrder is true. */
@@ -83,6 +97,9 @@ class BigattiBaseCase {
 
   bool univariateAllFaces(const BigattiState& state);
 
+  /** Sets _tmp to the degree of term in the coarse grading. */
+  void computeDegree(const Term& term);
+
   /** The ideal in state must be weakly generic. Then the
    Hilbert-Poincare series is computed by enumerating the facet of the
    Scarf complex.
@@ -131,6 +148,10 @@ class BigattiBaseCase {
   size_t _totalTermsOutputEver;
 
   bool _printDebug;
+
+  HilbertMemoRecorder* _recorder;
+  const mpz_class _plusOne;
+  const mpz_class _minusOne;
 };
 
 #endif
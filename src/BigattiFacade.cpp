@@ -21,12 +21,19 @@
 #include "BigattiHilbertAlgorithm.h"
 #include "BigattiParams.h"
 #include "BigattiPivotStrategy.h"
+#include "display.h"
 
 BigattiFacade::BigattiFacade(const BigattiParams& params):
   Facade(params.getPrintActions()),
   _pivot(BigattiPivotStrategy::createStrategy
          (params.getPivot(), params.getWidenPivot())),
   _params(params) {
+  if (_params.getPrintDebug() && _params.getThreadCount() > 1) {
+    displayNote
+      ("Using a single thread as debug output is not supported\n"
+       "for parallel computation.");
+    _params.setThreadCount(1);
+  }
   _common.readIdealAndSetPolyOutput(params);
 }
 
@@ -36,6 +43,9 @@ BigattiFacade::~BigattiFacade() {
 }
 
 void BigattiFacade::computeMultigradedHilbertSeries() {
+  if (_common.lookupCachedPolynomial
+      ("multigraded Hilbert-Poincare series by Bigatti et.al."))
+    return;
   beginAction("Computing multigraded Hilbert-Poincare series.");
 
   BigattiHilbertAlgorithm alg(_common.takeIdeal(),
@@ -47,9 +57,13 @@ void BigattiFacade::computeMultigradedHilbertSeries() {
   alg.run();
 
   endAction();
+  _common.storeCachedResult();
 }
 
 void BigattiFacade::computeUnivariateHilbertSeries() {
+  if (_common.lookupCachedPolynomial
+      ("univariate Hilbert-Poincare series by Bigatti et.al."))
+    return;
   beginAction("Computing univariate Hilbert-Poincare series");
 
   BigattiHilbertAlgorithm alg(_common.takeIdeal(),
@@ -61,4 +75,5 @@ void BigattiFacade::computeUnivariateHilbertSeries() {
   alg.run();
 
   endAction();
+  _common.storeCachedResult();
 }
@@ -21,6 +21,49 @@
 #include "Ideal.h"
 #include "CoefBigTermConsumer.h"
 #include "BigattiState.h"
+#include "TermTranslator.h"
+#include "CoefTermConsumer.h"
+#include "TaskSchedule.h"
+#include "ProgressReporter.h"
+
+namespace {
+  /** States whose ideal has more generators than this are not looked
+   up in the memo table. */
+  const size_t MaxMemoGeneratorCount = 64;
+
+  /** Passes what the memo table outputs on to a base case object. */
+  class BaseCaseConsumer : public CoefTermConsumer {
+  public:
+    BaseCaseConsumer(BigattiBaseCase& baseCase):
+      _baseCase(baseCase) {
+    }
+
+    virtual void consumeRing(const VarNames& names) {
+    }
+
+    virtual void beginConsuming() {
+    }
+
+    virtual void consume(const mpz_class& coef, const Term& term) {
+      _baseCase.output(coef, term);
+    }
+
+    virtual void doneConsuming() {
+    }
+
+  private:
+    BigattiBaseCase& _baseCase;
+  };
+}
+
+BigattiHilbertAlgorithm::Worker::Worker
+(const TermTranslator& translator,
+ unique_ptr<BigattiPivotStrategy> pivotParam):
+  baseCase(translator),
+  pivot(std::move(pivotParam)) {
+  ASSERT(pivot.get() != 0);
+  tmp_simplify_gcd.reset(translator.getVarCount());
+}
 
 BigattiHilbertAlgorithm::
 BigattiHilbertAlgorithm
@@ -31,17 +74,27 @@ BigattiHilbertAlgorithm
  CoefBigTermConsumer& consumer):
  _translator(translator),
  _consumer(&consumer),
- _baseCase(translator),
- _pivot(std::move(pivot)),
+ _workersDeleter(_workers),
  _computeUnivariate(false),
  _params(params) {
 
   ASSERT(ideal.get() != 0);
   ASSERT(ideal->isMinimallyGenerated());
   _varCount = ideal->getVarCount();
-  _tmp_simplify_gcd.reset(_varCount);
 
-  _baseCase.setPrintDebug(_params.getPrintDebug());
+  // Pivot strategies keep state, so each worker gets its own.
+  _tasks.setThreadCount(_params.getThreadCount());
+  _tasks.setSchedule(TaskSchedule::createSchedule
+                     (_params.getSchedule(), _params.getScheduleLimit()));
+  _workers.reserve(_tasks.getThreadCount());
+  for (size_t i = 0; i < _tasks.getThreadCount(); ++i) {
+    if (i > 0 || pivot.get() == 0)
+      pivot = BigattiPivotStrategy::createStrategy
+        (_params.getPivot(), _params.getWidenPivot());
+    unique_ptr<Worker> worker(new Worker(translator, std::move(pivot)));
+    worker->baseCase.setPrintDebug(_params.getPrintDebug());
+    exceptionSafePushBack(_workers, std::move(worker));
+  }
 
   // TODO: use swap to avoid copy of ideal.
   _tasks.addTask(new BigattiState(this, *ideal, Term(_varCount)));
@@ -52,44 +105,84 @@ void BigattiHilbertAlgorithm::setComputeUnivariate(bool value) {
 }
 
 void BigattiHilbertAlgorithm::run() {
-  if (_pivot.get() == 0)
-    _pivot = BigattiPivotStrategy::createStrategy("median", true);
+  for (size_t i = 0; i < _workers.size(); ++i)
+    _workers[i]->baseCase.setComputeUnivariate(_computeUnivariate);
+
+  // The univariate base case outputs some states directly as
+  // univariate polynomials, which cannot be recorded as terms.
+  if (!_computeUnivariate)
+    _memo.setMaxMemoryUse(_params.getMemoSize() * 1024 * 1024);
 
-  _baseCase.setComputeUnivariate(_computeUnivariate);
   _tasks.runTasks();
-  _baseCase.feedOutputTo(*_consumer, _params.getProduceCanonicalOutput());
+
+  BigattiBaseCase& baseCase = _workers.front()->baseCase;
+  for (size_t i = 1; i < _workers.size(); ++i)
+    baseCase.add(_workers[i]->baseCase);
+  baseCase.feedOutputTo(*_consumer, _params.getProduceCanonicalOutput());
 
   if (_params.getPrintStatistics()) {
     fputs("*** Statistics for run of Bigatti algorithm ***\n", stderr);
     fprintf(stderr, " %u states processed.\n",
             (unsigned int)_tasks.getTotalTasksEver());
+    fprintf(stderr, " %u states pending at most at once.\n",
+            (unsigned int)_tasks.getMaxPendingTasks());
     fprintf(stderr, " %u base cases.\n",
-            (unsigned int)_baseCase.getTotalBaseCasesEver());
+            (unsigned int)baseCase.getTotalBaseCasesEver());
     fprintf(stderr, " %u terms output.\n",
-            (unsigned int)_baseCase.getTotalTermsOutputEver());
+            (unsigned int)baseCase.getTotalTermsOutputEver());
     fprintf(stderr, " %u terms in final output.\n",
-            (unsigned int)_baseCase.getTotalTermsInOutput());
+            (unsigned int)baseCase.getTotalTermsInOutput());
+    if (_memo.isOn())
+      _memo.printReport(stderr);
   }
 }
 
-void BigattiHilbertAlgorithm::processState(unique_ptr<BigattiState> state) {
-  if (_params.getUseSimplification())
-    simplify(*state);
-
-  if (_params.getPrintDebug()) {
-    fputs("Debug: Processing state.\n", stderr);
-    state->print(stderr);
-  }
+BigattiHilbertAlgorithm::Worker& BigattiHilbertAlgorithm::getWorker() {
+  ASSERT(_tasks.getCurrentWorker() < _workers.size());
+  return *_workers[_tasks.getCurrentWorker()];
+}
 
-  bool isBaseCase = _params.getUseGenericBaseCase() ?
-    _baseCase.genericBaseCase(*state) :
-    _baseCase.baseCase(*state);
-  if (isBaseCase) {
-    freeState(std::move(state));
-    return;
+void BigattiHilbertAlgorithm::processState(unique_ptr<BigattiState> state) {
+  Worker& worker = getWorker();
+  worker.baseCase.setRecorder(state->getRecorder());
+
+  if (state->isBeingRecorded()) {
+    // The state has already been simplified and looked up in the memo
+    // table, so it only remains to split it.
+    state->setIsBeingRecorded(false);
+  } else {
+    if (_params.getUseSimplification())
+      simplify(*state, worker);
+
+    if (_params.getPrintDebug()) {
+      fputs("Debug: Processing state.\n", stderr);
+      state->print(stderr);
+    }
+
+    bool isBaseCase = _params.getUseGenericBaseCase() ?
+      worker.baseCase.genericBaseCase(*state) :
+      worker.baseCase.baseCase(*state);
+    ProgressReporter::noteSlice(isBaseCase);
+    if (isBaseCase) {
+      freeState(std::move(state));
+      return;
+    }
+
+    if (useMemo(*state)) {
+      HilbertMemoKey key;
+      key.set(state->getIdeal(), 0);
+      BaseCaseConsumer consumer(worker.baseCase);
+      if (_memo.lookup(key, state->getMultiply(), consumer)) {
+        freeState(std::move(state));
+        return;
+      }
+
+      recordState(std::move(state), key);
+      return;
+    }
   }
 
-  const Term& pivot = _pivot->getPivot(*state);
+  const Term& pivot = worker.pivot->getPivot(*state);
   if (_params.getPrintDebug()) {
     fputs("Debug: Performing pivot split on ", stderr);
     pivot.print(stderr);
@@ -98,7 +191,7 @@ void BigattiHilbertAlgorithm::processState(unique_ptr<BigattiState> state) {
   ASSERT(!pivot.isIdentity());
   ASSERT(!state->getIdeal().contains(pivot));
 
-  unique_ptr<BigattiState> colonState(_stateCache.newObjectCopy(*state));
+  unique_ptr<BigattiState> colonState(worker.stateCache.newObjectCopy(*state));
   colonState->colonStep(pivot);
   _tasks.addTask(colonState.release());
 
@@ -106,16 +199,16 @@ void BigattiHilbertAlgorithm::processState(unique_ptr<BigattiState> state) {
   _tasks.addTask(state.release());
 }
 
-void BigattiHilbertAlgorithm::simplify(BigattiState& state) {
-  Term& gcd = _tmp_simplify_gcd;
+void BigattiHilbertAlgorithm::simplify(BigattiState& state, Worker& worker) {
+  Term& gcd = worker.tmp_simplify_gcd;
   ASSERT(gcd.getVarCount() == _varCount);
 
   state.getIdeal().getGcd(gcd);
   if (!gcd.isIdentity()) {
     // Do colon and output multiply-gcd*multiply.
-    _baseCase.output(true, state.getMultiply());
+    worker.baseCase.output(true, state.getMultiply());
     state.colonStep(gcd);
-    _baseCase.output(false, state.getMultiply());
+    worker.baseCase.output(false, state.getMultiply());
   }
 
   IF_DEBUG(state.getIdeal().getGcd(gcd));
@@ -124,5 +217,26 @@ void BigattiHilbertAlgorithm::simplify(BigattiState& state) {
 
 void BigattiHilbertAlgorithm::freeState(unique_ptr<BigattiState> state) {
   state->getIdeal().clear(); // To preserve memory
-  _stateCache.freeObject(std::move(state));
+  getWorker().stateCache.freeObject(std::move(state));
+}
+
+bool BigattiHilbertAlgorithm::useMemo(const BigattiState& state) const {
+  return _memo.isOn() &&
+    state.getIdeal().getGeneratorCount() <= MaxMemoGeneratorCount;
+}
+
+void BigattiHilbertAlgorithm::recordState(unique_ptr<BigattiState> state,
+                                          HilbertMemoKey& key) {
+  ASSERT(state.get() != 0);
+  ASSERT(!state->isBeingRecorded());
+
+  unique_ptr<HilbertMemoRecorder> recorder
+    (new HilbertMemoRecorder(_memo, key, state->getMultiply(),
+                             state->getRecorder(),
+                             _tasks.getThreadCount() > 1));
+  state->setRecorder(recorder.get());
+  state->setIsBeingRecorded(true);
+
+  // The recorder runs when we are done with the state.
+  _tasks.addTask(state.release(), recorder.release());
 }
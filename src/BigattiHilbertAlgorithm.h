@@ -25,6 +25,8 @@
 #include "BigattiBaseCase.h"
 #include "BigattiPivotStrategy.h"
 #include "BigattiParams.h"
+#include "ElementDeleter.h"
+#include "HilbertMemo.h"
 
 class CoefBigTermConsumer;
 class Term;
@@ -50,24 +52,50 @@ public:
   void run();
 
 private:
+    /** The part of the state of the algorithm that each worker thread
+     has its own copy of. Each worker accumulates the base cases it
+     sees into its own output polynomial, and these are added together
+     once all states have been processed. */
+    struct Worker {
+      Worker(const TermTranslator& translator,
+             unique_ptr<BigattiPivotStrategy> pivot);
+
+      BigattiBaseCase baseCase;
+      ObjectCache<BigattiState> stateCache;
+      Term tmp_simplify_gcd;
+      unique_ptr<BigattiPivotStrategy> pivot;
+    };
+
+    /** Returns the worker that is running on the calling thread. */
+    Worker& getWorker();
+
     void processState(unique_ptr<BigattiState> state);
     void getPivot(BigattiState& state, size_t& var, Exponent& e);
-    void simplify(BigattiState& state);
+    void simplify(BigattiState& state, Worker& worker);
 
     void freeState(unique_ptr<BigattiState> state);
 
+    bool useMemo(const BigattiState& state) const;
+
+    /** Splits state once it has been run again and stores the output
+     of state and the states it is split into as the contribution for
+     key once they are all done. */
+    void recordState(unique_ptr<BigattiState> state, HilbertMemoKey& key);
+
     size_t _varCount;
     const TermTranslator& _translator;
     CoefBigTermConsumer* _consumer;
-    TaskEngine _tasks;
-    ObjectCache<BigattiState> _stateCache;
 
-    Term _tmp_processState_pivot;
-    Term _tmp_simplify_gcd;
+    /** These have to be declared before _tasks since pending tasks
+     return themselves to the state cache of a worker when _tasks is
+     destructed. */
+    vector<Worker*> _workers;
+    ElementDeleter<vector<Worker*> > _workersDeleter;
 
-    BigattiBaseCase _baseCase;
+    /** The contributions of states that have been computed before. */
+    HilbertMemo _memo;
 
-    unique_ptr<BigattiPivotStrategy>  _pivot;
+    TaskEngine _tasks;
 
     bool _computeUnivariate;
     BigattiParams _params;
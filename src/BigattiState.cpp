@@ -25,7 +25,9 @@ BigattiState::BigattiState(BigattiHilbertAlgorithm* algorithm,
                            const Ideal& ideal, const Term& multiply):
   _algorithm(algorithm),
   _ideal(ideal),
-  _multiply(multiply) {
+  _multiply(multiply),
+  _recorder(0),
+  _isBeingRecorded(false) {
   ASSERT(_algorithm != 0);
   ASSERT(_ideal.getVarCount() == _multiply.getVarCount());
 }
@@ -87,6 +89,22 @@ void BigattiState::addStep(const Term& pivot) {
   _ideal.insertReminimize(pivot);
 }
 
+HilbertMemoRecorder* BigattiState::getRecorder() const {
+  return _recorder;
+}
+
+void BigattiState::setRecorder(HilbertMemoRecorder* recorder) {
+  _recorder = recorder;
+}
+
+bool BigattiState::isBeingRecorded() const {
+  return _isBeingRecorded;
+}
+
+void BigattiState::setIsBeingRecorded(bool value) {
+  _isBeingRecorded = value;
+}
+
 void BigattiState::run(TaskEngine& tasks) {
   _algorithm->processState(unique_ptr<BigattiState>(this));
 }
@@ -95,6 +113,10 @@ void BigattiState::dispose() {
   _algorithm->freeState(unique_ptr<BigattiState>(this));
 }
 
+size_t BigattiState::getSizeEstimate() const {
+  return _ideal.getGeneratorCount();
+}
+
 void BigattiState::print(FILE* out) {
   ostringstream str;
   print(str);
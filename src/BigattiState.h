@@ -23,6 +23,7 @@
 #include "Term.h"
 
 class BigattiHilbertAlgorithm;
+class HilbertMemoRecorder;
 
 class BigattiState : public Task {
  public:
@@ -43,9 +44,24 @@ class BigattiState : public Task {
   void colonStep(const Term& term);
   void addStep(const Term& term);
 
+  /** Returns the recorder that records the output of this state for
+   the memo table, or null if there is none. Copies of a state have
+   the same recorder, so the states that a state is split into are
+   recorded along with it. */
+  HilbertMemoRecorder* getRecorder() const;
+  void setRecorder(HilbertMemoRecorder* recorder);
+
+  /** Returns true if this state has already been looked up in the
+   memo table, so that it only remains to split it. */
+  bool isBeingRecorded() const;
+  void setIsBeingRecorded(bool value);
+
   virtual void run(TaskEngine& tasks);
   virtual void dispose();
 
+  /** Returns the number of generators of the ideal. */
+  virtual size_t getSizeEstimate() const;
+
   void print(FILE* out);
   void print(ostream& out);
 
@@ -53,6 +69,8 @@ class BigattiState : public Task {
   BigattiHilbertAlgorithm* _algorithm;
   Ideal _ideal;
   Term _multiply;
+  HilbertMemoRecorder* _recorder;
+  bool _isBeingRecorded;
 };
 
 #endif
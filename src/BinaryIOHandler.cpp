@@ -0,0 +1,733 @@
+/* Frobby: Software for monomial ideal computations.
+   Copyright (C) 2007 Bjarke Hammersholt Roune (www.broune.com)
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see http://www.gnu.org/licenses/.
+*/
+#include "stdinc.h"
+#include "BinaryIOHandler.h"
+
+#include "Scanner.h"
+#include "VarNames.h"
+#include "BigTermConsumer.h"
+#include "CoefBigTermConsumer.h"
+#include "DataType.h"
+#include "IdealWriter.h"
+#include "PolyWriter.h"
+#include "TermTranslator.h"
+#include "Term.h"
+#include "InputConsumer.h"
+#include "FrobbyStringStream.h"
+#include "error.h"
+
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <algorithm>
+
+namespace IO {
+  namespace Binary {
+    typedef vector<unsigned char> Bytes;
+
+    const char Magic[] = "\x7F" "FRB";
+    const size_t MagicSize = 4;
+    const unsigned char Version = 1;
+
+    const unsigned char IdealKind = 'I';
+    const unsigned char PolynomialKind = 'P';
+    const unsigned char RingKind = 'R';
+    const unsigned char TermKind = 'T';
+
+    const unsigned char HasNamesFlag = 1;
+
+    /** Bit 0 of a number is set if it is a big integer. */
+    const unsigned long BigFlag = 1;
+
+    /** Bit 1 of a signed number is set if it is negative. */
+    const unsigned long NegativeFlag = 2;
+
+    /** The largest number of variables that a header without names
+     can have. The names x1, x2 and so on are made up without reading
+     any input, so unlike the other counts in the format this one
+     cannot be checked against the input that remains. Writers give
+     the names explicitly for more variables than this. */
+    const size_t MaxDefaultNameCount = 1 << 20;
+
+    /** The number of terms in each block that the writers produce.
+     This is also the most terms that a block can have in a ring
+     without variables. */
+    const size_t BlockTermCount = 4096;
+
+    /** Exponents that do not fit in a word are marked with this in
+     BlockWriter. Note that CompactBigIdeal uses the same marker. */
+    const unsigned long BigMarker = numeric_limits<unsigned long>::max();
+
+    void writeVarint(Bytes& out, unsigned long value);
+    size_t getVarintSize(unsigned long value);
+    void writeNumber(Bytes& out, const mpz_class& value, bool isSigned);
+    void writeWord(Bytes& out, unsigned long value);
+    void writeHeader(Bytes& out, unsigned char kind, const VarNames& names);
+    void writeBytes(Bytes& out, FILE* file);
+
+    unsigned char readByte(Scanner& in);
+    unsigned long readVarint(Scanner& in);
+    bool readNumber(Scanner& in, unsigned long& word, mpz_class& big);
+    void readSignedNumber(Scanner& in, mpz_class& value);
+    void readBig(Scanner& in, unsigned long byteCount, mpz_class& big);
+    unsigned char readHeader(Scanner& in, VarNames& names);
+    void expectKind(Scanner& in, unsigned char kind, unsigned char expected);
+    unsigned int readColumnWidth(Scanner& in);
+
+    /** Reads blocks until the end of the record. Reads coefficients
+     into coefs if it is not null. */
+    template<class Sink>
+    void readBlocks(Scanner& in, size_t varCount,
+                    vector<mpz_class>* coefs, Sink& sink);
+
+    /** Collects the terms of an ideal or polynomial and writes them
+     in blocks. The column width of each block is chosen based on the
+     exponents in that block. */
+    class BlockWriter {
+    public:
+      BlockWriter(FILE* out);
+
+      void writeHeader(unsigned char kind, const VarNames& names);
+      void writeRing(const VarNames& names);
+
+      void addCoef(const mpz_class& coef);
+      void addExponent(const mpz_class& exponent);
+      void endTerm();
+
+      /** Writes the remaining terms and ends the record. */
+      void writeEnd();
+
+    private:
+      void writeBlock();
+
+      FILE* const _out;
+      Bytes _bytes;
+      size_t _termCount;
+
+      /** The exponents of the current block, with BigMarker for
+       those that are stored in _bigs. */
+      vector<unsigned long> _exponents;
+      vector<mpz_class> _bigs;
+      size_t _bigCount;
+
+      vector<mpz_class> _coefs;
+    };
+  }
+  namespace B = Binary;
+
+  class BinaryIdealWriter : public IdealWriter {
+  public:
+    // BlockWriter buffers the output, so IdealWriter does not have to.
+    BinaryIdealWriter(FILE* out): IdealWriter(out, 1, false), _writer(out) {
+    }
+
+  private:
+    virtual void doWriteHeader(bool first) {
+      _writer.writeHeader(B::IdealKind, getNames());
+    }
+
+    virtual void doWriteTerm(const Term& term,
+                             const TermTranslator& translator,
+                             bool first) {
+      for (size_t var = 0; var < term.getVarCount(); ++var)
+        _writer.addExponent(translator.getExponent(var, term));
+      _writer.endTerm();
+    }
+
+    virtual void doWriteTerm(const vector<mpz_class>& term,
+                             bool first) {
+      for (size_t var = 0; var < term.size(); ++var)
+        _writer.addExponent(term[var]);
+      _writer.endTerm();
+    }
+
+    virtual void doWriteFooter(bool wasZeroIdeal) {
+      _writer.writeEnd();
+    }
+
+    virtual void doWriteEmptyList() {
+      _writer.writeRing(getNames());
+    }
+
+    B::BlockWriter _writer;
+  };
+
+  class BinaryPolyWriter : public PolyWriter {
+  public:
+    BinaryPolyWriter(FILE* out): PolyWriter(out, 1, false), _writer(out) {
+    }
+
+  private:
+    virtual void doWriteHeader() {
+      _writer.writeHeader(B::PolynomialKind, getNames());
+    }
+
+    virtual void doWriteTerm(const mpz_class& coef,
+                             const Term& term,
+                             const TermTranslator& translator,
+                             bool firstGenerator) {
+      _writer.addCoef(coef);
+      for (size_t var = 0; var < term.getVarCount(); ++var)
+        _writer.addExponent(translator.getExponent(var, term));
+      _writer.endTerm();
+    }
+
+    virtual void doWriteTerm(const mpz_class& coef,
+                             const vector<mpz_class>& term,
+                             bool firstGenerator) {
+      _writer.addCoef(coef);
+      for (size_t var = 0; var < term.size(); ++var)
+        _writer.addExponent(term[var]);
+      _writer.endTerm();
+    }
+
+    virtual void doWriteFooter(bool wasZero) {
+      _writer.writeEnd();
+    }
+
+    B::BlockWriter _writer;
+  };
+
+  namespace {
+    /** Passes the terms read by readBlocks on to an InputConsumer. */
+    class IdealSink {
+    public:
+      IdealSink(InputConsumer& consumer, const Scanner& in):
+        _consumer(consumer), _in(in) {}
+
+      void beginTerm(size_t term) {_consumer.beginTerm();}
+      void consumeExponent(size_t var, unsigned long exponent) {
+        _consumer.consumeVarExponent(var, exponent, _in);
+      }
+      void consumeExponent(size_t var, const mpz_class& exponent) {
+        _consumer.consumeVarExponent(var, exponent, _in);
+      }
+      void endTerm(size_t term) {_consumer.endTerm();}
+
+    private:
+      InputConsumer& _consumer;
+      const Scanner& _in;
+    };
+
+    /** Passes the terms read by readBlocks on to a
+     CoefBigTermConsumer. */
+    class PolySink {
+    public:
+      PolySink(CoefBigTermConsumer& consumer, size_t varCount):
+        _consumer(consumer), _term(varCount) {}
+
+      void beginTerm(size_t term) {}
+      void consumeExponent(size_t var, unsigned long exponent) {
+        _term[var] = exponent;
+      }
+      void consumeExponent(size_t var, const mpz_class& exponent) {
+        _term[var] = exponent;
+      }
+      void endTerm(size_t term) {
+        ASSERT(term < _coefs.size());
+        _consumer.consume(_coefs[term], _term);
+      }
+      vector<mpz_class>& getCoefs() {return _coefs;}
+
+    private:
+      CoefBigTermConsumer& _consumer;
+      vector<mpz_class> _term;
+      vector<mpz_class> _coefs;
+    };
+  }
+
+  BinaryIOHandler::BinaryIOHandler():
+    IOHandlerImpl(staticGetName(),
+                  "Compact binary format for exchanging data between programs.") {
+    registerInput(DataType::getMonomialIdealType());
+    registerInput(DataType::getMonomialIdealListType());
+    registerInput(DataType::getPolynomialType());
+    registerOutput(DataType::getMonomialIdealType());
+    registerOutput(DataType::getMonomialIdealListType());
+    registerOutput(DataType::getPolynomialType());
+  }
+
+  const char* BinaryIOHandler::staticGetName() {
+    return "binary";
+  }
+
+  BigTermConsumer* BinaryIOHandler::
+  doCreateIdealWriter(FILE* out, size_t threadCount) {
+    return new BinaryIdealWriter(out);
+  }
+
+  CoefBigTermConsumer* BinaryIOHandler::
+  doCreatePolynomialWriter(FILE* out, size_t threadCount) {
+    return new BinaryPolyWriter(out);
+  }
+
+  void BinaryIOHandler::doWriteTerm(const vector<mpz_class>& term,
+                                    const VarNames& names,
+                                    FILE* out) {
+    B::Bytes bytes;
+    B::writeHeader(bytes, B::TermKind, names);
+    for (size_t var = 0; var < term.size(); ++var)
+      B::writeNumber(bytes, term[var], false);
+    B::writeBytes(bytes, out);
+  }
+
+  void BinaryIOHandler::doReadTerm(Scanner& in, InputConsumer& consumer) {
+    VarNames names;
+    B::expectKind(in, B::readHeader(in, names), B::TermKind);
+
+    // Match up the variables by name if there are names.
+    const VarNames& ring = consumer.getRing();
+    if (names.getVarCount() != ring.getVarCount()) {
+      FrobbyStringStream errorMsg;
+      errorMsg << "Expected a term with " << ring.getVarCount()
+               << " variables but got one with "
+               << names.getVarCount() << " variables.";
+      reportSyntaxError(in, errorMsg);
+    }
+
+    unsigned long word;
+    mpz_class big;
+    consumer.beginTerm();
+    for (size_t i = 0; i < names.getVarCount(); ++i) {
+      size_t var = i;
+      if (!names.namesAreDefault()) {
+        var = ring.getIndex(names.getName(i));
+        if (var == VarNames::invalidIndex)
+          reportSyntaxError
+            (in, "Unknown variable \"" + names.getName(i) + "\".");
+      }
+      if (B::readNumber(in, word, big))
+        consumer.consumeVarExponent(var, word, in);
+      else
+        consumer.consumeVarExponent(var, big, in);
+    }
+    consumer.endTerm();
+  }
+
+  void BinaryIOHandler::doReadIdeal(Scanner& in, InputConsumer& consumer) {
+    VarNames names;
+    B::expectKind(in, B::readHeader(in, names), B::IdealKind);
+    consumer.consumeRing(names);
+
+    consumer.beginIdeal();
+    IdealSink sink(consumer, in);
+    B::readBlocks(in, names.getVarCount(), 0, sink);
+    consumer.endIdeal();
+  }
+
+  void BinaryIOHandler::doReadIdeals(Scanner& in, InputConsumer& consumer) {
+    VarNames names;
+    while (hasMoreInput(in)) {
+      const unsigned char kind = B::readHeader(in, names);
+      if (kind != B::RingKind)
+        B::expectKind(in, kind, B::IdealKind);
+      consumer.consumeRing(names);
+      if (kind == B::RingKind)
+        continue;
+
+      consumer.beginIdeal();
+      IdealSink sink(consumer, in);
+      B::readBlocks(in, names.getVarCount(), 0, sink);
+      consumer.endIdeal();
+    }
+  }
+
+  void BinaryIOHandler::doReadPolynomial(Scanner& in,
+                                         CoefBigTermConsumer& consumer) {
+    VarNames names;
+    B::expectKind(in, B::readHeader(in, names), B::PolynomialKind);
+    consumer.consumeRing(names);
+
+    consumer.beginConsuming();
+    PolySink sink(consumer, names.getVarCount());
+    B::readBlocks(in, names.getVarCount(), &sink.getCoefs(), sink);
+    consumer.doneConsuming();
+  }
+
+  void B::writeVarint(Bytes& out, unsigned long value) {
+    while (value >= 0x80) {
+      out.push_back(static_cast<unsigned char>(value | 0x80));
+      value >>= 7;
+    }
+    out.push_back(static_cast<unsigned char>(value));
+  }
+
+  size_t B::getVarintSize(unsigned long value) {
+    size_t size = 1;
+    while (value >= 0x80) {
+      value >>= 7;
+      ++size;
+    }
+    return size;
+  }
+
+  void B::writeNumber(Bytes& out, const mpz_class& value, bool isSigned) {
+    const size_t shift = isSigned ? 2 : 1;
+    ASSERT(isSigned || value >= 0);
+    unsigned long flags = 0;
+    if (value < 0)
+      flags |= NegativeFlag;
+
+    // mpz_get_ui and mpz_export both use the absolute value.
+    if (mpz_cmpabs_ui(value.get_mpz_t(), BigMarker >> shift) <= 0) {
+      writeVarint(out, (mpz_get_ui(value.get_mpz_t()) << shift) | flags);
+      return;
+    }
+
+    const size_t byteCount = (mpz_sizeinbase(value.get_mpz_t(), 2) + 7) / 8;
+    writeVarint(out, (byteCount << shift) | flags | BigFlag);
+    const size_t pos = out.size();
+    out.resize(pos + byteCount);
+    size_t written;
+    mpz_export(&out[pos], &written, -1, 1, -1, 0, value.get_mpz_t());
+    ASSERT(written == byteCount);
+  }
+
+  void B::writeWord(Bytes& out, unsigned long value) {
+    if (value <= (BigMarker >> 1))
+      writeVarint(out, value << 1);
+    else
+      writeNumber(out, mpz_class(value), false);
+  }
+
+  void B::writeHeader(Bytes& out, unsigned char kind, const VarNames& names) {
+    out.insert(out.end(), Magic, Magic + MagicSize);
+    out.push_back(Version);
+    out.push_back(kind);
+
+    // The names x1, x2 and so on are implied when there are no names.
+    const bool hasNames = !names.namesAreDefault() ||
+      names.getVarCount() > MaxDefaultNameCount;
+    out.push_back(hasNames ? HasNamesFlag : 0);
+    writeVarint(out, names.getVarCount());
+    if (hasNames) {
+      for (size_t var = 0; var < names.getVarCount(); ++var) {
+        const string& name = names.getName(var);
+        writeVarint(out, name.size());
+        out.insert(out.end(), name.begin(), name.end());
+      }
+    }
+  }
+
+  void B::writeBytes(Bytes& out, FILE* file) {
+    if (!out.empty())
+      fwrite(&out[0], 1, out.size(), file);
+    out.clear();
+  }
+
+  unsigned char B::readByte(Scanner& in) {
+    return static_cast<unsigned char>(*in.readBytes(1));
+  }
+
+  unsigned long B::readVarint(Scanner& in) {
+    const size_t bits = numeric_limits<unsigned long>::digits;
+    unsigned long value = 0;
+    for (size_t shift = 0; shift < bits; shift += 7) {
+      const unsigned char byte = readByte(in);
+      const unsigned long part = byte & 0x7F;
+      if ((part << shift) >> shift != part)
+        break;
+      value |= part << shift;
+      if ((byte & 0x80) == 0)
+        return value;
+    }
+    reportSyntaxError(in, "Binary integer too large.");
+    return 0;
+  }
+
+  bool B::readNumber(Scanner& in, unsigned long& word, mpz_class& big) {
+    const unsigned long value = readVarint(in);
+    if ((value & BigFlag) == 0) {
+      word = value >> 1;
+      return true;
+    }
+    readBig(in, value >> 1, big);
+    if (big.fits_ulong_p() && big.get_ui() != BigMarker) {
+      word = big.get_ui();
+      return true;
+    }
+    return false;
+  }
+
+  void B::readSignedNumber(Scanner& in, mpz_class& value) {
+    const unsigned long number = readVarint(in);
+    if ((number & BigFlag) == 0)
+      value = number >> 2;
+    else
+      readBig(in, number >> 2, value);
+    if ((number & NegativeFlag) != 0)
+      value = -value;
+  }
+
+  void B::readBig(Scanner& in, unsigned long byteCount, mpz_class& big) {
+    const char* bytes = in.readBytes(byteCount);
+    mpz_import(big.get_mpz_t(), byteCount, -1, 1, -1, 0, bytes);
+  }
+
+  unsigned char B::readHeader(Scanner& in, VarNames& names) {
+    in.eatWhite();
+    if (memcmp(in.readBytes(MagicSize), Magic, MagicSize) != 0)
+      reportSyntaxError(in, "Expected the start of a binary record.");
+
+    const unsigned char version = readByte(in);
+    if (version != Version) {
+      FrobbyStringStream errorMsg;
+      errorMsg << "Binary format version " << static_cast<unsigned int>(version)
+               << " is not supported. Expected version "
+               << static_cast<unsigned int>(Version) << '.';
+      reportSyntaxError(in, errorMsg);
+    }
+
+    const unsigned char kind = readByte(in);
+    const unsigned char flags = readByte(in);
+    if ((flags & ~HasNamesFlag) != 0)
+      reportSyntaxError(in, "Unknown flags in binary record.");
+
+    const size_t varCount = readVarint(in);
+    if ((flags & HasNamesFlag) == 0) {
+      if (varCount > MaxDefaultNameCount)
+        reportSyntaxError(in, "Too many variables in binary record.");
+      VarNames defaultNames(varCount);
+      names.swap(defaultNames);
+      return kind;
+    }
+
+    names.clear();
+    for (size_t var = 0; var < varCount; ++var) {
+      const size_t size = readVarint(in);
+      if (size == 0)
+        reportSyntaxError(in, "Expected a variable name, but got nothing.");
+      const char* name = in.readBytes(size);
+      names.addVarSyntaxCheckUnique(in, string(name, name + size));
+    }
+    return kind;
+  }
+
+  void B::expectKind(Scanner& in, unsigned char kind, unsigned char expected) {
+    if (kind == expected)
+      return;
+    FrobbyStringStream errorMsg;
+    errorMsg << "Expected a binary record of kind "
+             << static_cast<char>(expected)
+             << ", but got kind " << static_cast<char>(kind) << '.';
+    reportSyntaxError(in, errorMsg);
+  }
+
+  unsigned int B::readColumnWidth(Scanner& in) {
+    const unsigned int width = readByte(in);
+    if (width != 0 && width != 1 && width != 2 && width != 4 && width != 8) {
+      FrobbyStringStream errorMsg;
+      errorMsg << "Invalid column width " << width << " in binary block.";
+      reportSyntaxError(in, errorMsg);
+    }
+    return width;
+  }
+
+  template<class Sink>
+  void B::readBlocks(Scanner& in, size_t varCount,
+                     vector<mpz_class>* coefs, Sink& sink) {
+    unsigned long word;
+    mpz_class big;
+    vector<char> column;
+    while (true) {
+      const size_t termCount = readVarint(in);
+      if (termCount == 0)
+        break;
+      // Terms without variables take up no bytes of the block, so
+      // termCount cannot be checked against the input that remains.
+      if (varCount == 0 && termCount > BlockTermCount)
+        reportSyntaxError(in, "Binary block too large.");
+      const unsigned int width = readColumnWidth(in);
+
+      if (coefs != 0) {
+        // Each coefficient takes at least one byte. termCount comes
+        // from the input, so coefs grows as the coefficients are read
+        // rather than all at once.
+        if (in.hasFewerBytesThan(termCount))
+          reportSyntaxError(in, "Binary block too large.");
+        for (size_t term = 0; term < termCount; ++term) {
+          if (term == coefs->size())
+            coefs->push_back(mpz_class());
+          readSignedNumber(in, (*coefs)[term]);
+        }
+      }
+
+      if (width == 0) {
+        for (size_t term = 0; term < termCount; ++term) {
+          sink.beginTerm(term);
+          for (size_t var = 0; var < varCount; ++var) {
+            if (readNumber(in, word, big))
+              sink.consumeExponent(var, word);
+            else
+              sink.consumeExponent(var, big);
+          }
+          sink.endTerm(term);
+        }
+        continue;
+      }
+
+      if (varCount != 0 &&
+          termCount > numeric_limits<size_t>::max() / varCount / width)
+        reportSyntaxError(in, "Binary block too large.");
+      const size_t size = termCount * varCount * width;
+      const char* data = in.readBytes(size);
+
+      // The value with all bits set marks a big exponent. Those
+      // follow the block, and reading them invalidates data, so data
+      // has to be copied if there are any.
+      const unsigned long long allOnes =
+        numeric_limits<unsigned long long>::max() >> (64 - 8 * width);
+      const unsigned char* it = reinterpret_cast<const unsigned char*>(data);
+      const unsigned char* end = it + size;
+      for (; it != end; it += width)
+        if (*it == 0xFF &&
+            std::count(it, it + width, static_cast<unsigned char>(0xFF)) ==
+            static_cast<ptrdiff_t>(width))
+          break;
+      if (it != end) {
+        column.assign(data, data + size);
+        data = &column[0];
+      }
+
+      it = reinterpret_cast<const unsigned char*>(data);
+      for (size_t term = 0; term < termCount; ++term) {
+        sink.beginTerm(term);
+        for (size_t var = 0; var < varCount; ++var, it += width) {
+          unsigned long long value = 0;
+          for (size_t byte = width; byte > 0; --byte)
+            value = (value << 8) | it[byte - 1];
+          if (value == allOnes) {
+            if (readNumber(in, word, big))
+              sink.consumeExponent(var, word);
+            else
+              sink.consumeExponent(var, big);
+          } else if (value < BigMarker)
+            sink.consumeExponent(var, static_cast<unsigned long>(value));
+          else {
+            mpz_import(big.get_mpz_t(), 1, -1, width, -1, 0, it);
+            sink.consumeExponent(var, big);
+          }
+        }
+        sink.endTerm(term);
+      }
+    }
+  }
+
+  B::BlockWriter::BlockWriter(FILE* out):
+    _out(out),
+    _termCount(0),
+    _bigCount(0) {
+  }
+
+  void B::BlockWriter::writeHeader(unsigned char kind, const VarNames& names) {
+    ASSERT(_termCount == 0);
+    B::writeHeader(_bytes, kind, names);
+  }
+
+  void B::BlockWriter::writeRing(const VarNames& names) {
+    writeHeader(RingKind, names);
+    writeBytes(_bytes, _out);
+  }
+
+  void B::BlockWriter::addCoef(const mpz_class& coef) {
+    ASSERT(_coefs.size() >= _termCount);
+    if (_coefs.size() == _termCount)
+      _coefs.push_back(coef);
+    else
+      _coefs[_termCount] = coef;
+  }
+
+  void B::BlockWriter::addExponent(const mpz_class& exponent) {
+    if (exponent.fits_ulong_p() && exponent.get_ui() != BigMarker) {
+      _exponents.push_back(exponent.get_ui());
+      return;
+    }
+    _exponents.push_back(BigMarker);
+    if (_bigs.size() == _bigCount)
+      _bigs.push_back(exponent);
+    else
+      _bigs[_bigCount] = exponent;
+    ++_bigCount;
+  }
+
+  void B::BlockWriter::endTerm() {
+    ++_termCount;
+    if (_termCount == BlockTermCount)
+      writeBlock();
+  }
+
+  void B::BlockWriter::writeEnd() {
+    writeBlock();
+    writeVarint(_bytes, 0);
+    writeBytes(_bytes, _out);
+  }
+
+  void B::BlockWriter::writeBlock() {
+    if (_termCount == 0)
+      return;
+
+    // Find the smallest fixed width where the all ones value is larger
+    // than every word exponent, and see if varints would be smaller.
+    unsigned long maxWord = 0;
+    size_t varintSize = 0;
+    for (size_t i = 0; i < _exponents.size(); ++i) {
+      const unsigned long e = _exponents[i];
+      if (e == BigMarker)
+        continue;
+      if (maxWord < e)
+        maxWord = e;
+      varintSize += e > (BigMarker >> 1) ? 10 : getVarintSize(e << 1);
+    }
+    unsigned int width = 1;
+    while (width < sizeof(unsigned long) &&
+           maxWord >= (1ul << (8 * width)) - 1)
+      width *= 2;
+    if (varintSize < _exponents.size() * width)
+      width = 0;
+
+    writeVarint(_bytes, _termCount);
+    _bytes.push_back(static_cast<unsigned char>(width));
+    for (size_t term = 0; term < _termCount && !_coefs.empty(); ++term)
+      writeNumber(_bytes, _coefs[term], true);
+
+    size_t big = 0;
+    if (width == 0) {
+      for (size_t i = 0; i < _exponents.size(); ++i) {
+        if (_exponents[i] == BigMarker)
+          writeNumber(_bytes, _bigs[big++], false);
+        else
+          writeWord(_bytes, _exponents[i]);
+      }
+    } else {
+      for (size_t i = 0; i < _exponents.size(); ++i) {
+        unsigned long e = _exponents[i];
+        for (size_t byte = 0; byte < width; ++byte) {
+          _bytes.push_back(static_cast<unsigned char>(e));
+          e >>= 8;
+        }
+      }
+      for (; big < _bigCount; ++big)
+        writeNumber(_bytes, _bigs[big], false);
+    }
+    ASSERT(big == _bigCount);
+    writeBytes(_bytes, _out);
+
+    _exponents.clear();
+    _termCount = 0;
+    _bigCount = 0;
+  }
+}
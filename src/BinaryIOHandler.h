@@ -0,0 +1,87 @@
+/* Frobby: Software for monomial ideal computations.
+   Copyright (C) 2007 Bjarke Hammersholt Roune (www.broune.com)
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see http://www.gnu.org/licenses/.
+*/
+#ifndef BINARY_IO_HANDLER_GUARD
+#define BINARY_IO_HANDLER_GUARD
+
+#include "IOHandlerImpl.h"
+
+class Scanner;
+class VarNames;
+class BigTermConsumer;
+class CoefBigTermConsumer;
+
+namespace IO {
+  /** A binary format for passing ideals and polynomials between
+   programs without formatting and parsing decimal text. All integers
+   are little-endian. A varint is an unsigned integer written 7 bits
+   at a time starting with the least significant bits, where the high
+   bit of each byte is set if more bytes follow.
+
+   The input is a sequence of records, each of which starts with
+
+   - the 4 bytes 0x7F 'F' 'R' 'B',
+   - a version byte, which is currently 1,
+   - a kind byte: 'I' for an ideal, 'P' for a polynomial, 'R' for a
+     ring without an ideal and 'T' for a single term,
+   - a flags byte where bit 0 is set if variable names follow,
+   - the number of variables as a varint and
+   - if there are names, each name as a varint length followed by
+     that many bytes. Otherwise the names are the default names.
+
+   The generators of an ideal or the terms of a polynomial follow in
+   blocks, and a block with zero terms ends the record. Each block is
+
+   - the number of terms as a varint,
+   - the column width as a byte, which is 0 for varint exponents and
+     otherwise 1, 2, 4 or 8 bytes per exponent,
+   - for a polynomial, the coefficient of each term as a signed number,
+   - the exponents, term by term, in the column width and then
+   - for fixed width columns, the big exponents in order as numbers.
+
+   A number is a varint where bit 0 is set if the value is a big
+   integer and, for signed numbers, bit 1 is set if the value is
+   negative. The remaining bits are the absolute value, or for a big
+   integer the number of bytes in its absolute value, which then
+   follow. In a fixed width column the value with all bits set
+   indicates a big exponent. Fixed width blocks can be read in place
+   from a mapped file.
+
+   A term record has the exponents as numbers directly after the
+   number of variables. Whitespace between records is ignored, so
+   records can be concatenated. */
+  class BinaryIOHandler : public IOHandlerImpl {
+  public:
+    BinaryIOHandler();
+
+    static const char* staticGetName();
+
+  private:
+    virtual BigTermConsumer* doCreateIdealWriter(FILE* out, size_t threadCount);
+    virtual CoefBigTermConsumer* doCreatePolynomialWriter(FILE* out,
+                                                          size_t threadCount);
+
+    virtual void doWriteTerm(const vector<mpz_class>& term,
+                             const VarNames& names,
+                             FILE* out);
+    virtual void doReadTerm(Scanner& in, InputConsumer& consumer);
+    virtual void doReadIdeal(Scanner& in, InputConsumer& consumer);
+    virtual void doReadIdeals(Scanner& in, InputConsumer& consumer);
+    virtual void doReadPolynomial(Scanner& in, CoefBigTermConsumer& consumer);
+  };
+}
+
+#endif
@@ -18,6 +18,25 @@
 #include "CanonicalCoefTermConsumer.h"
 
 #include "Term.h"
+#include "Polynomial.h"
+
+namespace {
+  /** Adds the terms it consumes to a polynomial. */
+  class PolynomialAdder : public CoefTermConsumer {
+  public:
+    PolynomialAdder(Polynomial& polynomial): _polynomial(polynomial) {}
+
+    virtual void consumeRing(const VarNames& names) {}
+    virtual void beginConsuming() {}
+    virtual void consume(const mpz_class& coef, const Term& term) {
+      _polynomial.add(coef, term);
+    }
+    virtual void doneConsuming() {}
+
+  private:
+    Polynomial& _polynomial;
+  };
+}
 
 CanonicalCoefTermConsumer::
 CanonicalCoefTermConsumer(unique_ptr<CoefTermConsumer> consumer):
@@ -40,13 +59,22 @@ void CanonicalCoefTermConsumer::consume
   _polynomial.add(coef, term);
 }
 
+void CanonicalCoefTermConsumer::consume(long coef, const Term& term) {
+  ASSERT(term.getVarCount() == _polynomial.getVarCount());
+
+  _polynomial.add(coef, term);
+}
+
 void CanonicalCoefTermConsumer::doneConsuming() {
-  _polynomial.sortTermsReverseLex();
+  Polynomial sorted(_polynomial.getVarCount());
+  PolynomialAdder adder(sorted);
+  _polynomial.feedTermsTo(adder);
+  _polynomial.clearAndSetVarCount(_polynomial.getVarCount());
+  sorted.sortTermsReverseLex();
 
   _consumer->consumeRing(_names);
   _consumer->beginConsuming();
-  for (size_t index = 0; index < _polynomial.getTermCount(); ++index)
-    _consumer->consume(_polynomial.getCoef(index), _polynomial.getTerm(index));
+  for (size_t index = 0; index < sorted.getTermCount(); ++index)
+    _consumer->consume(sorted.getCoef(index), sorted.getTerm(index));
   _consumer->doneConsuming();
-  _polynomial.clear();
 }
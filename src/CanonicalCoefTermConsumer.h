@@ -18,7 +18,7 @@
 #define CANONICAL_COEF_TERM_CONSUMER_GUARD
 
 #include "CoefTermConsumer.h"
-#include "Polynomial.h"
+#include "HashPolynomial.h"
 #include "VarNames.h"
 
 class Term;
@@ -33,11 +33,15 @@ class CanonicalCoefTermConsumer : public CoefTermConsumer {
 
   virtual void beginConsuming();
   virtual void consume(const mpz_class& coef, const Term& term);
+  virtual void consume(long coef, const Term& term);
   virtual void doneConsuming();
 
  private:
   unique_ptr<CoefTermConsumer> _consumer;
-  Polynomial _polynomial;
+
+  /** Like terms are added together as they are consumed, so that
+   only the distinct terms have to be sorted. */
+  HashPolynomial _polynomial;
   VarNames _names;
 };
 
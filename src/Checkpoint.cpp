@@ -0,0 +1,197 @@
+/* Frobby: Software for monomial ideal computations.
+   Copyright (C) 2007 Bjarke Hammersholt Roune (www.broune.com)
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see http://www.gnu.org/licenses/.
+*/
+#include "stdinc.h"
+#include "Checkpoint.h"
+
+#include "error.h"
+
+#include <algorithm>
+#include <cstring>
+#include <unistd.h>
+
+namespace {
+  const char* const Header = "frobby checkpoint 1\n";
+
+  /** A result of the unit that is running. */
+  const char ResultRecord = 'R';
+
+  /** A unit is done. */
+  const char DoneRecord = 'D';
+
+  void appendSize(string& out, size_t size) {
+    out.append(reinterpret_cast<const char*>(&size), sizeof(size));
+  }
+
+  void appendString(string& out, const char* data, size_t size) {
+    appendSize(out, size);
+    out.append(data, size);
+  }
+
+  bool readSize(FILE* in, size_t& size) {
+    return fread(&size, sizeof(size), 1, in) == 1;
+  }
+
+  /** Reads a string that appendString() wrote. Returns false if the
+   file ends before the string does. */
+  bool readString(FILE* in, string& str) {
+    size_t size;
+    if (!readSize(in, size))
+      return false;
+    str.clear();
+    char buffer[4096];
+    while (size > 0) {
+      const size_t toRead = std::min(size, sizeof(buffer));
+      if (fread(buffer, 1, toRead, in) != toRead)
+        return false;
+      str.append(buffer, toRead);
+      size -= toRead;
+    }
+    return true;
+  }
+}
+
+Checkpoint::Checkpoint(const string& path, size_t intervalSeconds):
+  _path(path),
+  _interval(intervalSeconds),
+  _file(0) {
+}
+
+Checkpoint::~Checkpoint() {
+  if (_file != 0)
+    fclose(_file);
+}
+
+void Checkpoint::create(const string& key, const vector<string>& units) {
+  ASSERT(_file == 0);
+
+  _pending = Header;
+  appendString(_pending, key.data(), key.size());
+  appendSize(_pending, units.size());
+  for (size_t unit = 0; unit < units.size(); ++unit)
+    appendString(_pending, units[unit].data(), units[unit].size());
+
+  // The new checkpoint is written to another file first, so that the
+  // file holds a complete checkpoint at all times.
+  const string newPath = _path + ".new";
+  _file = fopen(newPath.c_str(), "wb");
+  if (_file == 0)
+    reportError("Could not create checkpoint file \"" + newPath + "\".");
+  write();
+  if (rename(newPath.c_str(), _path.c_str()) != 0)
+    reportError("Could not rename \"" + newPath +
+                "\" to checkpoint file \"" + _path + "\".");
+}
+
+void Checkpoint::resume(const string& key,
+                        const vector<string>& units,
+                        vector<bool>& isDone,
+                        const ResultConsumer& consumeResult) {
+  ASSERT(_file == 0);
+
+  _file = fopen(_path.c_str(), "r+b");
+  if (_file == 0)
+    reportError("Could not open checkpoint file \"" + _path +
+                "\" to resume from.");
+
+  const size_t headerSize = strlen(Header);
+  string header(headerSize, ' ');
+  if (fread(&header[0], 1, headerSize, _file) != headerSize ||
+      header != Header)
+    reportNotCheckpoint();
+
+  string str;
+  size_t unitCount;
+  if (!readString(_file, str) || !readSize(_file, unitCount))
+    reportNotCheckpoint();
+  if (str != key || unitCount != units.size())
+    reportError("The checkpoint file \"" + _path + "\" is for a "
+                "different computation or input.");
+  for (size_t unit = 0; unit < unitCount; ++unit) {
+    if (!readString(_file, str))
+      reportNotCheckpoint();
+    if (str != units[unit])
+      reportError("The checkpoint file \"" + _path + "\" is for a "
+                  "different computation or input.");
+  }
+
+  // The results of a unit are only passed on once the record that
+  // the unit is done has been read. The file ends after the last such
+  // record unless it was interrupted while being written.
+  isDone.assign(unitCount, false);
+  vector<string> results;
+  long end = ftell(_file);
+  char record;
+  while (fread(&record, 1, 1, _file) == 1) {
+    if (record == ResultRecord) {
+      results.push_back(string());
+      if (!readString(_file, results.back()))
+        break;
+    } else if (record == DoneRecord) {
+      size_t unit;
+      if (!readSize(_file, unit) || unit >= unitCount)
+        break;
+      for (size_t result = 0; result < results.size(); ++result)
+        consumeResult(results[result].data(), results[result].size());
+      results.clear();
+      isDone[unit] = true;
+      end = ftell(_file);
+    } else
+      break;
+  }
+
+  // Drop what is after the last done record, so that further records
+  // are appended right after it.
+  if (end < 0 ||
+      fseek(_file, end, SEEK_SET) != 0 ||
+      ftruncate(fileno(_file), end) != 0)
+    reportError("Could not continue checkpoint file \"" + _path + "\".");
+  _lastWrite = std::chrono::steady_clock::now();
+}
+
+void Checkpoint::addResult(const char* result, size_t size) {
+  _pending += ResultRecord;
+  appendString(_pending, result, size);
+}
+
+void Checkpoint::unitDone(size_t unit) {
+  _pending += DoneRecord;
+  appendSize(_pending, unit);
+  if (std::chrono::steady_clock::now() - _lastWrite >= _interval)
+    write();
+}
+
+void Checkpoint::remove() {
+  if (_file != 0) {
+    fclose(_file);
+    _file = 0;
+  }
+  std::remove(_path.c_str());
+}
+
+void Checkpoint::write() {
+  ASSERT(_file != 0);
+  if (fwrite(_pending.data(), 1, _pending.size(), _file) != _pending.size() ||
+      fflush(_file) != 0 ||
+      fsync(fileno(_file)) != 0)
+    reportError("Could not write checkpoint file \"" + _path + "\".");
+  _pending.clear();
+  _lastWrite = std::chrono::steady_clock::now();
+}
+
+void Checkpoint::reportNotCheckpoint() {
+  reportError("The file \"" + _path + "\" is not a complete checkpoint.");
+}
@@ -0,0 +1,103 @@
+/* Frobby: Software for monomial ideal computations.
+   Copyright (C) 2007 Bjarke Hammersholt Roune (www.broune.com)
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see http://www.gnu.org/licenses/.
+*/
+#ifndef CHECKPOINT_GUARD
+#define CHECKPOINT_GUARD
+
+#include <vector>
+#include <string>
+#include <functional>
+#include <chrono>
+#include <cstdio>
+
+/** Records the progress of a computation that is split into work
+ units in a file, so that the computation can be resumed from the
+ file if it is interrupted. This is the implementation of the
+ -checkpoint and -resume options.
+
+ The file starts with a key that identifies the computation and the
+ units of the computation. After that, the results of each unit are
+ appended to the file once the unit is done, followed by a record
+ that the unit is done. Results and units are strings of bytes whose
+ meaning is up to the caller.
+
+ Appending to the file is deferred until the interval has passed since
+ the last time, so the cost of writing checkpoints is bounded by the
+ interval regardless of how quickly the units are done. An
+ interruption loses at most the units that were done since the last
+ write and the units that were running. A unit whose done record was
+ not written completely is run again on resume. */
+class Checkpoint {
+ public:
+  /** Checkpoints are written to path at most once every
+   intervalSeconds seconds. */
+  Checkpoint(const string& path, size_t intervalSeconds);
+
+  /** Closes the file without writing anything that is pending. */
+  ~Checkpoint();
+
+  typedef std::function<void(const char* result, size_t size)>
+    ResultConsumer;
+
+  /** Starts a checkpoint for the computation identified by key that
+   has the given units. The file is replaced once the start of the
+   new checkpoint has been written. */
+  void create(const string& key, const vector<string>& units);
+
+  /** Continues the checkpoint in the file. Reports an error if the
+   file is not a checkpoint of the computation identified by key with
+   the given units. Calls consumeResult on each result of the units
+   that are done according to the file and sets isDone to indicate
+   which units those are. */
+  void resume(const string& key,
+              const vector<string>& units,
+              vector<bool>& isDone,
+              const ResultConsumer& consumeResult);
+
+  /** Records result as a result of the unit that is running. This is
+   not safe to call from several threads at once. */
+  void addResult(const char* result, size_t size);
+
+  /** Records that unit is done, and that the results recorded since
+   the last unit was done are its results. Writes what has been
+   recorded to the file if the interval has passed. */
+  void unitDone(size_t unit);
+
+  /** Removes the file. Call this once the computation is done. */
+  void remove();
+
+ private:
+  /** Appends what has been recorded to the file and waits for it to
+   reach the disk. */
+  void write();
+
+  void reportNotCheckpoint();
+
+  const string _path;
+  const std::chrono::seconds _interval;
+
+  FILE* _file;
+
+  /** Records that have not been written yet. */
+  string _pending;
+
+  std::chrono::steady_clock::time_point _lastWrite;
+
+  Checkpoint(const Checkpoint&); // not available
+  Checkpoint& operator=(const Checkpoint&); // not available
+};
+
+#endif
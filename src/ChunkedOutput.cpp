@@ -0,0 +1,166 @@
+/* Frobby: Software for monomial ideal computations.
+   Copyright (C) 2007 Bjarke Hammersholt Roune (www.broune.com)
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see http://www.gnu.org/licenses/.
+*/
+#include "stdinc.h"
+#include "ChunkedOutput.h"
+
+#include "TaskEngine.h"
+#include "Task.h"
+#include "MemoryFile.h"
+#include "error.h"
+
+#include <cstdlib>
+#include <algorithm>
+
+namespace IO {
+  namespace {
+    /** The number of chunks per thread that are formatted before
+     they are written. This bounds the memory used for formatted
+     output while leaving enough chunks to balance the threads. */
+    const size_t ChunksPerThreadPerRound = 4;
+  }
+
+  struct ChunkedOutput::Chunk {
+    Chunk(): data(0), size(0) {}
+    ~Chunk() {
+      free(data);
+    }
+
+    char* data;
+    size_t size;
+
+  private:
+    Chunk(const Chunk&); // not available
+    Chunk& operator=(const Chunk&); // not available
+  };
+
+  class ChunkedOutput::ChunkTask : public Task {
+  public:
+    ChunkTask(ChunkedOutput& output,
+              const std::function<void(size_t chunk)>& formatChunk,
+              size_t chunk,
+              Chunk& result):
+      _output(output),
+      _formatChunk(formatChunk),
+      _chunk(chunk),
+      _result(result) {
+    }
+
+    virtual void run(TaskEngine& engine) {
+      MemoryOutput output;
+      FILE*& workerFile = _output._workerFiles[engine.getCurrentWorker()];
+      workerFile = output.getFile();
+      try {
+        _formatChunk(_chunk);
+      } catch (...) {
+        workerFile = 0;
+        throw;
+      }
+      workerFile = 0;
+
+      output.close();
+      _result.size = output.getSize();
+      _result.data = output.releaseData();
+    }
+
+    virtual void dispose() {
+    }
+
+  private:
+    ChunkedOutput& _output;
+    const std::function<void(size_t chunk)>& _formatChunk;
+    const size_t _chunk;
+    Chunk& _result;
+  };
+
+  ChunkedOutput::ChunkedOutput(FILE* out, size_t threadCount, bool chunked):
+    _out(out),
+    _threadCount(threadCount == 0 ? 1 : threadCount),
+    _chunked(chunked),
+    _tasks(0) {
+  }
+
+  size_t ChunkedOutput::getChunksPerRound() const {
+    return ChunksPerThreadPerRound * _threadCount;
+  }
+
+  FILE* ChunkedOutput::getChunkFile() const {
+    ASSERT(_tasks != 0);
+    FILE* file = _workerFiles[_tasks->getCurrentWorker()];
+    ASSERT(file != 0);
+    return file;
+  }
+
+  void ChunkedOutput::write
+  (size_t chunkCount, const std::function<void(size_t chunk)>& formatChunk) {
+    ASSERT(_tasks == 0);
+    if (!_chunked) {
+      for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+        formatChunk(chunk);
+      return;
+    }
+
+    const size_t roundSize = getChunksPerRound();
+    for (size_t begin = 0; begin < chunkCount; begin += roundSize)
+      writeRound(begin, std::min(chunkCount, begin + roundSize), formatChunk);
+  }
+
+  void ChunkedOutput::writeRound
+  (size_t begin, size_t end,
+   const std::function<void(size_t chunk)>& formatChunk) {
+    ASSERT(begin < end);
+    if (end - begin == 1) {
+      // Starting threads costs more than formatting a single chunk,
+      // and output such as a list of irreducible ideals can consist
+      // of very many single-chunk writes.
+      formatChunk(begin);
+      return;
+    }
+
+    vector<Chunk> chunks(end - begin);
+    vector<ChunkTask> tasks;
+    tasks.reserve(end - begin);
+    for (size_t chunk = begin; chunk < end; ++chunk)
+      tasks.push_back(ChunkTask(*this, formatChunk, chunk,
+                                chunks[chunk - begin]));
+
+    {
+      // The engine is destroyed before the tasks so that it does not
+      // refer to them after they are gone if there is an exception.
+      TaskEngine engine;
+      engine.setThreadCount(std::min(_threadCount, end - begin));
+      _workerFiles.assign(engine.getThreadCount(), 0);
+
+      // Add the tasks in reverse since pending tasks are run in
+      // last-in-first-out order.
+      for (size_t i = tasks.size(); i > 0; --i)
+        engine.addTask(&tasks[i - 1]);
+
+      _tasks = &engine;
+      try {
+        engine.runTasks();
+      } catch (...) {
+        _tasks = 0;
+        throw;
+      }
+      _tasks = 0;
+    }
+
+    for (size_t i = 0; i < chunks.size(); ++i)
+      if (fwrite(chunks[i].data, 1, chunks[i].size, _out) != chunks[i].size)
+        reportError("Could not write output.");
+  }
+}
@@ -0,0 +1,96 @@
+/* Frobby: Software for monomial ideal computations.
+   Copyright (C) 2007 Bjarke Hammersholt Roune (www.broune.com)
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see http://www.gnu.org/licenses/.
+*/
+#ifndef CHUNKED_OUTPUT_GUARD
+#define CHUNKED_OUTPUT_GUARD
+
+#include <vector>
+#include <functional>
+
+class TaskEngine;
+
+namespace IO {
+  /** Formats output in chunks on a number of threads. Each chunk is
+   formatted into memory and then written to the output file with a
+   single fwrite, in the order of the chunks, so the output is the
+   same as if the chunks had been formatted one after the other
+   directly to the output file. This is also done on a single thread,
+   where it replaces many small writes by a few large ones.
+
+   Code that formats output writes to the file returned by
+   getFile(). That is the output file except while write() is running,
+   in which case it is the in-memory file of the chunk that the
+   calling thread is formatting. */
+  class ChunkedOutput {
+  public:
+    /** If chunked is false, then write() formats each chunk directly
+     to the output file on the calling thread. That is for writers
+     that buffer their output themselves. */
+    ChunkedOutput(FILE* out, size_t threadCount, bool chunked = true);
+
+    /** The number of terms that a writer formats in each chunk. */
+    static const size_t TermsPerChunk = 4096;
+
+    /** Returns the number of chunks that write() keeps in memory at
+     the same time. A writer that buffers terms before writing them
+     should buffer enough terms for this many chunks. */
+    size_t getChunksPerRound() const;
+
+    /** Returns true if write() formats chunks on more than one
+     thread. */
+    bool isParallel() const {return _threadCount > 1;}
+
+    /** Returns true if write() formats chunks into memory. A writer
+     only needs to buffer terms for write() if this is true. */
+    bool isChunked() const {return _chunked;}
+
+    FILE* getFile() const {
+      return _tasks != 0 ? getChunkFile() : _out;
+    }
+
+    /** Calls formatChunk(chunk) for each chunk in [0, chunkCount) and
+     writes what each call writes to getFile() to the output file in
+     order of chunk. The calls run on up to the thread count many
+     threads at the same time. Only a bounded number of chunks is kept
+     in memory at any one time. */
+    void write(size_t chunkCount,
+               const std::function<void(size_t chunk)>& formatChunk);
+
+  private:
+    class ChunkTask;
+    struct Chunk;
+
+    FILE* getChunkFile() const;
+
+    /** Formats and writes the chunks in [begin, end) at the same
+     time. */
+    void writeRound(size_t begin, size_t end,
+                    const std::function<void(size_t chunk)>& formatChunk);
+
+    FILE* const _out;
+    const size_t _threadCount;
+    const bool _chunked;
+
+    /** The engine that is running the chunks while write() is
+     running. Null otherwise. */
+    TaskEngine* _tasks;
+
+    /** The file that each worker of _tasks is formatting a chunk to. */
+    std::vector<FILE*> _workerFiles;
+  };
+}
+
+#endif
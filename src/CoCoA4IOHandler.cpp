@@ -52,7 +52,8 @@ namespace IO {
 
   class CoCoA4IdealWriter : public IdealWriter {
   public:
-    CoCoA4IdealWriter(FILE* out): IdealWriter(out) {
+    CoCoA4IdealWriter(FILE* out, size_t threadCount):
+      IdealWriter(out, threadCount) {
     }
 
   private:
@@ -85,7 +86,8 @@ namespace IO {
 
   class CoCoA4PolyWriter : public PolyWriter {
   public:
-    CoCoA4PolyWriter(FILE* out): PolyWriter(out) {
+    CoCoA4PolyWriter(FILE* out, size_t threadCount):
+      PolyWriter(out, threadCount) {
     }
 
     virtual void doWriteHeader() {
@@ -161,12 +163,14 @@ namespace IO {
     return "cocoa4";
   }
 
-  BigTermConsumer* CoCoA4IOHandler::doCreateIdealWriter(FILE* out) {
-    return new CoCoA4IdealWriter(out);
+  BigTermConsumer* CoCoA4IOHandler::
+  doCreateIdealWriter(FILE* out, size_t threadCount) {
+    return new CoCoA4IdealWriter(out, threadCount);
   }
 
-  CoefBigTermConsumer* CoCoA4IOHandler::doCreatePolynomialWriter(FILE* out) {
-    return new CoCoA4PolyWriter(out);
+  CoefBigTermConsumer* CoCoA4IOHandler::
+  doCreatePolynomialWriter(FILE* out, size_t threadCount) {
+    return new CoCoA4PolyWriter(out, threadCount);
   }
 
   void CoCoA4IOHandler::doWriteTerm(const vector<mpz_class>& term,
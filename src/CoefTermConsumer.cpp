@@ -22,6 +22,10 @@
 CoefTermConsumer::~CoefTermConsumer() {
 }
 
+void CoefTermConsumer::consume(long coef, const Term& term) {
+  consume(mpz_class(coef), term);
+}
+
 void CoefTermConsumer::consume(const Polynomial& poly) {
   beginConsuming();
   for (size_t index = 0; index < poly.getTermCount(); ++index)
@@ -31,6 +31,14 @@ class CoefTermConsumer {
 
   virtual void beginConsuming() = 0;
   virtual void consume(const mpz_class& coef, const Term& term) = 0;
+
+  /** Consumes coef*term. Almost all coefficients that are output by
+   Hilbert-Poincare series computations fit in a long, so those are
+   output through this method to avoid GMP. The default implementation
+   converts coef to an mpz_class and passes it to the other consume
+   method. Override it to handle small coefficients without GMP. */
+  virtual void consume(long coef, const Term& term);
+
   virtual void doneConsuming() = 0;
 };
 
@@ -21,6 +21,7 @@
 #include "CliParams.h"
 #include "IOHandler.h"
 #include "BoolParameter.h"
+#include "StringParameter.h"
 
 CommonParams::CommonParams():
   _idealIsMinimal(false),
@@ -28,8 +29,11 @@ CommonParams::CommonParams():
   _produceCanonicalOutput(false),
   _printDebug(false),
   _printStatistics(false),
+  _threadCount(1),
   _inputFormat(getFormatNameIndicatingToGuessTheInputFormat()),
-  _outputFormat(getFormatNameIndicatingToUseInputFormatAsOutputFormat()) {
+  _outputFormat(getFormatNameIndicatingToUseInputFormatAsOutputFormat()),
+  _inputFile(stdin),
+  _outputFile(stdout) {
 }
 
 namespace {
@@ -40,6 +44,8 @@ namespace {
   static const char* OutputFormatParamName = "oformat";
   static const char* PrintDebugName = "debug";
   static const char* PrintStatisticsName = "stats";
+  static const char* ThreadCountName = "threads";
+  static const char* ResultCacheName = "cache";
 }
 
 void addDebugParam(CliParams& params) {
@@ -52,6 +58,26 @@ void addDebugParam(CliParams& params) {
        false)));
 }
 
+void addResultCacheParam(CliParams& params) {
+  ASSERT(!params.hasParam(ResultCacheName));
+  params.add
+    (unique_ptr<Parameter>
+     (new StringParameter
+      (ResultCacheName,
+       "Store results in the given directory and look them up there before\n"
+       "computing them. A result is found again if the same computation is\n"
+       "done on an ideal with the same minimal generators and variables.\n"
+       "The empty string turns the cache off.",
+       "")));
+}
+
+string getResultCacheDir(const CliParams& params) {
+  if (params.hasParam(ResultCacheName))
+    return getString(params, ResultCacheName);
+  else
+    return "";
+}
+
 void addCommonParams(CliParams& params) {
   addDebugParam(params);
 }
@@ -69,4 +95,7 @@ void extractCliValues(CommonParams& common, const CliParams& cli) {
     common.printDebug(getBool(cli, PrintDebugName));
   if (cli.hasParam(PrintStatisticsName))
     common.printStatistics(getBool(cli, PrintStatisticsName));
+  if (cli.hasParam(ThreadCountName))
+    common.setThreadCount(getInt(cli, ThreadCountName));
+  common.setResultCacheDir(getResultCacheDir(cli));
 }
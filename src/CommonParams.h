@@ -51,6 +51,16 @@ class CommonParams {
   const string& getOutputFormat() const {return _outputFormat;}
   void setOutputFormat(const string& value) {_outputFormat = value;}
 
+  /** Returns the file that input is read from. This is stdin by
+      default. */
+  FILE* getInputFile() const {return _inputFile;}
+  void setInputFile(FILE* file) {_inputFile = file;}
+
+  /** Returns the file that output is written to. This is stdout by
+      default. */
+  FILE* getOutputFile() const {return _outputFile;}
+  void setOutputFile(FILE* file) {_outputFile = file;}
+
   /** Returns whether to produce output in a canonical
       representation. */
   bool getProduceCanonicalOutput() const {return _produceCanonicalOutput;}
@@ -66,19 +76,39 @@ class CommonParams {
   bool getPrintStatistics() const {return _printStatistics;}
   void printStatistics(bool value) {_printStatistics = value;}
 
+  /** The number of threads to run the algorithm and the formatting
+      of output on. This is 1 by default. */
+  size_t getThreadCount() const {return _threadCount;}
+  void setThreadCount(size_t value) {_threadCount = value;}
+
+  /** Returns the directory that results are cached in. Results are
+      not cached if this is empty, which it is by default. */
+  const string& getResultCacheDir() const {return _resultCacheDir;}
+  void setResultCacheDir(const string& value) {_resultCacheDir = value;}
+
  private:
   bool _idealIsMinimal;
   bool _printActions;
   bool _produceCanonicalOutput;
   bool _printDebug;
   bool _printStatistics;
+  size_t _threadCount;
 
   string _inputFormat;
   string _outputFormat;
+  string _resultCacheDir;
+
+  FILE* _inputFile;
+  FILE* _outputFile;
 };
 
 void addCommonParams(CliParams& params);
 void addDebugParam(CliParams& params);
+void addResultCacheParam(CliParams& params);
+
+/** Returns the value of the parameter added by addResultCacheParam,
+    or the empty string if there is no such parameter. */
+string getResultCacheDir(const CliParams& params);
 
 void extractCliValues(CommonParams& common, const CliParams& cli);
 
@@ -21,6 +21,7 @@
 #include "CommonParams.h"
 #include "IOFacade.h"
 #include "BigIdeal.h"
+#include "CompactBigIdeal.h"
 #include "Ideal.h"
 #include "TermTranslator.h"
 #include "VarSorter.h"
@@ -39,11 +40,13 @@
 #include "CanonicalTermConsumer.h"
 #include "CanonicalCoefTermConsumer.h"
 #include "TotalDegreeCoefTermConsumer.h"
+#include "ResultCache.h"
 
 CommonParamsHelper::CommonParamsHelper():
   _idealConsumer(0),
   _polyConsumer(0),
-  _produceCanonicalOutput(false) {
+  _produceCanonicalOutput(false),
+  _recording(false) {
 }
 
 CommonParamsHelper::~CommonParamsHelper() {
@@ -55,17 +58,20 @@ void CommonParamsHelper::readIdealAndSetOutput(const CommonParams& params,
                                                const DataType& output) {
   _produceCanonicalOutput = params.getProduceCanonicalOutput();
 
-  Scanner in(params.getInputFormat(), stdin);
+  Scanner in(params.getInputFormat(), params.getInputFile());
   unique_ptr<IOHandler> outputHandler =
     createOHandler(in.getFormat(), params.getOutputFormat());
   if (output == DataType::getPolynomialType()) {
-    _polyConsumerDeleter = outputHandler->createPolynomialWriter(stdout);
+    _polyConsumerDeleter = outputHandler->createPolynomialWriter
+    (params.getOutputFile(), params.getThreadCount());
     _polyConsumer = _polyConsumerDeleter.get();
   } else if (output == DataType::getMonomialIdealType()) {
-    _idealConsumerDeleter = outputHandler->createIdealWriter(stdout);
+    _idealConsumerDeleter = outputHandler->createIdealWriter
+    (params.getOutputFile(), params.getThreadCount());
     _idealConsumer = _idealConsumerDeleter.get();
   } else if (output == DataType::getMonomialIdealListType()) {
-    _idealConsumerDeleter = outputHandler->createIdealListWriter(stdout);
+    _idealConsumerDeleter = outputHandler->createIdealListWriter
+    (params.getOutputFile(), params.getThreadCount());
     _idealConsumer = _idealConsumerDeleter.get();
   } else if (output == DataType::getNullType()) {
     _idealConsumerDeleter.reset(new NullTermConsumer());
@@ -85,10 +91,11 @@ void CommonParamsHelper::readIdealAndSetOutput(const CommonParams& params,
 void CommonParamsHelper::readIdealAndSetPolyOutput(const CommonParams& params) {
   _produceCanonicalOutput = params.getProduceCanonicalOutput();
 
-  Scanner in(params.getInputFormat(), stdin);
+  Scanner in(params.getInputFormat(), params.getInputFile());
   unique_ptr<IOHandler> outputHandler =
     createOHandler(in.getFormat(), params.getOutputFormat());
-  _polyConsumerDeleter = outputHandler->createPolynomialWriter(stdout);
+  _polyConsumerDeleter = outputHandler->createPolynomialWriter
+    (params.getOutputFile(), params.getThreadCount());
   _polyConsumer = _polyConsumerDeleter.get();
 
   readIdeal(params, in);
@@ -98,10 +105,11 @@ void CommonParamsHelper::readIdealAndSetIdealOutput
 (const CommonParams& params) {
   _produceCanonicalOutput = params.getProduceCanonicalOutput();
 
-  Scanner in(params.getInputFormat(), stdin);
+  Scanner in(params.getInputFormat(), params.getInputFile());
   unique_ptr<IOHandler> outputHandler =
     createOHandler(in.getFormat(), params.getOutputFormat());
-  _idealConsumerDeleter = outputHandler->createIdealWriter(stdout);
+  _idealConsumerDeleter = outputHandler->createIdealWriter
+    (params.getOutputFile(), params.getThreadCount());
   _idealConsumer = _idealConsumerDeleter.get();
 
   readIdeal(params, in);
@@ -165,12 +173,80 @@ void CommonParamsHelper::addPurePowersAtInfinity() {
   _translator->addPurePowersAtInfinity(*_ideal);
 }
 
+bool CommonParamsHelper::lookupCachedIdeal(const string& computation,
+                                           bool outputIsList) {
+  ASSERT(_idealConsumer != 0);
+  if (!setCacheKey(computation, true))
+    return false;
+  if (_cache->lookup(*_idealConsumer, outputIsList))
+    return true;
+
+  _idealRecorder = _cache->makeRecorder(*_idealConsumer);
+  _idealConsumer = _idealRecorder.get();
+  _recording = true;
+  return false;
+}
+
+bool CommonParamsHelper::lookupCachedPolynomial(const string& computation) {
+  ASSERT(_polyConsumer != 0);
+  if (!setCacheKey(computation, true))
+    return false;
+  if (_cache->lookup(*_polyConsumer))
+    return true;
+
+  _polyRecorder = _cache->makeRecorder(*_polyConsumer);
+  _polyConsumer = _polyRecorder.get();
+  _recording = true;
+  return false;
+}
+
+bool CommonParamsHelper::lookupCachedNumber(const string& computation,
+                                            mpz_class& value) {
+  if (!setCacheKey(computation, false))
+    return false;
+  return _cache->lookup(value);
+}
+
+void CommonParamsHelper::storeCachedResult() {
+  if (_recording) {
+    _recording = false;
+    _cache->store();
+  }
+}
+
+void CommonParamsHelper::storeCachedNumber(const mpz_class& value) {
+  if (_cache.get() != 0 && _cache->isOn())
+    _cache->store(value);
+}
+
+bool CommonParamsHelper::setCacheKey(const string& computation,
+                                     bool canonicalMatters) {
+  ASSERT(!_recording);
+  if (_cache.get() == 0 || !_cache->isOn())
+    return false;
+
+  // Canonical output has a different order than the same output
+  // that is not canonical.
+  if (canonicalMatters && _produceCanonicalOutput)
+    _cache->setKey(computation + " canonical", getIdeal(), getTranslator());
+  else
+    _cache->setKey(computation, getIdeal(), getTranslator());
+  return true;
+}
+
 void CommonParamsHelper::readIdeal(const CommonParams& params, Scanner& in) {
-  BigIdeal bigIdeal;
+  CompactBigIdeal compactIdeal;
   IOFacade facade(params.getPrintActions());
-  facade.readIdeal(in, bigIdeal);
+  facade.readIdeal(in, compactIdeal);
   in.expectEOF();
-  setIdeal(params, bigIdeal);
+
+  ActionPrinter printer(params.getPrintActions());
+  printer.beginAction("Translating ideal to internal data structure.");
+  _ideal.reset(new Ideal());
+  _translator.reset(new TermTranslator(compactIdeal, *_ideal));
+  printer.endAction();
+
+  prepareIdeal(params);
 }
 
 void CommonParamsHelper::setIdeal(const CommonParams& params,
@@ -182,6 +258,16 @@ void CommonParamsHelper::setIdeal(const CommonParams& params,
   _translator.reset(new TermTranslator(bigIdeal, *_ideal, false));
   printer.endAction();
 
+  prepareIdeal(params);
+}
+
+void CommonParamsHelper::prepareIdeal(const CommonParams& params) {
+  ActionPrinter printer(params.getPrintActions());
+
+  _cache.reset(new ResultCache(params.getResultCacheDir(),
+                               params.getPrintActions(),
+                               params.getPrintStatistics()));
+
   if (!params.getIdealIsMinimal()) {
     printer.beginAction("Minimizing ideal.");
     _ideal->minimize();
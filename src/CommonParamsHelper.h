@@ -32,6 +32,7 @@ class BigIdeal;
 class BigTermConsumer;
 class CoefBigTermConsumer;
 class TermTranslator;
+class ResultCache;
 
 /** Utility class for dealing with the contents of
  CommonParams. Throws an appropriate exception if given invalid data. */
@@ -81,6 +82,32 @@ class CommonParamsHelper {
 
   void addPurePowersAtInfinity();
 
+  /** Looks up the result of computation on the ideal in the result
+   cache if the parameters specify one. Returns true if the result is
+   there, in which case it has been written to the ideal output.
+   Otherwise the ideal output is recorded from then on, and
+   storeCachedResult() stores it in the cache. This must be called
+   before the ideal or the translator is changed. Set outputIsList if
+   the computation outputs a list of ideals. */
+  bool lookupCachedIdeal(const string& computation,
+                         bool outputIsList = false);
+
+  /** As lookupCachedIdeal, but for the polynomial output. */
+  bool lookupCachedPolynomial(const string& computation);
+
+  /** As lookupCachedIdeal, but for a result that is a number. Sets
+   value to the result if it is there. */
+  bool lookupCachedNumber(const string& computation, mpz_class& value);
+
+  /** Stores the output recorded since the last lookup in the result
+   cache. Does nothing if that lookup found its result or if there is
+   no result cache. */
+  void storeCachedResult();
+
+  /** Stores value in the result cache as the result of the last
+   lookup. Does nothing if there is no result cache. */
+  void storeCachedNumber(const mpz_class& value);
+
  private:
   // No copies
   CommonParamsHelper(const CommonParamsHelper&);
@@ -88,6 +115,8 @@ class CommonParamsHelper {
 
   void readIdeal(const CommonParams& params, Scanner& in);
   void setIdeal(const CommonParams& params, const BigIdeal& ideal);
+  void prepareIdeal(const CommonParams& params);
+  bool setCacheKey(const string& computation, bool canonicalMatters);
 
   unique_ptr<Ideal> _ideal;
   unique_ptr<TermTranslator> _translator;
@@ -99,6 +128,11 @@ class CommonParamsHelper {
   unique_ptr<CoefBigTermConsumer> _polyConsumerDeleter;
 
   bool _produceCanonicalOutput;
+
+  unique_ptr<ResultCache> _cache;
+  bool _recording;
+  unique_ptr<BigTermConsumer> _idealRecorder;
+  unique_ptr<CoefBigTermConsumer> _polyRecorder;
 };
 
 #endif
@@ -0,0 +1,116 @@
+/* Frobby: Software for monomial ideal computations.
+   Copyright (C) 2007 Bjarke Hammersholt Roune (www.broune.com)
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see http://www.gnu.org/licenses/.
+*/
+#include "stdinc.h"
+#include "CompactBigIdeal.h"
+
+#include "SquareFreeIdeal.h"
+#include "RawSquareFreeTerm.h"
+
+CompactBigIdeal::CompactBigIdeal():
+  _generatorCount(0) {
+}
+
+CompactBigIdeal::CompactBigIdeal(const VarNames& names):
+  _generatorCount(0),
+  _names(names) {
+}
+
+void CompactBigIdeal::insert(const SquareFreeIdeal& ideal) {
+  ASSERT(ideal.getVarCount() == getVarCount());
+  reserve(getGeneratorCount() + ideal.getGeneratorCount());
+
+  SquareFreeIdeal::const_iterator it = ideal.begin();
+  for (; it != ideal.end(); ++it) {
+    newLastTerm();
+    for (size_t var = 0; var < getVarCount(); ++var)
+      if (SquareFreeTermOps::getExponent(*it, var))
+        setLastTermExponent(var, 1ul);
+  }
+}
+
+void CompactBigIdeal::renameVars(const VarNames& names) {
+  ASSERT(names.getVarCount() == _names.getVarCount());
+  _names = names;
+}
+
+void CompactBigIdeal::newLastTerm() {
+  _exponents.resize(_exponents.size() + getVarCount());
+  ++_generatorCount;
+}
+
+void CompactBigIdeal::reserve(size_t capacity) {
+  _exponents.reserve(capacity * getVarCount());
+}
+
+void CompactBigIdeal::setLastTermExponent(size_t var,
+                                          unsigned long exponent) {
+  ASSERT(exponent != BigMarker);
+  ASSERT(getGeneratorCount() > 0);
+  const size_t index = getIndex(getGeneratorCount() - 1, var);
+  if (_exponents[index] == BigMarker)
+    _bigExponents.erase(index);
+  _exponents[index] = exponent;
+}
+
+void CompactBigIdeal::setLastTermExponent(size_t var,
+                                          const mpz_class& exponent) {
+  ASSERT(exponent >= 0);
+  if (exponent.fits_ulong_p() && exponent.get_ui() != BigMarker) {
+    setLastTermExponent(var, exponent.get_ui());
+    return;
+  }
+
+  ASSERT(getGeneratorCount() > 0);
+  const size_t index = getIndex(getGeneratorCount() - 1, var);
+  _bigExponents[index] = exponent;
+  _exponents[index] = BigMarker;
+}
+
+const mpz_class& CompactBigIdeal::
+getBigExponent(size_t term, size_t var) const {
+  ASSERT(!isWordExponent(term, var));
+  std::map<size_t, mpz_class>::const_iterator it =
+    _bigExponents.find(getIndex(term, var));
+  ASSERT(it != _bigExponents.end());
+  return it->second;
+}
+
+void CompactBigIdeal::getExponent(size_t term, size_t var,
+                                  mpz_class& exponent) const {
+  if (isWordExponent(term, var))
+    exponent = getWordExponent(term, var);
+  else
+    exponent = getBigExponent(term, var);
+}
+
+void CompactBigIdeal::clear() {
+  _exponents.clear();
+  _bigExponents.clear();
+  _generatorCount = 0;
+}
+
+void CompactBigIdeal::clearAndSetNames(const VarNames& names) {
+  clear();
+  _names = names;
+}
+
+void CompactBigIdeal::swap(CompactBigIdeal& ideal) {
+  _exponents.swap(ideal._exponents);
+  _bigExponents.swap(ideal._bigExponents);
+  std::swap(_generatorCount, ideal._generatorCount);
+  _names.swap(ideal._names);
+}
@@ -0,0 +1,102 @@
+/* Frobby: Software for monomial ideal computations.
+   Copyright (C) 2007 Bjarke Hammersholt Roune (www.broune.com)
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see http://www.gnu.org/licenses/.
+*/
+#ifndef COMPACT_BIG_IDEAL_GUARD
+#define COMPACT_BIG_IDEAL_GUARD
+
+#include "VarNames.h"
+#include <vector>
+#include <map>
+#include <limits>
+
+class SquareFreeIdeal;
+
+/** A monomial ideal with arbitrary precision exponents that uses
+ one machine word per exponent. Only the exponents that do not fit in
+ a word are kept as mpz_class. This is how ideals are kept while
+ they are being read, since almost all exponents in practice are
+ small, and a BigIdeal uses a heap allocated mpz_class for every
+ exponent. The generators can be translated to an Ideal directly by
+ TermTranslator without going through a BigIdeal. */
+class CompactBigIdeal {
+ public:
+  CompactBigIdeal();
+  CompactBigIdeal(const VarNames& names);
+
+  void insert(const SquareFreeIdeal& ideal);
+
+  void renameVars(const VarNames& names);
+
+  /** Appends the identity as a new generator. */
+  void newLastTerm();
+  void reserve(size_t capacity);
+
+  bool isLastTermExponentZero(size_t var) const;
+  void setLastTermExponent(size_t var, unsigned long exponent);
+  void setLastTermExponent(size_t var, const mpz_class& exponent);
+
+  /** Returns true if the exponent fits in a word, in which case it
+   can be gotten from getWordExponent. Otherwise it has to be gotten
+   from getBigExponent. */
+  bool isWordExponent(size_t term, size_t var) const;
+  unsigned long getWordExponent(size_t term, size_t var) const;
+  const mpz_class& getBigExponent(size_t term, size_t var) const;
+  void getExponent(size_t term, size_t var, mpz_class& exponent) const;
+
+  size_t getGeneratorCount() const {return _generatorCount;}
+  size_t getVarCount() const {return _names.getVarCount();}
+  const VarNames& getNames() const {return _names;}
+
+  void clear();
+  void clearAndSetNames(const VarNames& names);
+
+  void swap(CompactBigIdeal& ideal);
+
+ private:
+  /** The word stored for exponents that are in _bigExponents. */
+  static const unsigned long BigMarker =
+    numeric_limits<unsigned long>::max();
+
+  size_t getIndex(size_t term, size_t var) const;
+
+  vector<unsigned long> _exponents;
+  std::map<size_t, mpz_class> _bigExponents;
+  size_t _generatorCount;
+  VarNames _names;
+};
+
+inline size_t CompactBigIdeal::getIndex(size_t term, size_t var) const {
+  ASSERT(term < getGeneratorCount());
+  ASSERT(var < getVarCount());
+  return term * getVarCount() + var;
+}
+
+inline bool CompactBigIdeal::isWordExponent(size_t term, size_t var) const {
+  return _exponents[getIndex(term, var)] != BigMarker;
+}
+
+inline unsigned long CompactBigIdeal::
+getWordExponent(size_t term, size_t var) const {
+  ASSERT(isWordExponent(term, var));
+  return _exponents[getIndex(term, var)];
+}
+
+inline bool CompactBigIdeal::isLastTermExponentZero(size_t var) const {
+  ASSERT(getGeneratorCount() > 0);
+  return _exponents[getIndex(getGeneratorCount() - 1, var)] == 0;
+}
+
+#endif
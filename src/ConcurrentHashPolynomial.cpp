@@ -0,0 +1,57 @@
+/* Frobby: Software for monomial ideal computations.
+   Copyright (C) 2007 Bjarke Hammersholt Roune (www.broune.com)
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see http://www.gnu.org/licenses/.
+*/
+#include "stdinc.h"
+#include "ConcurrentHashPolynomial.h"
+
+#include "Term.h"
+
+ConcurrentHashPolynomial::ConcurrentHashPolynomial(size_t varCount,
+                                                   size_t shardCount):
+  _shardsDeleter(_shards) {
+  ASSERT(shardCount > 0);
+  _shards.reserve(shardCount);
+  for (size_t shard = 0; shard < shardCount; ++shard) {
+    unique_ptr<Shard> newShard(new Shard(varCount));
+    exceptionSafePushBack(_shards, std::move(newShard));
+  }
+}
+
+void ConcurrentHashPolynomial::add(const mpz_class& coef, const Term& term) {
+  Shard& shard = *_shards[term.getHashCode() % _shards.size()];
+
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  shard.poly.add(coef, term);
+}
+
+void ConcurrentHashPolynomial::add(long coef, const Term& term) {
+  Shard& shard = *_shards[term.getHashCode() % _shards.size()];
+
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  shard.poly.add(coef, term);
+}
+
+void ConcurrentHashPolynomial::feedTermsTo(CoefTermConsumer& consumer) const {
+  for (size_t shard = 0; shard < _shards.size(); ++shard)
+    _shards[shard]->poly.feedTermsTo(consumer);
+}
+
+size_t ConcurrentHashPolynomial::getTermCount() const {
+  size_t termCount = 0;
+  for (size_t shard = 0; shard < _shards.size(); ++shard)
+    termCount += _shards[shard]->poly.getTermCount();
+  return termCount;
+}
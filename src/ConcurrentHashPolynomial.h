@@ -0,0 +1,72 @@
+/* Frobby: Software for monomial ideal computations.
+   Copyright (C) 2007 Bjarke Hammersholt Roune (www.broune.com)
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see http://www.gnu.org/licenses/.
+*/
+#ifndef CONCURRENT_HASH_POLYNOMIAL_GUARD
+#define CONCURRENT_HASH_POLYNOMIAL_GUARD
+
+#include "HashPolynomial.h"
+#include "ElementDeleter.h"
+#include <vector>
+#include <mutex>
+
+class CoefTermConsumer;
+
+/** A sparse multivariate polynomial that several threads can add
+ terms to at the same time. The terms are split into a number of
+ shards by their hash code, each of which is a HashPolynomial with its
+ own lock, so threads only wait for each other when they add terms
+ to the same shard at the same time. With enough shards that is
+ rare. */
+class ConcurrentHashPolynomial {
+ public:
+  /** Use shardCount shards. More shards make it less likely that
+   threads wait for each other, at the cost of some memory for each
+   shard. */
+  ConcurrentHashPolynomial(size_t varCount, size_t shardCount);
+
+  /** Add coef*term to the polynomial. This can be called from
+   several threads at the same time. */
+  void add(const mpz_class& coef, const Term& term);
+  void add(long coef, const Term& term);
+
+  /** Passes each term to consumer in no particular order, as
+   HashPolynomial::feedTermsTo does. This must not be called while
+   terms are being added. */
+  void feedTermsTo(CoefTermConsumer& consumer) const;
+
+  /** Returns the number of terms. This must not be called while terms
+   are being added. */
+  size_t getTermCount() const;
+
+ private:
+  struct Shard {
+    Shard(size_t varCount): poly(varCount) {}
+
+    HashPolynomial poly;
+    std::mutex mutex;
+  };
+
+  /** The shards are allocated separately so that the locks of
+   different shards are not on the same cache line. */
+  vector<Shard*> _shards;
+  ElementDeleter<vector<Shard*> > _shardsDeleter;
+
+  ConcurrentHashPolynomial(const ConcurrentHashPolynomial&); // not available
+  ConcurrentHashPolynomial& operator=
+    (const ConcurrentHashPolynomial&); // not available
+};
+
+#endif
@@ -109,11 +109,13 @@ namespace IO {
     return "count";
   }
 
-  BigTermConsumer* CountingIOHandler::doCreateIdealWriter(FILE* out) {
+  BigTermConsumer* CountingIOHandler::
+  doCreateIdealWriter(FILE* out, size_t threadCount) {
     return new CountingConsumer(out);
   }
 
-  CoefBigTermConsumer* CountingIOHandler::doCreatePolynomialWriter(FILE* out) {
+  CoefBigTermConsumer* CountingIOHandler::
+  doCreatePolynomialWriter(FILE* out, size_t threadCount) {
     return new CountingConsumer(out);
   }
 
@@ -18,6 +18,7 @@
 #include "DebugStrategy.h"
 
 #include "Slice.h"
+#include "TaskSchedule.h"
 
 DebugStrategy::DebugStrategy(SliceStrategy* strategy, FILE* out):
   _strategy(strategy),
@@ -69,7 +70,29 @@ bool DebugStrategy::getUseSimplification() const {
   return _strategy->getUseSimplification();
 }
 
+void DebugStrategy::setThreadCount(size_t threadCount) {
+  _strategy->setThreadCount(threadCount);
+}
+
+void DebugStrategy::setSchedule(unique_ptr<TaskSchedule> schedule) {
+  _strategy->setSchedule(std::move(schedule));
+}
+
+void DebugStrategy::setProcessCount(size_t processCount) {
+  _strategy->setProcessCount(processCount);
+}
+
+void DebugStrategy::setCheckpoint(const string& path,
+                                size_t intervalSeconds,
+                                bool resume) {
+  _strategy->setCheckpoint(path, intervalSeconds, resume);
+}
+
 void DebugStrategy::freeSlice(unique_ptr<Slice> slice) {
   fputs("DEBUG: Freeing slice.\n", _out);
   _strategy->freeSlice(std::move(slice));
 }
+
+void DebugStrategy::printStatistics(FILE* out) const {
+  _strategy->printStatistics(out);
+}
@@ -62,6 +62,7 @@ DimensionAction::DimensionAction():
    false),
 
   _io(DataType::getMonomialIdealType(), DataType::getNullType()) {
+  addResultCacheParam(_params);
 }
 
 void DimensionAction::obtainParameters(vector<Parameter*>& parameters) {
@@ -77,12 +78,14 @@ void DimensionAction::perform() {
   if (_useSlice) {
     SliceParams params;
     params.useIndependenceSplits(false); // not supported
+    params.setInputFile(_in);
+    params.setResultCacheDir(getResultCacheDir(_params));
     validateSplit(params, true, false);
     SliceFacade facade(params, DataType::getNullType());
     result = facade.computeDimension(_codimension);
   } else {
     BigIdeal ideal;
-    Scanner in(_io.getInputFormat(), stdin);
+    Scanner in(_io.getInputFormat(), _in);
     _io.autoDetectInputFormat(in);
     _io.validateFormats();
 
@@ -91,11 +94,16 @@ void DimensionAction::perform() {
     in.expectEOF();
 
     IdealFacade facade(_printActions);
+    facade.setResultCacheDir(getResultCacheDir(_params));
     result = facade.computeDimension(ideal,
                                      _codimension,
                                      _squareFreeAndMinimal);
   }
-  gmp_fprintf(stdout, "%Zd\n", result.get_mpz_t());
+  gmp_fprintf(_out, "%Zd\n", result.get_mpz_t());
+}
+
+bool DimensionAction::supportsBatch() const {
+  return true;
 }
 
 const char* DimensionAction::staticGetName() {
@@ -30,6 +30,8 @@ class DimensionAction : public Action {
 
   virtual void perform();
 
+  virtual bool supportsBatch() const;
+
   static const char* staticGetName();
 
  private:
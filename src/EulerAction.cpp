@@ -29,6 +29,7 @@
 #include "PivotStrategy.h"
 #include "SquareFreeIdeal.h"
 #include "ActionPrinter.h"
+#include "display.h"
 
 #include <algorithm>
 #include <cstdio>
@@ -157,6 +158,12 @@ EulerAction::EulerAction():
    "Change all 0 exponents to 1 and vice versa.",
    false),
 
+  _threadCount
+  ("threads",
+   "The number of threads to use. The output is the same for any number of\n"
+   "threads.",
+   1),
+
   _io(DataType::getMonomialIdealType(), DataType::getNullType()) {
 }
 
@@ -172,30 +179,30 @@ void EulerAction::obtainParameters(vector<Parameter*>& parameters) {
   parameters.push_back(&_useManyDivSimplify);
   parameters.push_back(&_useAllPairsSimplify);
   parameters.push_back(&_swap01);
+  parameters.push_back(&_threadCount);
   Action::obtainParameters(parameters);
 }
 
 void EulerAction::perform() {
-  unique_ptr<PivotStrategy> stdStrat = newStdPivotStrategy(_stdPivot.getValue());
-  unique_ptr<PivotStrategy> genStrat = newGenPivotStrategy(_genPivot.getValue());
-  unique_ptr<PivotStrategy> strat;
-  if (_pivot == "std")
-	strat = std::move(stdStrat);
-  else if (_pivot == "gen")
-	strat = std::move(genStrat);
-  else if (_pivot == "hybrid")
-	strat = newHybridPivotStrategy(std::move(stdStrat), std::move(genStrat));
-  else
-    reportError("Unknown kind of pivot strategy \"" +
-				_pivot.getValue() + "\".");
+  size_t threadCount = _threadCount;
+  if (threadCount > 1 && (_printDebug || _printStatistics)) {
+    displayNote
+      ("Using a single thread as debug output and statistics are not\n"
+       "supported for parallel computation.");
+    threadCount = 1;
+  }
 
+  unique_ptr<PivotStrategy> strat = newPivotStrategy();
   if (_printDebug)
 	strat = newDebugPivotStrategy(std::move(strat), stderr);
   if (_printStatistics)
 	strat = newStatisticsPivotStrategy(std::move(strat), stderr);
 
   PivotEulerAlg alg;
+  alg.setThreadCount(threadCount);
   alg.setPivotStrategy(std::move(strat));
+  for (size_t thread = 1; thread < alg.getThreadCount(); ++thread)
+    alg.setPivotStrategy(thread, newPivotStrategy());
   alg.setUseUniqueDivSimplify(_useUniqueDivSimplify);
   alg.setUseManyDivSimplify(_useManyDivSimplify);
   alg.setUseAllPairsSimplify(_useAllPairsSimplify);
@@ -203,7 +210,7 @@ void EulerAction::perform() {
   IOFacade ioFacade(_printActions);
   SquareFreeIdeal ideal;
   {
-    Scanner in(_io.getInputFormat(), stdin);
+    Scanner in(_io.getInputFormat(), _in);
     _io.autoDetectInputFormat(in);
     _io.validateFormats();
     ioFacade.readSquareFreeIdeal(in, ideal);
@@ -237,7 +244,27 @@ void EulerAction::perform() {
     ActionPrinter pr(_printActions, "Computing Euler characteristic.");
     euler = alg.computeEulerCharacteristic(*ideal.getRawIdeal());
   }
-  gmp_fprintf(stdout, "%Zd\n", euler.get_mpz_t());
+  gmp_fprintf(_out, "%Zd\n", euler.get_mpz_t());
+}
+
+unique_ptr<PivotStrategy> EulerAction::newPivotStrategy() {
+  unique_ptr<PivotStrategy> stdStrat = newStdPivotStrategy(_stdPivot.getValue());
+  unique_ptr<PivotStrategy> genStrat = newGenPivotStrategy(_genPivot.getValue());
+  if (_pivot == "std")
+	return stdStrat;
+  else if (_pivot == "gen")
+	return genStrat;
+  else if (_pivot == "hybrid")
+	return newHybridPivotStrategy(std::move(stdStrat), std::move(genStrat));
+  else
+    reportError("Unknown kind of pivot strategy \"" +
+				_pivot.getValue() + "\".");
+  ASSERT(false);
+  return unique_ptr<PivotStrategy>();
+}
+
+bool EulerAction::supportsBatch() const {
+  return true;
 }
 
 const char* EulerAction::staticGetName() {
@@ -21,6 +21,9 @@
 #include "IOParameters.h"
 #include "BoolParameter.h"
 #include "StringParameter.h"
+#include "IntegerParameter.h"
+
+class PivotStrategy;
 
 /** Implements the command line interface action euler. */
 class EulerAction : public Action {
@@ -31,9 +34,15 @@ class EulerAction : public Action {
 
   virtual void perform();
 
+  virtual bool supportsBatch() const;
+
   static const char* staticGetName();
 
  private:
+  /** Returns the pivot strategy selected by the parameters, not
+   including debug output and statistics. */
+  unique_ptr<PivotStrategy> newPivotStrategy();
+
   StringParameter _pivot;
   StringParameter _stdPivot;
   StringParameter _genPivot;
@@ -44,6 +53,7 @@ class EulerAction : public Action {
   BoolParameter _useManyDivSimplify;
   BoolParameter _useAllPairsSimplify;
   BoolParameter _swap01;
+  IntegerParameter _threadCount;
   IOParameters _io;
 };
 
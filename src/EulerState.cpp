@@ -54,6 +54,21 @@ EulerState* EulerState::construct
   return state;
 }
 
+EulerState* EulerState::construct(const EulerState& state, Arena* arena) {
+  ASSERT(arena != 0);
+
+  const size_t varCount = state.getVarCount();
+  const size_t capacity = state.getIdeal().getGeneratorCount();
+  EulerState* copy = rawConstruct(varCount, capacity, arena);
+
+  *copy->ideal = *state.ideal;
+  Ops::assign(copy->eliminated, state.eliminated, varCount);
+  copy->sign = state.sign;
+  ASSERT(copy->debugIsValid());
+
+  return copy;
+}
+
 EulerState* EulerState::rawConstruct(size_t varCount, size_t capacity,
 									 Arena* arena) {
   ASSERT(arena != 0);
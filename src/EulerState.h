@@ -28,6 +28,11 @@ public:
   static EulerState* construct
 	(const RawSquareFreeIdeal& idealParam, Arena* arena);
 
+  /** Returns a copy of state allocated from arena. The copy has no
+   parent, so it can be processed independently of state, for example
+   on another thread. */
+  static EulerState* construct(const EulerState& state, Arena* arena);
+
   EulerState* inPlaceStdSplit(size_t pivotVar);
   EulerState* inPlaceStdSplit(Word* pivot);
   EulerState* inPlaceGenSplit(size_t pivotIndex);
@@ -59,7 +59,8 @@ namespace IO {
 
   class Fourti2IdealWriter : public IdealWriter {
   public:
-    Fourti2IdealWriter(FILE* out): IdealWriter(out) {
+    Fourti2IdealWriter(FILE* out, size_t threadCount):
+      IdealWriter(out, threadCount) {
     }
 
   private:
@@ -95,7 +96,8 @@ namespace IO {
 
   class Fourti2PolyWriter : public PolyWriter {
   public:
-    Fourti2PolyWriter(FILE* out): PolyWriter(out) {
+    Fourti2PolyWriter(FILE* out, size_t threadCount):
+      PolyWriter(out, threadCount) {
     }
 
   private:
@@ -163,15 +165,19 @@ namespace IO {
     return "4ti2";
   }
 
-  BigTermConsumer* Fourti2IOHandler::doCreateIdealWriter(FILE* out) {
+  BigTermConsumer* Fourti2IOHandler::
+  doCreateIdealWriter(FILE* out, size_t threadCount) {
     F::display4ti2Warning();
-    unique_ptr<BigTermConsumer> writer(new Fourti2IdealWriter(out));
+    unique_ptr<BigTermConsumer> writer
+      (new Fourti2IdealWriter(out, threadCount));
     return new IdealConsolidator(std::move(writer));
   }
 
-  CoefBigTermConsumer* Fourti2IOHandler::doCreatePolynomialWriter(FILE* out) {
+  CoefBigTermConsumer* Fourti2IOHandler::
+  doCreatePolynomialWriter(FILE* out, size_t threadCount) {
     F::display4ti2Warning();
-    unique_ptr<CoefBigTermConsumer> writer(new Fourti2PolyWriter(out));
+    unique_ptr<CoefBigTermConsumer> writer
+      (new Fourti2PolyWriter(out, threadCount));
     return new PolynomialConsolidator(std::move(writer));
   }
 
@@ -18,81 +18,267 @@
 #ifndef HASH_MAP_GUARD
 #define HASH_MAP_GUARD
 
+#include "HashTableSlots.h"
+#include <vector>
+#include <utility>
+#include <type_traits>
+
 /** \file
 
- The purpose of this file is to provide a definition of a hash map
- whenever possible. This needs to be done separately since various
- compilers put their hash maps in different places. GCC even moves it
- around for different versions and issues warnings for some
- placements. This has been fixed by including GCCs hash_map with
- Frobby to get a consistent and warning-free place to get it from.
+ The purpose of this file is to provide a hash map that stores its
+ entries in a single array rather than in a node for each entry, as
+ the hash maps of the standard library do. This avoids an allocation
+ for each entry and keeps entries that are looked up together close
+ together in memory.
 
- If the current compiler is not recognized, we use a comparison-based
- map as a fall-back.
+ The hash code of a key is computed by FrobbyHash<Key>, which has to
+ be specialized for each type of key.
 */
 
 template<class Key>
 class FrobbyHash {};
 
-// *********************************************************
-#if defined(__GNUC__) || defined(__clang__)
-#if 0
-#include "hash_map/hash_map"
-#include <string>
-#endif
-#include <unordered_map>
+/** A hash map with open addressing that uses Robin Hood hashing as
+ implemented by HashTableSlots. Erasing an entry moves the entries
+ after it back one slot, so no tombstones are needed.
+
+ The interface is the part of that of std::unordered_map that Frobby
+ uses. Unlike std::unordered_map, inserting or erasing an entry
+ invalidates all iterators and references to entries, and the key of
+ an entry can be changed through an iterator, which must not be
+ done. */
 template<class Key, class Value>
-  class HashMap : public std::unordered_map<Key, Value, FrobbyHash<Key>> { };
+class HashMap {
+ public:
+  typedef Key key_type;
+  typedef Value mapped_type;
+  typedef std::pair<Key, Value> value_type;
 
-#if 0
-template<>
-class FrobbyHash<string> : public __gnu_cxx::hash<string> {
-};
+  class iterator;
+  class const_iterator;
 
-template<class Key, class Value>
-class HashMap : public __gnu_cxx::hash_map<Key, Value,
-  FrobbyHash<Key> > {
-};
-#endif
-#else
-// *********************************************************
-#ifdef _MSC_VER // Only Microsoft C++ defines this macro
-#include <hash_map>
-#include <string>
+  HashMap() {}
+  HashMap(const HashMap& map) {
+    for (const_iterator it = map.begin(); it != map.end(); ++it)
+      insert(*it);
+  }
+  ~HashMap() {clear();}
 
-template<class Key>
-class HashWrapper : public stdext::hash_compare<Key, ::std::less<Key> >, FrobbyHash<Key> {
-public:
-  size_t operator()(const Key& key) const {
-    return FrobbyHash<typename Key>::operator()(key);
+  HashMap& operator=(const HashMap& map) {
+    HashMap copy(map);
+    swap(copy);
+    return *this;
   }
 
-  bool operator()(const Key& a, const Key& b) const {
-    return stdext::hash_compare<Key, ::std::less<Key> >::operator()(a, b);
+  void swap(HashMap& map) {
+    _table.swap(map._table);
+    _storage.swap(map._storage);
   }
-};
 
-template<>
-class HashWrapper<string> : public stdext::hash_compare<string, ::std::less<string> > {
+  size_t size() const {return _table.size();}
+  bool empty() const {return _table.size() == 0;}
+
+  /** Removes all entries while keeping the memory of the table. */
+  void clear() {
+    for (size_t slot = 0; slot < _table.getSlotCount(); ++slot)
+      if (!_table.isEmpty(slot))
+        getEntry(slot).~value_type();
+    _table.clear();
+  }
+
+  iterator begin() {return iterator(this, _table.nextEntry(0));}
+  iterator end() {return iterator(this, _table.getSlotCount());}
+  const_iterator begin() const {
+    return const_iterator(this, _table.nextEntry(0));
+  }
+  const_iterator end() const {
+    return const_iterator(this, _table.getSlotCount());
+  }
+
+  iterator find(const Key& key) {
+    return iterator(this, findSlot(key, hash(key)));
+  }
+
+  const_iterator find(const Key& key) const {
+    return const_iterator(this, findSlot(key, hash(key)));
+  }
+
+  Value& operator[](const Key& key) {
+    size_t hashCode = hash(key);
+    size_t slot = findSlot(key, hashCode);
+    if (slot == _table.getSlotCount())
+      slot = insertNew(value_type(key, Value()), hashCode);
+    return getEntry(slot).second;
+  }
+
+  /** Inserts value unless its key already has an entry. Returns the
+   entry of the key and whether value was inserted. */
+  std::pair<iterator, bool> insert(const value_type& value) {
+    size_t hashCode = hash(value.first);
+    size_t slot = findSlot(value.first, hashCode);
+    if (slot != _table.getSlotCount())
+      return std::make_pair(iterator(this, slot), false);
+    slot = insertNew(value_type(value), hashCode);
+    return std::make_pair(iterator(this, slot), true);
+  }
+
+  /** Erases the entry of key if there is one. Returns the number of
+   entries erased. */
+  size_t erase(const Key& key) {
+    size_t slot = findSlot(key, hash(key));
+    if (slot == _table.getSlotCount())
+      return 0;
+    eraseSlot(slot);
+    return 1;
+  }
+
+  void erase(iterator it) {
+    ASSERT(it._map == this);
+    eraseSlot(it._slot);
+  }
+
+  class iterator {
+  public:
+    iterator(): _map(0), _slot(0) {}
+
+    value_type& operator*() const {return _map->getEntry(_slot);}
+    value_type* operator->() const {return &_map->getEntry(_slot);}
+
+    iterator& operator++() {
+      _slot = _map->_table.nextEntry(_slot + 1);
+      return *this;
+    }
+
+    bool operator==(const iterator& it) const {return _slot == it._slot;}
+    bool operator!=(const iterator& it) const {return _slot != it._slot;}
+
+  private:
+    friend class HashMap;
+    friend class const_iterator;
+    iterator(HashMap* map, size_t slot): _map(map), _slot(slot) {}
+
+    HashMap* _map;
+    size_t _slot;
+  };
+
+  class const_iterator {
+  public:
+    const_iterator(): _map(0), _slot(0) {}
+    const_iterator(const iterator& it): _map(it._map), _slot(it._slot) {}
+
+    const value_type& operator*() const {return _map->getEntry(_slot);}
+    const value_type* operator->() const {return &_map->getEntry(_slot);}
+
+    const_iterator& operator++() {
+      _slot = _map->_table.nextEntry(_slot + 1);
+      return *this;
+    }
+
+    bool operator==(const const_iterator& it) const {
+      return _slot == it._slot;
+    }
+    bool operator!=(const const_iterator& it) const {
+      return _slot != it._slot;
+    }
+
+  private:
+    friend class HashMap;
+    const_iterator(const HashMap* map, size_t slot):
+      _map(map), _slot(slot) {}
+
+    const HashMap* _map;
+    size_t _slot;
+  };
+
+ private:
+  /** The entries are constructed in place in _storage, so that empty
+   slots do not hold an entry. */
+  typedef typename std::aligned_storage
+    <sizeof(value_type), std::alignment_of<value_type>::value>::type Storage;
+
+  static size_t hash(const Key& key) {
+    return HashTableSlots::mix(FrobbyHash<Key>()(key));
+  }
+
+  value_type& getEntry(size_t slot) {
+    ASSERT(!_table.isEmpty(slot));
+    return *reinterpret_cast<value_type*>(&_storage[slot]);
+  }
+
+  const value_type& getEntry(size_t slot) const {
+    ASSERT(!_table.isEmpty(slot));
+    return *reinterpret_cast<const value_type*>(&_storage[slot]);
+  }
+
+  /** Returns the slot of key, or the number of slots if key has no
+   entry. */
+  size_t findSlot(const Key& key, size_t hashCode) const {
+    return _table.find(hashCode, [&](size_t slot) {
+        return getEntry(slot).first == key;
+      });
+  }
+
+  /** Inserts value, whose key must not have an entry, and returns its
+   slot. */
+  size_t insertNew(value_type value, size_t hashCode);
+
+  /** Moves the entry in slot from to the empty slot to. */
+  void moveEntry(size_t from, size_t to);
+
+  void eraseSlot(size_t slot) {
+    getEntry(slot).~value_type();
+    _table.erase(slot, [this](size_t from, size_t to) {moveEntry(from, to);});
+  }
+
+  void grow();
+
+  HashTableSlots _table;
+  std::vector<Storage> _storage;
 };
 
+#undef new
 template<class Key, class Value>
-class HashMap : public stdext::hash_map<Key, Value, HashWrapper<Key> > {
-};
+size_t HashMap<Key, Value>::insertNew(value_type value, size_t hashCode) {
+  if (_table.isFull())
+    grow();
+
+  auto move = [this](size_t from, size_t to) {moveEntry(from, to);};
+  const size_t slot = _table.insert(hashCode, move);
+  try {
+    new (&_storage[slot]) value_type(std::move(value));
+  } catch (...) {
+    _table.erase(slot, move);
+    throw;
+  }
+  return slot;
+}
 
-// *********************************************************
-#else // Fall-back for unknown compilers
-#include <map>
 template<class Key, class Value>
-class HashMap :
-  #if __cplusplus < 201103
-       public std::map<Key, Value>
-  #else
-       public std::unordered_map<Key, Value>
-#endif
-{};
-#endif
+void HashMap<Key, Value>::moveEntry(size_t from, size_t to) {
+  new (&_storage[to]) value_type(std::move(getEntry(from)));
+  getEntry(from).~value_type();
+}
+#ifdef NEW_MACRO
+#define new NEW_MACRO
 #endif
 
+template<class Key, class Value>
+void HashMap<Key, Value>::grow() {
+  // The grown table is built on the side and only swapped in once it
+  // holds every entry, so this map is unchanged if anything throws.
+  // Entries are copied rather than moved across if moving them can
+  // throw, since a move that throws halfway through would leave the
+  // entries moved so far in neither table.
+  HashMap map;
+  const size_t slotCount = _table.getGrownSlotCount();
+  map._table.reset(slotCount);
+  map._storage.resize(slotCount);
+
+  for (size_t slot = 0; slot < _table.getSlotCount(); ++slot)
+    if (!_table.isEmpty(slot))
+      map.insertNew(std::move_if_noexcept(getEntry(slot)),
+                    _table.getHash(slot));
+  swap(map);
+}
 
 #endif
@@ -0,0 +1,154 @@
+/* Frobby: Software for monomial ideal computations.
+   Copyright (C) 2009 University of Aarhus
+   Contact Bjarke Hammersholt Roune for license information (www.broune.com)
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see http://www.gnu.org/licenses/.
+*/
+#include "stdinc.h"
+#include "HashMap.h"
+#include "tests.h"
+
+#include "UniHashPolynomial.h"
+#include <map>
+
+TEST_SUITE(HashMap)
+
+namespace {
+  /** A key whose hash codes collide a lot, so that the entries form
+   long runs of used slots. */
+  struct CollidingKey {
+    CollidingKey(size_t value): value(value) {}
+    bool operator==(const CollidingKey& key) const {
+      return value == key.value;
+    }
+    size_t value;
+  };
+
+  /** A value that counts down copiesLeft each time it is copied or
+   moved and that throws instead once copiesLeft is zero. Its move
+   constructor is not noexcept. */
+  struct ThrowingValue {
+    ThrowingValue(size_t value): value(value) {}
+    ThrowingValue(const ThrowingValue& v): value(v.value) {count();}
+    ThrowingValue(ThrowingValue&& v): value(v.value) {
+      count();
+      v.value = 0;
+    }
+
+    static void count() {
+      if (copiesLeft == 0)
+        throw std::bad_alloc();
+      --copiesLeft;
+    }
+
+    size_t value;
+    static size_t copiesLeft;
+  };
+
+  size_t ThrowingValue::copiesLeft = static_cast<size_t>(-1);
+}
+
+template<>
+class FrobbyHash<CollidingKey> {
+ public:
+  size_t operator()(const CollidingKey& key) const {
+    return key.value / 8;
+  }
+};
+
+TEST(HashMap, InsertFindErase) {
+  HashMap<mpz_class, mpz_class> map;
+  ASSERT_TRUE(map.empty());
+  map[mpz_class(1)] = 10;
+  map[mpz_class(2)] = 20;
+  ASSERT_TRUE(map.insert(make_pair(mpz_class(3), mpz_class(30))).second);
+  ASSERT_FALSE(map.insert(make_pair(mpz_class(3), mpz_class(31))).second);
+  ASSERT_EQ(map.size(), 3u);
+  ASSERT_EQ(map.find(mpz_class(3))->second, 30);
+
+  ASSERT_EQ(map.erase(mpz_class(2)), 1u);
+  ASSERT_EQ(map.erase(mpz_class(2)), 0u);
+  ASSERT_TRUE(map.find(mpz_class(2)) == map.end());
+  ASSERT_EQ(map.find(mpz_class(1))->second, 10);
+
+  map.erase(map.find(mpz_class(1)));
+  ASSERT_EQ(map.size(), 1u);
+  ASSERT_EQ(map[mpz_class(3)], 30);
+
+  map.clear();
+  ASSERT_TRUE(map.empty());
+  ASSERT_TRUE(map.begin() == map.end());
+}
+
+TEST(HashMap, EraseWithCollisions) {
+  // Compare to std::map while inserting and erasing keys that collide
+  // in groups of 8, so that erasing moves the entries after it.
+  HashMap<CollidingKey, size_t> map;
+  std::map<size_t, size_t> reference;
+  unsigned long seed = 1;
+  for (size_t step = 0; step < 20000; ++step) {
+    seed = seed * 1103515245 + 12345;
+    const size_t key = (seed >> 16) % 500;
+    if ((seed >> 8) % 3 == 0) {
+      ASSERT_EQ(map.erase(CollidingKey(key)), reference.erase(key));
+    } else {
+      map[CollidingKey(key)] = step;
+      reference[key] = step;
+    }
+    ASSERT_EQ(map.size(), reference.size());
+  }
+
+  size_t count = 0;
+  for (HashMap<CollidingKey, size_t>::const_iterator it = map.begin();
+       it != map.end(); ++it) {
+    ASSERT_EQ(reference[it->first.value], it->second);
+    ++count;
+  }
+  ASSERT_EQ(count, reference.size());
+}
+
+TEST(HashMap, Copy) {
+  HashMap<mpz_class, mpz_class> map;
+  for (size_t i = 0; i < 100; ++i)
+    map[mpz_class(i)] = i * i;
+  HashMap<mpz_class, mpz_class> copy(map);
+  map.erase(mpz_class(5));
+  ASSERT_EQ(copy.size(), 100u);
+  ASSERT_EQ(copy[mpz_class(5)], 25);
+  ASSERT_EQ(map.size(), 99u);
+}
+
+TEST(HashMap, GrowThrows) {
+  // The initial table of 16 slots is full with 11 entries, so the
+  // next insertion grows the table, and that grow throws partway
+  // through.
+  HashMap<CollidingKey, ThrowingValue> map;
+  const size_t count = 11;
+  for (size_t key = 0; key < count; ++key)
+    map.insert(make_pair(CollidingKey(key), ThrowingValue(key + 1)));
+
+  ThrowingValue::copiesLeft = 5;
+  bool threw = false;
+  try {
+    map.insert(make_pair(CollidingKey(count), ThrowingValue(count + 1)));
+  } catch (const std::bad_alloc&) {
+    threw = true;
+  }
+  ThrowingValue::copiesLeft = static_cast<size_t>(-1);
+
+  ASSERT_TRUE(threw);
+  ASSERT_EQ(map.size(), count);
+  for (size_t key = 0; key < count; ++key)
+    ASSERT_EQ(map.find(CollidingKey(key))->second.value, key + 1);
+}
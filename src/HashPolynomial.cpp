@@ -21,16 +21,33 @@
 #include "CoefBigTermConsumer.h"
 #include "TermTranslator.h"
 #include "TermPredicate.h"
+#include "CoefTermConsumer.h"
 #include <vector>
 #include <algorithm>
+#include <climits>
+
+namespace {
+  /** Sets sum to a+b and returns true if that fits in a long, and
+   otherwise returns false. */
+  inline bool addSmall(long a, long b, long& sum) {
+    if (b > 0 ? a > LONG_MAX - b : a < LONG_MIN - b)
+      return false;
+    sum = a + b;
+    return true;
+  }
+}
 
 HashPolynomial::HashPolynomial(size_t varCount):
   _varCount(varCount) {
 }
 
 void HashPolynomial::clearAndSetVarCount(size_t varCount) {
-  _terms.clear();
   _varCount = varCount;
+  HashTableSlots().swap(_table);
+  _coefs.clear();
+  _exponents.clear();
+  _bigCoefs.clear();
+  _freeBigCoefs.clear();
 }
 
 void HashPolynomial::add(const mpz_class& coef, const Term& term) {
@@ -39,38 +56,40 @@ void HashPolynomial::add(const mpz_class& coef, const Term& term) {
   if (coef == 0)
     return;
 
-  // Doing it this way incurs the penalty of looking up term twice if
-  // ref ends up zero. I don't know how to avoid two look-ups in all
-  // cases, especially when the interface of _terms is not fixed,
-  // e.g. lowerbound doesn't exist for GCC's hash_map, so we can't use
-  // that.
-  mpz_class& ref = _terms[term];
-  ref += coef;
-  if (ref == 0)
-    _terms.erase(term);
+  size_t slot = insertSlot(term.begin());
+  if (coef.fits_slong_p())
+    addToSlot(slot, coef.get_si());
+  else
+    addToSlot(slot, coef);
+}
+
+void HashPolynomial::add(long coef, const Term& term) {
+  ASSERT(_varCount == term.getVarCount());
+
+  if (coef != 0)
+    addToSlot(insertSlot(term.begin()), coef);
 }
 
 void HashPolynomial::add(bool plus, const Term& term) {
   ASSERT(_varCount == term.getVarCount());
 
-  mpz_class& ref = _terms[term];
-  if (plus)
-    ++ref;
-  else
-    --ref;
-  if (ref == 0)
-    _terms.erase(term);
+  addToSlot(insertSlot(term.begin()), plus ? 1L : -1L);
 }
 
-namespace {
-  /** Helper class for feedTo. */
-  class RefCompare {
-  public:
-    typedef HashMap<Term, mpz_class> TermMap;
-    bool operator()(TermMap::const_iterator a, TermMap::const_iterator b) {
-      return lexCompare(a->first, b->first) > 0;
-    }
-  };
+void HashPolynomial::add(const HashPolynomial& poly) {
+  ASSERT(_varCount == poly._varCount);
+
+  ASSERT(&poly != this);
+  for (size_t slot = 0; slot < poly._table.getSlotCount(); ++slot) {
+    if (poly._table.isEmpty(slot))
+      continue;
+    size_t to = insertSlot(poly.getExponents(slot));
+    const Coef& from = poly._coefs[slot];
+    if (from.big == NotBig)
+      addToSlot(to, from.small);
+    else
+      addToSlot(to, poly._bigCoefs[from.big]);
+  }
 }
 
 void HashPolynomial::feedTo
@@ -81,39 +100,196 @@ void HashPolynomial::feedTo
   consumer.consumeRing(translator.getNames());
   consumer.beginConsuming();
 
+  Term term(_varCount);
+  mpz_class coef;
   if (!inCanonicalOrder) {
-    // Output the terms in whatever order _terms is storing them.
-    TermMap::const_iterator termsEnd = _terms.end();
-    TermMap::const_iterator it = _terms.begin();
-    for (; it != termsEnd; ++it)
-      consumer.consume(it->second, it->first, translator);
+    // Output the terms in whatever order the table is storing them.
+    for (size_t slot = 0; slot < _table.getSlotCount(); ++slot) {
+      if (_table.isEmpty(slot))
+        continue;
+      term = getExponents(slot);
+      getCoef(slot, coef);
+      consumer.consume(coef, term, translator);
+    }
   } else {
+    // Sort the slots of the terms rather than moving the terms
+    // around in the table.
+    vector<size_t> slots;
+    slots.reserve(_table.size());
+    for (size_t slot = 0; slot < _table.getSlotCount(); ++slot)
+      if (!_table.isEmpty(slot))
+        slots.push_back(slot);
+
+    sort(slots.begin(), slots.end(), [this](size_t a, size_t b) {
+      return lexCompare(getExponents(a), getExponents(b), _varCount) > 0;
+    });
+
+    // Output the terms in the sorted order.
+    for (size_t i = 0; i < slots.size(); ++i) {
+      term = getExponents(slots[i]);
+      getCoef(slots[i], coef);
+      consumer.consume(coef, term, translator);
+    }
+  }
+
+  consumer.doneConsuming();
+}
 
-    // Fill refs with references to the terms in order to sort
-    // them. We can't sort _terms since HashMap doesn't support that,
-    // so we have to sort references into _terms instead.
-    vector<TermMap::const_iterator> refs;
-    refs.reserve(_terms.size());
+void HashPolynomial::feedTermsTo(CoefTermConsumer& consumer) const {
+  Term term(_varCount);
+  mpz_class coef;
+  for (size_t slot = 0; slot < _table.getSlotCount(); ++slot) {
+    if (_table.isEmpty(slot))
+      continue;
+    term = getExponents(slot);
+    getCoef(slot, coef);
+    consumer.consume(coef, term);
+  }
+}
 
-    TermMap::const_iterator termsEnd = _terms.end();
-    TermMap::const_iterator it = _terms.begin();
-    for (; it != termsEnd; ++it)
-      refs.push_back(it);
+size_t HashPolynomial::getTermCount() const {
+  return _table.size();
+}
 
-    // Sort the references.
-    sort(refs.begin(), refs.end(), RefCompare());
+size_t HashPolynomial::insertSlot(const Exponent* term) {
+  const size_t hash =
+    HashTableSlots::mix(Term::getHashCode(term, _varCount));
+  size_t slot = _table.find(hash, [&](size_t slot) {
+      return equals(getExponents(slot), term, _varCount);
+    });
+  if (slot != _table.getSlotCount())
+    return slot;
 
-    // Output the terms in the sorted order specified by refs.
+  if (_table.isFull())
+    grow();
+  slot = _table.insert(hash, [this](size_t from, size_t to) {
+      moveSlot(from, to);
+    });
+  _coefs[slot].small = 0;
+  _coefs[slot].big = NotBig;
+  copy(term, term + _varCount, getExponents(slot));
+  return slot;
+}
 
-    vector<TermMap::const_iterator>::const_iterator refsEnd = refs.end();
-    vector<TermMap::const_iterator>::const_iterator refIt = refs.begin();
-    for (; refIt != refsEnd; ++refIt)
-      consumer.consume((*refIt)->second, (*refIt)->first, translator);
+void HashPolynomial::moveSlot(size_t from, size_t to) {
+  _coefs[to] = _coefs[from];
+  copy(getExponents(from), getExponents(from) + _varCount,
+       getExponents(to));
+}
+
+void HashPolynomial::addToSlot(size_t slot, long coef) {
+  Coef& s = _coefs[slot];
+  if (s.big == NotBig) {
+    long sum;
+    if (addSmall(s.small, coef, sum)) {
+      s.small = sum;
+      if (sum == 0)
+        eraseSlot(slot);
+      return;
+    }
+    // The sum does not fit in a long, so it cannot be zero.
+    mpz_class big(s.small);
+    big += coef;
+    setBig(slot, big);
+  } else {
+    mpz_class& big = _bigCoefs[s.big];
+    big += coef;
+    if (big.fits_slong_p()) {
+      long small = big.get_si();
+      freeBig(slot);
+      s.small = small;
+      if (small == 0)
+        eraseSlot(slot);
+    }
   }
+}
 
-  consumer.doneConsuming();
+void HashPolynomial::addToSlot(size_t slot, const mpz_class& coef) {
+  Coef& s = _coefs[slot];
+  if (coef.fits_slong_p()) {
+    addToSlot(slot, coef.get_si());
+    return;
+  }
+
+  if (s.big == NotBig) {
+    mpz_class big(s.small);
+    big += coef;
+    s.small = 0;
+    if (big.fits_slong_p())
+      s.small = big.get_si();
+    else
+      setBig(slot, big);
+  } else {
+    mpz_class& big = _bigCoefs[s.big];
+    big += coef;
+    if (big.fits_slong_p()) {
+      long small = big.get_si();
+      freeBig(slot);
+      s.small = small;
+    }
+  }
+  if (isZero(slot))
+    eraseSlot(slot);
 }
 
-size_t HashPolynomial::getTermCount() const {
-  return _terms.size();
+void HashPolynomial::eraseSlot(size_t slot) {
+  ASSERT(isZero(slot));
+  _table.erase(slot, [this](size_t from, size_t to) {moveSlot(from, to);});
+}
+
+void HashPolynomial::getCoef(size_t slot, mpz_class& coef) const {
+  const Coef& s = _coefs[slot];
+  if (s.big == NotBig)
+    coef = s.small;
+  else
+    coef = _bigCoefs[s.big];
+}
+
+void HashPolynomial::setBig(size_t slot, const mpz_class& coef) {
+  Coef& s = _coefs[slot];
+  ASSERT(s.big == NotBig);
+  if (_freeBigCoefs.empty()) {
+    s.big = _bigCoefs.size();
+    _bigCoefs.push_back(coef);
+  } else {
+    s.big = _freeBigCoefs.back();
+    _freeBigCoefs.pop_back();
+    _bigCoefs[s.big] = coef;
+  }
+  s.small = 0;
+}
+
+void HashPolynomial::freeBig(size_t slot) {
+  Coef& s = _coefs[slot];
+  ASSERT(s.big != NotBig);
+  _freeBigCoefs.push_back(s.big);
+  s.big = NotBig;
+}
+
+void HashPolynomial::grow() {
+  HashTableSlots table;
+  const size_t slotCount = _table.getGrownSlotCount();
+  table.reset(slotCount);
+  vector<Coef> coefs(slotCount);
+  vector<Exponent> exponents(slotCount * _varCount);
+
+  // Big coefficients keep their index, so only the slots move.
+  auto move = [&](size_t from, size_t to) {
+    coefs[to] = coefs[from];
+    copy(exponents.begin() + from * _varCount,
+         exponents.begin() + (from + 1) * _varCount,
+         exponents.begin() + to * _varCount);
+  };
+  for (size_t from = 0; from < _table.getSlotCount(); ++from) {
+    if (_table.isEmpty(from))
+      continue;
+    const size_t to = table.insert(_table.getHash(from), move);
+    coefs[to] = _coefs[from];
+    copy(getExponents(from), getExponents(from) + _varCount,
+         exponents.begin() + to * _varCount);
+  }
+
+  _table.swap(table);
+  _coefs.swap(coefs);
+  _exponents.swap(exponents);
 }
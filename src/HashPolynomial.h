@@ -20,8 +20,11 @@
 
 #include "Term.h"
 #include "HashMap.h"
+#include "HashTableSlots.h"
+#include <vector>
 
 class CoefBigTermConsumer;
+class CoefTermConsumer;
 class TermTranslator;
 
 /** This template specialization makes the hash code of a term
@@ -38,6 +41,14 @@ class FrobbyHash<Term> {
 /** A sparse multivariate polynomial represented by a hash table
  mapping terms to coefficients. This allows to avoid duplicate terms
  without a large overhead.
+
+ The table is a HashTableSlots, the same as for HashMap, with the
+ exponents of all the terms stored one after the other in a single
+ vector indexed by slot, so adding a term does not allocate memory
+ except when the table grows. Coefficients that fit in a long are
+ stored inline, and a coefficient is only moved to an mpz_class when
+ it no longer fits. A term is erased as soon as its coefficient
+ becomes zero.
 */
 class HashPolynomial {
  public:
@@ -45,24 +56,81 @@ class HashPolynomial {
 
   void clearAndSetVarCount(size_t varCount);
 
+  size_t getVarCount() const {return _varCount;}
+
   /** Add coef*term to the polynomial. */
   void add(const mpz_class& coef, const Term& term);
+  void add(long coef, const Term& term);
 
   /** Add +term or -term to the polynomial depending on whether plus
    is true or false, respectively. */
   void add(bool plus, const Term& term);
 
+  /** Add poly to this polynomial. The two polynomials must have the
+   same number of variables. */
+  void add(const HashPolynomial& poly);
+
   void feedTo(const TermTranslator& translator,
               CoefBigTermConsumer& consumer,
               bool inCanonicalOrder) const;
 
+  /** Passes each term to consumer in no particular order. This does
+   not call beginConsuming() or doneConsuming(), so the terms can be
+   part of a larger polynomial that consumer is consuming. */
+  void feedTermsTo(CoefTermConsumer& consumer) const;
+
   size_t getTermCount() const;
 
  private:
+  /** The coefficient of a term. It is zero if small is zero and big
+   is NotBig. */
+  struct Coef {
+    /** The coefficient unless big is not NotBig. */
+    long small;
+
+    /** The index in _bigCoefs of the coefficient, or NotBig if the
+     coefficient is small. */
+    size_t big;
+  };
+  static const size_t NotBig = static_cast<size_t>(-1);
+
+  bool isZero(size_t slot) const {
+    return _coefs[slot].small == 0 && _coefs[slot].big == NotBig;
+  }
+  Exponent* getExponents(size_t slot) {
+    return _exponents.data() + slot * _varCount;
+  }
+  const Exponent* getExponents(size_t slot) const {
+    return _exponents.data() + slot * _varCount;
+  }
+
+  /** Returns the slot of term, inserting term with coefficient zero if
+   it is not already there. Such a slot must get a non-zero
+   coefficient before any other operation on the table. */
+  size_t insertSlot(const Exponent* term);
+
+  /** Moves the term in slot from to the empty slot to. */
+  void moveSlot(size_t from, size_t to);
+
+  void addToSlot(size_t slot, long coef);
+  void addToSlot(size_t slot, const mpz_class& coef);
+
+  /** Erases the term in slot, whose coefficient must be zero. */
+  void eraseSlot(size_t slot);
+
+  void getCoef(size_t slot, mpz_class& coef) const;
+  void setBig(size_t slot, const mpz_class& coef);
+  void freeBig(size_t slot);
+
+  void grow();
+
   size_t _varCount;
+  HashTableSlots _table;
+  vector<Coef> _coefs;
+  vector<Exponent> _exponents;
 
-  typedef HashMap<Term, mpz_class> TermMap;
-  TermMap _terms;
+  vector<mpz_class> _bigCoefs;
+  vector<size_t> _freeBigCoefs;
 };
 
 #endif
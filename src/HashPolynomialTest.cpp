@@ -0,0 +1,221 @@
+/* Frobby: Software for monomial ideal computations.
+   Copyright (C) 2009 University of Aarhus
+   Contact Bjarke Hammersholt Roune for license information (www.broune.com)
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see http://www.gnu.org/licenses/.
+*/
+#include "stdinc.h"
+#include "HashPolynomial.h"
+#include "tests.h"
+
+#include "CoefTermConsumer.h"
+#include "Polynomial.h"
+#include <climits>
+
+TEST_SUITE(HashPolynomial)
+
+namespace {
+  /** Adds each consumed term to a Polynomial. */
+  class PolynomialRecorder : public CoefTermConsumer {
+  public:
+    PolynomialRecorder(Polynomial& poly): _poly(poly) {}
+
+    virtual void consumeRing(const VarNames& names) {}
+    virtual void beginConsuming() {}
+    virtual void consume(const mpz_class& coef, const Term& term) {
+      _poly.add(coef, term);
+    }
+    virtual void doneConsuming() {}
+
+  private:
+    Polynomial& _poly;
+  };
+
+  /** Sets poly to the terms of hashPoly in reverse lex order. */
+  void getSorted(const HashPolynomial& hashPoly, Polynomial& poly) {
+    poly.clearAndSetVarCount(hashPoly.getVarCount());
+    PolynomialRecorder recorder(poly);
+    hashPoly.feedTermsTo(recorder);
+    poly.sortTermsReverseLex(false);
+  }
+
+  /** Returns the coefficient of term in poly, which is zero if term
+   is not in poly. */
+  mpz_class getCoef(const HashPolynomial& hashPoly, const Term& term) {
+    Polynomial poly;
+    getSorted(hashPoly, poly);
+    for (size_t index = 0; index < poly.getTermCount(); ++index)
+      if (poly.getTerm(index) == term)
+        return poly.getCoef(index);
+    return 0;
+  }
+}
+
+TEST(HashPolynomial, SmallCoefficients) {
+  HashPolynomial poly(2);
+  poly.add(3L, Term("1 2"));
+  poly.add(true, Term("0 1"));
+  poly.add(false, Term("1 2"));
+  poly.add(mpz_class(5), Term("3 0"));
+  ASSERT_EQ(poly.getTermCount(), 3u);
+  ASSERT_EQ(getCoef(poly, Term("1 2")), 2);
+  ASSERT_EQ(getCoef(poly, Term("0 1")), 1);
+  ASSERT_EQ(getCoef(poly, Term("3 0")), 5);
+
+  // Adding zero does not insert a term.
+  poly.add(0L, Term("4 4"));
+  poly.add(mpz_class(0), Term("4 4"));
+  ASSERT_EQ(poly.getTermCount(), 3u);
+}
+
+TEST(HashPolynomial, LongMaxPromotion) {
+  HashPolynomial poly(1);
+  Term term("1");
+  poly.add(LONG_MAX, term);
+  ASSERT_EQ(getCoef(poly, term), LONG_MAX);
+
+  // The sum no longer fits in a long.
+  poly.add(1L, term);
+  mpz_class expected = mpz_class(LONG_MAX) + 1;
+  ASSERT_EQ(getCoef(poly, term), expected);
+  poly.add(LONG_MAX, term);
+  expected += LONG_MAX;
+  ASSERT_EQ(getCoef(poly, term), expected);
+
+  // And back into a long.
+  poly.add(LONG_MIN, term);
+  poly.add(LONG_MIN, term);
+  ASSERT_EQ(getCoef(poly, term), -1);
+  ASSERT_EQ(poly.getTermCount(), 1u);
+}
+
+TEST(HashPolynomial, LongMinPromotion) {
+  HashPolynomial poly(1);
+  Term term("2");
+  poly.add(LONG_MIN, term);
+  poly.add(-1L, term);
+  mpz_class expected = mpz_class(LONG_MIN) - 1;
+  ASSERT_EQ(getCoef(poly, term), expected);
+  poly.add(LONG_MIN, term);
+  expected += LONG_MIN;
+  ASSERT_EQ(getCoef(poly, term), expected);
+
+  poly.add(LONG_MAX, term);
+  poly.add(LONG_MAX, term);
+  poly.add(4L, term);
+  ASSERT_EQ(getCoef(poly, term), 1);
+}
+
+TEST(HashPolynomial, MpzCoefficients) {
+  mpz_class big;
+  mpz_ui_pow_ui(big.get_mpz_t(), 2, 100);
+
+  HashPolynomial poly(2);
+  poly.add(big, Term("1 1"));
+  poly.add(-big, Term("2 0"));
+  poly.add(big, Term("1 1"));
+  ASSERT_EQ(getCoef(poly, Term("1 1")), 2 * big);
+  ASSERT_EQ(getCoef(poly, Term("2 0")), -big);
+
+  // A big coefficient that becomes small.
+  poly.add(-2 * big + 7, Term("1 1"));
+  ASSERT_EQ(getCoef(poly, Term("1 1")), 7);
+
+  // A small coefficient that becomes big from adding an mpz_class.
+  poly.add(big, Term("1 1"));
+  ASSERT_EQ(getCoef(poly, Term("1 1")), big + 7);
+
+  // Adding an mpz_class that fits in a long.
+  poly.add(mpz_class(-7), Term("1 1"));
+  ASSERT_EQ(getCoef(poly, Term("1 1")), big);
+  ASSERT_EQ(poly.getTermCount(), 2u);
+}
+
+TEST(HashPolynomial, CancellationToZero) {
+  mpz_class big;
+  mpz_ui_pow_ui(big.get_mpz_t(), 2, 80);
+
+  HashPolynomial poly(1);
+  poly.add(true, Term("1"));
+  poly.add(false, Term("1"));
+  ASSERT_EQ(poly.getTermCount(), 0u);
+
+  // A small coefficient cancelled by a big one through a big sum.
+  poly.add(5L, Term("2"));
+  poly.add(big, Term("2"));
+  poly.add(-big - 5, Term("2"));
+  ASSERT_EQ(poly.getTermCount(), 0u);
+
+  // A coefficient that was promoted past LONG_MAX and cancels.
+  poly.add(LONG_MAX, Term("3"));
+  poly.add(LONG_MAX, Term("3"));
+  poly.add(LONG_MIN, Term("3"));
+  poly.add(LONG_MIN, Term("3"));
+  poly.add(2L, Term("3"));
+  ASSERT_EQ(poly.getTermCount(), 0u);
+
+  // The term can be added again after it has been erased.
+  poly.add(4L, Term("3"));
+  ASSERT_EQ(poly.getTermCount(), 1u);
+  ASSERT_EQ(getCoef(poly, Term("3")), 4);
+}
+
+TEST(HashPolynomial, Erase) {
+  // Many terms so that the table grows several times, and then
+  // erasing every other one moves the terms after each erased one.
+  // The result is checked against Polynomial, which collects terms by
+  // sorting them.
+  const size_t varCount = 3;
+  HashPolynomial poly(varCount);
+  Polynomial reference(varCount);
+  Term term(varCount);
+  unsigned long seed = 1;
+  for (size_t round = 0; round < 2; ++round) {
+    for (size_t index = 0; index < 2000; ++index) {
+      seed = seed * 1103515245 + 12345;
+      term[0] = index % 13;
+      term[1] = index / 13;
+      term[2] = (seed >> 16) % 2;
+      const long coef = round == 0 ?
+        static_cast<long>((seed >> 8) % 5) - 2 :
+        static_cast<long>(index % 2) - 1;
+      poly.add(coef, term);
+      reference.add(mpz_class(coef), term);
+    }
+  }
+  reference.sortTermsReverseLex(true);
+
+  Polynomial sorted;
+  getSorted(poly, sorted);
+  ASSERT_EQ(poly.getTermCount(), reference.getTermCount());
+  ASSERT_EQ(sorted.getTermCount(), reference.getTermCount());
+  for (size_t index = 0; index < reference.getTermCount(); ++index) {
+    ASSERT_EQ(sorted.getTerm(index), reference.getTerm(index));
+    ASSERT_EQ(sorted.getCoef(index), reference.getCoef(index));
+  }
+}
+
+TEST(HashPolynomial, AddPolynomial) {
+  HashPolynomial a(2);
+  HashPolynomial b(2);
+  a.add(LONG_MAX, Term("1 0"));
+  a.add(2L, Term("0 1"));
+  b.add(LONG_MAX, Term("1 0"));
+  b.add(-2L, Term("0 1"));
+  b.add(1L, Term("1 1"));
+  a.add(b);
+  ASSERT_EQ(a.getTermCount(), 2u);
+  ASSERT_EQ(getCoef(a, Term("1 0")), 2 * mpz_class(LONG_MAX));
+  ASSERT_EQ(getCoef(a, Term("1 1")), 1);
+}
@@ -0,0 +1,208 @@
+/* Frobby: Software for monomial ideal computations.
+   Copyright (C) 2009 University of Aarhus
+   Contact Bjarke Hammersholt Roune for license information (www.broune.com)
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see http://www.gnu.org/licenses/.
+*/
+#ifndef HASH_TABLE_SLOTS_GUARD
+#define HASH_TABLE_SLOTS_GUARD
+
+#include <vector>
+#include <utility>
+
+/** The slots of a hash table with open addressing that uses Robin
+ Hood hashing. This is the part that HashMap and HashPolynomial have in
+ common. It keeps track of which slots are in use and of the hash code
+ of the entry in each slot, while the owner keeps the entries
+ themselves in arrays indexed by slot.
+
+ Each entry is stored in the slot that its hash code points to or in
+ one of the slots after it, and the entries of a run of used slots
+ are in order of the slot that their hash code points to. So a search
+ can stop as soon as it reaches an entry that is closer to its slot
+ than the key being searched for would be. Inserting an entry moves
+ the entries after it one slot forward, and erasing an entry moves the
+ entries after it one slot back, so no tombstones are needed. The
+ owner is told about each such move through a callback move(from, to)
+ that has to move the entry in slot from to slot to, which is empty.
+
+ The owner grows the table when isFull() is true by making a new
+ table with getGrownSlotCount() slots and inserting the entries of the
+ old table into it. */
+class HashTableSlots {
+ public:
+  HashTableSlots(): _size(0), _shift(0) {}
+
+  /** Returns the hash code that a table uses for hashCode. Multiplying
+   by an odd constant and using the high bits spreads keys whose hash
+   codes differ only in a few bits over the whole table. */
+  static size_t mix(size_t hashCode) {
+    return hashCode * static_cast<size_t>(0x9E3779B97F4A7C15ULL);
+  }
+
+  size_t getSlotCount() const {return _slots.size();}
+  size_t size() const {return _size;}
+
+  bool isEmpty(size_t slot) const {return _slots[slot].distance == 0;}
+
+  size_t getHash(size_t slot) const {
+    ASSERT(!isEmpty(slot));
+    return _slots[slot].hash;
+  }
+
+  /** Returns true if the table has to grow before another entry can
+   be inserted. */
+  bool isFull() const {
+    return (_size + 1) * 16 > _slots.size() * MaxLoadPer16;
+  }
+
+  size_t getGrownSlotCount() const {
+    return _slots.empty() ? InitialSlotCount : 2 * _slots.size();
+  }
+
+  /** Makes the table have slotCount empty slots. slotCount must be a
+   power of two. */
+  void reset(size_t slotCount) {
+    ASSERT(slotCount > 0 && (slotCount & (slotCount - 1)) == 0);
+    Slot empty = {0, 0};
+    _slots.assign(slotCount, empty);
+    _size = 0;
+    _shift = 8 * sizeof(size_t);
+    for (size_t count = slotCount; count > 1; count /= 2)
+      --_shift;
+  }
+
+  /** Marks every slot as empty while keeping the number of slots. */
+  void clear() {
+    for (size_t slot = 0; slot < _slots.size(); ++slot)
+      _slots[slot].distance = 0;
+    _size = 0;
+  }
+
+  void swap(HashTableSlots& table) {
+    _slots.swap(table._slots);
+    std::swap(_size, table._size);
+    std::swap(_shift, table._shift);
+  }
+
+  /** Returns the first slot from slot on that is not empty, or the
+   number of slots if there is none. */
+  size_t nextEntry(size_t slot) const {
+    while (slot < _slots.size() && isEmpty(slot))
+      ++slot;
+    return slot;
+  }
+
+  /** Returns the slot of the entry with hash code hash for which
+   equals(slot) is true, or the number of slots if there is no such
+   entry. */
+  template<class Equals>
+  size_t find(size_t hash, const Equals& equals) const {
+    if (_size == 0)
+      return _slots.size();
+    const size_t mask = _slots.size() - 1;
+    size_t slot = hash >> _shift;
+    for (size_t distance = 1; _slots[slot].distance >= distance; ++distance) {
+      if (_slots[slot].hash == hash && equals(slot))
+        return slot;
+      slot = (slot + 1) & mask;
+    }
+    return _slots.size();
+  }
+
+  /** Makes room for a new entry with hash code hash and returns its
+   slot, which the owner then has to put the entry into. The entry
+   must not already be in the table, and isFull() must be false. */
+  template<class Move>
+  size_t insert(size_t hash, const Move& move) {
+    ASSERT(!isFull());
+    const size_t mask = _slots.size() - 1;
+
+    // Find the slot where the entry belongs, which is the first slot
+    // that is empty or whose entry is closer to its own slot.
+    size_t slot = hash >> _shift;
+    size_t distance = 1;
+    while (_slots[slot].distance >= distance) {
+      slot = (slot + 1) & mask;
+      ++distance;
+    }
+
+    if (!isEmpty(slot)) {
+      // Move the entries from slot up to the next empty slot forward
+      // by one, starting with the last one.
+      size_t end = slot;
+      while (!isEmpty(end))
+        end = (end + 1) & mask;
+      while (end != slot) {
+        const size_t from = (end - 1) & mask;
+        move(from, end);
+        _slots[end].hash = _slots[from].hash;
+        _slots[end].distance = _slots[from].distance + 1;
+        end = from;
+      }
+    }
+
+    _slots[slot].hash = hash;
+    _slots[slot].distance = distance;
+    ++_size;
+    return slot;
+  }
+
+  /** Empties slot, whose entry the owner must already have removed,
+   and moves the entries after it back by one until reaching an entry
+   that is in the slot that its hash code points to. */
+  template<class Move>
+  void erase(size_t slot, const Move& move) {
+    ASSERT(!isEmpty(slot));
+    const size_t mask = _slots.size() - 1;
+    size_t next = (slot + 1) & mask;
+    while (_slots[next].distance > 1) {
+      move(next, slot);
+      _slots[slot].hash = _slots[next].hash;
+      _slots[slot].distance = _slots[next].distance - 1;
+      slot = next;
+      next = (next + 1) & mask;
+    }
+    _slots[slot].distance = 0;
+    --_size;
+  }
+
+ private:
+  struct Slot {
+    /** The hash code of the entry after mixing. */
+    size_t hash;
+
+    /** Zero if the slot is empty. Otherwise one more than the number
+     of slots between the entry and the slot that its hash code points
+     to. */
+    size_t distance;
+  };
+
+  /** The table is full when more than this many of each 16 slots
+   would be in use. Runs of used slots get long as the table fills up,
+   and inserting or erasing moves every entry in the rest of the run,
+   which for HashPolynomial means copying whole terms. */
+  static const size_t MaxLoadPer16 = 11;
+
+  static const size_t InitialSlotCount = 16;
+
+  std::vector<Slot> _slots;
+  size_t _size;
+
+  /** The number of slots is 2 raised to the power of 8*sizeof(size_t)
+   minus _shift, or zero if there are no slots. */
+  size_t _shift;
+};
+
+#endif
@@ -24,6 +24,7 @@
 #include "ScarfFacade.h"
 #include "DataType.h"
 #include "ScarfParams.h"
+#include "CliParams.h"
 #include "error.h"
 
 HilbertAction::HilbertAction():
@@ -59,11 +60,26 @@ HilbertAction::HilbertAction():
   _params.add(_algorithm);
 
   addScarfParams(_params);
+  addResultCacheParam(_params);
+  addHilbertMemoParam(_params);
 }
 
 void HilbertAction::perform() {
+  if (_algorithm.getValue() != "slice") {
+    // Only the slice algorithm can checkpoint, so these options would
+    // otherwise be ignored without the user knowing.
+    if (!getString(_params, "checkpoint").empty())
+      reportError("Option -checkpoint is only supported for the slice "
+                  "algorithm.");
+    if (getBool(_params, "resume"))
+      reportError("Option -resume is only supported for the slice "
+                  "algorithm.");
+  }
+
   if (_algorithm.getValue() == "bigatti") {
     BigattiParams params(_params);
+    params.setInputFile(_in);
+    params.setOutputFile(_out);
     BigattiFacade facade(params);
     if (_univariate)
       facade.computeUnivariateHilbertSeries();
@@ -71,6 +87,8 @@ void HilbertAction::perform() {
       facade.computeMultigradedHilbertSeries();
   } else if (_algorithm.getValue() == "slice") {
     SliceParams params(_params);
+    params.setInputFile(_in);
+    params.setOutputFile(_out);
     validateSplit(params, false, false);
     SliceFacade sliceFacade(params, DataType::getPolynomialType());
     if (_univariate)
@@ -79,6 +97,8 @@ void HilbertAction::perform() {
       sliceFacade.computeMultigradedHilbertSeries();
   } else if (_algorithm.getValue() == "deform") {
     ScarfParams params(_params);
+    params.setInputFile(_in);
+    params.setOutputFile(_out);
     ScarfFacade facade(params);
     if (_univariate)
       facade.computeUnivariateHilbertSeries();
@@ -89,6 +109,10 @@ void HilbertAction::perform() {
                 _algorithm.getValue() + "\".");
 }
 
+bool HilbertAction::supportsBatch() const {
+  return true;
+}
+
 const char* HilbertAction::staticGetName() {
   return "hilbert";
 }
@@ -29,6 +29,8 @@ class HilbertAction : public Action {
 
   virtual void perform();
 
+  virtual bool supportsBatch() const;
+
   static const char* staticGetName();
 
  private:
@@ -23,6 +23,7 @@
 
 HilbertBasecase::HilbertBasecase():
   _idealCacheDeleter(_idealCache),
+  _sum(0),
   _stepsPerformed(0) {
 }
 
@@ -60,18 +61,12 @@ bool HilbertBasecase::stepComputation(Entry& entry, Entry& newEntry) {
     if (_term.isSquareFree()) {
       if ((entry.ideal->getGeneratorCount() % 2) == 1)
         entry.negate = !entry.negate;
-      if (entry.negate)
-        --_sum;
-      else
-        ++_sum;
+      addToSum(entry.negate ? -1 : 1);
       return false;
     }
 
     if (entry.ideal->getGeneratorCount() == 2) {
-      if (entry.negate)
-        --_sum;
-      else
-        ++_sum;
+      addToSum(entry.negate ? -1 : 1);
       return false;
     }
 
@@ -86,20 +81,14 @@ bool HilbertBasecase::stepComputation(Entry& entry, Entry& newEntry) {
     }
 
     if (entry.ideal->getGeneratorCount() == 3) {
-      if (entry.negate)
-        _sum -= 2;
-      else
-        _sum += 2;
+      addToSum(entry.negate ? -2 : 2);
       return false;
     }
 
     if (entry.ideal->getGeneratorCount() == 4 &&
         _term[_term.getFirstMaxExponent()] == 2 &&
         _term.getSizeOfSupport() == 4) {
-      if (entry.negate)
-        ++_sum;
-      else
-        --_sum;
+      addToSum(entry.negate ? 1 : -1);
       return false;
     }
 
@@ -134,6 +123,7 @@ void HilbertBasecase::computeCoefficient(Ideal& originalIdeal) {
   try { // Here to clear _todo in case of an exception
     // _sum is updated as a side-effect of calling stepComputation.
     _sum = 0;
+    _bigSum = 0;
 
     // _term is reused for several different purposes in order to avoid
     // having to allocate and deallocate the underlying data structure.
@@ -188,7 +178,16 @@ void HilbertBasecase::computeCoefficient(Ideal& originalIdeal) {
 }
 
 const mpz_class& HilbertBasecase::getLastCoefficient() {
-  return _sum;
+  _coef = _bigSum;
+  _coef += _sum;
+  return _coef;
+}
+
+bool HilbertBasecase::getLastCoefficient(long& coef) const {
+  if (_bigSum != 0)
+    return false;
+  coef = _sum;
+  return true;
 }
 
 bool HilbertBasecase::canSimplify(size_t var,
@@ -23,6 +23,7 @@ class Ideal;
 #include "ElementDeleter.h"
 
 #include <vector>
+#include <climits>
 
 class HilbertBasecase {
  public:
@@ -34,6 +35,11 @@ class HilbertBasecase {
 
   const mpz_class& getLastCoefficient();
 
+  /** Sets coef to the last coefficient and returns true if it fits in
+   a long. Otherwise returns false. This avoids GMP for the usual case
+   of a small coefficient. */
+  bool getLastCoefficient(long& coef) const;
+
  private:
   struct Entry {
     bool negate;
@@ -53,7 +59,23 @@ class HilbertBasecase {
   bool canSimplify(size_t var, const Ideal& ideal, const Term& counts);
   size_t eliminate1Counts(Ideal& ideal, Term& counts, bool& negate);
 
-  mpz_class _sum;
+  /** Adds delta to the coefficient being computed. */
+  void addToSum(long delta) {
+    _sum += delta;
+    if (_sum > MaxSmallSum || _sum < -MaxSmallSum) {
+      _bigSum += _sum;
+      _sum = 0;
+    }
+  }
+  static const long MaxSmallSum = LONG_MAX / 2;
+
+  /** The coefficient being computed is _bigSum plus _sum. The sum is
+   kept in _sum until it gets too large for a long, which it almost
+   never does, so that the inner loop does not use GMP. */
+  long _sum;
+  mpz_class _bigSum;
+  mpz_class _coef;
+
   Term _term;
   size_t _stepsPerformed;
 };
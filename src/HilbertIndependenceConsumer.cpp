@@ -19,22 +19,29 @@
 
 #include "IndependenceSplitter.h"
 #include "HilbertStrategy.h"
+#include "HilbertSlice.h"
 
 HilbertIndependenceConsumer::
 HilbertIndependenceConsumer(HilbertStrategy* strategy):
   _rightConsumer(this),
-  _strategy(strategy) {
+  _strategy(strategy),
+  _synchronize(false) {
   ASSERT(strategy != 0);
   clear();
 }
 
+HilbertIndependenceConsumer::~HilbertIndependenceConsumer() {
+}
+
 void HilbertIndependenceConsumer::reset(CoefTermConsumer* parent,
                                         IndependenceSplitter& splitter,
-                                        size_t varCount) {
+                                        size_t varCount,
+                                        bool synchronize) {
   ASSERT(parent != 0);
 
   _tmpTerm.reset(varCount);
   _parent = parent;
+  _synchronize = synchronize;
 
   splitter.getBigProjection(_leftProjection);
   splitter.getRestProjection(_rightProjection);
@@ -46,6 +53,13 @@ void HilbertIndependenceConsumer::clear() {
   _parent = 0;
   _rightTerms.clear();
   _rightCoefs.clear();
+  if (_leftSlice.get() != 0)
+    _strategy->freeSlice(std::move(_leftSlice));
+}
+
+void HilbertIndependenceConsumer::setLeftSlice
+(unique_ptr<HilbertSlice> leftSlice) {
+  _leftSlice = std::move(leftSlice);
 }
 
 void HilbertIndependenceConsumer::dispose() {
@@ -53,8 +67,16 @@ void HilbertIndependenceConsumer::dispose() {
   _strategy->freeConsumer(unique_ptr<HilbertIndependenceConsumer>(this));
 }
 
-void HilbertIndependenceConsumer::run(TaskEngine&) {
-  dispose();
+void HilbertIndependenceConsumer::run(TaskEngine& engine) {
+  if (_leftSlice.get() == 0) {
+    // Both slices are done.
+    dispose();
+    return;
+  }
+
+  // The right slice is done, so run the left slice and then run this
+  // object again.
+  engine.addTask(_leftSlice.release(), this);
 }
 
 CoefTermConsumer* HilbertIndependenceConsumer::getLeftConsumer() {
@@ -119,6 +141,10 @@ void HilbertIndependenceConsumer::consumeLeft(const mpz_class& leftCoef,
          _leftProjection.getRangeVarCount() +
          _rightProjection.getRangeVarCount());
 
+  std::unique_lock<std::mutex> lock(_mutex, std::defer_lock);
+  if (_synchronize)
+    lock.lock();
+
   _leftProjection.inverseProject(_tmpTerm, leftTerm);
 
   size_t rightSize = _rightTerms.getGeneratorCount();
@@ -141,6 +167,10 @@ void HilbertIndependenceConsumer::consumeRight(const mpz_class& coef,
   ASSERT(_rightTerms.getVarCount() == term.getVarCount());
   ASSERT(coef != 0);
 
+  std::unique_lock<std::mutex> lock(_mutex, std::defer_lock);
+  if (_synchronize)
+    lock.lock();
+
   _rightTerms.insert(term);
   _rightCoefs.push_back(coef);
 }
@@ -24,20 +24,31 @@
 #include "Task.h"
 
 #include <vector>
+#include <mutex>
 
 class IndependenceSplitter;
 class HilbertStrategy;
+class HilbertSlice;
 
 class HilbertIndependenceConsumer : public CoefTermConsumer, public Task {
 public:
   HilbertIndependenceConsumer(HilbertStrategy* strategy);
+  ~HilbertIndependenceConsumer();
 
+  /** If synchronize is true, then consuming terms is safe to do from
+   several threads at once. */
   void reset(CoefTermConsumer* parent,
              IndependenceSplitter& splitter,
-             size_t varCount);
+             size_t varCount,
+             bool synchronize);
 
   void clear();
 
+  /** The left slice is run once this object is run the first time,
+   which happens when the right slice is done. This object is then run
+   again once the left slice is done. */
+  void setLeftSlice(unique_ptr<HilbertSlice> leftSlice);
+
   virtual void run(TaskEngine& engine);
   virtual void dispose();
 
@@ -85,6 +96,10 @@ private:
   RightConsumer _rightConsumer;
 
   HilbertStrategy* _strategy;
+
+  unique_ptr<HilbertSlice> _leftSlice;
+  bool _synchronize;
+  std::mutex _mutex;
 };
 
 #endif
@@ -0,0 +1,337 @@
+/* Frobby: Software for monomial ideal computations.
+   Copyright (C) 2007 Bjarke Hammersholt Roune (www.broune.com)
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see http://www.gnu.org/licenses/.
+*/
+#include "stdinc.h"
+#include "HilbertMemo.h"
+
+#include "Ideal.h"
+#include "CoefTermConsumer.h"
+#include "TermPredicate.h"
+
+#include <algorithm>
+
+namespace {
+  /** Mixes the bits of a, b and c into a value that is as likely as
+   possible to differ for different parameters. */
+  size_t mix(size_t a, size_t b, size_t c) {
+    uint64_t h = (uint64_t)a * 0x9E3779B97F4A7C15ull;
+    h ^= (uint64_t)b + 0xBF58476D1CE4E5B9ull + (h << 6) + (h >> 2);
+    h ^= (uint64_t)c + 0x94D049BB133111EBull + (h << 6) + (h >> 2);
+    h ^= h >> 31;
+    return (size_t)h;
+  }
+
+  class SignatureOrder {
+  public:
+    SignatureOrder(const vector<size_t>& signatures):
+      _signatures(signatures) {}
+
+    bool operator()(size_t a, size_t b) const {
+      if (_signatures[a] != _signatures[b])
+        return _signatures[a] < _signatures[b];
+      return a < b;
+    }
+
+  private:
+    const vector<size_t>& _signatures;
+  };
+}
+
+void HilbertMemoKey::set(const Ideal& ideal, const Ideal* subtract) {
+  ASSERT(subtract == 0 || subtract->getVarCount() == ideal.getVarCount());
+
+  computeOrder(ideal, subtract);
+
+  size_t size = 2 + ideal.getGeneratorCount() * ideal.getVarCount();
+  if (subtract != 0)
+    size += 1 + subtract->getGeneratorCount() * subtract->getVarCount();
+  _data.clear();
+  _data.reserve(size);
+  _data.push_back(ideal.getVarCount());
+  append(ideal);
+  if (subtract != 0)
+    append(*subtract);
+}
+
+void HilbertMemoKey::toKeyOrder(Exponent* keyTerm,
+                                const Exponent* term) const {
+  for (size_t pos = 0; pos < _order.size(); ++pos)
+    keyTerm[pos] = term[_order[pos]];
+}
+
+void HilbertMemoKey::fromKeyOrder(Exponent* term,
+                                  const Exponent* keyTerm) const {
+  for (size_t pos = 0; pos < _order.size(); ++pos)
+    term[_order[pos]] = keyTerm[pos];
+}
+
+void HilbertMemoKey::swap(HilbertMemoKey& key) {
+  _data.swap(key._data);
+  _order.swap(key._order);
+}
+
+size_t HilbertMemoKey::getMemoryUse() const {
+  return _data.capacity() * sizeof(Exponent) +
+    _order.capacity() * sizeof(size_t);
+}
+
+void HilbertMemoKey::computeOrder(const Ideal& ideal,
+                                  const Ideal* subtract) {
+  // The order of the variables is given by a signature of each
+  // variable that does not depend on the order of the variables or
+  // the generators. Variables with the same signature are ordered as
+  // they are, so ideals that only differ by a permutation of such
+  // variables can get different keys. That only costs a miss.
+  _signatures.assign(ideal.getVarCount(), 0);
+  addSignatures(ideal, 1);
+  if (subtract != 0)
+    addSignatures(*subtract, 2);
+  refineSignatures(ideal);
+
+  _order.resize(ideal.getVarCount());
+  for (size_t var = 0; var < _order.size(); ++var)
+    _order[var] = var;
+  std::sort(_order.begin(), _order.end(), SignatureOrder(_signatures));
+}
+
+void HilbertMemoKey::addSignatures(const Ideal& ideal, size_t salt) {
+  const size_t varCount = ideal.getVarCount();
+  Ideal::const_iterator end = ideal.end();
+  for (Ideal::const_iterator it = ideal.begin(); it != end; ++it) {
+    const size_t support = Term::getSizeOfSupport(*it, varCount);
+    for (size_t var = 0; var < varCount; ++var)
+      if ((*it)[var] != 0)
+        _signatures[var] += mix(salt, (*it)[var], support);
+  }
+}
+
+void HilbertMemoKey::refineSignatures(const Ideal& ideal) {
+  const size_t varCount = ideal.getVarCount();
+  _refined.assign(varCount, 0);
+  Ideal::const_iterator end = ideal.end();
+  for (Ideal::const_iterator it = ideal.begin(); it != end; ++it) {
+    size_t sum = 0;
+    for (size_t var = 0; var < varCount; ++var)
+      if ((*it)[var] != 0)
+        sum += _signatures[var];
+    for (size_t var = 0; var < varCount; ++var)
+      if ((*it)[var] != 0)
+        _refined[var] += mix(3, (*it)[var], sum);
+  }
+  for (size_t var = 0; var < varCount; ++var)
+    _signatures[var] = mix(4, _signatures[var], _refined[var]);
+}
+
+void HilbertMemoKey::append(const Ideal& ideal) {
+  ASSERT(!_data.empty() && _data.front() == ideal.getVarCount());
+  ASSERT(_order.size() == ideal.getVarCount());
+  const size_t varCount = ideal.getVarCount();
+
+  _permuted.resize(ideal.getGeneratorCount() * varCount);
+  for (size_t gen = 0; gen < ideal.getGeneratorCount(); ++gen)
+    toKeyOrder(&_permuted[gen * varCount], ideal[gen]);
+
+  _sorted.resize(ideal.getGeneratorCount());
+  for (size_t gen = 0; gen < ideal.getGeneratorCount(); ++gen)
+    _sorted[gen] = &_permuted[gen * varCount];
+  std::sort(_sorted.begin(), _sorted.end(), LexComparator(varCount));
+
+  // The generator count separates the ideal from the subtract ideal.
+  _data.push_back(ideal.getGeneratorCount());
+  for (size_t i = 0; i < _sorted.size(); ++i)
+    _data.insert(_data.end(), _sorted[i], _sorted[i] + varCount);
+}
+
+HilbertMemo::HilbertMemo():
+  _maxMemoryUse(0),
+  _memoryUse(0),
+  _lookupCount(0),
+  _hitCount(0),
+  _storeCount(0),
+  _evictCount(0),
+  _tooLargeCount(0) {
+}
+
+void HilbertMemo::setMaxMemoryUse(size_t bytes) {
+  _maxMemoryUse = bytes;
+}
+
+bool HilbertMemo::lookup(const HilbertMemoKey& key,
+                         const Term& multiply,
+                         CoefTermConsumer& consumer) {
+  ASSERT(isOn());
+
+  shared_ptr<const Entry> entry;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    ++_lookupCount;
+    EntryMap::iterator it = _entries.find(key);
+    if (it == _entries.end())
+      return false;
+    ++_hitCount;
+    _lru.splice(_lru.begin(), _lru, it->second);
+    entry = *it->second;
+  }
+
+  const size_t varCount = multiply.getVarCount();
+  ASSERT(entry->terms.size() == entry->coefs.size() * varCount);
+  Term term(varCount);
+  for (size_t i = 0; i < entry->coefs.size(); ++i) {
+    key.fromKeyOrder(term, &entry->terms[i * varCount]);
+    term.product(term, multiply);
+    consumer.consume(entry->coefs[i], term);
+  }
+  return true;
+}
+
+void HilbertMemo::store(HilbertMemoKey& key,
+                        vector<Exponent>& terms,
+                        vector<mpz_class>& coefs) {
+  ASSERT(isOn());
+  ASSERT(terms.size() == coefs.size() * key.getVarCount());
+
+  shared_ptr<Entry> entry(new Entry());
+  entry->key.swap(key);
+  entry->terms.swap(terms);
+  entry->coefs.swap(coefs);
+  entry->terms.shrink_to_fit();
+  entry->coefs.shrink_to_fit();
+  terms.clear();
+  coefs.clear();
+  insert(entry);
+}
+
+void HilbertMemo::store(HilbertMemoKey& key, const mpz_class& coef) {
+  ASSERT(isOn());
+
+  shared_ptr<Entry> entry(new Entry());
+  entry->key.swap(key);
+  if (coef != 0) {
+    entry->terms.resize(entry->key.getVarCount());
+    entry->coefs.push_back(coef);
+  }
+  insert(entry);
+}
+
+void HilbertMemo::insert(const shared_ptr<const Entry>& entry) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (_entries.find(entry->key) != _entries.end())
+    return; // Another thread stored the same contribution first.
+
+  _lru.push_front(entry);
+  try {
+    _entries[entry->key] = _lru.begin();
+  } catch (...) {
+    _lru.pop_front();
+    throw;
+  }
+  ++_storeCount;
+  _memoryUse += getMemoryUse(*entry);
+
+  while (_memoryUse > _maxMemoryUse) {
+    ASSERT(!_lru.empty());
+    const Entry& evict = *_lru.back();
+    _memoryUse -= getMemoryUse(evict);
+    _entries.erase(evict.key);
+    _lru.pop_back();
+    ++_evictCount;
+  }
+}
+
+size_t HilbertMemo::getMemoryUse(const Entry& entry) {
+  // This includes an estimate of the overhead of the list, the hash
+  // table and of each allocation.
+  const size_t allocationOverhead = 2 * sizeof(void*);
+  size_t bytes = sizeof(Entry) + 16 * sizeof(void*) + entry.key.getMemoryUse();
+  bytes += entry.terms.capacity() * sizeof(Exponent);
+  bytes += entry.coefs.capacity() * sizeof(mpz_class);
+  for (size_t i = 0; i < entry.coefs.size(); ++i) {
+    const size_t limbs = entry.coefs[i].get_mpz_t()->_mp_alloc;
+    bytes += limbs * sizeof(mp_limb_t) + allocationOverhead;
+  }
+  return bytes;
+}
+
+void HilbertMemo::noteTooLarge() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  ++_tooLargeCount;
+}
+
+void HilbertMemo::printReport(FILE* out) const {
+  std::lock_guard<std::mutex> lock(_mutex);
+
+  fputs("|-memo of sub-slices:\n", out);
+  fprintf(out, " | %lu lookups\n", (unsigned long)_lookupCount);
+  fprintf(out, " | %lu hits (%.1f%%)\n", (unsigned long)_hitCount,
+          _lookupCount == 0 ? 0.0 : 100.0 * _hitCount / _lookupCount);
+  fprintf(out, " | %lu contributions stored\n", (unsigned long)_storeCount);
+  fprintf(out, " | %lu contributions evicted\n", (unsigned long)_evictCount);
+  fprintf(out, " | %lu contributions too large to store\n",
+          (unsigned long)_tooLargeCount);
+  fprintf(out, " | %lu contributions kept using about %lu bytes\n",
+          (unsigned long)_lru.size(), (unsigned long)_memoryUse);
+}
+
+HilbertMemoRecorder::HilbertMemoRecorder(HilbertMemo& memo,
+                                         HilbertMemoKey& key,
+                                         const Term& multiply,
+                                         HilbertMemoRecorder* parent,
+                                         bool synchronize):
+  _memo(memo),
+  _multiply(multiply),
+  _parent(parent),
+  _tmp(multiply.getVarCount()),
+  _tooLarge(false),
+  _synchronize(synchronize) {
+  ASSERT(key.getVarCount() == multiply.getVarCount());
+  _key.swap(key);
+}
+
+void HilbertMemoRecorder::record(const mpz_class& coef, const Term& term) {
+  if (_parent != 0)
+    _parent->record(coef, term);
+
+  std::unique_lock<std::mutex> lock(_mutex, std::defer_lock);
+  if (_synchronize)
+    lock.lock();
+
+  if (_tooLarge)
+    return;
+  if (_coefs.size() == HilbertMemo::MaxTermCount) {
+    _tooLarge = true;
+    _terms.clear();
+    _coefs.clear();
+    return;
+  }
+
+  ASSERT(_multiply.divides(term));
+  _tmp.colon(term, _multiply);
+  _terms.resize(_terms.size() + _tmp.getVarCount());
+  _key.toKeyOrder(&_terms[_terms.size() - _tmp.getVarCount()], _tmp);
+  _coefs.push_back(coef);
+}
+
+void HilbertMemoRecorder::run(TaskEngine& engine) {
+  unique_ptr<HilbertMemoRecorder> deleter(this);
+  if (_tooLarge)
+    _memo.noteTooLarge();
+  else
+    _memo.store(_key, _terms, _coefs);
+}
+
+void HilbertMemoRecorder::dispose() {
+  delete this;
+}
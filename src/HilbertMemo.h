@@ -0,0 +1,233 @@
+/* Frobby: Software for monomial ideal computations.
+   Copyright (C) 2007 Bjarke Hammersholt Roune (www.broune.com)
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see http://www.gnu.org/licenses/.
+*/
+#ifndef HILBERT_MEMO_GUARD
+#define HILBERT_MEMO_GUARD
+
+#include "Term.h"
+#include "HashMap.h"
+#include "Task.h"
+
+#include <vector>
+#include <list>
+#include <mutex>
+#include <memory>
+
+class Ideal;
+class CoefTermConsumer;
+
+/** Identifies a sub-computation of a Hilbert-Poincare series
+ computation up to the multiply term and up to the order of the
+ variables. This is an ideal, and for a slice that is not a base case
+ also a subtract ideal, with the variables put in an order that
+ depends only on the generators and with the generators of each ideal
+ sorted and written one after the other.
+
+ Sub-computations that differ only by a permutation of the variables
+ are common for ideals with a lot of symmetry, and they usually get
+ the same key. Two sub-computations that get the same key always
+ differ only by a permutation of the variables, so a contribution
+ that is stored for one of them can be used for the other by
+ permuting the variables of its terms. */
+class HilbertMemoKey {
+ public:
+  /** Sets this key to identify ideal and subtract. Subtract can be
+   null, which is used for base cases. */
+  void set(const Ideal& ideal, const Ideal* subtract);
+
+  /** Sets keyTerm to term with the variables in the order of the
+   key. */
+  void toKeyOrder(Exponent* keyTerm, const Exponent* term) const;
+
+  /** Sets term to keyTerm with the variables put back from the order
+   of the key. */
+  void fromKeyOrder(Exponent* term, const Exponent* keyTerm) const;
+
+  bool operator==(const HilbertMemoKey& key) const {
+    return _data == key._data;
+  }
+
+  size_t getHashCode() const {
+    return Term::getHashCode(_data.data(), _data.size());
+  }
+
+  void swap(HilbertMemoKey& key);
+
+  size_t getVarCount() const {return _order.size();}
+
+  /** Returns the number of bytes of memory used by the key, not
+   counting memory used only while it is being set. */
+  size_t getMemoryUse() const;
+
+ private:
+  void computeOrder(const Ideal& ideal, const Ideal* subtract);
+  void addSignatures(const Ideal& ideal, size_t salt);
+  void refineSignatures(const Ideal& ideal);
+  void append(const Ideal& ideal);
+
+  vector<Exponent> _data;
+
+  /** The variable at each position of the order of the key. */
+  vector<size_t> _order;
+
+  vector<size_t> _signatures;
+  vector<size_t> _refined;
+  vector<Exponent> _permuted;
+  vector<const Exponent*> _sorted;
+};
+
+template<>
+class FrobbyHash<HilbertMemoKey> {
+ public:
+  size_t operator()(const HilbertMemoKey& key) const {
+    return key.getHashCode();
+  }
+};
+
+/** A bounded table from sub-computations of a Hilbert-Poincare series
+ computation to their contribution to the numerator, so that a
+ sub-computation that comes up again in another branch of the
+ computation does not have to be done again.
+
+ The contribution of a sub-computation is a polynomial that is
+ multiplied by the multiply term of the sub-computation, so the
+ contribution is stored divided by the multiply term and multiplied
+ by the multiply term of whichever sub-computation looks it up. When
+ the table is full, the entry that was least recently looked up or
+ stored is evicted. It is safe to use the table from several threads
+ at once. */
+class HilbertMemo {
+ public:
+  /** The table is off until the maximum memory use is set to more
+   than zero. */
+  HilbertMemo();
+
+  /** Sets the approximate maximum number of bytes of memory that the
+   entries of the table use. This must not be called while the table
+   is in use. */
+  void setMaxMemoryUse(size_t bytes);
+
+  bool isOn() const {return _maxMemoryUse > 0;}
+
+  /** Contributions with more terms than this are not stored, since
+   recording them takes memory in every sub-computation that is being
+   recorded at the time. */
+  static const size_t MaxTermCount = 1024;
+
+  /** If key has an entry, then outputs the contribution in the entry
+   with its variables put back from the order of key and times
+   multiply to consumer and returns true. Otherwise returns false. */
+  bool lookup(const HilbertMemoKey& key,
+              const Term& multiply,
+              CoefTermConsumer& consumer);
+
+  /** Stores the terms with coefficients coefs as the contribution for
+   key. The terms are written one after the other in terms, and they
+   must have their variables in the order of the key. The parameters
+   are cleared. */
+  void store(HilbertMemoKey& key,
+             vector<Exponent>& terms,
+             vector<mpz_class>& coefs);
+
+  /** Stores the single term coef*1 as the contribution for key. Key is
+   cleared. This is for base cases. */
+  void store(HilbertMemoKey& key, const mpz_class& coef);
+
+  /** Notes that a contribution was not stored because it had more
+   than MaxTermCount terms. */
+  void noteTooLarge();
+
+  /** Prints statistics on the use of the table to out. */
+  void printReport(FILE* out) const;
+
+ private:
+  struct Entry {
+    HilbertMemoKey key;
+    vector<Exponent> terms;
+    vector<mpz_class> coefs;
+  };
+
+  /** Entries are immutable once stored, so they are shared to be able
+   to output an entry without holding the lock. */
+  typedef list<shared_ptr<const Entry> > LruList;
+  typedef HashMap<HilbertMemoKey, LruList::iterator> EntryMap;
+
+  /** Adds entry unless its key already has an entry. Evicts least
+   recently used entries until the table uses no more than the
+   maximum memory. */
+  void insert(const shared_ptr<const Entry>& entry);
+
+  static size_t getMemoryUse(const Entry& entry);
+
+  size_t _maxMemoryUse;
+  size_t _memoryUse;
+
+  /** The entries with the most recently used at the front. */
+  LruList _lru;
+  EntryMap _entries;
+
+  size_t _lookupCount;
+  size_t _hitCount;
+  size_t _storeCount;
+  size_t _evictCount;
+  size_t _tooLargeCount;
+
+  mutable std::mutex _mutex;
+};
+
+/** Records the contribution of a sub-computation as it is output,
+ and stores it in a memo table when it is run as a task. Add it as
+ the continuation of the sub-computation, so that it runs once the
+ sub-computation and everything it leads to are done. Recorders are
+ allocated with new and delete themselves when they are run or
+ disposed. */
+class HilbertMemoRecorder : public Task {
+ public:
+  /** Records the contribution for key, which is cleared, of a
+   sub-computation with the given multiply term. If parent is not
+   null, then each term that is recorded is recorded by parent as
+   well. If synchronize is true, then terms can be recorded from
+   several threads at once. */
+  HilbertMemoRecorder(HilbertMemo& memo,
+                      HilbertMemoKey& key,
+                      const Term& multiply,
+                      HilbertMemoRecorder* parent,
+                      bool synchronize);
+
+  /** Records coef*term, which must be a multiple of the multiply
+   term. Stops recording, except for the parent, if the contribution
+   gets more than HilbertMemo::MaxTermCount terms. */
+  void record(const mpz_class& coef, const Term& term);
+
+  virtual void run(TaskEngine& engine);
+  virtual void dispose();
+
+ private:
+  HilbertMemo& _memo;
+  HilbertMemoKey _key;
+  const Term _multiply;
+  HilbertMemoRecorder* _parent;
+
+  Term _tmp;
+  vector<Exponent> _terms;
+  vector<mpz_class> _coefs;
+  bool _tooLarge;
+
+  bool _synchronize;
+  std::mutex _mutex;
+};
+
+#endif
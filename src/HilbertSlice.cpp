@@ -23,14 +23,16 @@
 
 HilbertSlice::HilbertSlice(HilbertStrategy& strategy):
   Slice(strategy),
-  _consumer(0) {
+  _consumer(0),
+  _isBeingRecorded(false) {
 }
 
 HilbertSlice::HilbertSlice(HilbertStrategy& strategy,
                            const Ideal& ideal, const Ideal& subtract,
                            const Term& multiply, CoefTermConsumer* consumer):
   Slice(strategy, ideal, subtract, multiply),
-  _consumer(consumer) {
+  _consumer(consumer),
+  _isBeingRecorded(false) {
   ASSERT(consumer != 0);
 }
 
@@ -47,6 +49,19 @@ bool HilbertSlice::baseCase(bool simplified) {
   if (_varCount == 0)
     return true;
 
+  // Base cases that differ only by a permutation of the variables
+  // have the same coefficient, and such base cases are common for
+  // ideals with a lot of symmetry.
+  HilbertMemo& memo = static_cast<HilbertStrategy&>(_strategy).getMemo();
+  HilbertMemoKey key;
+  if (memo.isOn()) {
+    key.set(_ideal, 0);
+    if (memo.lookup(key, getMultiply(), *_consumer)) {
+      clearIdealAndSubtract();
+      return true;
+    }
+  }
+
   // TODO: find a way other than static to use the same basecase
   // object every time, instead of allocating a new one. This provides
   // around a 4% speed-up, at least on Cygwin. We cannot use static
@@ -54,10 +69,14 @@ bool HilbertSlice::baseCase(bool simplified) {
   // crashes on Mac OS X.
   HilbertBasecase basecase;
   basecase.computeCoefficient(_ideal);
-  const mpz_class& coef = basecase.getLastCoefficient();
-
-  if (coef != 0)
-    _consumer->consume(coef, getMultiply());
+  long smallCoef;
+  if (basecase.getLastCoefficient(smallCoef)) {
+    if (smallCoef != 0)
+      _consumer->consume(smallCoef, getMultiply());
+  } else
+    _consumer->consume(basecase.getLastCoefficient(), getMultiply());
+  if (memo.isOn())
+    memo.store(key, basecase.getLastCoefficient());
   clearIdealAndSubtract();
   return true;
 }
@@ -67,6 +86,7 @@ Slice& HilbertSlice::operator=(const Slice& slice) {
 
   Slice::operator=(slice);
   _consumer = ((HilbertSlice&)slice)._consumer;
+  _isBeingRecorded = false;
   return *this;
 }
 
@@ -85,11 +105,13 @@ void HilbertSlice::setToProjOf(const Slice& slice,
 
   Slice::setToProjOf(slice, projection);
   _consumer = consumer;
+  _isBeingRecorded = false;
 }
 
 void HilbertSlice::swap(HilbertSlice& slice) {
   Slice::swap(slice);
   std::swap(_consumer, slice._consumer);
+  std::swap(_isBeingRecorded, slice._isBeingRecorded);
 }
 
 bool HilbertSlice::getLowerBound(Term& bound, size_t var) const {
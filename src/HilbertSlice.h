@@ -34,6 +34,13 @@ class HilbertSlice : public Slice {
                CoefTermConsumer* consumer);
 
   CoefTermConsumer* getConsumer() {return _consumer;}
+  void setConsumer(CoefTermConsumer* consumer) {_consumer = consumer;}
+
+  /** Returns true if the contribution of this slice is being recorded
+   for the memo table of HilbertStrategy, and the slice has not yet
+   been processed since then. */
+  bool isBeingRecorded() const {return _isBeingRecorded;}
+  void setIsBeingRecorded(bool value) {_isBeingRecorded = value;}
 
   // *** Mutators
 
@@ -57,6 +64,7 @@ class HilbertSlice : public Slice {
   virtual bool getLowerBound(Term& bound, size_t var) const;
 
   CoefTermConsumer* _consumer;
+  bool _isBeingRecorded;
 };
 
 
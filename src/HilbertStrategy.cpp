@@ -25,13 +25,149 @@
 #include "IndependenceSplitter.h"
 #include "HilbertIndependenceConsumer.h"
 #include "ElementDeleter.h"
+#include "ConcurrentHashPolynomial.h"
+
+#include <cstring>
+
+namespace {
+  /** Slices whose ideal has more generators than this are not looked
+   up in the memo table. Such large slices rarely come up more than
+   once, their contribution is usually too large to store, and
+   recording them would add to the cost of every term output
+   below them. */
+  const size_t MaxMemoGeneratorCount = 64;
+
+  /** The number of shards of the polynomial that the output is
+   collected in for each thread when running in parallel. */
+  const size_t ShardsPerThread = 16;
+
+  /** Adds terms to a polynomial that several threads can add to at
+   the same time, so that slices that are processed on different
+   threads can all output to the same consumer without waiting for
+   each other. */
+  class ConcurrentPolynomialConsumer : public CoefTermConsumer {
+  public:
+    ConcurrentPolynomialConsumer(ConcurrentHashPolynomial& poly):
+      _poly(poly) {
+    }
+
+    virtual void consumeRing(const VarNames& names) {
+    }
+
+    virtual void beginConsuming() {
+    }
+
+    virtual void consume(const mpz_class& coef, const Term& term) {
+      _poly.add(coef, term);
+    }
+
+    virtual void consume(long coef, const Term& term) {
+      _poly.add(coef, term);
+    }
+
+    virtual void doneConsuming() {
+    }
+
+  private:
+    ConcurrentHashPolynomial& _poly;
+  };
+
+  /** Passes the terms that a slice and its sub-slices output on to the
+   consumer of the slice while recording them as the contribution of
+   the slice. */
+  class MemoRecorder : public HilbertMemoRecorder, public CoefTermConsumer {
+  public:
+    MemoRecorder(HilbertMemo& memo,
+                 HilbertMemoKey& key,
+                 const Term& multiply,
+                 CoefTermConsumer& parent,
+                 bool synchronize):
+      HilbertMemoRecorder(memo, key, multiply, 0, synchronize),
+      _parent(parent) {
+    }
+
+    virtual void consumeRing(const VarNames& names) {
+    }
+
+    virtual void beginConsuming() {
+    }
+
+    virtual void consume(const mpz_class& coef, const Term& term) {
+      record(coef, term);
+      _parent.consume(coef, term);
+    }
+
+    virtual void doneConsuming() {
+    }
+
+  private:
+    CoefTermConsumer& _parent;
+  };
+
+  /** Tells a result of a work unit whose coefficient fits in a long
+   from one that is written out with mpz_export. */
+  const char LongCoef = 'L';
+  const char BigCoef = 'B';
+
+  /** Sends the terms of a work unit on as results of the unit. A
+   result is the exponents of the term followed by the coefficient. */
+  class UnitResultConsumer : public CoefTermConsumer {
+  public:
+    UnitResultConsumer(const SliceStrategyCommon::ResultSender& sendResult):
+      _sendResult(sendResult) {
+    }
+
+    virtual void consumeRing(const VarNames& names) {
+    }
+
+    virtual void beginConsuming() {
+    }
+
+    virtual void consume(const mpz_class& coef, const Term& term) {
+      if (coef.fits_slong_p()) {
+        consume(coef.get_si(), term);
+        return;
+      }
+
+      appendTerm(term, BigCoef);
+      _result += static_cast<char>(sgn(coef));
+      const size_t offset = _result.size();
+      _result.resize
+        (offset + (mpz_sizeinbase(coef.get_mpz_t(), 2) + 7) / 8);
+      size_t written;
+      mpz_export(&_result[offset], &written, 1, 1, 0, 0, coef.get_mpz_t());
+      ASSERT(offset + written == _result.size());
+      _sendResult(_result.data(), _result.size());
+    }
+
+    virtual void consume(long coef, const Term& term) {
+      appendTerm(term, LongCoef);
+      _result.append(reinterpret_cast<const char*>(&coef), sizeof(coef));
+      _sendResult(_result.data(), _result.size());
+    }
+
+    virtual void doneConsuming() {
+    }
+
+  private:
+    void appendTerm(const Term& term, char coefKind) {
+      _result.assign(reinterpret_cast<const char*>(term.begin()),
+                     term.getVarCount() * sizeof(Exponent));
+      _result += coefKind;
+    }
+
+    const SliceStrategyCommon::ResultSender& _sendResult;
+    string _result;
+  };
+}
 
 HilbertStrategy::HilbertStrategy(CoefTermConsumer* consumer,
                                  const SplitStrategy* splitStrategy):
   SliceStrategyCommon(splitStrategy),
   _consumerCache(),
   _consumerCacheDeleter(_consumerCache),
-  _consumer(consumer) {
+  _consumer(consumer),
+  _unitConsumer(0) {
 }
 
 void HilbertStrategy::run(const Ideal& ideal) {
@@ -53,14 +189,36 @@ void HilbertStrategy::run(const Ideal& ideal) {
     }
   }
 
+  // When running in parallel, on several processes or with
+  // checkpoints, the output is collected and passed on to _consumer
+  // once all slices are done. Collecting the output also adds
+  // together terms that are output more than once.
+  ConcurrentHashPolynomial output
+    (varCount, isParallel() ? ShardsPerThread * _tasks.getThreadCount() : 1);
+  ConcurrentPolynomialConsumer outputConsumer(output);
+  CoefTermConsumer* consumer = _consumer;
+  if (isParallel() || getProcessCount() > 1 || usesCheckpoints())
+    consumer = &outputConsumer;
+
   unique_ptr<Slice> slice
     (new HilbertSlice(*this, sliceIdeal, Ideal(varCount),
-                      Term(varCount), _consumer));
+                      Term(varCount), consumer));
 
   simplify(*slice);
-  _tasks.addTask(slice.release());
-  _tasks.runTasks();
+  if (usesCheckpoints() || getProcessCount() > 1) {
+    _unitConsumer = consumer;
+    _unitTerm.reset(varCount);
+    if (usesCheckpoints())
+      runWithCheckpoints(std::move(slice), "hilbert");
+    else
+      runInProcesses(std::move(slice));
+  } else {
+    _tasks.addTask(slice.release());
+    _tasks.runTasks();
+  }
   _consumerCacheDeleter.deleteElements();
+
+  output.feedTermsTo(*_consumer);
 }
 
 bool HilbertStrategy::processSlice
@@ -68,12 +226,33 @@ bool HilbertStrategy::processSlice
   ASSERT(slice.get() != 0);
   ASSERT(debugIsValidSlice(slice.get()));
 
-  if (slice->baseCase(getUseSimplification())) {
-    freeSlice(std::move(slice));
-    return true;
+  HilbertSlice& hilbertSlice = static_cast<HilbertSlice&>(*slice);
+  if (hilbertSlice.isBeingRecorded()) {
+    // The slice has already been looked up in the memo table, so it
+    // only remains to split it.
+    hilbertSlice.setIsBeingRecorded(false);
+  } else {
+    if (slice->baseCase(getUseSimplification())) {
+      freeSlice(std::move(slice));
+      return true;
+    }
+
+    if (useMemo(*slice)) {
+      HilbertMemoKey key;
+      key.set(slice->getIdeal(), &slice->getSubtract());
+      if (_memo.lookup(key, slice->getMultiply(),
+                       *hilbertSlice.getConsumer())) {
+        freeSlice(std::move(slice));
+        return true;
+      }
+
+      recordSlice(tasks, unique_ptr<HilbertSlice>
+                  (static_cast<HilbertSlice*>(slice.release())), key);
+      return false;
+    }
   }
 
-  if (getUseIndependence() && _indepSplitter.analyze(*slice)) {
+  if (getUseIndependence() && getIndependenceSplitter().analyze(*slice)) {
     independenceSplit(std::move(slice));
   } else {
     ASSERT(_split->isPivotSplit());
@@ -83,6 +262,90 @@ bool HilbertStrategy::processSlice
   return false;
 }
 
+void HilbertStrategy::setMemoSize(size_t bytes) {
+  _memo.setMaxMemoryUse(bytes);
+}
+
+void HilbertStrategy::printStatistics(FILE* out) const {
+  SliceStrategyCommon::printStatistics(out);
+  if (_memo.isOn())
+    _memo.printReport(out);
+}
+
+bool HilbertStrategy::useMemo(const Slice& slice) const {
+  return _memo.isOn() &&
+    slice.getIdeal().getGeneratorCount() <= MaxMemoGeneratorCount;
+}
+
+void HilbertStrategy::recordSlice(TaskEngine& tasks,
+                                  unique_ptr<HilbertSlice> slice,
+                                  HilbertMemoKey& key) {
+  ASSERT(slice.get() != 0);
+  ASSERT(!slice->isBeingRecorded());
+
+  unique_ptr<MemoRecorder> recorder
+    (new MemoRecorder(_memo, key, slice->getMultiply(),
+                      *slice->getConsumer(), isParallel()));
+  slice->setConsumer(recorder.get());
+  slice->setIsBeingRecorded(true);
+
+  // The recorder runs when we are done with the slice.
+  tasks.addTask(slice.release(), recorder.release());
+}
+
+void HilbertStrategy::runUnit(const string& unit,
+                              const ResultSender& sendResult) {
+  Ideal ideal;
+  Ideal subtract;
+  Term multiply;
+  decodeSlice(unit, ideal, subtract, multiply);
+
+  // As in run(), the output is collected when running in parallel.
+  UnitResultConsumer resultConsumer(sendResult);
+  ConcurrentHashPolynomial output
+    (multiply.getVarCount(),
+     isParallel() ? ShardsPerThread * _tasks.getThreadCount() : 1);
+  ConcurrentPolynomialConsumer outputConsumer(output);
+  CoefTermConsumer* consumer = &resultConsumer;
+  if (isParallel())
+    consumer = &outputConsumer;
+
+  unique_ptr<Slice> slice
+    (new HilbertSlice(*this, ideal, subtract, multiply, consumer));
+  _tasks.addTask(slice.release());
+  _tasks.runTasks();
+
+  output.feedTermsTo(resultConsumer);
+}
+
+void HilbertStrategy::consumeUnitResult(const char* result, size_t size) {
+  ASSERT(_unitConsumer != 0);
+  const size_t termSize = _unitTerm.getVarCount() * sizeof(Exponent);
+  ASSERT(size > termSize);
+  if (termSize > 0)
+    memcpy(_unitTerm.begin(), result, termSize);
+  result += termSize;
+  size -= termSize;
+
+  const char coefKind = *result;
+  ++result;
+  --size;
+  if (coefKind == LongCoef) {
+    long coef;
+    ASSERT(size == sizeof(coef));
+    memcpy(&coef, result, sizeof(coef));
+    _unitConsumer->consume(coef, _unitTerm);
+  } else {
+    ASSERT(coefKind == BigCoef);
+    ASSERT(size >= 1);
+    const int sign = static_cast<signed char>(*result);
+    mpz_import(_unitCoef.get_mpz_t(), size - 1, 1, 1, 0, 0, result + 1);
+    if (sign < 0)
+      _unitCoef = -_unitCoef;
+    _unitConsumer->consume(_unitCoef, _unitTerm);
+  }
+}
+
 unique_ptr<HilbertSlice> HilbertStrategy::newHilbertSlice() {
   unique_ptr<Slice> slice(newSlice());
   ASSERT(debugIsValidSlice(slice.get()));
@@ -108,11 +371,13 @@ void HilbertStrategy::getPivot(Term& term, Slice& slice) {
 void HilbertStrategy::freeConsumer(unique_ptr<HilbertIndependenceConsumer>
                                    consumer) {
   ASSERT(consumer.get() != 0);
+
+  consumer->clear();
+
+  std::lock_guard<std::mutex> lock(_consumerCacheMutex);
   ASSERT(std::find(_consumerCache.begin(),
                    _consumerCache.end(), consumer.get()) ==
          _consumerCache.end());
-
-  consumer->clear();
   noThrowPushBack(_consumerCache, std::move(consumer));
 }
 
@@ -123,28 +388,30 @@ void HilbertStrategy::independenceSplit(unique_ptr<Slice> sliceParam) {
     (static_cast<HilbertSlice*>(sliceParam.release()));
 
   // Construct split object.
-  unique_ptr<HilbertIndependenceConsumer> autoSplit = newConsumer();
-  autoSplit->reset(slice->getConsumer(), _indepSplitter, slice->getVarCount());
-  HilbertIndependenceConsumer* split = autoSplit.release();
-  _tasks.addTask(split); // Runs when we are done with all of this split.
+  unique_ptr<HilbertIndependenceConsumer> split = newConsumer();
+  split->reset(slice->getConsumer(), getIndependenceSplitter(),
+               slice->getVarCount(), isParallel());
 
   // Construct left slice.
   unique_ptr<HilbertSlice> leftSlice(newHilbertSlice());
   leftSlice->setToProjOf(*slice, split->getLeftProjection(),
                          split->getLeftConsumer());
-  _tasks.addTask(leftSlice.release());
+  split->setLeftSlice(std::move(leftSlice));
 
   // Construct right slice.
   unique_ptr<HilbertSlice> rightSlice(newHilbertSlice());
   rightSlice->setToProjOf(*slice, split->getRightProjection(),
                           split->getRightConsumer());
-  _tasks.addTask(rightSlice.release());
+
+  // The split runs when we are done with the right slice.
+  _tasks.addTask(rightSlice.release(), split.release());
 
   // Deal with slice.
   freeSlice(std::move(slice));
 }
 
 unique_ptr<HilbertIndependenceConsumer> HilbertStrategy::newConsumer() {
+  std::lock_guard<std::mutex> lock(_consumerCacheMutex);
   if (_consumerCache.empty())
     return unique_ptr<HilbertIndependenceConsumer>
       (new HilbertIndependenceConsumer(this));
@@ -18,10 +18,12 @@
 #define HILBERT_STRATEGY_GUARD
 
 #include <vector>
+#include <mutex>
 #include "IndependenceSplitter.h"
 #include "SliceStrategyCommon.h"
 #include "ElementDeleter.h"
 #include "HilbertIndependenceConsumer.h"
+#include "HilbertMemo.h"
 
 class HilbertSlice;
 class Ideal;
@@ -39,6 +41,18 @@ class HilbertStrategy : public SliceStrategyCommon {
 
   virtual bool processSlice(TaskEngine& tasks, unique_ptr<Slice> slice);
 
+  /** Use up to about the given number of bytes to keep the
+   contribution of sub-slices, so that it can be reused when the same
+   sub-slice comes up again up to the multiply term and a permutation
+   of the variables. The default of zero turns this off. This method
+   should only be called before calling run(). */
+  void setMemoSize(size_t bytes);
+
+  /** Returns the table of contributions of sub-slices. */
+  HilbertMemo& getMemo() {return _memo;}
+
+  virtual void printStatistics(FILE* out) const;
+
   void freeConsumer(unique_ptr<HilbertIndependenceConsumer> consumer);
 
  private:
@@ -50,14 +64,39 @@ class HilbertStrategy : public SliceStrategyCommon {
 
   virtual void getPivot(Term& term, Slice& slice);
 
-  IndependenceSplitter _indepSplitter;
   void independenceSplit(unique_ptr<Slice> slice);
 
+  /** Returns true if the contribution of slice should be looked up in
+   and stored in the memo table. */
+  bool useMemo(const Slice& slice) const;
+
+  /** Sets things up so that the contribution of slice is stored in
+   the memo table for key once slice is done, and then adds slice to
+   tasks. */
+  void recordSlice(TaskEngine& tasks,
+                   unique_ptr<HilbertSlice> slice,
+                   HilbertMemoKey& key);
+
+  virtual void runUnit(const string& unit, const ResultSender& sendResult);
+  virtual void consumeUnitResult(const char* result, size_t size);
+
   vector<HilbertIndependenceConsumer*> _consumerCache;
   ElementDeleter<vector<HilbertIndependenceConsumer*> > _consumerCacheDeleter;
 
+  /** Protects _consumerCache, as consumers are freed by whichever
+   thread runs them last. */
+  std::mutex _consumerCacheMutex;
+
   CoefTermConsumer* _consumer;
   bool _useIndependence;
+
+  HilbertMemo _memo;
+
+  /** The consumer that consumeUnitResult outputs to, and space that
+   it uses to avoid reallocating for each result. */
+  CoefTermConsumer* _unitConsumer;
+  Term _unitTerm;
+  mpz_class _unitCoef;
 };
 
 #endif
@@ -20,6 +20,7 @@
 #include "IOHandler.h"
 #include "fourti2.h"
 #include "BigIdeal.h"
+#include "CompactBigIdeal.h"
 #include "fplllIO.h"
 #include "Scanner.h"
 #include "ElementDeleter.h"
@@ -111,6 +112,22 @@ void IOFacade::readIdeal(Scanner& in, BigIdeal& ideal) {
   endAction();
 }
 
+void IOFacade::readIdeal(Scanner& in, CompactBigIdeal& ideal) {
+  beginAction("Reading monomial ideal.");
+
+  unique_ptr<IOHandler> handler(in.createIOHandler());
+  ASSERT(handler.get() != 0);
+
+  InputConsumer recorder;
+  handler->readIdeal(in, recorder);
+
+  ASSERT(!recorder.empty());
+  ideal.swap(*(recorder.releaseCompactIdeal()));
+  ASSERT(recorder.empty());
+
+  endAction();
+}
+
 /** Read a square free ideal from in and place it in the parameter
 	ideal. */
 void IOFacade::readSquareFreeIdeal(Scanner& in, SquareFreeIdeal& ideal) {
@@ -29,6 +29,7 @@ class BigTermConsumer;
 class SatBinomIdeal;
 class SatBinomConsumer;
 class SquareFreeIdeal;
+class CompactBigIdeal;
 
 /** A facade for input and output of mathematical objects.
 
@@ -55,6 +56,11 @@ class IOFacade : private Facade {
   /** Read an ideal from in and place it in the parameter ideal. */
   void readIdeal(Scanner& in, BigIdeal& ideal);
 
+  /** Read an ideal from in and place it in the parameter ideal. This
+   uses much less memory than reading a BigIdeal when the exponents
+   fit in a word. */
+  void readIdeal(Scanner& in, CompactBigIdeal& ideal);
+
   /** Read a square free ideal from in and place it in the parameter
 	  ideal. */
   void readSquareFreeIdeal(Scanner& in, SquareFreeIdeal& ideal);
@@ -32,6 +32,7 @@
 #include "NullIOHandler.h"
 #include "CoCoA4IOHandler.h"
 #include "SingularIOHandler.h"
+#include "BinaryIOHandler.h"
 #include "error.h"
 #include "BigTermRecorder.h"
 #include "InputConsumer.h"
@@ -86,16 +87,18 @@ const char* IOHandler::getDescription() const {
   return doGetDescription();
 }
 
-unique_ptr<BigTermConsumer> IOHandler::createIdealWriter(FILE* out) {
+unique_ptr<BigTermConsumer> IOHandler::createIdealWriter
+(FILE* out, size_t threadCount) {
   if (!supportsOutput(DataType::getMonomialIdealType())) {
     throwError<UnsupportedException>
       ("The " + string(getName()) +
        " format does not support output of a monomial ideal.");
   }
-  return unique_ptr<BigTermConsumer>(doCreateIdealWriter(out));
+  return unique_ptr<BigTermConsumer>(doCreateIdealWriter(out, threadCount));
 }
 
-unique_ptr<BigTermConsumer> IOHandler::createIdealListWriter(FILE* out) {
+unique_ptr<BigTermConsumer> IOHandler::createIdealListWriter
+(FILE* out, size_t threadCount) {
   if (!supportsOutput(DataType::getMonomialIdealListType())) {
     throwError<UnsupportedException>
       ("The " + string(getName()) +
@@ -104,16 +107,18 @@ unique_ptr<BigTermConsumer> IOHandler::createIdealListWriter(FILE* out) {
   // This is the same kind of object as for a non-list ideal
   // writer. The only difference is that we checked for support for
   // output of lists above.
-  return unique_ptr<BigTermConsumer>(doCreateIdealWriter(out));
+  return unique_ptr<BigTermConsumer>(doCreateIdealWriter(out, threadCount));
 }
 
-unique_ptr<CoefBigTermConsumer> IOHandler::createPolynomialWriter(FILE* out) {
+unique_ptr<CoefBigTermConsumer> IOHandler::createPolynomialWriter
+(FILE* out, size_t threadCount) {
   if (!supportsOutput(DataType::getPolynomialType())) {
     throwError<UnsupportedException>
       ("The " + string(getName()) +
        " format does not support output of a polynomial.");
   }
-  return unique_ptr<CoefBigTermConsumer>(doCreatePolynomialWriter(out));
+  return unique_ptr<CoefBigTermConsumer>(doCreatePolynomialWriter
+    (out, threadCount));
 }
 
 bool IOHandler::supportsInput(const DataType& type) const {
@@ -137,6 +142,7 @@ namespace {
     nameFactoryRegister<IO::Fourti2IOHandler>(factory);
     nameFactoryRegister<IO::NullIOHandler>(factory);
     nameFactoryRegister<IO::CountingIOHandler>(factory);
+    nameFactoryRegister<IO::BinaryIOHandler>(factory);
 
     return factory;
   }
@@ -221,6 +227,9 @@ string autoDetectFormat(Scanner& in) {
   case 'v': // correct
     return IO::MonosIOHandler::staticGetName();
 
+  case 0x7F: // correct
+    return IO::BinaryIOHandler::staticGetName();
+
   case 'R': // correct
   default: // incorrect
     return IO::Macaulay2IOHandler::staticGetName();
@@ -63,16 +63,24 @@ class IOHandler {
   const char* getName() const;
   const char* getDescription() const;
 
-  unique_ptr<BigTermConsumer> createIdealWriter(FILE* out);
-  unique_ptr<BigTermConsumer> createIdealListWriter(FILE* out);
-  unique_ptr<CoefBigTermConsumer> createPolynomialWriter(FILE* out);
+  /** The writers format their output on threadCount threads if the
+   format supports that. The output is the same for any thread
+   count. */
+  unique_ptr<BigTermConsumer> createIdealWriter
+    (FILE* out, size_t threadCount = 1);
+  unique_ptr<BigTermConsumer> createIdealListWriter
+    (FILE* out, size_t threadCount = 1);
+  unique_ptr<CoefBigTermConsumer> createPolynomialWriter
+    (FILE* out, size_t threadCount = 1);
 
   bool supportsInput(const DataType& type) const;
   bool supportsOutput(const DataType& type) const;
 
  protected:
-  virtual BigTermConsumer* doCreateIdealWriter(FILE* out) = 0;
-  virtual CoefBigTermConsumer* doCreatePolynomialWriter(FILE* out) = 0;
+  virtual BigTermConsumer* doCreateIdealWriter
+    (FILE* out, size_t threadCount) = 0;
+  virtual CoefBigTermConsumer* doCreatePolynomialWriter
+    (FILE* out, size_t threadCount) = 0;
 
  private:
   virtual const char* doGetName() const = 0;
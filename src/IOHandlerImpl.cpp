@@ -39,11 +39,13 @@ IO::IOHandlerImpl::IOHandlerImpl(const char* formatName,
   _formatDescription(formatDescription) {
 }
 
-BigTermConsumer* IO::IOHandlerImpl::doCreateIdealWriter(FILE* out) {
+BigTermConsumer* IO::IOHandlerImpl::
+doCreateIdealWriter(FILE* out, size_t threadCount) {
   INTERNAL_ERROR_UNIMPLEMENTED();
 }
 
-CoefBigTermConsumer* IO::IOHandlerImpl::doCreatePolynomialWriter(FILE* out) {
+CoefBigTermConsumer* IO::IOHandlerImpl::
+doCreatePolynomialWriter(FILE* out, size_t threadCount) {
   INTERNAL_ERROR_UNIMPLEMENTED();
 }
 
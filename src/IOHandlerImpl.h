@@ -49,8 +49,10 @@ namespace IO {
     // The following methods have implementations that merely report
     // an internal error. Make sure to override those you register
     // support for.
-    virtual BigTermConsumer* doCreateIdealWriter(FILE* out) = 0;
-    virtual CoefBigTermConsumer* doCreatePolynomialWriter(FILE* out);
+    virtual BigTermConsumer* doCreateIdealWriter(FILE* out,
+                                                 size_t threadCount) = 0;
+    virtual CoefBigTermConsumer* doCreatePolynomialWriter(FILE* out,
+                                                          size_t threadCount);
 
     virtual void doReadTerm(Scanner& in, InputConsumer& term);
     virtual void doReadIdeal(Scanner& in, InputConsumer& consumer);
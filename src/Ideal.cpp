@@ -25,6 +25,17 @@
 #include <functional>
 #include <sstream>
 
+namespace {
+  class InSupport {
+  public:
+    InSupport(size_t var): _var(var) {}
+    bool operator()(const Exponent* term) const {return term[_var] != 0;}
+
+  private:
+    size_t _var;
+  };
+}
+
 Ideal::~Ideal() {
 }
 
@@ -461,10 +472,12 @@ void Ideal::insert(const Exponent* exponents) {
   // keeping track of the allocated memory, so there is not a memory
   // leak.
   _terms.push_back(term);
+  insertIntoTree(term);
 }
 
 void Ideal::insert(const Ideal& ideal) {
   _terms.reserve(_terms.size() + ideal._terms.size());
+  _allocator.reserve(ideal._terms.size());
   Ideal::const_iterator stop = ideal.end();
   for (Ideal::const_iterator it = ideal.begin(); it != stop; ++it)
     insert(*it);
@@ -479,11 +492,12 @@ void Ideal::insert(size_t var, Exponent e) {
   // keeping track of the allocated memory, so there is not a memory
   // leak.
   _terms.push_back(term);
+  insertIntoTree(term);
 }
 
 void Ideal::insertReminimize(const Exponent* term) {
   ASSERT(isMinimallyGenerated());
-  if (contains(term))
+  if (useTree() ? _tree->contains(term) : contains(term))
     return;
 
   removeMultiples(term);
@@ -493,6 +507,7 @@ void Ideal::insertReminimize(const Exponent* term) {
 
 void Ideal::insertReminimize(size_t var, Exponent e) {
   ASSERT(isMinimallyGenerated());
+  useTree();
   removeMultiples(var, e);
   insert(var, e);
   ASSERT(isMinimallyGenerated());
@@ -502,8 +517,13 @@ void Ideal::minimize() {
   if (_terms.empty())
     return;
 
-  Minimizer minimizer(_varCount);
-  _terms.erase(minimizer.minimize(_terms.begin(), _terms.end()), _terms.end());
+  if (useTree())
+    minimizeWithTree(_terms.begin());
+  else {
+    Minimizer minimizer(_varCount);
+    _terms.erase(minimizer.minimize(_terms.begin(), _terms.end()),
+                 _terms.end());
+  }
   ASSERT(isMinimallyGenerated());
 }
 
@@ -523,18 +543,21 @@ void Ideal::singleDegreeSort(size_t var) {
 }
 
 void Ideal::product(const Exponent* by) {
+  _tree.reset();
   iterator stop = _terms.end();
   for (iterator it = _terms.begin(); it != stop; ++it)
     Term::product(*it, *it, by, _varCount);
 }
 
 void Ideal::colon(const Exponent* by) {
+  _tree.reset();
   iterator stop = _terms.end();
   for (iterator it = _terms.begin(); it != stop; ++it)
     Term::colon(*it, *it, by, _varCount);
 }
 
 void Ideal::colon(size_t var, Exponent e) {
+  _tree.reset();
   iterator stop = _terms.end();
   for (iterator it = _terms.begin(); it != stop; ++it) {
     Exponent& ite = (*it)[var];
@@ -550,6 +573,44 @@ void Ideal::colon(size_t var, Exponent e) {
 bool Ideal::colonReminimize(const Exponent* by) {
   ASSERT(isMinimallyGenerated());
 
+  if (useTree()) {
+    if (Term::getSizeOfSupport(by, _varCount) == 1) {
+      size_t var = Term::getFirstNonZeroExponent(by, _varCount);
+      return colonReminimize(var, by[var]);
+    }
+
+    // A generator can only stop being minimal if the colon removes a
+    // variable from the support of some generator. The generators
+    // whose exponents change are taken out of the tree while they
+    // change, as the tree finds a term by its exponents.
+    bool changed = false;
+    iterator stop = _terms.end();
+    for (iterator it = _terms.begin(); it != stop; ++it) {
+      bool affected = false;
+      for (size_t var = 0; var < _varCount; ++var) {
+        if (by[var] > 0 && (*it)[var] > 0) {
+          affected = true;
+          if (by[var] >= (*it)[var])
+            changed = true;
+        }
+      }
+      if (affected) {
+        removeFromTree(*it);
+        Term::colon(*it, *it, by, _varCount);
+        insertIntoTree(*it);
+      }
+    }
+
+    if (changed) {
+      if (_tree.get() != 0)
+        minimizeWithTree(_terms.begin());
+      else
+        minimize();
+    }
+    ASSERT(isMinimallyGenerated());
+    return changed;
+  }
+
   Minimizer minimizer(_varCount);
   pair<iterator, bool> pair =
     minimizer.colonReminimize(_terms.begin(), _terms.end(), by);
@@ -563,6 +624,38 @@ bool Ideal::colonReminimize(const Exponent* by) {
 bool Ideal::colonReminimize(size_t var, Exponent e) {
   ASSERT(isMinimallyGenerated());
 
+  if (useTree()) {
+    bool changed = false;
+    iterator stop = _terms.end();
+    for (iterator it = _terms.begin(); it != stop; ++it) {
+      Exponent& exponent = (*it)[var];
+      if (exponent == 0)
+        continue;
+      removeFromTree(*it);
+      if (exponent > e)
+        exponent -= e;
+      else {
+        exponent = 0;
+        changed = true;
+      }
+      insertIntoTree(*it);
+    }
+
+    // Only generators that do not have var in their support can stop
+    // being minimal, and only if some generator lost var from its
+    // support.
+    if (changed) {
+      if (_tree.get() != 0) {
+        iterator candidates = std::partition
+          (_terms.begin(), _terms.end(), InSupport(var));
+        minimizeWithTree(candidates);
+      } else
+        minimize();
+    }
+    ASSERT(isMinimallyGenerated());
+    return changed;
+  }
+
   Minimizer minimizer(_varCount);
   pair<iterator, bool> pair =
     minimizer.colonReminimize(_terms.begin(), _terms.end(), var, e);
@@ -574,26 +667,44 @@ bool Ideal::colonReminimize(size_t var, Exponent e) {
 }
 
 void Ideal::remove(const_iterator it) {
-  ASSERT(begin() <= it);
-  ASSERT(it < end());
+  ASSERT(_terms.begin() <= it);
+  ASSERT(it < _terms.end());
+  removeFromTree(*it);
   std::swap(const_cast<Exponent*&>(*it), *(_terms.end() - 1));
   _terms.pop_back();
 }
 
 
 void Ideal::removeMultiples(const Exponent* term) {
+  if (_tree.get() != 0) {
+    // Most calls have no multiples to remove, and the tree finds that
+    // out without looking at every generator.
+    vector<const Exponent*> multiples;
+    _tree->getMultiples(term, multiples);
+    if (multiples.empty())
+      return;
+  }
+
   iterator newEnd = _terms.begin();
   iterator stop = _terms.end();
   for (iterator it = _terms.begin(); it != stop; ++it) {
     if (!Term::divides(term, *it, _varCount)) {
       *newEnd = *it;
       ++newEnd;
-    }
+    } else
+      removeFromTree(*it);
   }
   _terms.erase(newEnd, stop);
 }
 
 void Ideal::removeMultiples(size_t var, Exponent e) {
+  if (_tree.get() != 0) {
+    Term pure(_varCount);
+    pure[var] = e;
+    removeMultiples(pure);
+    return;
+  }
+
   iterator newEnd = _terms.begin();
   iterator stop = _terms.end();
   for (iterator it = _terms.begin(); it != stop; ++it) {
@@ -626,12 +737,14 @@ void Ideal::removeStrictMultiples(const Exponent* term) {
     if (!Term::strictlyDivides(term, *it, _varCount)) {
       *newEnd = *it;
       ++newEnd;
-    }
+    } else
+      removeFromTree(*it);
   }
   _terms.erase(newEnd, stop);
 }
 
 void Ideal::removeDuplicates() {
+  _tree.reset();
   std::sort(_terms.begin(), _terms.end(), LexComparator(_varCount));
   iterator newEnd =
     unique(_terms.begin(), _terms.end(), EqualsPredicate(_varCount));
@@ -639,17 +752,20 @@ void Ideal::removeDuplicates() {
 }
 
 void Ideal::clear() {
+  _tree.reset();
   _terms.clear();
   _allocator.reset(_varCount);
 }
 
 void Ideal::clearAndSetVarCount(size_t varCount) {
+  _tree.reset();
   _varCount = varCount;
   _terms.clear();
   _allocator.reset(varCount);
 }
 
 void Ideal::mapExponentsToZeroNoMinimize(const Term& zeroExponents) {
+  _tree.reset();
   iterator stop = _terms.end();
   for (iterator it = _terms.begin(); it != stop; ++it)
     for (size_t var = 0; var < _varCount; ++var)
@@ -658,6 +774,7 @@ void Ideal::mapExponentsToZeroNoMinimize(const Term& zeroExponents) {
 }
 
 void Ideal::takeRadicalNoMinimize() {
+  _tree.reset();
   iterator stop = _terms.end();
   for (iterator it = _terms.begin(); it != stop; ++it)
     for (size_t var = 0; var < _varCount; ++var)
@@ -684,6 +801,76 @@ void Ideal::swap(Ideal& ideal) {
   std::swap(_varCount, ideal._varCount);
   _terms.swap(ideal._terms);
   _allocator.swap(ideal._allocator);
+  _tree.swap(ideal._tree);
+}
+
+void Ideal::compact() {
+  _tree.reset();
+  ExponentAllocator allocator(_varCount);
+  allocator.reserve(_terms.size());
+
+  // Nothing below can throw, so _terms never points into memory that
+  // is about to be freed.
+  for (iterator it = _terms.begin(); it != _terms.end(); ++it) {
+    Exponent* term = allocator.allocate();
+    IF_DEBUG(if (_varCount > 0)) // avoid copy asserting on null pointer
+    copy(*it, *it + _varCount, term);
+    *it = term;
+  }
+  _allocator.swap(allocator);
+}
+
+void Ideal::compactIfProfitable() {
+  if (_allocator.getAllocatedCount() > 2 * _terms.size())
+    compact();
+}
+
+bool Ideal::updateTree() {
+  if (_tree.get() != 0) {
+    if (_terms.size() < MinTreeTermCount / 2)
+      _tree.reset();
+  } else if (_terms.size() >= MinTreeTermCount && _varCount > 0) {
+    unique_ptr<IdealTree> tree(new IdealTree(_varCount));
+    iterator stop = _terms.end();
+    for (iterator it = _terms.begin(); it != stop; ++it)
+      tree->insert(*it);
+    _tree = std::move(tree);
+  }
+  return _tree.get() != 0;
+}
+
+void Ideal::resetTree() {
+  _tree.reset();
+}
+
+void Ideal::insertIntoTree(const Exponent* term) {
+  if (_tree.get() == 0)
+    return;
+  try {
+    _tree->insert(term);
+  } catch (const bad_alloc&) {
+    _tree.reset();
+  }
+}
+
+void Ideal::minimizeWithTree(iterator candidates) {
+  ASSERT(_tree.get() != 0);
+
+  // Each redundant generator is removed from the tree as soon as it
+  // is found. That keeps one of each set of equal generators, and
+  // every generator that is removed still has a divisor in the tree,
+  // since divisibility is transitive.
+  iterator newEnd = candidates;
+  iterator stop = _terms.end();
+  for (iterator it = candidates; it != stop; ++it) {
+    if (_tree->getOtherDivisor(*it) != 0)
+      _tree->remove(*it);
+    else {
+      *newEnd = *it;
+      ++newEnd;
+    }
+  }
+  _terms.erase(newEnd, stop);
 }
 
 
@@ -700,6 +887,9 @@ void Ideal::swap(Ideal& ideal) {
 const int ExponentsPerChunk = 1024;
 const int MinTermsPerChunk = 2;
 
+/** Keeps chunks for reuse. There is one pool per thread so that
+ ideals can be allocated without locking. A chunk can be returned to
+ the pool of a different thread than the one it was taken from. */
 class ChunkPool {
 public:
   Exponent* allocate() {
@@ -733,10 +923,12 @@ public:
 
 private:
   vector<Exponent*> _chunks;
-} globalChunkPool;
+};
+thread_local ChunkPool globalChunkPool;
 
 Ideal::ExponentAllocator::ExponentAllocator(size_t varCount):
   _varCount(varCount),
+  _allocatedCount(0),
   _chunkIterator(0),
   _chunkEnd(0) {
   if (_varCount == 0)
@@ -757,6 +949,7 @@ Exponent* Ideal::ExponentAllocator::allocate() {
         delete[] term;
         throw;
       }
+      ++_allocatedCount;
       return term;
     }
 
@@ -774,33 +967,64 @@ Exponent* Ideal::ExponentAllocator::allocate() {
   Exponent* term = _chunkIterator;
   _chunkIterator += _varCount;
   ASSERT(_chunkIterator <= _chunkEnd);
+  ++_allocatedCount;
 
   return term;
 }
 
-void Ideal::ExponentAllocator::reset(size_t newVarCount) {
-  _varCount = newVarCount;
+void Ideal::ExponentAllocator::reserve(size_t termCount) {
+  if (termCount == 0 ||
+      static_cast<size_t>(_chunkEnd - _chunkIterator) / _varCount >= termCount)
+    return;
+
+  if (termCount > static_cast<size_t>(-1) / _varCount)
+    throw bad_alloc();
+  const size_t exponentCount = termCount * _varCount;
 
+  if (exponentCount <= static_cast<size_t>(ExponentsPerChunk) &&
+      !useSingleChunking()) {
+    _chunks.reserve(_chunks.size() + 1);
+    _chunkIterator = globalChunkPool.allocate();
+    _chunkEnd = _chunkIterator + ExponentsPerChunk;
+    _chunks.push_back(_chunkIterator);
+  } else {
+    _largeChunks.reserve(_largeChunks.size() + 1);
+    _chunkIterator = new Exponent[exponentCount];
+    _chunkEnd = _chunkIterator + exponentCount;
+    _largeChunks.push_back(_chunkIterator);
+  }
+}
+
+void Ideal::ExponentAllocator::reset(size_t newVarCount) {
+  // Which kind of chunks there are depends on the old number of
+  // variables, so this has to be done before changing it.
   if (useSingleChunking()) {
     for (size_t i = 0; i < _chunks.size(); ++i)
       delete[] _chunks[i];
-    _chunks.clear();
   } else {
-    _chunkIterator = 0;
-    _chunkEnd = 0;
-
     for (size_t i = 0; i < _chunks.size(); ++i)
       globalChunkPool.deallocate(_chunks[i]);
-    _chunks.clear();
   }
+  _chunks.clear();
+
+  for (size_t i = 0; i < _largeChunks.size(); ++i)
+    delete[] _largeChunks[i];
+  _largeChunks.clear();
+
+  _chunkIterator = 0;
+  _chunkEnd = 0;
+  _allocatedCount = 0;
+  _varCount = newVarCount == 0 ? 1 : newVarCount;
 }
 
 void Ideal::ExponentAllocator::swap(ExponentAllocator& allocator) {
   std::swap(_varCount, allocator._varCount);
+  std::swap(_allocatedCount, allocator._allocatedCount);
   std::swap(_chunkIterator, allocator._chunkIterator);
   std::swap(_chunkEnd, allocator._chunkEnd);
 
   _chunks.swap(allocator._chunks);
+  _largeChunks.swap(allocator._largeChunks);
 }
 
 bool Ideal::ExponentAllocator::useSingleChunking() const {
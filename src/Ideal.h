@@ -19,6 +19,7 @@
 
 class Term;
 
+#include "IdealTree.h"
 #include <vector>
 #include <algorithm>
 #include <ostream>
@@ -49,9 +50,11 @@ class Ideal {
   const_iterator end() const {return _terms.end();}
   const Exponent* operator[](size_t index) const {return _terms[index];}
 
-  iterator begin() {return _terms.begin();}
-  iterator end() {return _terms.end();}
-  Exponent*& operator[](size_t index) {return _terms[index];}
+  // The generators can be changed through these, so they discard the
+  // index of the generators. See _tree.
+  iterator begin() {discardTree(); return _terms.begin();}
+  iterator end() {discardTree(); return _terms.end();}
+  Exponent*& operator[](size_t index) {discardTree(); return _terms[index];}
 
   size_t getVarCount() const {return _varCount;}
   size_t getGeneratorCount() const {return _terms.size();}
@@ -274,6 +277,17 @@ class Ideal {
 
   void swap(Ideal& ideal);
 
+  /** Copies the generators into one contiguous block of memory in
+   the order that they appear in, and frees the memory of generators
+   that have been removed. Scans over the generators then access
+   memory sequentially. This invalidates pointers to the
+   generators. */
+  void compact();
+
+  /** Calls compact() if at least half of the memory allocated for
+   generators belongs to generators that have since been removed. */
+  void compactIfProfitable();
+
   /** Removes those generators m such that pred(m) evaluates to
    true. Returns true if any generators were removed.
   */
@@ -282,17 +296,29 @@ class Ideal {
 
   /** Ideal caches memory allocated with new internally and reuses it
    to avoid calling new all the time. Call this method to release
-   the cache.
+   the cache of the calling thread. Each thread has its own cache.
   */
   static void clearStaticCache();
 
  protected:
+  /** Allocates terms of a fixed length from chunks of memory, so
+   that terms allocated one after the other are placed one after the
+   other in memory. */
   class ExponentAllocator {
   public:
     ExponentAllocator(size_t varCount);
     ~ExponentAllocator();
 
     Exponent* allocate();
+
+    /** Makes the next termCount calls to allocate() return terms that
+     are placed one after the other in memory with no gaps, and
+     ensures that those calls will not throw an exception. */
+    void reserve(size_t termCount);
+
+    /** Returns the number of terms allocated since the last reset. */
+    size_t getAllocatedCount() const {return _allocatedCount;}
+
     void reset(size_t newVarCount);
 
     void swap(ExponentAllocator& allocator);
@@ -304,22 +330,83 @@ class Ideal {
     bool useSingleChunking() const;
 
     size_t _varCount;
+    size_t _allocatedCount;
 
-    Exponent* _chunk;
     Exponent* _chunkIterator;
     Exponent* _chunkEnd;
 
+    /** Chunks from the chunk pool, or individual terms if
+     useSingleChunking() is true. */
     vector<Exponent*> _chunks;
+
+    /** Chunks allocated by reserve() that are too large for the chunk
+     pool. */
+    vector<Exponent*> _largeChunks;
   };
 
+  /** Builds _tree if there is none and the ideal is large enough to
+   gain from it, and discards _tree if the ideal has become small.
+   Returns true if there is a tree afterwards. Most ideals are small,
+   so that case is inlined. */
+  bool useTree() {
+    if (_tree.get() == 0 && _terms.size() < MinTreeTermCount)
+      return false;
+    return updateTree();
+  }
+  bool updateTree();
+
+  /** useTree() builds _tree once there are at least this many
+   generators, and discards it if the number of generators drops below
+   half of this. */
+  static const size_t MinTreeTermCount = 1000;
+
+  /** Adds term to _tree if there is a tree. Discards the tree instead
+   if that runs out of memory. */
+  void insertIntoTree(const Exponent* term);
+
+  /** Discards _tree if there is a tree. This is called on every
+   non-const access, so the deallocation is not inlined. */
+  void discardTree() {
+    if (_tree.get() != 0)
+      resetTree();
+  }
+  void resetTree();
+
+  /** Removes term from _tree if there is a tree. */
+  void removeFromTree(const Exponent* term) {
+    if (_tree.get() != 0)
+      _tree->remove(term);
+  }
+
+  /** Removes the generators in [candidates, end()) that some other
+   generator divides. Requires a tree. */
+  void minimizeWithTree(iterator candidates);
+
   size_t _varCount;
   vector<Exponent*> _terms;
   ExponentAllocator _allocator;
+
+  /** An index of the generators that minimize(), insertReminimize()
+   and colonReminimize() build once the ideal is large and then keep up
+   to date, so that each call does not have to start from scratch. The
+   other mutators also keep it up to date, except those that change
+   the exponents of the generators in ways the index cannot follow,
+   which discard it. It is null if there is no index. */
+  unique_ptr<IdealTree> _tree;
 };
 
 template<class Predicate>
 inline bool Ideal::removeIf(Predicate pred) {
-  iterator newEnd = std::remove_if(_terms.begin(), _terms.end(), pred);
+  iterator newEnd = _terms.begin();
+  iterator stop = _terms.end();
+  for (iterator it = _terms.begin(); it != stop; ++it) {
+    if (pred(*it))
+      removeFromTree(*it);
+    else {
+      *newEnd = *it;
+      ++newEnd;
+    }
+  }
 
   if (newEnd != _terms.end()) {
     _terms.erase(newEnd, _terms.end());
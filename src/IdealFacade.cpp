@@ -29,11 +29,16 @@
 #include "SizeMaxIndepSetAlg.h"
 #include "HilbertBasecase.h"
 #include "PivotEulerAlg.h"
+#include "ResultCache.h"
 
 IdealFacade::IdealFacade(bool printActions):
   Facade(printActions) {
 }
 
+void IdealFacade::setResultCacheDir(const string& directory) {
+  _resultCacheDir = directory;
+}
+
 void IdealFacade::deform(BigIdeal& bigIdeal) {
   beginAction("Applying generic deformation to ideal.");
 
@@ -82,6 +87,19 @@ void IdealFacade::swap01(BigIdeal& bigIdeal) {
 mpz_class IdealFacade::computeDimension(const BigIdeal& bigIdeal,
                                         bool codimension,
                                         bool squareFreeAndMinimal) {
+  ResultCache cache(_resultCacheDir, isPrintingActions(), false);
+  if (cache.isOn()) {
+    Ideal minimized;
+    TermTranslator translator(bigIdeal, minimized, false);
+    minimized.minimize();
+    cache.setKey(codimension ? "codimension" : "dimension",
+                 minimized, translator);
+
+    mpz_class result;
+    if (cache.lookup(result))
+      return result;
+  }
+
   beginAction("Computing dimension of ideal.");
 
   size_t varCount = bigIdeal.getVarCount();
@@ -108,13 +126,14 @@ mpz_class IdealFacade::computeDimension(const BigIdeal& bigIdeal,
   SizeMaxIndepSetAlg alg;
   alg.run(radical);
   mpz_class result = alg.getMaxIndepSetSize();
+  if (codimension)
+    result = varCount - result;
 
   endAction();
 
-  if (codimension)
-    return varCount - result;
-  else
-    return result;
+  if (cache.isOn())
+    cache.store(result);
+  return result;
 }
 
 void IdealFacade::takeProducts(const vector<BigIdeal*>& ideals,
@@ -35,6 +35,12 @@ class IdealFacade : private Facade {
  public:
   IdealFacade(bool printActions);
 
+  /** Look up the results of the computations that support it in the
+      given directory before computing them, and store them there
+      afterwards. Results are not cached if directory is empty, which
+      is the default. */
+  void setResultCacheDir(const string& directory);
+
   /** Applies some generic deformation to the ideal. */
   void deform(BigIdeal& ideal);
 
@@ -92,6 +98,9 @@ class IdealFacade : private Facade {
 
   /** @todo: describe. */
   void printLcm(BigIdeal& ideal, IOHandler* handler, FILE* out);
+
+ private:
+  string _resultCacheDir;
 };
 
 #endif
@@ -24,9 +24,9 @@
 #include "NameFactory.h"
 #include "TermExtra.h"
 #include "ElementDeleter.h"
+#include "RandomSource.h"
 
 #include <algorithm>
-#include <cstdlib>
 #include <iterator>
 #include <map>
 
@@ -53,15 +53,9 @@ namespace {
   public:
     static const char* staticGetName() {return "random";}
   private:
-    struct URBG {
-        using result_type = int;
-        static constexpr int min() { return 0; }
-        static constexpr int max() { return RAND_MAX; }
-        int operator()() const { return std::rand(); }
-    };
     void doOrder(Ideal& ideal) const {
-      URBG g;
-      std::shuffle(ideal.begin(), ideal.end(), g);
+      std::shuffle(ideal.begin(), ideal.end(),
+                   RandomSource::getThreadSource());
     }
   };
 
@@ -19,9 +19,35 @@
 #include "tests.h"
 
 #include "Term.h"
+#include "TermPredicate.h"
 
 TEST_SUITE(Ideal)
 
+namespace {
+  /** Sets minimized to the generators of ideal that no other
+   generator divides, keeping one copy of equal generators, by
+   comparing every pair of generators. */
+  void bruteMinimize(const Ideal& ideal, Ideal& minimized) {
+    const size_t varCount = ideal.getVarCount();
+    minimized.clearAndSetVarCount(varCount);
+    for (size_t gen = 0; gen < ideal.getGeneratorCount(); ++gen) {
+      bool redundant = false;
+      for (size_t other = 0; other < ideal.getGeneratorCount(); ++other) {
+        if (other != gen &&
+            Term::divides(ideal[other], ideal[gen], varCount) &&
+            (!Term::divides(ideal[gen], ideal[other], varCount) ||
+             other < gen)) {
+          redundant = true;
+          break;
+        }
+      }
+      if (!redundant)
+        minimized.insert(ideal[gen]);
+    }
+    minimized.sortLex();
+  }
+}
+
 TEST(Ideal, IsWeaklyGeneric1) {
   Ideal id(4);
   id.insert(Term("0 2 1 1"));
@@ -40,3 +66,214 @@ TEST(Ideal, IsWeaklyGeneric2) {
 
   ASSERT_FALSE(id.isWeaklyGeneric());
 }
+
+namespace {
+  bool isContiguous(const Ideal& ideal) {
+    for (size_t gen = 1; gen < ideal.getGeneratorCount(); ++gen)
+      if (ideal[gen] != ideal[gen - 1] + ideal.getVarCount())
+        return false;
+    return true;
+  }
+
+  class NotGeneratorOf {
+  public:
+    NotGeneratorOf(const Ideal& ideal): _ideal(ideal) {}
+
+    bool operator()(const Exponent* term) const {
+      for (size_t gen = 0; gen < _ideal.getGeneratorCount(); ++gen)
+        if (equals(term, _ideal[gen], _ideal.getVarCount()))
+          return false;
+      return true;
+    }
+
+  private:
+    const Ideal& _ideal;
+  };
+}
+
+TEST(Ideal, CopyIsContiguous) {
+  // 1000 variables is enough that each term gets its own allocation
+  // when the terms are inserted one at a time.
+  for (size_t varCount = 3; varCount <= 1000; varCount += 997) {
+    Ideal ideal(varCount);
+    Term term(varCount);
+    for (size_t gen = 0; gen < 600; ++gen) {
+      term[gen % varCount] = gen + 1;
+      ideal.insert(term);
+    }
+
+    Ideal copy(ideal);
+    ASSERT_TRUE(copy == ideal);
+    ASSERT_TRUE(isContiguous(copy));
+  }
+}
+
+TEST(Ideal, Compact) {
+  for (size_t varCount = 3; varCount <= 1000; varCount += 997) {
+    Ideal ideal(varCount);
+    Ideal expected(varCount);
+    Term term(varCount);
+    for (size_t gen = 0; gen < 600; ++gen) {
+      term[gen % varCount] = gen + 1;
+      ideal.insert(term);
+      if (gen % 3 == 0)
+        expected.insert(term);
+    }
+
+    // Not enough has been removed yet for this to do anything.
+    for (size_t gen = ideal.getGeneratorCount(); gen > 0; --gen)
+      if (gen % 3 == 0)
+        ideal.remove(ideal.begin() + (gen - 1));
+    const Exponent* first = ideal[0];
+    ideal.compactIfProfitable();
+    ASSERT_EQ(ideal[0], first);
+
+    ideal.removeIf(NotGeneratorOf(expected));
+    ideal.sortReverseLex();
+    expected.sortReverseLex();
+    ASSERT_TRUE(ideal == expected);
+
+    ideal.compactIfProfitable();
+    ASSERT_TRUE(ideal == expected);
+    ASSERT_TRUE(isContiguous(ideal));
+
+    ideal.insert(term);
+    ASSERT_EQ(ideal.getGeneratorCount(), expected.getGeneratorCount() + 1);
+  }
+}
+
+TEST(Ideal, MinimizeKernelSets) {
+  // Try exponents of several sizes, both with and without vector
+  // instructions for the divisibility checks.
+  const KernelSet originalKernelSet = Term::getKernelSet();
+  const Exponent maxExponents[] = {3, 200, 60000, 100000};
+  unsigned long seed = 1;
+  for (int set = 0; set < KernelSetCount; ++set) {
+    if (!Term::setKernelSet(static_cast<KernelSet>(set)))
+      continue;
+    for (size_t i = 0; i < sizeof(maxExponents) / sizeof(Exponent); ++i) {
+      const size_t varCount = 20;
+      Ideal ideal(varCount);
+      Term term(varCount);
+      for (size_t gen = 0; gen < 300; ++gen) {
+        for (size_t var = 0; var < varCount; ++var) {
+          seed = seed * 1103515245 + 12345;
+          // Mostly zero so that there is something to minimize.
+          if ((seed >> 16) % 4 == 0)
+            term[var] = maxExponents[i] - (seed >> 20) % 4;
+          else
+            term[var] = 0;
+        }
+        ideal.insert(term);
+      }
+
+      Ideal minimized(ideal);
+      minimized.minimize();
+      ASSERT_TRUE(minimized.isMinimallyGenerated());
+      for (size_t gen = 0; gen < ideal.getGeneratorCount(); ++gen)
+        ASSERT_TRUE(minimized.contains(ideal[gen]));
+      ASSERT_TRUE(minimized.getGeneratorCount() < ideal.getGeneratorCount());
+    }
+  }
+  Term::setKernelSet(originalKernelSet);
+}
+
+TEST(Ideal, MinimizeMany) {
+  // Enough generators that the minimizer uses an IdealTree.
+  unsigned long seed = 1;
+  const size_t varCount = 5;
+  Ideal ideal(varCount);
+  Term term(varCount);
+  for (size_t gen = 0; gen < 5000; ++gen) {
+    for (size_t var = 0; var < varCount; ++var) {
+      seed = seed * 1103515245 + 12345;
+      term[var] = (seed >> 16) % 8;
+    }
+    ideal.insert(term);
+  }
+
+  Ideal minimized(ideal);
+  minimized.minimize();
+  ASSERT_TRUE(minimized.getGeneratorCount() < ideal.getGeneratorCount());
+
+  Ideal expected(varCount);
+  bruteMinimize(ideal, expected);
+  minimized.sortLex();
+  ASSERT_TRUE(minimized == expected);
+  ASSERT_TRUE(minimized.isMinimallyGenerated());
+
+  // And a minimally generated ideal that is large enough to use an
+  // IdealTree.
+  ideal.clear();
+  for (Exponent e = 0; e < 2000; ++e) {
+    term[0] = e;
+    term[1] = 2000 - e;
+    ideal.insert(term);
+  }
+  ASSERT_TRUE(ideal.isMinimallyGenerated());
+  ideal.insert(term);
+  ASSERT_FALSE(ideal.isMinimallyGenerated());
+}
+
+TEST(Ideal, ReminimizeMany) {
+  // Enough generators that the ideal keeps an IdealTree, which each
+  // step below has to keep up to date for the next one.
+  // The terms x0^a*x1^(10-a)*x2^b*x3^(10-b)*x4^c*x5^(10-c) are 1331
+  // minimal generators, and each is inserted along with one of its
+  // multiples. A colon by one variable then removes only a few of them.
+  const size_t varCount = 6;
+  Ideal ideal(varCount);
+  Term term(varCount);
+  for (size_t index = 0; index < 11 * 11 * 11; ++index) {
+    size_t rest = index;
+    for (size_t var = 0; var < varCount; var += 2) {
+      term[var] = rest % 11;
+      term[var + 1] = 10 - term[var];
+      rest /= 11;
+    }
+    ideal.insert(term);
+    term[index % varCount] += 1;
+    ideal.insert(term);
+  }
+  ideal.minimize();
+  ASSERT_EQ(ideal.getGeneratorCount(), 1331u);
+  unsigned long seed = 1;
+
+  Ideal expected(varCount);
+  Ideal colon(varCount);
+  Ideal sorted(varCount);
+  for (size_t step = 0; step < 6; ++step) {
+    seed = seed * 1103515245 + 12345;
+    const size_t var = (seed >> 16) % varCount;
+    term.setToIdentity();
+    switch (step % 3) {
+    case 0:
+      term[var] = 1;
+      break;
+
+    case 1:
+      term[var] = 1;
+      term[(var + 2) % varCount] = 1;
+      break;
+
+    case 2:
+      for (size_t v = 0; v < varCount; ++v)
+        term[v] = v == var ? 0 : 2 + (seed >> (20 + v)) % 3;
+      break;
+    }
+
+    colon = ideal;
+    if (step % 3 == 2) {
+      colon.insert(term);
+      ideal.insertReminimize(term);
+    } else {
+      colon.colon(term);
+      ideal.colonReminimize(term);
+    }
+    bruteMinimize(colon, expected);
+
+    sorted = ideal;
+    sorted.sortLex();
+    ASSERT_TRUE(sorted == expected);
+  }
+}
@@ -23,134 +23,94 @@
 #include "Term.h"
 
 namespace {
+  /** Leaves are split once they have more terms than this. */
   const size_t MaxLeafSize = 60;
-
-  bool rawStrictlyDivides(Ideal::const_iterator begin,
-                          Ideal::const_iterator end,
-                          const Exponent* term,
-                          size_t varCount) {
-    for (; begin != end; ++begin)
-      if (Term::strictlyDivides(*begin, term, varCount))
-        return true;
-    return false;
-  }
 }
 
 class IdealTree::Node {
 public:
-  Node(Ideal::iterator begin,
-       Ideal::iterator end,
-       size_t varCount):
-    _begin(begin), _end(end), _varCount(varCount) {
-    makeTree();
-  }
+  Node(): _var(0), _pivot(0), _maxLeafSize(MaxLeafSize) {}
+
+  bool isLeaf() const {return _lessOrEqual.get() == 0;}
+
+  /** Splits this leaf into two if it has grown too large. */
+  void splitIfLarge(size_t varCount);
 
-  void makeTree();
-  bool strictlyContains(const Exponent* term) const;
-  size_t getVarCount() const {return _varCount;}
+  /** The terms of a leaf. */
+  vector<const Exponent*> _terms;
 
-private:
+  /** The children of an interior node. The terms below _greater
+   raise _var to a power greater than _pivot, and the terms below
+   _lessOrEqual do not. */
   unique_ptr<Node> _lessOrEqual;
   unique_ptr<Node> _greater;
-  Ideal::iterator _begin;
-  Ideal::iterator _end;
-  size_t _varCount;
   size_t _var;
-  size_t _pivot;
+  Exponent _pivot;
+
+  /** A leaf is split when it has more terms than this. This starts
+   out as MaxLeafSize, and it is doubled if the leaf cannot be split
+   because all its terms are equal, so that those terms are not
+   looked at on every insert. */
+  size_t _maxLeafSize;
 };
 
-void IdealTree::Node::makeTree() {
-  if ((size_t)distance(_begin, _end) <= MaxLeafSize)
+void IdealTree::Node::splitIfLarge(size_t varCount) {
+  ASSERT(isLeaf());
+  if (_terms.size() <= _maxLeafSize)
     return;
 
-  Term lcm(_varCount);
-  Term gcd(*_begin, _varCount);
-  for (Ideal::const_iterator it = _begin; it != _end; ++it) {
-    lcm.lcm(lcm, *it);
-    gcd.gcd(gcd, *it);
+  // Split on the variable whose exponents vary the most.
+  Term lcm(_terms.front(), varCount);
+  Term gcd(_terms.front(), varCount);
+  for (size_t i = 1; i < _terms.size(); ++i) {
+    lcm.lcm(lcm, _terms[i]);
+    gcd.gcd(gcd, _terms[i]);
   }
 
-  while (true) {
-    size_t maxVar = 0;
-    for (size_t var = 1; var < _varCount; ++var)
-      if (lcm[var] - gcd[var] > lcm[maxVar] - gcd[maxVar])
-        maxVar = var;
-
-    // TODO: could this ever happen?
-    if (lcm[maxVar] == 0)
-      break; // we are not making any progress anyway.
-
-    ASSERT(lcm[maxVar] >= 1);
-    _var = maxVar;
-
-    // It's significant that we are rounding down to ensure that
-    // neither of _lessOrEqual and _greater becomes empty.
-    _pivot = (lcm[maxVar] + gcd[maxVar]) >> 1; // Note: x >> 1 == x / 2
-
-    Ideal::iterator left = _begin;
-    Ideal::iterator right = _end - 1;
-
-    // put those strictly divisible by _var^_pivot to right and the
-    // rest to the left.
-    while (left != right) {
-      // Find left-most element that should go right.
-      while ((*left)[_var] <= _pivot && left != right)
-        ++left;
-
-      // Find right-most element that should go left.
-      while ((*right)[_var] > _pivot && left != right)
-        --right;
-
-      // Swap the two found elements so that they both go into the
-      // right place.
-      using std::swap;
-      swap(*left, *right);
-    }
-    ASSERT((*(_end - 1))[_var] > _pivot);
-    ASSERT((*_begin)[_var] <= _pivot);
-
-    // Make middle the first element that went right, so that the two
-    // ranges become [_begin, middle) and [middle, _end).
-    ASSERT((*right)[_var] > _pivot)
-    Ideal::iterator middle = right;
-    while ((*middle)[_var] > _pivot) {
-      ASSERT(middle != _begin);
-      --middle;
-    }
-    ++middle;
-    ASSERT(_begin < middle && middle <= _end);
-    ASSERT((*middle)[_var] > _pivot);
-    ASSERT((*(middle - 1))[_var] <= _pivot);
-
-    _lessOrEqual.reset(new Node(_begin, middle, _varCount));
-    _greater.reset(new Node(middle, _end, _varCount));
-
-    _lessOrEqual->makeTree();
-    _greater->makeTree();
+  size_t maxVar = 0;
+  for (size_t var = 1; var < varCount; ++var)
+    if (lcm[var] - gcd[var] > lcm[maxVar] - gcd[maxVar])
+      maxVar = var;
+  if (varCount == 0 || lcm[maxVar] == gcd[maxVar]) {
+    // All the terms are equal.
+    _maxLeafSize *= 2;
     return;
   }
-}
 
-bool IdealTree::Node::strictlyContains(const Exponent* term) const {
-  if (_lessOrEqual.get() != 0) {
-    ASSERT(_greater.get() != 0);
-    bool returnValue =
-      _lessOrEqual->strictlyContains(term) ||
-      _greater->strictlyContains(term);
-    ASSERT(returnValue == rawStrictlyDivides(_begin, _end, term, _varCount));
-    return returnValue;
-  } else {
-    ASSERT(_greater.get() == 0);
-    return rawStrictlyDivides(_begin, _end, term, _varCount);
+  // Rounding down makes the pivot less than lcm[maxVar] and at least
+  // gcd[maxVar], so neither child is empty.
+  _var = maxVar;
+  _pivot = gcd[maxVar] + (lcm[maxVar] - gcd[maxVar]) / 2;
+  _lessOrEqual.reset(new Node());
+  _greater.reset(new Node());
+  for (size_t i = 0; i < _terms.size(); ++i) {
+    if (_terms[i][_var] > _pivot)
+      _greater->_terms.push_back(_terms[i]);
+    else
+      _lessOrEqual->_terms.push_back(_terms[i]);
   }
+  ASSERT(!_lessOrEqual->_terms.empty());
+  ASSERT(!_greater->_terms.empty());
+
+  vector<const Exponent*>().swap(_terms);
+  _lessOrEqual->splitIfLarge(varCount);
+  _greater->splitIfLarge(varCount);
 }
 
-IdealTree::IdealTree(const Ideal& ideal) {
-  // not using initialization for this to avoid depending on order of
-  // initialization of members.
-  _storage.reset(new Ideal(ideal));
-  _root.reset
-    (new Node(_storage->begin(), _storage->end(), ideal.getVarCount()));
+IdealTree::IdealTree(size_t varCount):
+  _varCount(varCount),
+  _size(0),
+  _root(new Node()) {
+}
+
+IdealTree::IdealTree(const Ideal& ideal):
+  _varCount(ideal.getVarCount()),
+  _size(0),
+  _storage(new Ideal(ideal)),
+  _root(new Node()) {
+  Ideal::const_iterator stop = _storage->end();
+  for (Ideal::const_iterator it = _storage->begin(); it != stop; ++it)
+    insert(*it);
 }
 
 IdealTree::~IdealTree() {
@@ -158,12 +118,117 @@ IdealTree::~IdealTree() {
   // definition of T.
 }
 
+void IdealTree::insert(const Exponent* term) {
+  ASSERT(term != 0 || _varCount == 0);
+  Node* node = _root.get();
+  while (!node->isLeaf()) {
+    if (term[node->_var] > node->_pivot)
+      node = node->_greater.get();
+    else
+      node = node->_lessOrEqual.get();
+  }
+  node->_terms.push_back(term);
+  ++_size;
+  node->splitIfLarge(_varCount);
+}
+
+bool IdealTree::remove(const Exponent* term) {
+  Node* node = _root.get();
+  while (!node->isLeaf()) {
+    if (term[node->_var] > node->_pivot)
+      node = node->_greater.get();
+    else
+      node = node->_lessOrEqual.get();
+  }
+
+  vector<const Exponent*>& terms = node->_terms;
+  for (size_t i = 0; i < terms.size(); ++i) {
+    if (terms[i] == term) {
+      terms[i] = terms.back();
+      terms.pop_back();
+      --_size;
+      return true;
+    }
+  }
+  return false;
+}
+
+const Exponent* IdealTree::getDivisor(const Exponent* term) const {
+  return findDivisor(term, 0);
+}
+
+const Exponent* IdealTree::getOtherDivisor(const Exponent* term) const {
+  ASSERT(term != 0);
+  return findDivisor(term, term);
+}
+
+const Exponent* IdealTree::findDivisor(const Exponent* term,
+                                       const Exponent* ignore) const {
+  _stack.clear();
+  _stack.push_back(_root.get());
+  while (!_stack.empty()) {
+    const Node* node = _stack.back();
+    _stack.pop_back();
+
+    if (node->isLeaf()) {
+      for (size_t i = 0; i < node->_terms.size(); ++i)
+        if (Term::divides(node->_terms[i], term, _varCount) &&
+            node->_terms[i] != ignore)
+          return node->_terms[i];
+      continue;
+    }
+
+    // A divisor d below _greater has d[_var] > _pivot, so term[_var]
+    // has to be greater than _pivot too.
+    _stack.push_back(node->_lessOrEqual.get());
+    if (term[node->_var] > node->_pivot)
+      _stack.push_back(node->_greater.get());
+  }
+  return 0;
+}
+
 bool IdealTree::strictlyContains(const Exponent* term) const {
-  ASSERT(_root.get() != 0);
-  return _root->strictlyContains(term);
+  _stack.clear();
+  _stack.push_back(_root.get());
+  while (!_stack.empty()) {
+    const Node* node = _stack.back();
+    _stack.pop_back();
+
+    if (node->isLeaf()) {
+      for (size_t i = 0; i < node->_terms.size(); ++i)
+        if (Term::strictlyDivides(node->_terms[i], term, _varCount))
+          return true;
+      continue;
+    }
+
+    // A strict divisor d below _greater has a non-zero d[_var] >
+    // _pivot, so term[_var] > d[_var] > _pivot.
+    _stack.push_back(node->_lessOrEqual.get());
+    if (term[node->_var] > node->_pivot + 1)
+      _stack.push_back(node->_greater.get());
+  }
+  return false;
 }
 
-size_t IdealTree::getVarCount() const {
-  ASSERT(_root.get() != 0);
-  return _root->getVarCount();
+void IdealTree::getMultiples(const Exponent* term,
+                             vector<const Exponent*>& multiples) const {
+  _stack.clear();
+  _stack.push_back(_root.get());
+  while (!_stack.empty()) {
+    const Node* node = _stack.back();
+    _stack.pop_back();
+
+    if (node->isLeaf()) {
+      for (size_t i = 0; i < node->_terms.size(); ++i)
+        if (Term::divides(term, node->_terms[i], _varCount))
+          multiples.push_back(node->_terms[i]);
+      continue;
+    }
+
+    // A multiple m below _lessOrEqual has term[_var] <= m[_var] <=
+    // _pivot.
+    _stack.push_back(node->_greater.get());
+    if (term[node->_var] <= node->_pivot)
+      _stack.push_back(node->_lessOrEqual.get());
+  }
 }
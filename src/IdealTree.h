@@ -18,27 +18,84 @@
 #ifndef IDEAL_TREE_GUARD
 #define IDEAL_TREE_GUARD
 
+#include <vector>
+
 class Ideal;
 
-/** Objects of this class represents a monomial ideal.
+/** Objects of this class represent a monomial ideal.
 
- The representation uses a tree that speeds up some operations
- compared to a flat list.
+ The representation is a kd-tree that speeds up some operations
+ compared to a flat list. Each interior node splits the terms below
+ it according to whether the exponent of some variable is above a
+ pivot, and each leaf holds a short list of terms. Terms can be
+ inserted and removed at any time, so the same tree can be kept up to
+ date while an ideal is being built or reduced.
 
- @todo: avoid unbounded recursion. */
+ The tree does not copy the terms that are inserted into it, so they
+ must stay valid and unchanged while they are in the tree. The
+ exception is the constructor that takes an Ideal, which keeps its
+ own copy of that ideal. The tree does not have to be minimally
+ generated. */
 class IdealTree {
  public:
+  /** Constructs a tree with no terms. */
+  IdealTree(size_t varCount);
+
+  /** Constructs a tree of a copy of the generators of ideal. */
   IdealTree(const Ideal& ideal);
+
   ~IdealTree();
 
+  /** Adds term to the tree. The term itself is stored, not a copy. */
+  void insert(const Exponent* term);
+
+  /** Removes term from the tree. Terms are identified by address,
+   not by value. Returns false if term is not in the tree. */
+  bool remove(const Exponent* term);
+
+  /** Returns a term in the tree that divides term, or null if there
+   is no such term. */
+  const Exponent* getDivisor(const Exponent* term) const;
+
+  /** Returns a term in the tree that divides term and that is not
+   term itself, or null if there is no such term. Terms are told apart
+   by address, so a copy of term at another address is returned. */
+  const Exponent* getOtherDivisor(const Exponent* term) const;
+
+  /** Returns true if some term in the tree divides term. */
+  bool contains(const Exponent* term) const {return getDivisor(term) != 0;}
+
+  /** Returns true if some term in the tree strictly divides term. */
   bool strictlyContains(const Exponent* term) const;
-  size_t getVarCount() const;
+
+  /** Appends the terms in the tree that are divisible by term to
+   multiples. */
+  void getMultiples(const Exponent* term,
+                    vector<const Exponent*>& multiples) const;
+
+  size_t getVarCount() const {return _varCount;}
+
+  /** Returns the number of terms in the tree. */
+  size_t size() const {return _size;}
 
  private:
+  IdealTree(const IdealTree&); // not available
+  IdealTree& operator=(const IdealTree&); // not available
+
   class Node;
 
+  /** Returns a term in the tree other than ignore that divides term,
+   or null if there is no such term. */
+  const Exponent* findDivisor(const Exponent* term,
+                              const Exponent* ignore) const;
+
+  size_t _varCount;
+  size_t _size;
   unique_ptr<Ideal> _storage;
   unique_ptr<Node> _root;
+
+  /** Scratch space for the traversals. */
+  mutable vector<const Node*> _stack;
 };
 
 #endif
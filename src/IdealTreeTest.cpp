@@ -0,0 +1,143 @@
+/* Frobby: Software for monomial ideal computations.
+   Copyright (C) 2007 Bjarke Hammersholt Roune (www.broune.com)
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see http://www.gnu.org/licenses/.
+*/
+#include "stdinc.h"
+#include "IdealTree.h"
+#include "tests.h"
+
+#include "Ideal.h"
+#include "Term.h"
+
+TEST_SUITE(IdealTree)
+
+namespace {
+  /** Fills ideal with count pseudo-random terms with exponents in
+   [0, maxExponent] where most exponents are zero. */
+  void makeIdeal(Ideal& ideal, size_t count, Exponent maxExponent,
+                 unsigned long& seed) {
+    Term term(ideal.getVarCount());
+    for (size_t gen = 0; gen < count; ++gen) {
+      for (size_t var = 0; var < ideal.getVarCount(); ++var) {
+        seed = seed * 1103515245 + 12345;
+        if ((seed >> 16) % 3 == 0)
+          term[var] = 1 + (seed >> 20) % maxExponent;
+        else
+          term[var] = 0;
+      }
+      ideal.insert(term);
+    }
+  }
+
+  /** Returns true if the queries on tree for term agree with a
+   linear scan of the terms in [begin, end). */
+  bool queriesAgree(const IdealTree& tree, const Exponent* term,
+                    Ideal::const_iterator begin, Ideal::const_iterator end) {
+    size_t varCount = tree.getVarCount();
+    bool contains = false;
+    bool strictlyContains = false;
+    size_t multipleCount = 0;
+    for (Ideal::const_iterator it = begin; it != end; ++it) {
+      if (Term::divides(*it, term, varCount))
+        contains = true;
+      if (Term::strictlyDivides(*it, term, varCount))
+        strictlyContains = true;
+      if (Term::divides(term, *it, varCount))
+        ++multipleCount;
+    }
+
+    if (tree.contains(term) != contains)
+      return false;
+    if (contains && !Term::divides(tree.getDivisor(term), term, varCount))
+      return false;
+    if (tree.strictlyContains(term) != strictlyContains)
+      return false;
+
+    vector<const Exponent*> multiples;
+    tree.getMultiples(term, multiples);
+    if (multiples.size() != multipleCount)
+      return false;
+    for (size_t i = 0; i < multiples.size(); ++i)
+      if (!Term::divides(term, multiples[i], varCount))
+        return false;
+    return true;
+  }
+}
+
+TEST(IdealTree, Empty) {
+  IdealTree tree(3);
+  Term term("1 2 3");
+  ASSERT_EQ(tree.size(), 0u);
+  ASSERT_FALSE(tree.contains(term));
+  ASSERT_FALSE(tree.strictlyContains(term));
+  ASSERT_FALSE(tree.remove(term));
+}
+
+TEST(IdealTree, InsertRemoveAndQuery) {
+  unsigned long seed = 1;
+  const size_t varCount = 6;
+  Ideal ideal(varCount);
+  makeIdeal(ideal, 1000, 10, seed);
+  Ideal queries(varCount);
+  makeIdeal(queries, 200, 12, seed);
+
+  // Enough terms to make the tree split many times.
+  IdealTree tree(varCount);
+  for (size_t gen = 0; gen < ideal.getGeneratorCount(); ++gen)
+    tree.insert(ideal[gen]);
+  ASSERT_EQ(tree.size(), ideal.getGeneratorCount());
+  for (size_t query = 0; query < queries.getGeneratorCount(); ++query)
+    ASSERT_TRUE_SILENT
+      (queriesAgree(tree, queries[query], ideal.begin(), ideal.end()));
+
+  // Remove every other term.
+  const size_t kept = ideal.getGeneratorCount() / 2;
+  for (size_t gen = kept; gen < ideal.getGeneratorCount(); ++gen)
+    ASSERT_TRUE_SILENT(tree.remove(ideal[gen]));
+  ASSERT_FALSE(tree.remove(ideal[kept]));
+  ASSERT_EQ(tree.size(), kept);
+  for (size_t query = 0; query < queries.getGeneratorCount(); ++query)
+    ASSERT_TRUE_SILENT(queriesAgree(tree, queries[query],
+                                    ideal.begin(), ideal.begin() + kept));
+}
+
+TEST(IdealTree, EqualTerms) {
+  // The tree cannot split a leaf of equal terms, so it must not
+  // try to on every insert.
+  IdealTree tree(2);
+  Term term("1 1");
+  for (size_t i = 0; i < 1000; ++i)
+    tree.insert(term);
+  ASSERT_EQ(tree.size(), 1000u);
+  ASSERT_TRUE(tree.contains(term));
+  ASSERT_FALSE(tree.strictlyContains(term));
+  ASSERT_TRUE(tree.strictlyContains(Term("2 2")));
+}
+
+TEST(IdealTree, CopyOfIdeal) {
+  unsigned long seed = 2;
+  Ideal ideal(4);
+  makeIdeal(ideal, 300, 5, seed);
+  IdealTree tree(ideal);
+  ideal.clear(); // The tree has its own copy.
+  ASSERT_EQ(tree.size(), 300u);
+
+  Ideal copy(4);
+  seed = 2;
+  makeIdeal(copy, 300, 5, seed);
+  for (size_t gen = 0; gen < copy.getGeneratorCount(); ++gen)
+    ASSERT_TRUE_SILENT
+      (queriesAgree(tree, copy[gen], copy.begin(), copy.end()));
+}
@@ -20,12 +20,19 @@
 
 #include "BigIdeal.h"
 #include "Term.h"
+#include "TermTranslator.h"
+#include "ProgressReporter.h"
+
+#include <algorithm>
 
 namespace IO {
-  IdealWriter::IdealWriter(FILE* out):
-    _out(out),
+  IdealWriter::IdealWriter(FILE* out, size_t threadCount, bool chunked):
+    _output(out, threadCount, chunked),
     _firstIdeal(true),
-    _firstGenerator(true) {
+    _firstGenerator(true),
+    _bufferedTermCount(0),
+    _bufferedTranslator(0),
+    _bufferStartsIdeal(false) {
   }
 
   void IdealWriter::consumeRing(const VarNames& names) {
@@ -40,12 +47,31 @@ namespace IO {
   }
 
   void IdealWriter::beginConsuming() {
+    writeBufferedTerms();
     _firstGenerator = true;
     doWriteHeader(_firstIdeal);
   }
 
   void IdealWriter::consume(const Term& term, const TermTranslator& translator) {
     ASSERT(term.getVarCount() == _names.getVarCount());
+    ProgressReporter::noteOutputTerms(1);
+    if (_output.isChunked()) {
+      if (_bufferedTranslator != &translator) {
+        writeBufferedTerms();
+        _bufferedTranslator = &translator;
+      }
+      if (_bufferedTermCount == 0)
+        _bufferStartsIdeal = _firstGenerator;
+      _firstGenerator = false;
+
+      _bufferedTerms.insert(_bufferedTerms.end(), term.begin(), term.end());
+      ++_bufferedTermCount;
+      if (_bufferedTermCount >=
+          ChunkedOutput::TermsPerChunk * _output.getChunksPerRound())
+        writeBufferedTerms();
+      return;
+    }
+
     bool firstGenerator = _firstGenerator; // To get tail recursion.
     _firstGenerator = false;
     doWriteTerm(term, translator, firstGenerator);
@@ -53,12 +79,15 @@ namespace IO {
 
   void IdealWriter::consume(const vector<mpz_class>& term) {
     ASSERT(term.size() == _names.getVarCount());
+    ProgressReporter::noteOutputTerms(1);
+    writeBufferedTerms();
     bool firstGenerator = _firstGenerator; // To get tail recursion.
     _firstGenerator = false;
     doWriteTerm(term, firstGenerator);
   }
 
   void IdealWriter::doneConsuming() {
+    writeBufferedTerms();
     _firstIdeal = false;
     doWriteFooter(_firstGenerator);
   }
@@ -69,15 +98,56 @@ namespace IO {
   }
 
   void IdealWriter::consume(const BigIdeal& ideal) {
+    writeBufferedTerms();
     consumeRing(ideal.getNames());
     _firstGenerator = true;
-    doWriteHeader(_firstIdeal, ideal.getGeneratorCount());
+    const size_t generatorCount = ideal.getGeneratorCount();
+    doWriteHeader(_firstIdeal, generatorCount);
 
-    for (size_t term = 0; term < ideal.getGeneratorCount(); ++term)
-      consume(ideal.getTerm(term));
+    if (_output.isChunked() && generatorCount > 0) {
+      ProgressReporter::noteOutputTerms(generatorCount);
+      const size_t chunkSize = ChunkedOutput::TermsPerChunk;
+      const size_t chunkCount = (generatorCount + chunkSize - 1) / chunkSize;
+      _output.write(chunkCount, [&](size_t chunk) {
+          const size_t begin = chunk * chunkSize;
+          const size_t end = std::min(generatorCount, begin + chunkSize);
+          for (size_t term = begin; term < end; ++term)
+            doWriteTerm(ideal.getTerm(term), term == 0);
+        });
+      _firstGenerator = false;
+    } else {
+      for (size_t term = 0; term < generatorCount; ++term)
+        consume(ideal.getTerm(term));
+    }
     doneConsuming();
   }
 
+  void IdealWriter::writeBufferedTerms() {
+    if (_bufferedTermCount == 0)
+      return;
+    ASSERT(_bufferedTranslator != 0);
+
+    const TermTranslator& translator = *_bufferedTranslator;
+    translator.prepareStrings();
+
+    const size_t varCount = _names.getVarCount();
+    const size_t termCount = _bufferedTermCount;
+    const size_t chunkSize = ChunkedOutput::TermsPerChunk;
+    const size_t chunkCount = (termCount + chunkSize - 1) / chunkSize;
+    _output.write(chunkCount, [&](size_t chunk) {
+        Term term(varCount);
+        const size_t begin = chunk * chunkSize;
+        const size_t end = std::min(termCount, begin + chunkSize);
+        for (size_t index = begin; index < end; ++index) {
+          term = _bufferedTerms.data() + index * varCount;
+          doWriteTerm(term, translator, index == 0 && _bufferStartsIdeal);
+        }
+      });
+
+    _bufferedTerms.clear();
+    _bufferedTermCount = 0;
+  }
+
   void IdealWriter::doWriteHeader(bool firstIdeal, size_t generatorCount) {
     doWriteHeader(firstIdeal);
   }
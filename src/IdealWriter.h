@@ -20,14 +20,24 @@
 
 #include "VarNames.h"
 #include "BigTermConsumer.h"
+#include "ChunkedOutput.h"
 
 class TermTranslator;
 class Term;
 
 namespace IO {
+  /** Base class for writers of ideals in text formats. A subclass
+   writes each part of the output to getFile().
+
+   Terms are buffered and formatted in chunks through ChunkedOutput,
+   on as many threads as the thread count. If that is more than one,
+   then doWriteTerm can be called concurrently on different threads,
+   so it must not change the state of the writer. The output is the
+   same for any number of threads. A writer that buffers its output
+   itself can turn this off by passing false for chunked. */
   class IdealWriter : public BigTermConsumer {
   public:
-    IdealWriter(FILE* out);
+    IdealWriter(FILE* out, size_t threadCount = 1, bool chunked = true);
 
     virtual void consumeRing(const VarNames& names);
 
@@ -40,10 +50,13 @@ namespace IO {
 
     virtual void consume(const BigIdeal& ideal);
 
-    FILE* getFile() {return _out;}
+    FILE* getFile() {return _output.getFile();}
     const VarNames& getNames() {return _names;}
 
   private:
+    /** Formats the terms in _bufferedTerms in chunks. */
+    void writeBufferedTerms();
+
     virtual void doWriteHeader(bool firstIdeal, size_t generatorCount);
     virtual void doWriteHeader(bool firstIdeal) = 0;
     virtual void doWriteTerm(const Term& term,
@@ -54,10 +67,19 @@ namespace IO {
     virtual void doWriteFooter(bool wasZeroIdeal) = 0;
     virtual void doWriteEmptyList() = 0;
 
-    FILE* const _out;
+    ChunkedOutput _output;
     bool _firstIdeal;
     bool _firstGenerator;
     VarNames _names;
+
+    /** The exponents of terms that have been consumed but not yet
+     written. Terms are only buffered if _output is chunked. */
+    vector<Exponent> _bufferedTerms;
+    size_t _bufferedTermCount;
+    const TermTranslator* _bufferedTranslator;
+
+    /** Whether the first buffered term is the first generator. */
+    bool _bufferStartsIdeal;
   };
 }
 
@@ -25,11 +25,15 @@
 #include <iostream>
 
 InputConsumer::InputConsumer():
+  _tmpWord(0),
   _idealsDeleter(_ideals),
   _inIdeal(false),
   _requireSquareFree(false) {
 }
 
+InputConsumer::~InputConsumer() {
+}
+
 void InputConsumer::consumeRing(const VarNames& names) {
   VarNames nameCopy(names); // exception safety: copy and swap
   if (_inIdeal) {
@@ -37,7 +41,7 @@ void InputConsumer::consumeRing(const VarNames& names) {
 	if (_sqfIdeal.get() != 0)
 	  _sqfIdeal->renameVars(names);
 	else
-	  _bigIdeal->renameVars(names);
+	  _compactIdeal->renameVars(names);
   }
   _names.swap(nameCopy);
 }
@@ -56,7 +60,10 @@ void InputConsumer::beginIdeal() {
 
 void InputConsumer::hintGenCount(size_t hintGenCountParam) {
   ASSERT(_inIdeal);
-  _bigIdeal->reserve(hintGenCountParam);
+  if (_sqfIdeal.get() != 0)
+    _sqfIdeal->reserve(hintGenCountParam);
+  else
+    _compactIdeal->reserve(hintGenCountParam);
 }
 
 void InputConsumer::beginTerm() {
@@ -70,7 +77,7 @@ void InputConsumer::beginTerm() {
   if (_sqfIdeal.get() != 0)
     _sqfIdeal->insertIdentity();
   else
-    _bigIdeal->newLastTerm();
+    _compactIdeal->newLastTerm();
 }
 
 size_t InputConsumer::consumeVarNumber(Scanner& in) {
@@ -110,9 +117,8 @@ void InputConsumer::consumeVarExponentOne(size_t var, const Scanner& in) {
       return;
     }
   } else {
-    mpz_class& exponent = _bigIdeal->getLastTermExponentRef(var);
-    if (exponent == 0) {
-      exponent = 1;
+    if (_compactIdeal->isLastTermExponentZero(var)) {
+      _compactIdeal->setLastTermExponent(var, 1ul);
       return;
     }
   }
@@ -123,22 +129,50 @@ void InputConsumer::consumeVarExponent(size_t var, Scanner& in) {
   ASSERT(_inIdeal);
   ASSERT(var < _names.getVarCount());
 
+  const bool isWord = in.readIntegerNoSign(_tmpWord, _tmpInteger);
+  consumeTmpExponent(var, isWord, in);
+}
+
+void InputConsumer::consumeVarExponent
+(size_t var, unsigned long exponent, const Scanner& in) {
+  ASSERT(_inIdeal);
+  ASSERT(var < _names.getVarCount());
+
+  _tmpWord = exponent;
+  consumeTmpExponent(var, true, in);
+}
+
+void InputConsumer::consumeVarExponent
+(size_t var, const mpz_class& exponent, const Scanner& in) {
+  ASSERT(_inIdeal);
+  ASSERT(var < _names.getVarCount());
+
+  _tmpInteger = exponent;
+  consumeTmpExponent(var, false, in);
+}
+
+void InputConsumer::consumeTmpExponent
+(size_t var, bool isWord, const Scanner& in) {
   if (_sqfIdeal.get() != 0) {
-    in.readIntegerNoSign(_tmpString);
     Word* back = _sqfIdeal->back();
     if (!SquareFreeTermOps::getExponent(back, var)) {
-      if (_tmpString == "1")
+      if (isWord && _tmpWord == 1)
         SquareFreeTermOps::setExponent(back, var, true);
-      else if (_tmpString != "0") {
+      else if (!isWord || _tmpWord != 0) {
         idealNotSquareFree();
-        _bigIdeal->getLastTermExponentRef(var) = _tmpString;
+        if (isWord)
+          _compactIdeal->setLastTermExponent(var, _tmpWord);
+        else
+          _compactIdeal->setLastTermExponent(var, _tmpInteger);
       }
       return;
     }
   } else {
-    mpz_class& exponent = _bigIdeal->getLastTermExponentRef(var);
-    if (exponent == 0) {
-      in.readIntegerNoSign(exponent);
+    if (_compactIdeal->isLastTermExponentZero(var)) {
+      if (isWord)
+        _compactIdeal->setLastTermExponent(var, _tmpWord);
+      else
+        _compactIdeal->setLastTermExponent(var, _tmpInteger);
       return;
     }
   }
@@ -192,7 +226,7 @@ void InputConsumer::endIdeal() {
   ASSERT(_inIdeal);
   _inIdeal = false;
   unique_ptr<Entry> entry(new Entry());
-  entry->_big = std::move(_bigIdeal);
+  entry->_compact = std::move(_compactIdeal);
   entry->_sqf = std::move(_sqfIdeal);
   exceptionSafePushBack(_ideals, std::move(entry));
 }
@@ -202,8 +236,10 @@ void InputConsumer::releaseIdeal(unique_ptr<SquareFreeIdeal>& sqf, unique_ptr<Bi
   ASSERT(!empty());
   Entry entry;
   releaseIdeal(entry);
-  sqf = std::move(entry._sqf);
-  big = std::move(entry._big);
+  if (entry._sqf.get() != 0)
+    sqf = std::move(entry._sqf);
+  else
+    big = toBigIdeal(entry);
 }
 
 unique_ptr<BigIdeal> InputConsumer::releaseBigIdeal() {
@@ -211,8 +247,16 @@ unique_ptr<BigIdeal> InputConsumer::releaseBigIdeal() {
   ASSERT(!empty());
   Entry entry;
   releaseIdeal(entry);
-  toBigIdeal(entry._sqf, entry._big);
-  return std::move(entry._big);
+  return toBigIdeal(entry);
+}
+
+unique_ptr<CompactBigIdeal> InputConsumer::releaseCompactIdeal() {
+  ASSERT(!_inIdeal);
+  ASSERT(!empty());
+  Entry entry;
+  releaseIdeal(entry);
+  toCompactIdeal(entry._sqf, entry._compact);
+  return std::move(entry._compact);
 }
 
 unique_ptr<SquareFreeIdeal> InputConsumer::releaseSquareFreeIdeal() {
@@ -241,14 +285,30 @@ void InputConsumer::errorVariableAppearsTwice(const Scanner& in, size_t var) {
 void InputConsumer::idealNotSquareFree() {
   if (_requireSquareFree)
     reportError("Expected square free term.");
-  toBigIdeal(_sqfIdeal, _bigIdeal);
+  toCompactIdeal(_sqfIdeal, _compactIdeal);
 }
 
-void InputConsumer::toBigIdeal(std::unique_ptr<SquareFreeIdeal>& sqf, std::unique_ptr<BigIdeal>& big) {
-  if (big.get() != 0)
+void InputConsumer::toCompactIdeal(unique_ptr<SquareFreeIdeal>& sqf,
+                                   unique_ptr<CompactBigIdeal>& compact) {
+  if (compact.get() != 0)
     return;
   ASSERT(sqf.get() != 0);
-  big.reset(new BigIdeal(sqf->getNames()));
-  big->insert(*sqf);
+  compact.reset(new CompactBigIdeal(sqf->getNames()));
+  compact->insert(*sqf);
   sqf.reset(0);
 }
+
+unique_ptr<BigIdeal> InputConsumer::toBigIdeal(Entry& entry) {
+  unique_ptr<BigIdeal> big;
+  if (entry._sqf.get() != 0) {
+    big.reset(new BigIdeal(entry._sqf->getNames()));
+    big->insert(*entry._sqf);
+    entry._sqf.reset(0);
+  } else {
+    ASSERT(entry._compact.get() != 0);
+    big.reset(new BigIdeal(entry._compact->getNames()));
+    big->insert(*entry._compact);
+    entry._compact.reset(0);
+  }
+  return big;
+}
@@ -18,6 +18,7 @@
 #define INPUT_CONSUMER_GUARD
 
 #include "BigIdeal.h"
+#include "CompactBigIdeal.h"
 #include "SquareFreeIdeal.h"
 #include "VarNames.h"
 #include "ElementDeleter.h"
@@ -30,6 +31,7 @@ class Scanner;
 class InputConsumer {
  public:
   InputConsumer();
+  virtual ~InputConsumer();
 
   void consumeRing(const VarNames& names);
 
@@ -61,28 +63,41 @@ class InputConsumer {
    Does not return if there is an error. */
   void consumeVarExponent(size_t var, Scanner& in);
 
+  /** Consumes var raised to exponent, which has already been read
+   from in. Does not return if there is an error. */
+  void consumeVarExponent(size_t var, unsigned long exponent, const Scanner& in);
+
+  /** As above for an exponent that does not fit in a word. */
+  void consumeVarExponent(size_t var, const mpz_class& exponent,
+                          const Scanner& in);
+
   /** Done reading a term. */
   void endTerm();
 
   /** Reads a term in a format like "a^4*b*c^2" */
   void consumeTermProductNotation(Scanner& in);
 
-  /** Done reading an ideal. */
-  void endIdeal();
+  /** Done reading an ideal. A subclass can override this to process
+   each ideal as soon as it has been read. */
+  virtual void endIdeal();
 
   /** Returns true if there are ideals stored. */
   bool empty() const {return _ideals.empty();}
 
-  /** Struct that keeps either a BigIdeal or a SquareFreeIdeal. */
-
   /** Assigns the least recently read ideal that has not been released
-   to the parameter of the type that the ideal was read as. */
+   to sqf if it was read as a SquareFreeIdeal and otherwise to big. */
   void releaseIdeal(unique_ptr<SquareFreeIdeal>& sqf, unique_ptr<BigIdeal>& big);
 
   /** Returns the least recently read ideal that has not been released.
    Converts the ideal to a BigIdeal if it had been read as something else. */
   unique_ptr<BigIdeal> releaseBigIdeal();
 
+  /** Returns the least recently read ideal that has not been released.
+   Converts the ideal to a CompactBigIdeal if it had been read as
+   something else. Unlike releaseBigIdeal, this does not allocate an
+   mpz_class for each exponent. */
+  unique_ptr<CompactBigIdeal> releaseCompactIdeal();
+
   /** Returns the least recently read ideal that has not been released.
    That ideal must have been read as a SquareFreeIdeal. */
   unique_ptr<SquareFreeIdeal> releaseSquareFreeIdeal();
@@ -91,20 +106,28 @@ class InputConsumer {
   const VarNames& getRing() const {return _names;}
 
  private:
+  /** Struct that keeps either a CompactBigIdeal or a SquareFreeIdeal. */
   struct Entry {
-	unique_ptr<BigIdeal> _big;
+	unique_ptr<CompactBigIdeal> _compact;
 	unique_ptr<SquareFreeIdeal> _sqf;
   };
   void releaseIdeal(Entry& e);
 
+  /** Consumes var raised to _tmpWord if isWord and otherwise to
+   _tmpInteger. */
+  void consumeTmpExponent(size_t var, bool isWord, const Scanner& in);
+
   void errorVariableAppearsTwice(const Scanner& in, size_t var);
   void idealNotSquareFree();
-  static void toBigIdeal
-    (unique_ptr<SquareFreeIdeal>& sqf, unique_ptr<BigIdeal>& big);
+  static void toCompactIdeal
+    (unique_ptr<SquareFreeIdeal>& sqf, unique_ptr<CompactBigIdeal>& compact);
+  static unique_ptr<BigIdeal> toBigIdeal(Entry& entry);
 
   string _tmpString;
+  unsigned long _tmpWord;
+  mpz_class _tmpInteger;
   VarNames _names;
-  unique_ptr<BigIdeal> _bigIdeal;
+  unique_ptr<CompactBigIdeal> _compactIdeal;
   unique_ptr<SquareFreeIdeal> _sqfIdeal;
   vector<string> _term;
 
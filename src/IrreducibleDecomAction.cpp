@@ -38,6 +38,7 @@ IrreducibleDecomAction::IrreducibleDecomAction():
           false),
 
   _io(DataType::getMonomialIdealType(), DataType::getMonomialIdealType()) {
+  addResultCacheParam(_params);
 }
 
 void IrreducibleDecomAction::obtainParameters(vector<Parameter*>& parameters) {
@@ -0,0 +1,61 @@
+/* Frobby: Software for monomial ideal computations.
+   Copyright (C) 2007 Bjarke Hammersholt Roune (www.broune.com)
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see http://www.gnu.org/licenses/.
+*/
+#include "stdinc.h"
+#include "KernelSet.h"
+
+bool isKernelSetSupported(KernelSet set) {
+  switch (set) {
+  case ScalarKernels:
+    return true;
+
+#ifdef FROBBY_X86_KERNELS
+  case Avx2Kernels:
+    // This can be called during static initialization, which may be
+    // before the CPU model has been initialized.
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") &&
+      __builtin_cpu_supports("popcnt");
+
+  case Avx512Kernels:
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx512f") &&
+      __builtin_cpu_supports("avx2") &&
+      __builtin_cpu_supports("popcnt");
+#endif
+
+  default:
+    return false;
+  }
+}
+
+KernelSet getBestKernelSet() {
+  for (int set = KernelSetCount - 1; set > ScalarKernels; --set)
+    if (isKernelSetSupported(static_cast<KernelSet>(set)))
+      return static_cast<KernelSet>(set);
+  return ScalarKernels;
+}
+
+const char* getKernelSetName(KernelSet set) {
+  switch (set) {
+  case ScalarKernels: return "scalar";
+  case Avx2Kernels: return "avx2";
+  case Avx512Kernels: return "avx512";
+  default:
+    ASSERT(false);
+    return "unknown";
+  }
+}
@@ -0,0 +1,50 @@
+/* Frobby: Software for monomial ideal computations.
+   Copyright (C) 2007 Bjarke Hammersholt Roune (www.broune.com)
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see http://www.gnu.org/licenses/.
+*/
+#ifndef KERNEL_SET_GUARD
+#define KERNEL_SET_GUARD
+
+/** @file Selection of the machine instructions that the low-level
+ operations on terms are implemented with. */
+
+#if defined(__GNUC__) && defined(__x86_64__) && defined(__LP64__)
+/** Defined if the AVX2 and AVX-512 kernels are compiled in. Whether
+ they can be used is still up to the CPU. */
+#define FROBBY_X86_KERNELS
+#endif
+
+/** The sets of machine instructions that kernels can be implemented
+ with. Which sets are available is determined at run time by asking
+ the CPU. Later sets are preferred to earlier ones, and a CPU that
+ supports a set also supports the sets before it. */
+enum KernelSet {
+  ScalarKernels,
+  Avx2Kernels,
+  Avx512Kernels,
+  KernelSetCount
+};
+
+/** Returns true if this build and the CPU support the given kernel
+ set. ScalarKernels is always supported. */
+bool isKernelSetSupported(KernelSet set);
+
+/** Returns the best kernel set that is supported. */
+KernelSet getBestKernelSet();
+
+/** Returns a name for set such as "avx2". */
+const char* getKernelSetName(KernelSet set);
+
+#endif
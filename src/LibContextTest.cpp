@@ -0,0 +1,110 @@
+/* Frobby: Software for monomial ideal computations.
+   Copyright (C) 2007 Bjarke Hammersholt Roune (www.broune.com)
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see http://www.gnu.org/licenses/.
+*/
+#include "stdinc.h"
+
+#include "frobby.h"
+#include "tests.h"
+#include "BigIdeal.h"
+#include "BigPolynomial.h"
+#include "IdealFactory.h"
+#include "PolynomialFactory.h"
+#include "LibTest.h"
+
+#include <thread>
+
+TEST_SUITE2(LibraryInterface, Context)
+
+namespace {
+  /** Returns an ideal with enough generators that computing its
+   irreducible decomposition takes many steps of the Slice
+   Algorithm. */
+  Frobby::Ideal makeIdeal() {
+    Frobby::Ideal ideal(4);
+    for (int i = 0; i < 30; ++i) {
+      ideal.addExponent(i);
+      ideal.addExponent(30 - i);
+      ideal.addExponent((i * 7) % 11);
+      ideal.addExponent((i * 5) % 13);
+    }
+    return ideal;
+  }
+
+  /** Computes the irreducible decomposition and the Hilbert-Poincare
+   series of an ideal using a context of its own, so that several of
+   these can run at the same time on different threads. */
+  class ContextWorker {
+  public:
+    ContextWorker(const Frobby::Ideal& ideal, size_t threadCount):
+      _ideal(ideal),
+      _threadCount(threadCount),
+      _decom(VarNames(4)),
+      _hilbert(VarNames(4)) {
+    }
+
+    void run() {
+      Frobby::Context context;
+      context.setThreadCount(_threadCount);
+      Frobby::irreducibleDecompositionAsMonomials(context, _ideal, _decom);
+      Frobby::multigradedHilbertPoincareSeries(context, _ideal, _hilbert);
+    }
+
+    const BigIdeal& getDecom() const {return _decom.getIdeal();}
+    const BigPolynomial& getHilbert() const {return _hilbert.getPolynomial();}
+
+  private:
+    const Frobby::Ideal& _ideal;
+    size_t _threadCount;
+    LibIdealConsumer _decom;
+    LibPolynomialConsumer _hilbert;
+  };
+}
+
+TEST(Context, SameAsWithoutContext) {
+  Frobby::Ideal ideal = toLibIdeal(IdealFactory::xx_yy_xz_yz());
+  LibPolynomialConsumer consumer(IdealFactory::ring_xyzt());
+
+  Frobby::Context context;
+  context.setRandomSeed(42);
+  Frobby::multigradedHilbertPoincareSeries(context, ideal, consumer);
+
+  ASSERT_EQ(consumer.getPolynomial(), PolynomialFactory::hilbert_xx_yy_xz_yz());
+}
+
+TEST(Context, ConcurrentCalls) {
+  Frobby::Ideal ideal = makeIdeal();
+  LibIdealConsumer decom((VarNames(4)));
+  LibPolynomialConsumer hilbert((VarNames(4)));
+  Frobby::irreducibleDecompositionAsMonomials(ideal, decom);
+  Frobby::multigradedHilbertPoincareSeries(ideal, hilbert);
+
+  // The tests cannot assert on other threads, so the workers record
+  // their output to be checked here afterwards.
+  const size_t WorkerCount = 4;
+  vector<unique_ptr<ContextWorker>> workers;
+  for (size_t i = 0; i < WorkerCount; ++i)
+    workers.emplace_back(new ContextWorker(ideal, 1 + i % 2));
+  vector<std::thread> threads;
+  for (size_t i = 0; i < WorkerCount; ++i)
+    threads.push_back(std::thread(&ContextWorker::run, workers[i].get()));
+  for (size_t i = 0; i < WorkerCount; ++i)
+    threads[i].join();
+
+  for (size_t i = 0; i < WorkerCount; ++i) {
+    ASSERT_EQ(workers[i]->getDecom(), decom.getIdeal());
+    ASSERT_EQ(workers[i]->getHilbert(), hilbert.getPolynomial());
+  }
+}
@@ -37,7 +37,8 @@ namespace IO {
 
   class M2IdealWriter : public IdealWriter {
   public:
-    M2IdealWriter(FILE* out): IdealWriter(out) {
+    M2IdealWriter(FILE* out, size_t threadCount):
+      IdealWriter(out, threadCount) {
     }
 
   private:
@@ -93,7 +94,8 @@ namespace IO {
 
   class M2PolyWriter : public PolyWriter {
   public:
-    M2PolyWriter(FILE* out): PolyWriter(out) {
+    M2PolyWriter(FILE* out, size_t threadCount):
+      PolyWriter(out, threadCount) {
     }
 
     virtual void doWriteHeader() {
@@ -146,12 +148,14 @@ namespace IO {
     return "m2";
   }
 
-  BigTermConsumer* Macaulay2IOHandler::doCreateIdealWriter(FILE* out) {
-    return new M2IdealWriter(out);
+  BigTermConsumer* Macaulay2IOHandler::
+  doCreateIdealWriter(FILE* out, size_t threadCount) {
+    return new M2IdealWriter(out, threadCount);
   }
 
-  CoefBigTermConsumer* Macaulay2IOHandler::doCreatePolynomialWriter(FILE* out) {
-    return new M2PolyWriter(out);
+  CoefBigTermConsumer* Macaulay2IOHandler::
+  doCreatePolynomialWriter(FILE* out, size_t threadCount) {
+    return new M2PolyWriter(out, threadCount);
   }
 
   void Macaulay2IOHandler::doWriteTerm(const vector<mpz_class>& term,
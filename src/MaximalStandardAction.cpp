@@ -38,6 +38,7 @@ MaximalStandardAction::MaximalStandardAction():
    "Increase each entry of the output by 1 to compute maximal staircase\n"
    "monomials in place of maximal standard monomials.",
    false) {
+  addResultCacheParam(_params);
 }
 
 const char* MaximalStandardAction::staticGetName() {
@@ -0,0 +1,112 @@
+/* Frobby: Software for monomial ideal computations.
+   Copyright (C) 2007 Bjarke Hammersholt Roune (www.broune.com)
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see http://www.gnu.org/licenses/.
+*/
+#include "stdinc.h"
+#include "MemoryFile.h"
+
+#include "error.h"
+
+#include <cstdlib>
+
+// open_memstream and fmemopen are part of POSIX.1-2008.
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+#if defined(_POSIX_VERSION) && _POSIX_VERSION >= 200809L
+#define MEMORY_FILE_USE_POSIX
+#endif
+
+namespace IO {
+  namespace {
+    FILE* openTemporaryFile() {
+      FILE* file = tmpfile();
+      if (file == 0)
+        reportError("Could not create a temporary file.");
+      return file;
+    }
+  }
+
+  MemoryOutput::MemoryOutput():
+    _file(0),
+    _data(0),
+    _size(0) {
+#ifdef MEMORY_FILE_USE_POSIX
+    _file = open_memstream(&_data, &_size);
+    if (_file == 0)
+      throw bad_alloc();
+#else
+    _file = openTemporaryFile();
+#endif
+  }
+
+  MemoryOutput::~MemoryOutput() {
+    if (_file != 0)
+      fclose(_file);
+    free(_data);
+  }
+
+  void MemoryOutput::close() {
+    ASSERT(_file != 0);
+    FILE* file = _file;
+    _file = 0;
+#ifdef MEMORY_FILE_USE_POSIX
+    if (fclose(file) != 0)
+      throw bad_alloc();
+#else
+    const long size = ftell(file);
+    if (size < 0 || fseek(file, 0, SEEK_SET) != 0) {
+      fclose(file);
+      reportError("Could not read back a temporary file.");
+    }
+    _size = static_cast<size_t>(size);
+    _data = static_cast<char*>(malloc(_size + 1));
+    if (_data == 0) {
+      fclose(file);
+      throw bad_alloc();
+    }
+    const size_t read = fread(_data, 1, _size, file);
+    fclose(file);
+    if (read != _size)
+      reportError("Could not read back a temporary file.");
+#endif
+  }
+
+  char* MemoryOutput::releaseData() {
+    ASSERT(_file == 0);
+    char* data = _data;
+    _data = 0;
+    _size = 0;
+    return data;
+  }
+
+  FILE* openMemoryInput(const char* data, size_t size) {
+#ifdef MEMORY_FILE_USE_POSIX
+    // Some versions of fmemopen do not accept an empty buffer.
+    if (size > 0) {
+      FILE* file = fmemopen(const_cast<char*>(data), size, "r");
+      if (file == 0)
+        throw bad_alloc();
+      return file;
+    }
+#endif
+    FILE* file = openTemporaryFile();
+    if (fwrite(data, 1, size, file) != size || fseek(file, 0, SEEK_SET) != 0) {
+      fclose(file);
+      reportError("Could not write to a temporary file.");
+    }
+    return file;
+  }
+}
@@ -0,0 +1,65 @@
+/* Frobby: Software for monomial ideal computations.
+   Copyright (C) 2007 Bjarke Hammersholt Roune (www.broune.com)
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see http://www.gnu.org/licenses/.
+*/
+#ifndef MEMORY_FILE_GUARD
+#define MEMORY_FILE_GUARD
+
+#include <cstdio>
+
+namespace IO {
+  /** An output file whose contents are kept in memory. This uses
+   open_memstream on systems that provide it. Elsewhere it uses a
+   temporary file from tmpfile(), whose contents are read back into
+   memory by close(). */
+  class MemoryOutput {
+  public:
+    /** Reports an error if the file cannot be opened. */
+    MemoryOutput();
+    ~MemoryOutput();
+
+    /** Returns the file to write to. This is null after close(). */
+    FILE* getFile() const {return _file;}
+
+    /** Closes the file. Its contents are then the getSize() bytes at
+     getData(). */
+    void close();
+
+    const char* getData() const {return _data;}
+    size_t getSize() const {return _size;}
+
+    /** Returns the contents and gives up ownership of them. They must
+     be released with free(). Requires that close() has been
+     called. */
+    char* releaseData();
+
+  private:
+    FILE* _file;
+    char* _data;
+    size_t _size;
+
+    MemoryOutput(const MemoryOutput&); // not available
+    MemoryOutput& operator=(const MemoryOutput&); // not available
+  };
+
+  /** Returns a file that reads the size bytes at data, which must
+   remain valid until the file has been closed. This uses fmemopen on
+   systems that provide it, and otherwise a temporary file from
+   tmpfile() that the data is copied into. Reports an error if the
+   file cannot be opened. */
+  FILE* openMemoryInput(const char* data, size_t size);
+}
+
+#endif
@@ -0,0 +1,287 @@
+/* Frobby: Software for monomial ideal computations.
+   Copyright (C) 2007 Bjarke Hammersholt Roune (www.broune.com)
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see http://www.gnu.org/licenses/.
+*/
+#include "stdinc.h"
+#include "MicroBenchAction.h"
+
+#include "RawSquareFreeTerm.h"
+#include "Term.h"
+#include "Timer.h"
+#include "HashPolynomial.h"
+#include "HashMap.h"
+
+#include <cstdlib>
+#include <unordered_map>
+
+MicroBenchAction::MicroBenchAction():
+  Action
+(staticGetName(),
+ "Time low-level operations on terms.",
+ "Time the low-level operations on terms once for each implementation\n"
+ "that this machine supports, such as with scalar or vector instructions.\n"
+ "Each operation is applied to termCount pairs of random terms, and this\n"
+ "is repeated the given number of rounds. Also time adding termCount\n"
+ "random terms to a polynomial the given number of rounds with each\n"
+ "kind of hash table, which is what computing a Hilbert-Poincare series\n"
+ "numerator spends much of its time on.",
+ false),
+
+  _varCount("varCount", "The number of variables.", 512),
+  _termCount("termCount", "The number of pairs of terms.", 1000),
+  _rounds("rounds", "The number of times to repeat each operation.", 100) {
+}
+
+void MicroBenchAction::obtainParameters(vector<Parameter*>& parameters) {
+  Action::obtainParameters(parameters);
+  parameters.push_back(&_varCount);
+  parameters.push_back(&_termCount);
+  parameters.push_back(&_rounds);
+}
+
+void MicroBenchAction::perform() {
+  benchSquareFreeKernels();
+  benchTermKernels();
+  benchPolynomials();
+}
+
+namespace {
+  /** Prints the time taken by an operation as space-separated
+   columns, like test/bench/benchHelper does. */
+  void printTime(const char* operation, const char* implementation,
+                 const Timer& timer) {
+    fprintf(stdout, "%s %s %.2fs\n", operation, implementation,
+            timer.getMilliseconds() / 1000.0);
+  }
+}
+
+void MicroBenchAction::benchSquareFreeKernels() {
+  using namespace SquareFreeTermOps;
+
+  const size_t wordCount = getWordCount(_varCount);
+  const size_t termCount = _termCount;
+  const size_t rounds = _rounds;
+
+  // The terms are arranged so that the operations that can stop
+  // early, such as divides, have to look at every word: a[i] divides
+  // b[i] and a[i] is relatively prime to c[i].
+  vector<Word> a(wordCount * termCount);
+  vector<Word> b(wordCount * termCount);
+  vector<Word> c(wordCount * termCount);
+  vector<Word> res(wordCount);
+  for (size_t i = 0; i < a.size(); ++i) {
+    Word word = 0;
+    for (size_t byte = 0; byte < sizeof(Word); ++byte)
+      word = (word << 8) ^ static_cast<Word>(std::rand());
+    a[i] = word & static_cast<Word>(std::rand());
+    b[i] = a[i] | word;
+    c[i] = ~a[i];
+  }
+
+  // Accumulating the results keeps the compiler from removing the
+  // calls as dead code.
+  size_t sink = 0;
+  for (int set = 0; set < KernelSetCount; ++set) {
+    if (!isKernelSetSupported(static_cast<KernelSet>(set)))
+      continue;
+    const KernelTable& kernels = getKernelTable(static_cast<KernelSet>(set));
+    const char* name = getKernelSetName(static_cast<KernelSet>(set));
+
+    Timer timer;
+    for (size_t round = 0; round < rounds; ++round)
+      for (size_t i = 0; i < a.size(); i += wordCount)
+        sink += kernels.divides(&a[i], &a[i] + wordCount, &b[i]);
+    printTime("sqfree-divides", name, timer);
+
+    timer.reset();
+    for (size_t round = 0; round < rounds; ++round)
+      for (size_t i = 0; i < a.size(); i += wordCount)
+        sink += kernels.isRelativelyPrime(&a[i], &a[i] + wordCount, &c[i]);
+    printTime("sqfree-isRelativelyPrime", name, timer);
+
+    timer.reset();
+    for (size_t round = 0; round < rounds; ++round) {
+      for (size_t i = 0; i < a.size(); i += wordCount) {
+        kernels.lcm(&res[0], &res[0] + wordCount, &a[i], &c[i]);
+        sink += res[0];
+      }
+    }
+    printTime("sqfree-lcm", name, timer);
+
+    timer.reset();
+    for (size_t round = 0; round < rounds; ++round) {
+      for (size_t i = 0; i < a.size(); i += wordCount) {
+        kernels.gcd(&res[0], &res[0] + wordCount, &b[i], &c[i]);
+        sink += res[0];
+      }
+    }
+    printTime("sqfree-gcd", name, timer);
+
+    timer.reset();
+    for (size_t round = 0; round < rounds; ++round) {
+      for (size_t i = 0; i < a.size(); i += wordCount) {
+        kernels.colon(&res[0], &res[0] + wordCount, &b[i], &a[i]);
+        sink += res[0];
+      }
+    }
+    printTime("sqfree-colon", name, timer);
+
+    timer.reset();
+    for (size_t round = 0; round < rounds; ++round)
+      for (size_t i = 0; i < a.size(); i += wordCount)
+        sink += kernels.getSizeOfSupport(&b[i], &b[i] + wordCount);
+    printTime("sqfree-getSizeOfSupport", name, timer);
+  }
+
+  if (sink == 0)
+    fputs("(no work done)\n", stdout);
+}
+
+void MicroBenchAction::benchTermKernels() {
+  const size_t varCount = _varCount;
+  const size_t termCount = _termCount;
+  const size_t rounds = _rounds;
+
+  // As for square-free terms, a[i] divides b[i] and a[i] strictly
+  // divides c[i], so that divides has to look at every exponent.
+  vector<Exponent> a(varCount * termCount);
+  vector<Exponent> b(varCount * termCount);
+  vector<Exponent> c(varCount * termCount);
+  vector<Exponent> res(varCount + 1);
+  for (size_t i = 0; i < a.size(); ++i) {
+    a[i] = std::rand() % 10;
+    b[i] = a[i] + std::rand() % 2;
+    c[i] = a[i] == 0 ? std::rand() % 2 : a[i] + 1 + std::rand() % 3;
+  }
+
+  size_t sink = 0;
+  for (int set = 0; set < KernelSetCount; ++set) {
+    if (!isKernelSetSupported(static_cast<KernelSet>(set)))
+      continue;
+    const Term::KernelTable& kernels =
+      Term::getKernelTable(static_cast<KernelSet>(set));
+    const char* name = getKernelSetName(static_cast<KernelSet>(set));
+
+    Timer timer;
+    for (size_t round = 0; round < rounds; ++round)
+      for (size_t i = 0; i < a.size(); i += varCount)
+        sink += kernels.divides(&a[i], &b[i], varCount);
+    printTime("term-divides", name, timer);
+
+    timer.reset();
+    for (size_t round = 0; round < rounds; ++round)
+      for (size_t i = 0; i < a.size(); i += varCount)
+        sink += kernels.strictlyDivides(&a[i], &c[i], varCount);
+    printTime("term-strictlyDivides", name, timer);
+
+    timer.reset();
+    for (size_t round = 0; round < rounds; ++round) {
+      for (size_t i = 0; i < a.size(); i += varCount) {
+        kernels.lcm(&res[0], &a[i], &c[i], varCount);
+        sink += res[0];
+      }
+    }
+    printTime("term-lcm", name, timer);
+
+    timer.reset();
+    for (size_t round = 0; round < rounds; ++round) {
+      for (size_t i = 0; i < a.size(); i += varCount) {
+        kernels.gcd(&res[0], &b[i], &c[i], varCount);
+        sink += res[0];
+      }
+    }
+    printTime("term-gcd", name, timer);
+
+    timer.reset();
+    for (size_t round = 0; round < rounds; ++round) {
+      for (size_t i = 0; i < a.size(); i += varCount) {
+        kernels.colon(&res[0], &c[i], &a[i], varCount);
+        sink += res[0];
+      }
+    }
+    printTime("term-colon", name, timer);
+  }
+
+  if (sink == 0)
+    fputs("(no work done)\n", stdout);
+}
+
+namespace {
+  /** Adds the terms in rounds, where the term at index i is added
+   with a minus in round r if i+r is divisible by 3. So some terms
+   cancel and are removed while others build up larger coefficients,
+   as happens when accumulating a Hilbert-Poincare series
+   numerator. */
+  template<class Map>
+  void accumulate(Map& map, const vector<Term>& terms, size_t rounds) {
+    for (size_t round = 0; round < rounds; ++round) {
+      for (size_t i = 0; i < terms.size(); ++i) {
+        mpz_class& coef = map[terms[i]];
+        if ((i + round) % 3 == 0)
+          --coef;
+        else
+          ++coef;
+        if (coef == 0)
+          map.erase(terms[i]);
+      }
+    }
+  }
+}
+
+void MicroBenchAction::benchPolynomials() {
+  const size_t varCount = _varCount;
+  const size_t termCount = _termCount;
+  const size_t rounds = _rounds;
+
+  vector<Term> terms(termCount);
+  for (size_t i = 0; i < termCount; ++i) {
+    terms[i].reset(varCount);
+    for (size_t var = 0; var < varCount; ++var)
+      terms[i][var] = std::rand() % 3;
+  }
+
+  size_t sink = 0;
+
+  Timer timer;
+  HashPolynomial poly(varCount);
+  for (size_t round = 0; round < rounds; ++round)
+    for (size_t i = 0; i < termCount; ++i)
+      poly.add((i + round) % 3 != 0, terms[i]);
+  sink += poly.getTermCount();
+  printTime("poly-accumulate", "HashPolynomial", timer);
+
+  timer.reset();
+  HashMap<Term, mpz_class> hashMap;
+  accumulate(hashMap, terms, rounds);
+  sink += hashMap.size();
+  printTime("poly-accumulate", "HashMap", timer);
+
+  timer.reset();
+  std::unordered_map<Term, mpz_class, FrobbyHash<Term> > unorderedMap;
+  accumulate(unorderedMap, terms, rounds);
+  sink += unorderedMap.size();
+  printTime("poly-accumulate", "unordered_map", timer);
+
+  if (sink == 0)
+    fputs("(no work done)\n", stdout);
+}
+
+const char* MicroBenchAction::staticGetName() {
+  return "microbench";
+}
+
+bool MicroBenchAction::displayAction() const {
+  return false;
+}
@@ -0,0 +1,49 @@
+/* Frobby: Software for monomial ideal computations.
+   Copyright (C) 2007 Bjarke Hammersholt Roune (www.broune.com)
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see http://www.gnu.org/licenses/.
+*/
+#ifndef MICRO_BENCH_ACTION_GUARD
+#define MICRO_BENCH_ACTION_GUARD
+
+#include "Action.h"
+#include "IntegerParameter.h"
+
+/** Times the low-level operations on terms once for each way they
+ can be implemented on this machine, such as with scalar or vector
+ instructions, and times adding terms to polynomials with each kind
+ of hash table. This is for developers, so it is not displayed in the
+ list of actions and it is only run when given by its full name. */
+class MicroBenchAction : public Action {
+ public:
+  MicroBenchAction();
+  virtual void obtainParameters(vector<Parameter*>& parameters);
+
+  virtual void perform();
+
+  virtual bool displayAction() const;
+
+  static const char* staticGetName();
+
+ private:
+  void benchSquareFreeKernels();
+  void benchTermKernels();
+  void benchPolynomials();
+
+  IntegerParameter _varCount;
+  IntegerParameter _termCount;
+  IntegerParameter _rounds;
+};
+
+#endif
@@ -19,14 +19,15 @@
 
 #include "TermPredicate.h"
 #include "Term.h"
+#include "IdealTree.h"
 #include <algorithm>
 
-/** @todo: Convert everything in this file to be in terms of
-    IdealTree. After that, consider converting all clients of this
-    code to use IdealTree directly. */
-
 namespace {
   typedef vector<Exponent*>::iterator TermIterator;
+
+  /** Ranges of at least this many terms are handled with an
+   IdealTree instead of by comparing every pair of terms. */
+  const ptrdiff_t MinTreeTermCount = 1000;
 }
 
 TermIterator simpleMinimize(TermIterator begin, TermIterator end, size_t varCount) {
@@ -75,182 +76,32 @@ TermIterator twoVarMinimize(TermIterator begin, TermIterator end) {
   return last;
 }
 
-class TreeNode {
-  typedef vector<Exponent*>::iterator iterator;
-
-public:
-  TreeNode(iterator begin, iterator end, size_t varCount):
-    _lessOrEqual(0),
-    _greater(0),
-    _var(0),
-    _pivot(0),
-    _varCount(varCount),
-    _begin(begin),
-    _end(end) {
-  }
-
-  ~TreeNode() {
-    delete _lessOrEqual;
-    delete _greater;
-  }
-
-  void makeTree() {
-    ASSERT(_greater == 0);
-    ASSERT(_lessOrEqual == 0);
-
-    if (distance(_begin, _end) > 20) {
-
-      Term lcm(_varCount);
-      for (iterator it = _begin; it != _end; ++it)
-        lcm.lcm(lcm, *it);
-
-      while (true) {
-        size_t maxVar = 0;
-
-        for (size_t var = 0; var < _varCount; ++var)
-          if (lcm[var] > lcm[maxVar])
-            maxVar = var;
-        if (lcm[maxVar] == 0) {
-          break; // we are not making any progress anyway
-        }
-
-        ASSERT(lcm[maxVar] >= 1);
-        _var = maxVar;
-        _pivot = lcm[maxVar] / 4;
-        lcm[maxVar] = 0; // So we do not process this same var again.
-
-        iterator left = _begin;
-        iterator right = _end - 1;
-        while (left != right) {
-          while ((*left)[_var] <= _pivot && left != right)
-            ++left;
-          while ((*right)[_var] > _pivot && left != right)
-            --right;
-          swap(*left, *right);
-        }
-        ASSERT((*right)[_var] > _pivot);
-        if ((*_begin)[_var] > _pivot)
-          continue;
-
-        iterator middle = right;
-        while ((*middle)[maxVar] > _pivot)
-          --middle;
-        ++middle;
-
-        ASSERT(middle != _begin);
-
-        _lessOrEqual = new TreeNode(_begin, middle, _varCount);
-        _greater = new TreeNode(middle, _end, _varCount);
-        _end = _begin;
-
-        _lessOrEqual->makeTree();
-        _greater->makeTree();
-        return;
-      }
-    }
-
-    _end = simpleMinimize(_begin, _end, _varCount);
-
-  }
-
-  bool isRedundant(const Exponent* term) {
-    if (_begin != _end) {
-      ASSERT(_lessOrEqual == 0);
-      ASSERT(_greater == 0);
-
-      for (iterator it = _begin; it != _end; ++it)
-        if (Term::dominates(term, *it, _varCount))
-          return true;
-      return false;
-    } else {
-      ASSERT(_lessOrEqual != 0);
-      ASSERT(_greater != 0);
-
-      if (term[_var] > _pivot && _greater->isRedundant(term))
-        return true;
-      if (_lessOrEqual->isRedundant(term))
-        return true;
-      return false;
-    }
-  }
-
-  void collect(vector<Exponent*>& terms) {
-    if (_begin != _end) {
-      ASSERT(_lessOrEqual == 0);
-      ASSERT(_greater == 0);
-      terms.insert(terms.end(), _begin, _end);
-      return;
-    }
-    ASSERT(_lessOrEqual != 0);
-    ASSERT(_greater != 0);
-
-    size_t oldSize = terms.size();
-    _greater->collect(terms);
-    for (size_t i = oldSize; i < terms.size();) {
-      if (_lessOrEqual->isRedundant(terms[i])) {
-        swap(terms[i], terms.back());
-        terms.pop_back();
-      } else
-        ++i;
-    }
-
-    _lessOrEqual->collect(terms);
-  }
+/** Minimizes by going through the terms in lexicographic order while
+ keeping the terms kept so far in an IdealTree. A divisor comes before
+ its multiples in that order, so each term only has to be checked
+ against the terms that were kept before it. */
+TermIterator treeMinimize(TermIterator begin, TermIterator end,
+                          size_t varCount) {
+  std::sort(begin, end, LexComparator(varCount));
 
-  void print(FILE* out) {
-    if (_begin == _end) {
-      ASSERT(_lessOrEqual != 0);
-      ASSERT(_greater != 0);
-
-      fprintf(out, "NODE (pivot=%lu^%lu, varCount = %lu\n",
-              (unsigned long)_var,
-              (unsigned long)_pivot,
-              (unsigned long)_varCount);
-      fputs("-lessOrEqual: ", out);
-      _lessOrEqual->print(out);
-      fputs("-greater: ", out);
-      _greater->print(out);
-      fputs(")\n", out);
-    } else {
-      ASSERT(_lessOrEqual == 0);
-      ASSERT(_greater == 0);
-
-      fprintf(out, "NODE (_varCount = %lu terms:\n", (unsigned long)_varCount);
-      for (iterator it = _begin; it != _end; ++it) {
-        fputc(' ', out);
-        Term::print(out, *it, _varCount);
-        fprintf(out, " %p\n", (void*)*it);
-      }
-      fputs(")\n", out);
+  IdealTree tree(varCount);
+  TermIterator newEnd = begin;
+  for (TermIterator it = begin; it != end; ++it) {
+    if (!tree.contains(*it)) {
+      tree.insert(*it);
+      *newEnd = *it;
+      ++newEnd;
     }
   }
-
-private:
-  TreeNode* _lessOrEqual;
-  TreeNode* _greater;
-  size_t _var;
-  Exponent _pivot;
-  size_t _varCount;
-
-  iterator _begin;
-  iterator _end;
-};
+  return newEnd;
+}
 
 Minimizer::iterator Minimizer::minimize(iterator begin, iterator end) const {
   if (_varCount == 2)
     return twoVarMinimize(begin, end);
-  if (distance(begin, end) < 1000 || _varCount == 0)
+  if (distance(begin, end) < MinTreeTermCount || _varCount == 0)
     return simpleMinimize(begin, end, _varCount);
-
-  vector<Exponent*> terms;
-  terms.clear();
-  terms.reserve(distance(begin, end));
-
-  TreeNode node(begin, end, _varCount);
-  node.makeTree();
-  node.collect(terms);
-
-  return copy(terms.begin(), terms.end(), begin);
+  return treeMinimize(begin, end, _varCount);
 }
 
 pair<Minimizer::iterator, bool> Minimizer::colonReminimize
@@ -306,7 +157,7 @@ pair<Minimizer::iterator, bool> Minimizer::colonReminimize
 
 bool Minimizer::isMinimallyGenerated
 (const_iterator begin, const_iterator end) {
-  if (distance(begin, end) < 1000 || _varCount == 0) {
+  if (distance(begin, end) < MinTreeTermCount || _varCount == 0) {
     for (const_iterator divisor = begin; divisor != end; ++divisor)
       for (const_iterator dominator = begin; dominator != end; ++dominator)
         if (Term::divides(*divisor, *dominator, _varCount) &&
@@ -316,13 +167,7 @@ bool Minimizer::isMinimallyGenerated
   }
 
   vector<Exponent*> terms(begin, end);
-  TreeNode node(terms.begin(), terms.end(), _varCount);
-  node.makeTree();
-
-  vector<Exponent*> terms2;
-  node.collect(terms2);
-
-  return terms.size() == terms2.size();
+  return treeMinimize(terms.begin(), terms.end(), _varCount) == terms.end();
 }
 
 bool Minimizer::dominatesAny
@@ -34,7 +34,8 @@ namespace IO {
 
   class MonosIdealWriter : public IdealWriter {
   public:
-    MonosIdealWriter(FILE* out): IdealWriter(out) {
+    MonosIdealWriter(FILE* out, size_t threadCount):
+      IdealWriter(out, threadCount) {
     }
 
   private:
@@ -78,8 +79,9 @@ namespace IO {
     return "monos";
   }
 
-  BigTermConsumer* MonosIOHandler::doCreateIdealWriter(FILE* out) {
-    return new MonosIdealWriter(out);
+  BigTermConsumer* MonosIOHandler::
+  doCreateIdealWriter(FILE* out, size_t threadCount) {
+    return new MonosIdealWriter(out, threadCount);
   }
 
   void MonosIOHandler::doWriteTerm(const vector<mpz_class>& term,
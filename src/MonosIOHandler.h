@@ -32,7 +32,7 @@ namespace IO {
     static const char* staticGetName();
 
   private:
-    virtual BigTermConsumer* doCreateIdealWriter(FILE* out);
+    virtual BigTermConsumer* doCreateIdealWriter(FILE* out, size_t threadCount);
 
     virtual void doWriteTerm(const vector<mpz_class>& term,
                              const VarNames& names,
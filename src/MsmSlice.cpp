@@ -200,11 +200,12 @@ bool MsmSlice::removeDoubleLcm() {
 
   while (true) {
     DoubleLcmPredicate pred(getLcm());
-    if (!_ideal.removeIf(pred))
+    if (!removeFromIdealIf(pred))
       break;
 
     removedAny = true;
-    _lcmUpdated = false;
+    if (_lcmUpdated)
+      break; // No new generators can have a double lcm.
   };
 
   return removedAny;
@@ -25,6 +25,100 @@
 #include "Projection.h"
 #include "TermGrader.h"
 
+#include <mutex>
+#include <cstring>
+#include <algorithm>
+
+namespace {
+  /** Passes terms on to another consumer, so that slices that are
+   processed on different threads can all output to the same
+   consumer. Each worker collects its terms in a buffer of its own and
+   passes them on a batch at a time while holding a lock, as taking
+   the lock for every term makes the workers contend for it once there
+   are more workers than cores. Call flush() when the tasks are done
+   to pass on the terms that remain in the buffers. */
+  class SynchronizedTermConsumer : public TermConsumer {
+  public:
+    SynchronizedTermConsumer(TermConsumer& consumer,
+                             const TaskEngine& tasks,
+                             size_t varCount):
+      _consumer(consumer),
+      _tasks(tasks),
+      _buffers(tasks.getThreadCount()),
+      _tmp(varCount) {
+    }
+
+    virtual void beginConsuming() {
+      _consumer.beginConsuming();
+    }
+
+    virtual void consume(const Term& term) {
+      ASSERT(term.getVarCount() == _tmp.getVarCount());
+      ASSERT(_tasks.getCurrentWorker() < _buffers.size());
+      if (term.getVarCount() == 0) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _consumer.consume(term);
+        return;
+      }
+      vector<Exponent>& buffer = _buffers[_tasks.getCurrentWorker()];
+      buffer.insert(buffer.end(), term.begin(), term.end());
+      if (buffer.size() >= BufferExponentCount)
+        passOn(buffer);
+    }
+
+    virtual void doneConsuming() {
+      _consumer.doneConsuming();
+    }
+
+    void flush() {
+      for (size_t worker = 0; worker < _buffers.size(); ++worker)
+        passOn(_buffers[worker]);
+    }
+
+  private:
+    static const size_t BufferExponentCount = 16 * 1024;
+
+    void passOn(vector<Exponent>& buffer) {
+      const size_t varCount = _tmp.getVarCount();
+      std::lock_guard<std::mutex> lock(_mutex);
+      for (size_t i = 0; i < buffer.size(); i += varCount) {
+        std::copy(buffer.begin() + i, buffer.begin() + i + varCount,
+                  _tmp.begin());
+        _consumer.consume(_tmp);
+      }
+      buffer.clear();
+    }
+
+    TermConsumer& _consumer;
+    const TaskEngine& _tasks;
+    vector<vector<Exponent> > _buffers;
+    Term _tmp;
+    std::mutex _mutex;
+  };
+
+  /** Sends the terms of a work unit on as results of the unit. */
+  class UnitResultConsumer : public TermConsumer {
+  public:
+    UnitResultConsumer(const SliceStrategyCommon::ResultSender& sendResult):
+      _sendResult(sendResult) {
+    }
+
+    virtual void beginConsuming() {
+    }
+
+    virtual void consume(const Term& term) {
+      _sendResult(reinterpret_cast<const char*>(term.begin()),
+                  term.getVarCount() * sizeof(Exponent));
+    }
+
+    virtual void doneConsuming() {
+    }
+
+  private:
+    const SliceStrategyCommon::ResultSender& _sendResult;
+  };
+}
+
 MsmStrategy::MsmStrategy(TermConsumer* consumer,
                          const SplitStrategy* splitStrategy):
   SliceStrategyCommon(splitStrategy),
@@ -54,13 +148,27 @@ void MsmStrategy::run(const Ideal& ideal) {
   for (size_t var = 0; var < varCount; ++var)
     sliceMultiply[var] = 1;
 
+  SynchronizedTermConsumer synchronizedConsumer(*_consumer, _tasks, varCount);
+  TermConsumer* consumer = _consumer;
+  if (isParallel())
+    consumer = &synchronizedConsumer;
+
   unique_ptr<Slice> slice
-    (new MsmSlice(*this, ideal, *_initialSubtract, sliceMultiply, _consumer));
+    (new MsmSlice(*this, ideal, *_initialSubtract, sliceMultiply, consumer));
   simplify(*slice);
 
   _initialSubtract.reset();
-  _tasks.addTask(slice.release());
-  _tasks.runTasks();
+  if (usesCheckpoints()) {
+    _unitTerm.reset(varCount);
+    runWithCheckpoints(std::move(slice), "msm");
+  } else if (getProcessCount() > 1) {
+    _unitTerm.reset(varCount);
+    runInProcesses(std::move(slice));
+  } else {
+    _tasks.addTask(slice.release());
+    _tasks.runTasks();
+    synchronizedConsumer.flush();
+  }
   _consumer->doneConsuming();
 }
 
@@ -72,7 +180,7 @@ bool MsmStrategy::processSlice(TaskEngine& tasks, unique_ptr<Slice> slice) {
     return true;
   }
 
-  if (getUseIndependence() && _indep.analyze(*slice))
+  if (getUseIndependence() && getIndependenceSplitter().analyze(*slice))
     independenceSplit(std::move(slice));
   else if (_split->isLabelSplit())
     labelSplit(std::move(slice));
@@ -84,6 +192,34 @@ bool MsmStrategy::processSlice(TaskEngine& tasks, unique_ptr<Slice> slice) {
   return false;
 }
 
+void MsmStrategy::runUnit(const string& unit,
+                          const ResultSender& sendResult) {
+  Ideal ideal;
+  Ideal subtract;
+  Term multiply;
+  decodeSlice(unit, ideal, subtract, multiply);
+
+  UnitResultConsumer resultConsumer(sendResult);
+  SynchronizedTermConsumer synchronizedConsumer
+    (resultConsumer, _tasks, ideal.getVarCount());
+  TermConsumer* consumer = &resultConsumer;
+  if (isParallel())
+    consumer = &synchronizedConsumer;
+
+  unique_ptr<Slice> slice
+    (new MsmSlice(*this, ideal, subtract, multiply, consumer));
+  _tasks.addTask(slice.release());
+  _tasks.runTasks();
+  synchronizedConsumer.flush();
+}
+
+void MsmStrategy::consumeUnitResult(const char* result, size_t size) {
+  ASSERT(size == _unitTerm.getVarCount() * sizeof(Exponent));
+  if (size > 0)
+    memcpy(_unitTerm.begin(), result, size);
+  _consumer->consume(_unitTerm);
+}
+
 unique_ptr<MsmSlice> MsmStrategy::newMsmSlice() {
   unique_ptr<Slice> slice(newSlice());
   ASSERT(dynamic_cast<MsmSlice*>(slice.get()) != 0);
@@ -174,6 +310,12 @@ void MsmStrategy::labelSplit(unique_ptr<Slice> sliceParam) {
   _tasks.addTask(slice.release());
 }
 
+/** Combines the output of the two slices of an independence split.
+ The right slice is run first, and its output is stored. Then the
+ left slice is run, and each term that it outputs is combined with
+ each stored term from the right slice. The split object is scheduled
+ as a task to run after the right slice is done and then again after
+ the left slice is done. */
 class MsmIndependenceSplit : public TermConsumer, public Task {
 public:
   Task* getLeftEvent() {
@@ -197,20 +339,36 @@ public:
   }
 
   void reset(TermConsumer* consumer,
-             IndependenceSplitter& splitter) {
+             IndependenceSplitter& splitter,
+             bool synchronize) {
     _consumer = consumer;
     _tmpTerm.reset(splitter.getVarCount());
+    _synchronize = synchronize;
 
     splitter.getBigProjection(_leftProjection);
     splitter.getRestProjection(_rightProjection);
 
     _rightConsumer._decom.clearAndSetVarCount
       (_rightProjection.getRangeVarCount());
+    _rightConsumer._synchronize = synchronize;
+  }
+
+  /** The left slice is run once this object is run the first time. */
+  void setLeftSlice(unique_ptr<MsmSlice> leftSlice) {
+    _leftSlice = std::move(leftSlice);
   }
 
 private:
   virtual void run(TaskEngine& engine) {
-    dispose();
+    if (_leftSlice.get() == 0) {
+      // Both slices are done.
+      dispose();
+      return;
+    }
+
+    // The right slice is done, so run the left slice and then run
+    // this object again.
+    engine.addTask(_leftSlice.release(), this);
   }
 
   virtual void dispose() {
@@ -224,6 +382,10 @@ private:
   }
 
   virtual void consume(const Term& term) {
+    std::unique_lock<std::mutex> lock(_mutex, std::defer_lock);
+    if (_synchronize)
+      lock.lock();
+
     _leftProjection.inverseProject(_tmpTerm, term);
     Ideal::const_iterator stop = _rightConsumer._decom.end();
     for (Ideal::const_iterator it = _rightConsumer._decom.begin();
@@ -241,13 +403,24 @@ private:
     }
 
     virtual void consume(const Term& term) {
+      std::unique_lock<std::mutex> lock(_mutex, std::defer_lock);
+      if (_synchronize)
+        lock.lock();
       _decom.insert(term);
     }
 
     Ideal _decom;
+    bool _synchronize;
+    std::mutex _mutex;
   } _rightConsumer;
 
   TermConsumer* _consumer;
+  unique_ptr<MsmSlice> _leftSlice;
+
+  /** Lock _mutex when consuming if true, as then the slices of the
+   split can be run on several threads at once. */
+  bool _synchronize;
+  std::mutex _mutex;
 
   Projection _leftProjection;
   Projection _rightProjection;
@@ -262,21 +435,21 @@ void MsmStrategy::independenceSplit(unique_ptr<Slice> sliceParam) {
     (static_cast<MsmSlice*>(sliceParam.release()));
 
   // Construct split object
-  unique_ptr<MsmIndependenceSplit> autoSplit(new MsmIndependenceSplit());
-  autoSplit->reset(slice->getConsumer(), _indep);
-  MsmIndependenceSplit* split = autoSplit.release();
-  _tasks.addTask(split); // Runs when we are done with all of this split.
+  unique_ptr<MsmIndependenceSplit> split(new MsmIndependenceSplit());
+  split->reset(slice->getConsumer(), getIndependenceSplitter(), isParallel());
 
   // Construct left slice.
   unique_ptr<MsmSlice> leftSlice(new MsmSlice(*this));
-  leftSlice->setToProjOf(*slice, split->getLeftProjection(), split);
-  _tasks.addTask(leftSlice.release());
+  leftSlice->setToProjOf(*slice, split->getLeftProjection(), split.get());
+  split->setLeftSlice(std::move(leftSlice));
 
   // Construct right slice.
   unique_ptr<MsmSlice> rightSlice(new MsmSlice(*this));
   rightSlice->setToProjOf(*slice, split->getRightProjection(),
                           split->getRightConsumer());
-  _tasks.addTask(rightSlice.release());
+
+  // The split runs when we are done with the right slice.
+  _tasks.addTask(rightSlice.release(), split.release());
 
   // Deal with slice.
   freeSlice(std::move(slice));
@@ -23,6 +23,7 @@
 #include <vector>
 #include "SplitStrategy.h"
 #include "IndependenceSplitter.h"
+#include "Term.h"
 
 class MsmSlice;
 class Term;
@@ -59,9 +60,15 @@ class MsmStrategy : public SliceStrategyCommon {
 
   size_t getLabelSplitVariable(const Slice& slice);
 
-  IndependenceSplitter _indep;
+  virtual void runUnit(const string& unit, const ResultSender& sendResult);
+  virtual void consumeUnitResult(const char* result, size_t size);
+
   TermConsumer* _consumer;
 
+  /** Used by consumeUnitResult to avoid reallocating a term for each
+   result. */
+  Term _unitTerm;
+
   unique_ptr<Ideal> _initialSubtract;
 };
 
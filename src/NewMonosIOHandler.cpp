@@ -37,7 +37,8 @@ namespace IO {
 
   class NewMonosIdealWriter : public IdealWriter {
   public:
-    NewMonosIdealWriter(FILE* out): IdealWriter(out) {
+    NewMonosIdealWriter(FILE* out, size_t threadCount):
+      IdealWriter(out, threadCount) {
     }
 
   private:
@@ -79,8 +80,9 @@ namespace IO {
     return "newmonos";
   }
 
-  BigTermConsumer* NewMonosIOHandler::doCreateIdealWriter(FILE* out) {
-    return new NewMonosIdealWriter(out);
+  BigTermConsumer* NewMonosIOHandler::
+  doCreateIdealWriter(FILE* out, size_t threadCount) {
+    return new NewMonosIdealWriter(out, threadCount);
   }
 
   void NewMonosIOHandler::doWriteTerm(const vector<mpz_class>& term,
@@ -44,11 +44,13 @@ namespace IO {
     return "null";
   }
 
-  BigTermConsumer* NullIOHandler::doCreateIdealWriter(FILE* out) {
+  BigTermConsumer* NullIOHandler::
+  doCreateIdealWriter(FILE* out, size_t threadCount) {
     return new NullTermConsumer();
   }
 
-  CoefBigTermConsumer* NullIOHandler::doCreatePolynomialWriter(FILE* out) {
+  CoefBigTermConsumer* NullIOHandler::
+  doCreatePolynomialWriter(FILE* out, size_t threadCount) {
     return new NullCoefTermConsumer();
   }
 
@@ -26,6 +26,7 @@ OptimizeStrategy::OptimizeStrategy(TermGrader& grader,
                                    BoundSetting boundSetting):
   MsmStrategy(this, splitStrategy),
   _grader(grader),
+  _wordMaxValueToBeat(0),
   _maxSolutions(grader.getVarCount()),
   _reportAllSolutions(reportAllSolutions),
   _boundSetting(boundSetting),
@@ -51,11 +52,33 @@ void OptimizeStrategy::setUseIndependence(bool use) {
   ASSERT(!use);
 }
 
+void OptimizeStrategy::setThreadCount(size_t threadCount) {
+  ASSERT(threadCount <= 1);
+}
+
+void OptimizeStrategy::setProcessCount(size_t processCount) {
+  ASSERT(processCount <= 1);
+}
+
+void OptimizeStrategy::setCheckpoint(const string& path,
+                                     size_t intervalSeconds,
+                                     bool resume) {
+  ASSERT(path.empty());
+}
+
 void OptimizeStrategy::beginConsuming() {
   _maxSolutions.clear();
 }
 
 void OptimizeStrategy::consume(const Term& term) {
+  if (_grader.hasWordGrades()) {
+    // Most terms do not improve on the best value found so far, so
+    // check that using machine integers before using GMP.
+    long wordDegree = _grader.getWordDegree(term);
+    if (!_maxSolutions.isZeroIdeal() && wordDegree <= _wordMaxValueToBeat)
+      return;
+  }
+
   mpz_class& degree = _consume_tmpDegree;
 
   _grader.getDegree(term, degree);
@@ -65,6 +88,8 @@ void OptimizeStrategy::consume(const Term& term) {
     else {
       _maxValue = degree;
       _maxValueToBeat = degree - _reportAllSolutions;
+      if (_grader.hasWordGrades())
+        _wordMaxValueToBeat = _maxValueToBeat.get_si();
       _maxSolutions.clear();
       _maxSolutions.insert(term);
     }
@@ -103,12 +128,22 @@ bool OptimizeStrategy::simplify(Slice& slice) {
 
     // Obtain upper bound on the degree of elements of msm(I).
     mpz_class& upperBound = _simplify_tmpUpperBound;
-    _grader.getUpperBound(slice.getMultiply(), dominator, upperBound);
+    bool canImprove;
+    if (_grader.hasWordGrades()) {
+      long wordBound =
+        _grader.getWordUpperBound(slice.getMultiply(), dominator);
+      canImprove = wordBound > _wordMaxValueToBeat;
+      if (canImprove && _boundSetting == UseBoundToEliminateAndSimplify)
+        upperBound = wordBound;
+    } else {
+      _grader.getUpperBound(slice.getMultiply(), dominator, upperBound);
+      canImprove = upperBound > _maxValueToBeat;
+    }
 
     // Check if improvement on the best value found so far is possible
     // from this slice according to the bound. If it is not, then
     // there is no point in looking further at this slice.
-    if (upperBound <= _maxValueToBeat) {
+    if (!canImprove) {
       slice.clearIdealAndSubtract();
       return true;
     }
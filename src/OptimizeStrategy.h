@@ -90,6 +90,27 @@ public:
   */
   virtual void setUseIndependence(bool use);
 
+  /** Parallel computation is not supported, since the bound is shared
+   among all slices, so calling this method does nothing. Will assert
+   in debug mode if threadCount is more than one.
+  */
+  virtual void setThreadCount(size_t threadCount);
+
+  /** Computation on several processes is not supported, since the
+   bound is shared among all slices, so calling this method does
+   nothing. Will assert in debug mode if processCount is more than
+   one.
+  */
+  virtual void setProcessCount(size_t processCount);
+
+  /** Checkpoints are not supported, since the bound is shared among
+   all slices, so calling this method does nothing. Will assert in
+   debug mode if path is not empty.
+  */
+  virtual void setCheckpoint(const string& path,
+                             size_t intervalSeconds,
+                             bool resume);
+
   virtual void getPivot(Term& pivot, Slice& slice);
 
   /** This method calls MsmStrategy::simplify to perform the usual
@@ -360,6 +381,11 @@ public:
   */
   mpz_class _maxValueToBeat;
 
+  /** Equal to _maxValueToBeat when _grader.hasWordGrades() is true
+   and a solution has been found, so that comparisons against it can
+   be done using machine integers. */
+  long _wordMaxValueToBeat;
+
   /** Stores the optimal solutions found so far, according to the best
    value found so far.
   */
@@ -196,32 +196,60 @@ searchForMore:
   }
 }
 
-EulerState* PivotEulerAlg::processState(EulerState& state) {
+/** Processes a substate that was split off to be run by whichever
+ thread gets to it first. The substate is copied into an arena owned
+ by the task so that it does not depend on the arena of the thread that
+ made the split. */
+class PivotEulerAlg::StateTask : public Task {
+public:
+  StateTask(PivotEulerAlg& alg, const EulerState& state):
+    _alg(alg), _state(EulerState::construct(state, &_arena)) {}
+
+  virtual void run(TaskEngine& tasks) {
+    Thread& thread = *_alg._threads[tasks.getCurrentWorker()];
+    _alg.processStates(_state, _arena, thread, &tasks);
+    delete this;
+  }
+
+  virtual void dispose() {
+    delete this;
+  }
+
+private:
+  PivotEulerAlg& _alg;
+  Arena _arena;
+  EulerState* _state;
+};
+
+EulerState* PivotEulerAlg::processState(EulerState& state, Thread& thread) {
   state.compactEliminatedVariablesIfProfitable();
 
+  mpz_class& euler = thread.euler;
+  Word* termTmp = &(thread.termTmp[0]);
+
   // ** First optimize state and return false if a base case is detected.
   while (true) {
 	ASSERT(state.debugIsValid());
 
-	if (baseCaseSimple1(_euler, state))
+	if (baseCaseSimple1(euler, state))
 	  return 0;
 
-	state.getIdeal().getVarDividesCounts(_divCountsTmp);
-	size_t* divCountsTmp = &(_divCountsTmp[0]);
+	state.getIdeal().getVarDividesCounts(thread.divCountsTmp);
+	size_t* divCountsTmp = &(thread.divCountsTmp[0]);
 
 	if (_useUniqueDivSimplify &&
-		optimizeOneDivCounts(state, divCountsTmp, _termTmp))
+		optimizeOneDivCounts(state, divCountsTmp, termTmp))
 	  continue;
 	if (_useManyDivSimplify &&
-		optimizeSimpleFromDivCounts(_euler, state, divCountsTmp, _termTmp))
+		optimizeSimpleFromDivCounts(euler, state, divCountsTmp, termTmp))
 	  continue;
 	if (_useAllPairsSimplify) {
-	  if (optimizeVarPairs(state, _termTmp, divCountsTmp))
+	  if (optimizeVarPairs(state, termTmp, divCountsTmp))
 		continue;
-	  if (baseCasePreconditionSimplified(_euler, state))
+	  if (baseCasePreconditionSimplified(euler, state))
 		return 0;
 	}
-    if (_autoTranspose && autoTranspose(state))
+    if (_autoTranspose && autoTranspose(state, thread))
       continue;
 	break;
   }
@@ -229,9 +257,9 @@ EulerState* PivotEulerAlg::processState(EulerState& state) {
   // ** State is not a base case so perform a split while putting the
   // two sub-states into state and newState.
 
-  size_t* divCountsTmp = &(_divCountsTmp[0]);
-  ASSERT(_pivotStrategy.get() != 0);
-  EulerState* next = _pivotStrategy->doPivot(state, divCountsTmp);
+  size_t* divCountsTmp = &(thread.divCountsTmp[0]);
+  ASSERT(thread.pivotStrategy.get() != 0);
+  EulerState* next = thread.pivotStrategy->doPivot(state, divCountsTmp);
 
   return next;
 }
@@ -242,17 +270,42 @@ void PivotEulerAlg::getPivot(const EulerState& state, Word* pivot) {
 
 PivotEulerAlg::PivotEulerAlg():
   _euler(0),
-  _termTmp(0),
   _useUniqueDivSimplify(true),
   _useManyDivSimplify(true),
   _useAllPairsSimplify(false),
   _autoTranspose(true),
   _initialAutoTranspose(true) {
+  _threads.push_back(new Thread());
+}
+
+PivotEulerAlg::~PivotEulerAlg() {
+  for (size_t i = 0; i < _threads.size(); ++i)
+    delete _threads[i];
+}
+
+void PivotEulerAlg::setPivotStrategy
+(size_t thread, unique_ptr<PivotStrategy> strategy) {
+  ASSERT(thread < _threads.size());
+  _threads[thread]->pivotStrategy = std::move(strategy);
+}
+
+void PivotEulerAlg::setThreadCount(size_t threadCount) {
+  if (threadCount == 0)
+    threadCount = 1;
+  while (_threads.size() > threadCount) {
+    delete _threads.back();
+    _threads.pop_back();
+  }
+  _threads.reserve(threadCount);
+  while (_threads.size() < threadCount) {
+    unique_ptr<Thread> thread(new Thread());
+    exceptionSafePushBack(_threads, std::move(thread));
+  }
 }
 
 const mpz_class& PivotEulerAlg::computeEulerCharacteristic(const Ideal& ideal) {
-  if (_pivotStrategy.get() == 0)
-	_pivotStrategy = newDefaultPivotStrategy();
+  if (_threads.front()->pivotStrategy.get() == 0)
+	_threads.front()->pivotStrategy = newDefaultPivotStrategy();
 
   if (ideal.getGeneratorCount() == 0)
 	_euler = 0;
@@ -260,22 +313,18 @@ const mpz_class& PivotEulerAlg::computeEulerCharacteristic(const Ideal& ideal) {
 	_euler = -1;
   else {
     const size_t maxDim = std::max(ideal.getVarCount(), ideal.getGeneratorCount());
-	LocalArray<Word> termTmp(Ops::getWordCount(maxDim));
-	_termTmp = termTmp.begin();
 	EulerState* state = EulerState::construct(ideal, &(Arena::getArena()));
-	computeEuler(state);
-    _termTmp = 0;
+	computeEuler(state, maxDim);
   }
-  _pivotStrategy->computationCompleted(*this);
+  _threads.front()->pivotStrategy->computationCompleted(*this);
 
   return _euler;
 }
 
 const mpz_class& PivotEulerAlg::computeEulerCharacteristic
 (const RawSquareFreeIdeal& ideal) {
-  if (_pivotStrategy.get() == 0)
-	_pivotStrategy = newDefaultPivotStrategy();
-
+  if (_threads.front()->pivotStrategy.get() == 0)
+	_threads.front()->pivotStrategy = newDefaultPivotStrategy();
 
   if (ideal.getGeneratorCount() == 0)
 	_euler = 0;
@@ -283,33 +332,69 @@ const mpz_class& PivotEulerAlg::computeEulerCharacteristic
 	_euler = -1;
   else {
     const size_t maxDim = std::max(ideal.getVarCount(), ideal.getGeneratorCount());
-	LocalArray<Word> termTmp(Ops::getWordCount(maxDim));
-	_termTmp = termTmp.begin();
 	EulerState* state = EulerState::construct(ideal, &(Arena::getArena()));
-	computeEuler(state);
-    _termTmp = 0;
+	computeEuler(state, maxDim);
   }
-  _pivotStrategy->computationCompleted(*this);
+  _threads.front()->pivotStrategy->computationCompleted(*this);
 
   return _euler;
 }
 
-void PivotEulerAlg::computeEuler(EulerState* state) {
+void PivotEulerAlg::computeEuler(EulerState* state, size_t maxDim) {
+  for (size_t i = 0; i < _threads.size(); ++i) {
+    Thread& thread = *_threads[i];
+    if (thread.pivotStrategy.get() == 0)
+      thread.pivotStrategy = newDefaultPivotStrategy();
+    thread.euler = 0;
+    thread.termTmp.resize(Ops::getWordCount(maxDim));
+  }
+
   _euler = 0;
   if (_initialAutoTranspose)
-    autoTranspose(*state);
+    autoTranspose(*state, *_threads.front());
+
+  if (_threads.size() == 1) {
+    processStates(state, Arena::getArena(), *_threads.front(), 0);
+    _euler = _threads.front()->euler;
+    return;
+  }
+
+  TaskEngine tasks;
+  tasks.setThreadCount(_threads.size());
+  {
+    unique_ptr<StateTask> task(new StateTask(*this, *state));
+    Arena::getArena().freeAndAllAfter(state);
+    tasks.addTask(task.get());
+    task.release();
+  }
+  tasks.runTasks();
+
+  for (size_t i = 0; i < _threads.size(); ++i)
+    _euler += _threads[i]->euler;
+}
+
+void PivotEulerAlg::processStates(EulerState* state, Arena& arena,
+                                  Thread& thread, TaskEngine* tasks) {
   while (state != 0) {
-	EulerState* nextState = processState(*state);
+	EulerState* nextState = processState(*state, thread);
 	if (nextState == 0) {
 	  nextState = state->getParent();
-	  Arena::getArena().freeAndAllAfter(state);
-	}
+	  arena.freeAndAllAfter(state);
+	} else if (tasks != 0 && tasks->wantsMoreTasks()) {
+      // Let another thread have the substate. It is the most recent
+      // allocation from arena, so it can be freed right away.
+      unique_ptr<StateTask> task(new StateTask(*this, *nextState));
+      arena.freeAndAllAfter(nextState);
+      tasks->addTask(task.get());
+      task.release();
+      nextState = state;
+    }
 	state = nextState;
   }
 }
 
-bool PivotEulerAlg::autoTranspose(EulerState& state) {
-  if (!_pivotStrategy->shouldTranspose(state))
+bool PivotEulerAlg::autoTranspose(EulerState& state, Thread& thread) {
+  if (!thread.pivotStrategy->shouldTranspose(state))
     return false;
   state.transpose();
   return true;
@@ -26,19 +26,39 @@
 class Ideal;
 class RawSquareFreeIdeal;
 class EulerState;
+class Arena;
+class TaskEngine;
 
 class PivotEulerAlg {
  public:
   PivotEulerAlg();
+  ~PivotEulerAlg();
 
   const mpz_class& computeEulerCharacteristic(const Ideal& ideal);
   const mpz_class& computeEulerCharacteristic(const RawSquareFreeIdeal& ideal);
   const mpz_class& getComputedEulerCharacteristic() const {return _euler;}
 
   void setPivotStrategy(unique_ptr<PivotStrategy> strategy) {
-	_pivotStrategy = std::move(strategy);
+	setPivotStrategy(0, std::move(strategy));
   }
 
+  /** Sets the pivot strategy of the given thread. Pivot strategies
+   keep scratch state, so each thread needs its own. thread must be
+   less than getThreadCount(). A thread that has no strategy set uses
+   the default strategy. The choice of pivots does
+   not change the Euler characteristic, only how long it takes to
+   compute it. */
+  void setPivotStrategy(size_t thread, unique_ptr<PivotStrategy> strategy);
+
+  /** Sets the number of threads to use. If it is more than one, then
+   the two substates of a split are processed by different threads
+   when there are threads without work. Each thread has its own
+   partial Euler characteristic and these are summed at the end. Only
+   the strategy of the first thread is informed when the computation
+   completes. A thread count of zero is interpreted as one. */
+  void setThreadCount(size_t threadCount);
+  size_t getThreadCount() const {return _threads.size();}
+
   void setInitialAutoTranspose(bool value) {_initialAutoTranspose = value;}
   bool getInitialAutoTranspose() const {return _initialAutoTranspose;}
 
@@ -55,22 +75,32 @@ class PivotEulerAlg {
   bool getUseAllPairsSimplify() const {return _useAllPairsSimplify;}
 
  private:
-  void computeEuler(EulerState* state);
-  bool autoTranspose(EulerState& state);
-
-  EulerState* processState(EulerState& state);
+  /** The part of the state of the algorithm that each thread has
+   its own copy of. */
+  struct Thread {
+	mpz_class euler;
+	vector<Word> termTmp;
+	vector<size_t> divCountsTmp;
+	unique_ptr<PivotStrategy> pivotStrategy;
+  };
+  class StateTask;
+
+  void computeEuler(EulerState* state, size_t maxDim);
+  void processStates(EulerState* state, Arena& arena,
+                     Thread& thread, TaskEngine* tasks);
+  bool autoTranspose(EulerState& state, Thread& thread);
+
+  EulerState* processState(EulerState& state, Thread& thread);
   void getPivot(const EulerState& state, Word* pivot);
 
   mpz_class _euler;
-  Word* _termTmp;
-  vector<size_t> _divCountsTmp;
+  vector<Thread*> _threads;
 
   bool _useUniqueDivSimplify;
   bool _useManyDivSimplify;
   bool _useAllPairsSimplify;
   bool _autoTranspose;
   bool _initialAutoTranspose;
-  unique_ptr<PivotStrategy> _pivotStrategy;
 };
 
 #endif
@@ -22,6 +22,7 @@
 #include "RawSquareFreeTerm.h"
 #include "ElementDeleter.h"
 #include "PivotEulerAlg.h"
+#include "RandomSource.h"
 
 #include <sstream>
 #include <limits>
@@ -221,7 +222,7 @@ namespace {
   private:
 	size_t getRandomNotEliminatedVar(const EulerState& state) {
 	  while (true) {
-		size_t random = rand() % state.getVarCount();
+		size_t random = RandomSource::getRandom() % state.getVarCount();
 		if (Ops::getExponent(state.getEliminatedVars(), random) == 0)
 		  return random;
 	  }
@@ -715,7 +716,7 @@ namespace {
   class GenRandom  : public GenStrategy {
   public:
 	virtual EulerState* doPivot(EulerState& state, const size_t* divCounts) {
-	  size_t pivotIndex = rand() % state.getIdeal().getGeneratorCount();
+	  size_t pivotIndex = RandomSource::getRandom() % state.getIdeal().getGeneratorCount();
 	  return state.inPlaceGenSplit(pivotIndex);
 	}
 
@@ -723,7 +724,7 @@ namespace {
 							const size_t* divCounts,
 							const size_t varCount) {
 	  const size_t genCount = end - begin;
-	  const size_t choice = rand() % genCount;
+	  const size_t choice = RandomSource::getRandom() % genCount;
 	  Ops::swap(*begin, *(begin + choice), varCount);
 	  return ++begin;
 	}
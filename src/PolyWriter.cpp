@@ -20,11 +20,17 @@
 
 #include "BigPolynomial.h"
 #include "Term.h"
+#include "TermTranslator.h"
+#include "ProgressReporter.h"
+
+#include <algorithm>
 
 namespace IO {
-  PolyWriter::PolyWriter(FILE* out):
-    _out(out),
-    _firstTerm(true) {
+  PolyWriter::PolyWriter(FILE* out, size_t threadCount, bool chunked):
+    _output(out, threadCount, chunked),
+    _firstTerm(true),
+    _bufferedTranslator(0),
+    _bufferStartsPoly(false) {
   }
 
   void PolyWriter::consumeRing(const VarNames& names) {
@@ -32,6 +38,7 @@ namespace IO {
   }
 
   void PolyWriter::beginConsuming() {
+    writeBufferedTerms();
     _firstTerm = true;
     doWriteHeader();
   }
@@ -40,6 +47,24 @@ namespace IO {
                                const Term& term,
                                const TermTranslator& translator) {
     ASSERT(term.getVarCount() == _names.getVarCount());
+    ProgressReporter::noteOutputTerms(1);
+    if (_output.isChunked()) {
+      if (_bufferedTranslator != &translator) {
+        writeBufferedTerms();
+        _bufferedTranslator = &translator;
+      }
+      if (_bufferedCoefs.empty())
+        _bufferStartsPoly = _firstTerm;
+      _firstTerm = false;
+
+      _bufferedCoefs.push_back(coef);
+      _bufferedTerms.insert(_bufferedTerms.end(), term.begin(), term.end());
+      if (_bufferedCoefs.size() >=
+          ChunkedOutput::TermsPerChunk * _output.getChunksPerRound())
+        writeBufferedTerms();
+      return;
+    }
+
     bool firstTerm = _firstTerm; // To get tail recursion.
     _firstTerm = false;
     doWriteTerm(coef, term, translator, firstTerm);
@@ -47,24 +72,70 @@ namespace IO {
 
   void PolyWriter::consume(const mpz_class& coef, const vector<mpz_class>& term) {
     ASSERT(term.size() == _names.getVarCount());
+    ProgressReporter::noteOutputTerms(1);
+    writeBufferedTerms();
     bool firstTerm = _firstTerm; // To get tail recursion.
     _firstTerm = false;
     doWriteTerm(coef, term, firstTerm);
   }
 
   void PolyWriter::doneConsuming() {
+    writeBufferedTerms();
     doWriteFooter(_firstTerm);
   }
 
   void PolyWriter::consume(const BigPolynomial& poly) {
+    writeBufferedTerms();
     consumeRing(poly.getNames());
     _firstTerm = true;
-    doWriteHeader(poly.getTermCount());
-    for (size_t index = 0; index < poly.getTermCount(); ++index)
-      consume(poly.getCoef(index), poly.getTerm(index));
+    const size_t termCount = poly.getTermCount();
+    doWriteHeader(termCount);
+
+    if (_output.isChunked() && termCount > 0) {
+      ProgressReporter::noteOutputTerms(termCount);
+      const size_t chunkSize = ChunkedOutput::TermsPerChunk;
+      const size_t chunkCount = (termCount + chunkSize - 1) / chunkSize;
+      _output.write(chunkCount, [&](size_t chunk) {
+          const size_t begin = chunk * chunkSize;
+          const size_t end = std::min(termCount, begin + chunkSize);
+          for (size_t index = begin; index < end; ++index)
+            doWriteTerm(poly.getCoef(index), poly.getTerm(index), index == 0);
+        });
+      _firstTerm = false;
+    } else {
+      for (size_t index = 0; index < termCount; ++index)
+        consume(poly.getCoef(index), poly.getTerm(index));
+    }
     doneConsuming();
   }
 
+  void PolyWriter::writeBufferedTerms() {
+    if (_bufferedCoefs.empty())
+      return;
+    ASSERT(_bufferedTranslator != 0);
+
+    const TermTranslator& translator = *_bufferedTranslator;
+    translator.prepareStrings();
+
+    const size_t varCount = _names.getVarCount();
+    const size_t termCount = _bufferedCoefs.size();
+    const size_t chunkSize = ChunkedOutput::TermsPerChunk;
+    const size_t chunkCount = (termCount + chunkSize - 1) / chunkSize;
+    _output.write(chunkCount, [&](size_t chunk) {
+        Term term(varCount);
+        const size_t begin = chunk * chunkSize;
+        const size_t end = std::min(termCount, begin + chunkSize);
+        for (size_t index = begin; index < end; ++index) {
+          term = _bufferedTerms.data() + index * varCount;
+          doWriteTerm(_bufferedCoefs[index], term, translator,
+                      index == 0 && _bufferStartsPoly);
+        }
+      });
+
+    _bufferedCoefs.clear();
+    _bufferedTerms.clear();
+  }
+
   void PolyWriter::doWriteHeader(size_t generatorCount) {
     doWriteHeader();
   }
@@ -20,11 +20,15 @@
 
 #include "CoefBigTermConsumer.h"
 #include "VarNames.h"
+#include "ChunkedOutput.h"
 
 namespace IO {
+  /** Base class for writers of polynomials in text formats. Terms
+   are buffered and formatted in chunks in the same way as for
+   IdealWriter. */
   class PolyWriter : public CoefBigTermConsumer {
   public:
-    PolyWriter(FILE* out);
+    PolyWriter(FILE* out, size_t threadCount = 1, bool chunked = true);
 
     virtual void consumeRing(const VarNames& names);
 
@@ -37,10 +41,13 @@ namespace IO {
 
     virtual void consume(const BigPolynomial& poly);
 
-    FILE* getFile() {return _out;}
+    FILE* getFile() {return _output.getFile();}
     const VarNames& getNames() const {return _names;}
 
   private:
+    /** Formats the terms in _bufferedTerms in chunks. */
+    void writeBufferedTerms();
+
     virtual void doWriteHeader(size_t generatorCount);
     virtual void doWriteHeader() = 0;
     virtual void doWriteTerm(const mpz_class& coef,
@@ -52,9 +59,19 @@ namespace IO {
                              bool firstGenerator) = 0;
     virtual void doWriteFooter(bool wasZero) = 0;
 
-    FILE* const _out;
+    ChunkedOutput _output;
     bool _firstTerm;
     VarNames _names;
+
+    /** The coefficients and exponents of terms that have been
+     consumed but not yet written. Terms are only buffered if _output
+     is chunked. */
+    vector<mpz_class> _bufferedCoefs;
+    vector<Exponent> _bufferedTerms;
+    const TermTranslator* _bufferedTranslator;
+
+    /** Whether the first buffered term is the first term. */
+    bool _bufferStartsPoly;
   };
 }
 
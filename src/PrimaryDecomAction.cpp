@@ -32,6 +32,7 @@ PrimaryDecomAction::PrimaryDecomAction():
  false),
 
   _io(DataType::getMonomialIdealType(), DataType::getMonomialIdealListType()) {
+  addResultCacheParam(_params);
 }
 
 void PrimaryDecomAction::obtainParameters(vector<Parameter*>& parameters) {
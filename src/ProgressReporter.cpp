@@ -0,0 +1,344 @@
+/* Frobby: Software for monomial ideal computations.
+   Copyright (C) 2007 Bjarke Hammersholt Roune (www.broune.com)
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see http://www.gnu.org/licenses/.
+*/
+#include "stdinc.h"
+#include "ProgressReporter.h"
+
+#include "Arena.h"
+#include "error.h"
+
+#include <vector>
+#include <algorithm>
+#include <cstring>
+
+std::atomic<bool> ProgressReporter::_isOn(false);
+thread_local ProgressReporter::ThreadCounts ProgressReporter::_threadCounts;
+std::mutex ProgressReporter::_threadsMutex;
+vector<ProgressReporter::ThreadCounts*> ProgressReporter::_threads;
+size_t ProgressReporter::_exitedCounts[CountCount];
+
+namespace {
+  enum Phase {Parse, Translate, Minimize, Compute, Write, PhaseCount};
+
+  const char* const PhaseNames[PhaseCount] =
+    {"parse", "translate", "minimize", "compute", "write"};
+
+  /** Returns the phase of the action that message describes. */
+  Phase getPhase(const char* message) {
+    struct Prefix {
+      const char* word;
+      Phase phase;
+    };
+    static const Prefix prefixes[] = {
+      {"Reading", Parse},
+      {"Validating", Parse},
+      {"Translating", Translate},
+      {"Minimizing", Minimize},
+      {"Writing", Write}
+    };
+    const size_t prefixCount = sizeof(prefixes) / sizeof(*prefixes);
+    for (size_t prefix = 0; prefix < prefixCount; ++prefix) {
+      const char* word = prefixes[prefix].word;
+      if (strncmp(message, word, strlen(word)) == 0)
+        return prefixes[prefix].phase;
+    }
+    return Compute;
+  }
+
+  typedef std::chrono::steady_clock Clock;
+
+  double getSeconds(Clock::duration duration) {
+    return std::chrono::duration<double>(duration).count();
+  }
+
+  double getCpuSeconds(std::clock_t clocks) {
+    return static_cast<double>(clocks) / CLOCKS_PER_SEC;
+  }
+
+  struct RunningAction {
+    Phase phase;
+    string message;
+    std::thread::id thread;
+    Clock::time_point wallBegin;
+    std::clock_t cpuBegin;
+  };
+
+  /** The actions that have begun and not ended yet, and the time
+   spent in each phase by the actions that have ended. */
+  struct Phases {
+    std::mutex mutex;
+    vector<RunningAction> running;
+    double wall[PhaseCount];
+    double cpu[PhaseCount];
+  } phases;
+
+  /** Writes str to out as a JSON string. */
+  void writeJsonString(FILE* out, const string& str) {
+    fputc('"', out);
+    for (size_t i = 0; i < str.size(); ++i) {
+      const unsigned char c = str[i];
+      if (c == '"' || c == '\\')
+        fprintf(out, "\\%c", c);
+      else if (c < ' ')
+        fprintf(out, "\\u%04x", static_cast<unsigned int>(c));
+      else
+        fputc(c, out);
+    }
+    fputc('"', out);
+  }
+}
+
+ProgressReporter::ProgressReporter(size_t intervalSeconds,
+                                   const string& path):
+  _interval(intervalSeconds),
+  _file(0),
+  _json(!path.empty()),
+  _lastSliceCount(0),
+  _stopping(false) {
+  if (intervalSeconds == 0)
+    return;
+  ASSERT(!isOn());
+
+  if (_json) {
+    _file = fopen(path.c_str(), "w");
+    if (_file == 0)
+      reportError("Could not open progress file \"" + path + "\".");
+  } else
+    _file = stderr;
+
+  sumCounts(_beginCounts);
+  {
+    std::lock_guard<std::mutex> lock(phases.mutex);
+    phases.running.clear();
+    for (size_t phase = 0; phase < PhaseCount; ++phase) {
+      phases.wall[phase] = 0;
+      phases.cpu[phase] = 0;
+    }
+  }
+  _wallBegin = Clock::now();
+  _lastReport = _wallBegin;
+  _cpuBegin = std::clock();
+
+  _isOn = true;
+  try {
+    _thread = std::thread([this]() {run();});
+  } catch (...) {
+    _isOn = false;
+    if (_file != stderr)
+      fclose(_file);
+    throw;
+  }
+}
+
+ProgressReporter::~ProgressReporter() {
+  if (_file == 0)
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stopping = true;
+  }
+  _wakeUp.notify_all();
+  _thread.join();
+
+  try {
+    report(true);
+  } catch (...) {
+    // Do not let a failed report end the computation.
+  }
+  _isOn = false;
+  if (_file != stderr)
+    fclose(_file);
+}
+
+ProgressReporter::ThreadCounts::ThreadCounts() {
+  for (size_t count = 0; count < CountCount; ++count)
+    _counts[count].store(0, std::memory_order_relaxed);
+
+  std::lock_guard<std::mutex> lock(_threadsMutex);
+  _threads.push_back(this);
+}
+
+ProgressReporter::ThreadCounts::~ThreadCounts() {
+  std::lock_guard<std::mutex> lock(_threadsMutex);
+  for (size_t count = 0; count < CountCount; ++count)
+    _exitedCounts[count] += get(static_cast<Count>(count));
+  _threads.erase(find(_threads.begin(), _threads.end(), this));
+}
+
+void ProgressReporter::sumCounts(size_t* sums) {
+  std::lock_guard<std::mutex> lock(_threadsMutex);
+  for (size_t count = 0; count < CountCount; ++count) {
+    sums[count] = _exitedCounts[count];
+    for (size_t thread = 0; thread < _threads.size(); ++thread)
+      sums[count] += _threads[thread]->get(static_cast<Count>(count));
+  }
+}
+
+void ProgressReporter::beginPhase(const char* message) {
+  if (!isOn())
+    return;
+
+  RunningAction action;
+  action.phase = getPhase(message);
+  action.message = message;
+  action.thread = std::this_thread::get_id();
+  action.wallBegin = Clock::now();
+  action.cpuBegin = std::clock();
+
+  std::lock_guard<std::mutex> lock(phases.mutex);
+  phases.running.push_back(action);
+}
+
+void ProgressReporter::endPhase() {
+  if (!isOn())
+    return;
+
+  const Clock::time_point wallEnd = Clock::now();
+  const std::clock_t cpuEnd = std::clock();
+  const std::thread::id thread = std::this_thread::get_id();
+
+  // Actions can run on several threads at once in batch mode, so the
+  // action that ends is the last one that the calling thread began. It
+  // is not there if reporting began after the action did.
+  std::lock_guard<std::mutex> lock(phases.mutex);
+  for (size_t i = phases.running.size(); i > 0; --i) {
+    const RunningAction& action = phases.running[i - 1];
+    if (action.thread == thread) {
+      phases.wall[action.phase] += getSeconds(wallEnd - action.wallBegin);
+      phases.cpu[action.phase] += getCpuSeconds(cpuEnd - action.cpuBegin);
+      phases.running.erase(phases.running.begin() + (i - 1));
+      return;
+    }
+  }
+}
+
+void ProgressReporter::run() {
+  std::unique_lock<std::mutex> lock(_mutex);
+  while (!_wakeUp.wait_for(lock, _interval, [this]() {return _stopping;})) {
+    try {
+      report(false);
+    } catch (...) {
+      // Do not let a failed report end the computation.
+    }
+  }
+}
+
+void ProgressReporter::report(bool isFinal) {
+  const Clock::time_point now = Clock::now();
+  const std::clock_t cpuNow = std::clock();
+  const double wall = getSeconds(now - _wallBegin);
+  const double cpu = getCpuSeconds(cpuNow - _cpuBegin);
+
+  size_t counts[CountCount];
+  sumCounts(counts);
+  for (size_t count = 0; count < CountCount; ++count)
+    counts[count] -= _beginCounts[count];
+
+  const size_t slices = counts[Slices];
+  const double sinceLast = getSeconds(now - _lastReport);
+  const double slicesPerSecond = sinceLast > 0 ?
+    (slices - _lastSliceCount) / sinceLast : 0;
+  _lastReport = now;
+  _lastSliceCount = slices;
+
+  const unsigned long baseCases = counts[BaseCases];
+  // Tasks that were pending when reporting began can be removed after
+  // it, and a task can be counted as removed by one thread before the
+  // sum includes it being added by another.
+  const unsigned long pendingTasks =
+    counts[TasksAdded] > counts[TasksRemoved] ?
+    counts[TasksAdded] - counts[TasksRemoved] : 0;
+  const unsigned long outputTerms = counts[OutputTerms];
+  const unsigned long arenaBytes = Arena::getTotalMemoryUse();
+
+  // The time of the actions that are running counts towards their
+  // phase. The current action is the one that began last.
+  double phaseWall[PhaseCount];
+  double phaseCpu[PhaseCount];
+  bool hasAction = false;
+  Phase phase = Compute;
+  string action;
+  double actionWall = 0;
+  {
+    std::lock_guard<std::mutex> lock(phases.mutex);
+    for (size_t p = 0; p < PhaseCount; ++p) {
+      phaseWall[p] = phases.wall[p];
+      phaseCpu[p] = phases.cpu[p];
+    }
+    for (size_t i = 0; i < phases.running.size(); ++i) {
+      const RunningAction& running = phases.running[i];
+      phaseWall[running.phase] += getSeconds(now - running.wallBegin);
+      phaseCpu[running.phase] += getCpuSeconds(cpuNow - running.cpuBegin);
+    }
+    if (!phases.running.empty()) {
+      const RunningAction& last = phases.running.back();
+      hasAction = true;
+      phase = last.phase;
+      action = last.message;
+      actionWall = getSeconds(now - last.wallBegin);
+    }
+  }
+
+  if (_json) {
+    fprintf(_file, "{\"final\":%s,\"wall\":%.3f,\"cpu\":%.3f,\"phase\":",
+            isFinal ? "true" : "false", wall, cpu);
+    if (hasAction) {
+      fprintf(_file, "\"%s\",\"action\":", PhaseNames[phase]);
+      writeJsonString(_file, action);
+      fprintf(_file, ",\"actionWall\":%.3f", actionWall);
+    } else
+      fputs("null,\"action\":null,\"actionWall\":null", _file);
+    fprintf(_file,
+            ",\"slices\":%lu,\"slicesPerSecond\":%.1f,\"baseCases\":%lu,"
+            "\"pendingTasks\":%lu,\"arenaBytes\":%lu,\"outputTerms\":%lu,"
+            "\"phases\":{",
+            static_cast<unsigned long>(slices), slicesPerSecond,
+            baseCases, pendingTasks, arenaBytes, outputTerms);
+    for (size_t p = 0; p < PhaseCount; ++p) {
+      fprintf(_file, "%s\"%s\":{\"wall\":%.3f,\"cpu\":%.3f}",
+              p == 0 ? "" : ",", PhaseNames[p], phaseWall[p], phaseCpu[p]);
+    }
+    fputs("}}\n", _file);
+  } else {
+    fprintf(_file, "Progress %s %.1fs (%.1fs CPU)",
+            isFinal ? "done after" : "at", wall, cpu);
+    if (hasAction) {
+      // Action messages end in a period and some in a newline too.
+      size_t length = action.size();
+      while (length > 0 && (action[length - 1] == '\n' ||
+                            action[length - 1] == '.'))
+        --length;
+      fprintf(_file, ": %s for %.1fs, %.*s",
+              PhaseNames[phase], actionWall,
+              static_cast<int>(length), action.c_str());
+    }
+    fprintf(_file,
+            ".\n  %lu slices (%.1f per second), %lu base cases, "
+            "%lu pending tasks,\n"
+            "  %lu bytes in arenas, %lu output terms.\n"
+            "  Wall-clock/CPU seconds per phase:",
+            static_cast<unsigned long>(slices), slicesPerSecond,
+            baseCases, pendingTasks, arenaBytes, outputTerms);
+    for (size_t p = 0; p < PhaseCount; ++p) {
+      fprintf(_file, "%s%s %.1f/%.1f",
+              p == 0 ? " " : (p == Minimize ? ",\n  " : ", "),
+              PhaseNames[p], phaseWall[p], phaseCpu[p]);
+    }
+    fputs(".\n", _file);
+  }
+  fflush(_file);
+}
@@ -0,0 +1,183 @@
+/* Frobby: Software for monomial ideal computations.
+   Copyright (C) 2007 Bjarke Hammersholt Roune (www.broune.com)
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see http://www.gnu.org/licenses/.
+*/
+#ifndef PROGRESS_REPORTER_GUARD
+#define PROGRESS_REPORTER_GUARD
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <ctime>
+#include <cstdio>
+
+/** Reports on the progress of a computation while it runs, so that a
+ computation that is stuck can be told apart from one that is
+ slow. This is the implementation of the -progress option.
+
+ Code that does the computation notes what it does through the static
+ methods of this class. The notes update counters of the calling
+ thread, so threads do not contend for them, and they do nothing but
+ check a flag while there is no reporter. The reporter sums the
+ counters of all threads on a thread of its own once every interval,
+ and writes a report to standard error or a line of JSON to a file.
+
+ A report has the wall-clock and CPU time so far, the wall-clock and
+ CPU time of each phase so far, the number of slices processed and
+ the number processed per second since the last report, the number of
+ base cases, the number of pending tasks, the bytes of memory in
+ arenas and the number of output terms written. The phases are
+ parse, translate, minimize, compute and write, and the actions that
+ -time prints each belong to one of them. Counts are for this process
+ only, so they do not include what worker processes of -processes do. */
+class ProgressReporter {
+ public:
+  /** Starts reporting once every intervalSeconds seconds to the file
+   at path as JSON lines, or to standard error if path is
+   empty. Nothing is reported if intervalSeconds is zero. There must
+   not be more than one reporter at a time. */
+  ProgressReporter(size_t intervalSeconds, const string& path);
+
+  /** Writes a final report if reporting is on and stops reporting. */
+  ~ProgressReporter();
+
+  /** Returns true if there is a reporter that reports. */
+  static bool isOn() {return _isOn.load(std::memory_order_relaxed);}
+
+  /** Notes that a slice or Bigatti state has been processed, and
+   whether it was a base case. */
+  static void noteSlice(bool isBaseCase) {
+    if (isOn()) {
+      ThreadCounts& counts = _threadCounts;
+      counts.add(Slices, 1);
+      if (isBaseCase)
+        counts.add(BaseCases, 1);
+    }
+  }
+
+  /** Notes that count terms of output have been written. */
+  static void noteOutputTerms(size_t count) {
+    if (isOn())
+      _threadCounts.add(OutputTerms, count);
+  }
+
+  /** Notes that a task has been added to the pending tasks. */
+  static void noteTaskAdded() {
+    if (isOn())
+      _threadCounts.add(TasksAdded, 1);
+  }
+
+  /** Notes that a task has been taken from the pending tasks to be run
+   or disposed of. */
+  static void noteTaskRemoved() {
+    if (isOn())
+      _threadCounts.add(TasksRemoved, 1);
+  }
+
+  /** Notes that the action described by message has begun. The phase
+   of the action is determined from the first word of message. */
+  static void beginPhase(const char* message);
+
+  /** Notes that the action that the calling thread began last has
+   ended. */
+  static void endPhase();
+
+ private:
+  typedef std::chrono::steady_clock Clock;
+
+  /** Reports every interval until stopping is set. */
+  void run();
+
+  void report(bool isFinal);
+
+  enum Count {
+    Slices,
+    BaseCases,
+    OutputTerms,
+    TasksAdded,
+    TasksRemoved,
+    CountCount
+  };
+
+  /** The counters of one thread. Only that thread writes to them, so
+   adding to a counter is a load and a store rather than an atomic
+   read-modify-write. A thread registers its counters the first time
+   it notes something, and when it exits its counts are kept so that
+   they are still part of the sums. */
+  class ThreadCounts {
+  public:
+    ThreadCounts();
+    ~ThreadCounts();
+
+    void add(Count count, size_t value) {
+      std::atomic<size_t>& counter = _counts[count];
+      counter.store(counter.load(std::memory_order_relaxed) + value,
+                    std::memory_order_relaxed);
+    }
+
+    size_t get(Count count) const {
+      return _counts[count].load(std::memory_order_relaxed);
+    }
+
+  private:
+    std::atomic<size_t> _counts[CountCount];
+
+    ThreadCounts(const ThreadCounts&); // not available
+    ThreadCounts& operator=(const ThreadCounts&); // not available
+  };
+
+  /** Sets sums to the sum of each count over all threads. */
+  static void sumCounts(size_t* sums);
+
+  static std::atomic<bool> _isOn;
+  static thread_local ThreadCounts _threadCounts;
+
+  /** The counters of the threads that have noted something and not
+   exited yet, and the sums of the counts of those that have. */
+  static std::mutex _threadsMutex;
+  static vector<ThreadCounts*> _threads;
+  static size_t _exitedCounts[CountCount];
+
+  const std::chrono::seconds _interval;
+
+  /** The file that reports are written to, which is null if reporting
+   is off. */
+  FILE* _file;
+  bool _json;
+
+  Clock::time_point _wallBegin;
+  std::clock_t _cpuBegin;
+
+  /** The sums of the counts when reporting began. */
+  size_t _beginCounts[CountCount];
+
+  /** The time of and slice count at the last report. */
+  Clock::time_point _lastReport;
+  size_t _lastSliceCount;
+
+  std::thread _thread;
+  std::mutex _mutex;
+  std::condition_variable _wakeUp;
+  bool _stopping;
+
+  ProgressReporter(const ProgressReporter&); // not available
+  ProgressReporter& operator=(const ProgressReporter&); // not available
+};
+
+#endif
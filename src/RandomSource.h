@@ -0,0 +1,78 @@
+/* Frobby: Software for monomial ideal computations.
+   Copyright (C) 2007 Bjarke Hammersholt Roune (www.broune.com)
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see http://www.gnu.org/licenses/.
+*/
+#ifndef RANDOM_SOURCE_GUARD
+#define RANDOM_SOURCE_GUARD
+
+#include <random>
+
+/** A source of pseudo-random numbers for the algorithms that make
+ random choices, such as random pivots. Use this rather than
+ std::rand, since the state of std::rand is shared by every thread
+ in the process.
+
+ Each thread has a current source, which is where getRandom() draws
+ from. By default it is a source that belongs to the thread and that
+ is seeded from std::rand the first time it is used. The library
+ interface makes the source of a Frobby::Context current for the
+ duration of a call so that the context owns the random state, and
+ TaskEngine seeds the sources of the threads it starts from the
+ current source of the thread that runs it.
+
+ RandomSource satisfies the requirements of a uniform random bit
+ generator, so it can be passed to std::shuffle and similar.
+*/
+class RandomSource {
+ public:
+  typedef unsigned int result_type;
+
+  /** Constructs a source that is seeded from std::rand. */
+  RandomSource();
+
+  /** Constructs a source that is seeded with seed. */
+  RandomSource(unsigned int seed);
+
+  void setSeed(unsigned int seed);
+
+  result_type operator()() {return _engine();}
+
+  static constexpr result_type min() {return Engine::min();}
+  static constexpr result_type max() {return Engine::max();}
+
+  /** Returns a pseudo-random number from the current source of the
+   calling thread. */
+  static size_t getRandom() {return getThreadSource()();}
+
+  /** Returns the current source of the calling thread. */
+  static RandomSource& getThreadSource() {
+    return _threadSource != 0 ? *_threadSource : _defaultSource;
+  }
+
+  /** Makes source the current source of the calling thread and
+   returns the previous one, which is null for the default source of
+   the thread. Passing null makes the default source current again.
+   The caller must keep source alive while it is current. */
+  static RandomSource* setThreadSource(RandomSource* source);
+
+ private:
+  typedef std::minstd_rand Engine;
+  Engine _engine;
+
+  static thread_local RandomSource _defaultSource;
+  static thread_local RandomSource* _threadSource;
+};
+
+#endif
@@ -21,7 +21,268 @@
 #include <sstream>
 #include <vector>
 
+#ifdef FROBBY_X86_KERNELS
+#include <immintrin.h>
+#endif
+
 namespace SquareFreeTermOps {
+  namespace {
+	inline size_t popCount(Word word) {
+#ifdef __GNUC__
+	  return __builtin_popcountl(word);
+#else
+	  size_t count = 0;
+	  for (; word != 0; word &= word - 1)
+		++count;
+	  return count;
+#endif
+	}
+
+	// ** Scalar kernels. These work on any platform.
+
+	bool scalarDivides(const Word* a, const Word* aEnd, const Word* b) {
+	  for (; a != aEnd; ++a, ++b)
+		if ((*a & (~*b)) != 0)
+		  return false;
+	  return true;
+	}
+
+	bool scalarIsRelativelyPrime
+	(const Word* a, const Word* aEnd, const Word* b) {
+	  for (; a != aEnd; ++a, ++b)
+		if ((*a) & (*b))
+		  return false;
+	  return true;
+	}
+
+	void scalarLcm(Word* res, const Word* resEnd,
+				   const Word* a, const Word* b) {
+	  for (; res != resEnd; ++a, ++b, ++res)
+		*res = (*a) | (*b);
+	}
+
+	void scalarGcd(Word* res, const Word* resEnd,
+				   const Word* a, const Word* b) {
+	  for (; res != resEnd; ++a, ++b, ++res)
+		*res = (*a) & (*b);
+	}
+
+	void scalarColon(Word* res, const Word* resEnd,
+					 const Word* a, const Word* b) {
+	  for (; res != resEnd; ++res, ++a, ++b)
+		*res = (*a) & (~*b);
+	}
+
+	size_t scalarGetSizeOfSupport(const Word* a, const Word* aEnd) {
+	  size_t count = 0;
+	  for (; a != aEnd; ++a)
+		count += popCount(*a);
+	  return count;
+	}
+
+	const KernelTable scalarKernels = {
+	  scalarDivides,
+	  scalarIsRelativelyPrime,
+	  scalarLcm,
+	  scalarGcd,
+	  scalarColon,
+	  scalarGetSizeOfSupport
+	};
+
+#ifdef FROBBY_X86_KERNELS
+	// ** AVX2 kernels. These handle 4 words per instruction. The
+	// result may alias an operand exactly since each vector is loaded
+	// before the corresponding result is stored.
+
+#define FROBBY_AVX2 __attribute__((target("avx2,popcnt")))
+
+	FROBBY_AVX2 inline __m256i avx2Load(const Word* a) {
+	  return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a));
+	}
+
+	FROBBY_AVX2 inline void avx2Store(Word* a, __m256i value) {
+	  _mm256_storeu_si256(reinterpret_cast<__m256i*>(a), value);
+	}
+
+	FROBBY_AVX2 bool avx2Divides(const Word* a, const Word* aEnd, const Word* b) {
+	  for (; aEnd - a >= 4; a += 4, b += 4) {
+		// testc returns 1 if all bits of a are also set in b.
+		if (!_mm256_testc_si256(avx2Load(b), avx2Load(a)))
+		  return false;
+	  }
+	  return scalarDivides(a, aEnd, b);
+	}
+
+	FROBBY_AVX2 bool avx2IsRelativelyPrime
+	(const Word* a, const Word* aEnd, const Word* b) {
+	  for (; aEnd - a >= 4; a += 4, b += 4)
+		if (!_mm256_testz_si256(avx2Load(a), avx2Load(b)))
+		  return false;
+	  return scalarIsRelativelyPrime(a, aEnd, b);
+	}
+
+	FROBBY_AVX2 void avx2Lcm(Word* res, const Word* resEnd,
+							 const Word* a, const Word* b) {
+	  for (; resEnd - res >= 4; res += 4, a += 4, b += 4)
+		avx2Store(res, _mm256_or_si256(avx2Load(a), avx2Load(b)));
+	  scalarLcm(res, resEnd, a, b);
+	}
+
+	FROBBY_AVX2 void avx2Gcd(Word* res, const Word* resEnd,
+							 const Word* a, const Word* b) {
+	  for (; resEnd - res >= 4; res += 4, a += 4, b += 4)
+		avx2Store(res, _mm256_and_si256(avx2Load(a), avx2Load(b)));
+	  scalarGcd(res, resEnd, a, b);
+	}
+
+	FROBBY_AVX2 void avx2Colon(Word* res, const Word* resEnd,
+							   const Word* a, const Word* b) {
+	  for (; resEnd - res >= 4; res += 4, a += 4, b += 4)
+		avx2Store(res, _mm256_andnot_si256(avx2Load(b), avx2Load(a)));
+	  scalarColon(res, resEnd, a, b);
+	}
+
+	// There is no vector population count in AVX2, but the scalar
+	// popcnt instruction is much faster than the portable fallback.
+	FROBBY_AVX2 size_t avx2GetSizeOfSupport(const Word* a, const Word* aEnd) {
+	  size_t count = 0;
+	  for (; a != aEnd; ++a)
+		count += __builtin_popcountl(*a);
+	  return count;
+	}
+
+#undef FROBBY_AVX2
+
+	const KernelTable avx2Kernels = {
+	  avx2Divides,
+	  avx2IsRelativelyPrime,
+	  avx2Lcm,
+	  avx2Gcd,
+	  avx2Colon,
+	  avx2GetSizeOfSupport
+	};
+
+	// ** AVX-512 kernels. These handle 8 words per instruction, and
+	// the last partial vector is handled with a masked load instead
+	// of a scalar loop.
+
+#define FROBBY_AVX512 __attribute__((target("avx512f,popcnt")))
+
+	FROBBY_AVX512 inline __mmask8 avx512TailMask(size_t wordCount) {
+	  ASSERT(wordCount < 8);
+	  return static_cast<__mmask8>((1u << wordCount) - 1);
+	}
+
+	FROBBY_AVX512 bool avx512Divides
+	(const Word* a, const Word* aEnd, const Word* b) {
+	  for (; aEnd - a >= 8; a += 8, b += 8) {
+		__m512i va = _mm512_loadu_si512(a);
+		__m512i vb = _mm512_loadu_si512(b);
+		if (_mm512_test_epi64_mask(va, _mm512_andnot_si512(vb, va)) != 0)
+		  return false;
+	  }
+	  const __mmask8 mask = avx512TailMask(aEnd - a);
+	  __m512i va = _mm512_maskz_loadu_epi64(mask, a);
+	  __m512i vb = _mm512_maskz_loadu_epi64(mask, b);
+	  return _mm512_test_epi64_mask(va, _mm512_andnot_si512(vb, va)) == 0;
+	}
+
+	FROBBY_AVX512 bool avx512IsRelativelyPrime
+	(const Word* a, const Word* aEnd, const Word* b) {
+	  for (; aEnd - a >= 8; a += 8, b += 8)
+		if (_mm512_test_epi64_mask(_mm512_loadu_si512(a),
+								   _mm512_loadu_si512(b)) != 0)
+		  return false;
+	  const __mmask8 mask = avx512TailMask(aEnd - a);
+	  return _mm512_test_epi64_mask(_mm512_maskz_loadu_epi64(mask, a),
+									_mm512_maskz_loadu_epi64(mask, b)) == 0;
+	}
+
+	FROBBY_AVX512 void avx512Lcm(Word* res, const Word* resEnd,
+								 const Word* a, const Word* b) {
+	  for (; resEnd - res >= 8; res += 8, a += 8, b += 8)
+		_mm512_storeu_si512(res, _mm512_or_si512(_mm512_loadu_si512(a),
+												 _mm512_loadu_si512(b)));
+	  const __mmask8 mask = avx512TailMask(resEnd - res);
+	  _mm512_mask_storeu_epi64
+		(res, mask, _mm512_or_si512(_mm512_maskz_loadu_epi64(mask, a),
+									_mm512_maskz_loadu_epi64(mask, b)));
+	}
+
+	FROBBY_AVX512 void avx512Gcd(Word* res, const Word* resEnd,
+								 const Word* a, const Word* b) {
+	  for (; resEnd - res >= 8; res += 8, a += 8, b += 8)
+		_mm512_storeu_si512(res, _mm512_and_si512(_mm512_loadu_si512(a),
+												  _mm512_loadu_si512(b)));
+	  const __mmask8 mask = avx512TailMask(resEnd - res);
+	  _mm512_mask_storeu_epi64
+		(res, mask, _mm512_and_si512(_mm512_maskz_loadu_epi64(mask, a),
+									 _mm512_maskz_loadu_epi64(mask, b)));
+	}
+
+	FROBBY_AVX512 void avx512Colon(Word* res, const Word* resEnd,
+								   const Word* a, const Word* b) {
+	  for (; resEnd - res >= 8; res += 8, a += 8, b += 8)
+		_mm512_storeu_si512(res, _mm512_andnot_si512(_mm512_loadu_si512(b),
+													 _mm512_loadu_si512(a)));
+	  const __mmask8 mask = avx512TailMask(resEnd - res);
+	  _mm512_mask_storeu_epi64
+		(res, mask, _mm512_andnot_si512(_mm512_maskz_loadu_epi64(mask, b),
+										_mm512_maskz_loadu_epi64(mask, a)));
+	}
+
+#undef FROBBY_AVX512
+
+	const KernelTable avx512Kernels = {
+	  avx512Divides,
+	  avx512IsRelativelyPrime,
+	  avx512Lcm,
+	  avx512Gcd,
+	  avx512Colon,
+	  avx2GetSizeOfSupport // AVX-512F has no population count either.
+	};
+#endif
+
+	KernelSet currentKernelSet = ScalarKernels;
+
+	// Selects the best kernels during static initialization. Until
+	// then kernels points to the scalar kernels, which is also
+	// correct.
+	const bool kernelsInitialized = setKernelSet(getBestKernelSet());
+  }
+
+  KernelTable kernels = {
+	scalarDivides,
+	scalarIsRelativelyPrime,
+	scalarLcm,
+	scalarGcd,
+	scalarColon,
+	scalarGetSizeOfSupport
+  };
+
+  KernelSet getKernelSet() {
+	return currentKernelSet;
+  }
+
+  bool setKernelSet(KernelSet set) {
+	if (!isKernelSetSupported(set))
+	  return false;
+	kernels = getKernelTable(set);
+	currentKernelSet = set;
+	return true;
+  }
+
+  const KernelTable& getKernelTable(KernelSet set) {
+	ASSERT(isKernelSetSupported(set));
+#ifdef FROBBY_X86_KERNELS
+	if (set == Avx2Kernels)
+	  return avx2Kernels;
+	if (set == Avx512Kernels)
+	  return avx512Kernels;
+#endif
+	return scalarKernels;
+  }
+
   Word* newTermParse(const char* strParam) {
 	string str(strParam);
 	Word* term = newTerm(str.size());
@@ -71,21 +332,10 @@ namespace SquareFreeTermOps {
   size_t getSizeOfSupport(const Word* a, size_t varCount) {
 	if (varCount == 0)
 	  return 0;
-	size_t count = 0;
-	while (true) {
-	  Word word = *a;
-	  // TODO: should be able to improve this set bit counting algorithm.
-	  while (word != 0) {
-		if ((word & 1) != 0)
-		  ++count;
-		word >>= 1;
-	  }
-
-	  if (varCount <= BitsPerWord)
-		return count;
-	  ++a;
-	  varCount -= BitsPerWord;
-	}
+	const Word* aEnd = a + getWordCount(varCount);
+	if (static_cast<size_t>(aEnd - a) >= MinKernelWordCount)
+	  return kernels.getSizeOfSupport(a, aEnd);
+	return scalarGetSizeOfSupport(a, aEnd);
   }
 
   size_t getWordCount(size_t varCount) {
@@ -174,13 +424,14 @@ namespace SquareFreeTermOps {
   }
 
   void colon(Word* res, const Word* resEnd, const Word* a, const Word* b) {
-	for (; res != resEnd; ++res, ++a, ++b)
-	  *res = (*a) & (~*b);
+	if (static_cast<size_t>(resEnd - res) >= MinKernelWordCount)
+	  kernels.colon(res, resEnd, a, b);
+	else
+	  scalarColon(res, resEnd, a, b);
   }
 
   void colonInPlace(Word* res, const Word* resEnd, const Word* b) {
-	for (; res != resEnd; ++res,  ++b)
-	  *res &= ~*b;
+	colon(res, resEnd, res, b);
   }
 
   void assign(Word* a, const Word* b, size_t varCount) {
@@ -250,61 +501,51 @@ namespace SquareFreeTermOps {
 
   void lcm(Word* res, const Word* resEnd,
 				  const Word* a, const Word* b) {
-	for (; res != resEnd; ++a, ++b, ++res)
-	  *res = (*a) | (*b);
+	if (static_cast<size_t>(resEnd - res) >= MinKernelWordCount)
+	  kernels.lcm(res, resEnd, a, b);
+	else
+	  scalarLcm(res, resEnd, a, b);
   }
 
   void lcm(Word* res, const Word* a, const Word* b, size_t varCount) {
-	for (; varCount >= BitsPerWord; ++a, ++b, ++res, varCount -= BitsPerWord)
-	  *res = (*a) | (*b);
 	if (varCount != 0)
-	  *res = (*a) | (*b);
+	  lcm(res, res + getWordCount(varCount), a, b);
   }
 
   void lcmInPlace(Word* res, const Word* resEnd, const Word* a) {
-	for (; res != resEnd; ++a, ++res)
-	  *res |= *a;
+	lcm(res, resEnd, res, a);
   }
 
   void lcmInPlace(Word* res, const Word* a, size_t varCount) {
-	for (; varCount >= BitsPerWord; ++a, ++res, varCount -= BitsPerWord)
-	  *res |= *a;
 	if (varCount != 0)
-	  *res |= *a;
+	  lcm(res, res + getWordCount(varCount), res, a);
   }
 
   void gcd(Word* res, const Word* resEnd, const Word* a, const Word* b) {
-	for (; res != resEnd; ++a, ++b, ++res)
-	  *res = (*a) & (*b);
+	if (static_cast<size_t>(resEnd - res) >= MinKernelWordCount)
+	  kernels.gcd(res, resEnd, a, b);
+	else
+	  scalarGcd(res, resEnd, a, b);
   }
 
   void gcd(Word* res, const Word* a, const Word* b, size_t varCount) {
-	for (; varCount >= BitsPerWord; ++a, ++b, ++res, varCount -= BitsPerWord)
-	  *res = (*a) & (*b);
 	if (varCount != 0)
-	  *res = (*a) & (*b);
+	  gcd(res, res + getWordCount(varCount), a, b);
   }
 
   void gcdInPlace(Word* res, const Word* resEnd, const Word* a) {
-	for (; res != resEnd; ++a, ++res)
-	  *res &= *a;
+	gcd(res, resEnd, res, a);
   }
 
   void gcdInPlace(Word* res, const Word* a, size_t varCount) {
-	for (; varCount >= BitsPerWord; ++a, ++res, varCount -= BitsPerWord)
-	  *res &= *a;
 	if (varCount != 0)
-	  *res &= *a;
+	  gcd(res, res + getWordCount(varCount), res, a);
   }
 
   bool isRelativelyPrime(const Word* a, const Word* b, size_t varCount) {
-	for (; varCount >= BitsPerWord; ++a, ++b, varCount -= BitsPerWord)
-	  if ((*a) & (*b))
-		return false;
-	if (varCount != 0)
-	  if ((*a) & (*b))
-		return false;
-	return true;
+	if (varCount == 0)
+	  return true;
+	return isRelativelyPrime(a, a + getWordCount(varCount), b);
   }
 
   /** Make 0 exponents 1 and make 1 exponents 0. */
@@ -18,11 +18,46 @@
 #ifndef RAW_SQUARE_FREE_TERM_GUARD
 #define RAW_SQUARE_FREE_TERM_GUARD
 
+#include "KernelSet.h"
+
 #include <ostream>
 #include <algorithm>
 #include <vector>
 
 namespace SquareFreeTermOps {
+  /** Function pointers to the implementation of the operations on
+   ranges of words that are used for long terms. The range functions
+   below call these once the range is long enough for vector
+   instructions to pay off, so that short terms do not pay for the
+   indirect call. */
+  struct KernelTable {
+	bool (*divides)(const Word* a, const Word* aEnd, const Word* b);
+	bool (*isRelativelyPrime)(const Word* a, const Word* aEnd, const Word* b);
+	void (*lcm)(Word* res, const Word* resEnd, const Word* a, const Word* b);
+	void (*gcd)(Word* res, const Word* resEnd, const Word* a, const Word* b);
+	void (*colon)(Word* res, const Word* resEnd, const Word* a, const Word* b);
+	size_t (*getSizeOfSupport)(const Word* a, const Word* aEnd);
+  };
+
+  /** The kernels in use. This is set to the best kernels that the CPU
+   supports before main() is entered. */
+  extern KernelTable kernels;
+
+  /** Ranges of at least this many words are handled by kernels. */
+  const size_t MinKernelWordCount = 4;
+
+  /** Returns the kernel set that kernels currently points to. */
+  KernelSet getKernelSet();
+
+  /** Points kernels to the given set and returns true if it is
+   supported. Otherwise does nothing and returns false. This is for
+   benchmarks and tests, and it must not be called while another
+   thread could be using kernels. */
+  bool setKernelSet(KernelSet set);
+
+  /** Returns the table of kernels for set, which must be supported. */
+  const KernelTable& getKernelTable(KernelSet set);
+
   bool isIdentity(const Word* a, Word* aEnd);
 
   bool isIdentity(const Word* a, size_t varCount);
@@ -142,6 +177,8 @@ namespace SquareFreeTermOps {
   bool isValid(const Word* a, size_t varCount);
 
   inline bool divides(const Word* a, const Word* aEnd, const Word* b) {
+	if (static_cast<size_t>(aEnd - a) >= MinKernelWordCount)
+	  return kernels.divides(a, aEnd, b);
 	for (; a != aEnd; ++a, ++b)
 	  if ((*a & (~*b)) != 0)
 		return false;
@@ -193,6 +230,8 @@ namespace SquareFreeTermOps {
   }
 
   inline bool isRelativelyPrime(const Word* a, const Word* aEnd, const Word* b) {
+	if (static_cast<size_t>(aEnd - a) >= MinKernelWordCount)
+	  return kernels.isRelativelyPrime(a, aEnd, b);
 	for (; a != aEnd; ++a, ++b)
 	  if ((*a) & (*b))
 		return false;
@@ -19,6 +19,8 @@
 #include "RawSquareFreeTerm.h"
 #include "tests.h"
 
+#include <algorithm>
+
 TEST_SUITE(RawSquareFreeTerm)
 
 using namespace SquareFreeTermOps;
@@ -575,3 +577,63 @@ TEST(RawSquareFreeTerm, Compact) {
 			   "000000000000000000000000000000100000000000000001",
 			   "0111111111111111111111111111111111111111111110");
 }
+
+TEST(RawSquareFreeTerm, Kernels) {
+  ASSERT_TRUE(isKernelSetSupported(ScalarKernels));
+  ASSERT_TRUE(isKernelSetSupported(getKernelSet()));
+  const KernelTable& scalar = getKernelTable(ScalarKernels);
+
+  // Compare every supported kernel set to the scalar kernels for
+  // lengths that do and do not fill the last vector. Offsetting the
+  // terms by a word makes sure that unaligned terms work.
+  Word seed = 1;
+  for (int set = 0; set < KernelSetCount; ++set) {
+	if (!isKernelSetSupported(static_cast<KernelSet>(set)))
+	  continue;
+	const KernelTable& kernel = getKernelTable(static_cast<KernelSet>(set));
+	for (size_t wordCount = 0; wordCount < 20; ++wordCount) {
+	  for (size_t round = 0; round < 8; ++round) {
+		vector<Word> buffer(4 * (wordCount + 1));
+		for (size_t i = 0; i < buffer.size(); ++i) {
+		  seed = seed * 6364136223846793005ul + 1442695040888963407ul;
+		  buffer[i] = seed ^ (seed >> 29);
+		}
+		Word* a = &buffer[1];
+		Word* b = a + wordCount + 1;
+		Word* res = b + wordCount + 1;
+		Word* expected = res + wordCount;
+		Word* aEnd = a + wordCount;
+		if (round % 2 == 1) {
+		  // Make a divide b.
+		  for (size_t i = 0; i < wordCount; ++i)
+			b[i] |= a[i];
+		}
+
+		ASSERT_EQ(kernel.divides(a, aEnd, b), scalar.divides(a, aEnd, b));
+		ASSERT_EQ(kernel.divides(b, b + wordCount, a),
+				  scalar.divides(b, b + wordCount, a));
+		ASSERT_EQ(kernel.isRelativelyPrime(a, aEnd, b),
+				  scalar.isRelativelyPrime(a, aEnd, b));
+		ASSERT_EQ(kernel.getSizeOfSupport(a, aEnd),
+				  scalar.getSizeOfSupport(a, aEnd));
+
+		scalar.lcm(expected, expected + wordCount, a, b);
+		kernel.lcm(res, res + wordCount, a, b);
+		ASSERT_TRUE(std::equal(res, res + wordCount, expected));
+
+		scalar.gcd(expected, expected + wordCount, a, b);
+		kernel.gcd(res, res + wordCount, a, b);
+		ASSERT_TRUE(std::equal(res, res + wordCount, expected));
+
+		scalar.colon(expected, expected + wordCount, a, b);
+		kernel.colon(res, res + wordCount, a, b);
+		ASSERT_TRUE(std::equal(res, res + wordCount, expected));
+
+		// The word after the result must not be touched.
+		Word after = res[wordCount];
+		kernel.lcm(res, res + wordCount, res, a);
+		ASSERT_EQ(res[wordCount], after);
+	  }
+	}
+  }
+}
@@ -0,0 +1,436 @@
+/* Frobby: Software for monomial ideal computations.
+   Copyright (C) 2007 Bjarke Hammersholt Roune (www.broune.com)
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see http://www.gnu.org/licenses/.
+*/
+#include "stdinc.h"
+#include "ResultCache.h"
+
+#include "Ideal.h"
+#include "Term.h"
+#include "TermTranslator.h"
+#include "VarNames.h"
+#include "BigIdeal.h"
+#include "BigPolynomial.h"
+#include "BigTermConsumer.h"
+#include "CoefBigTermConsumer.h"
+#include "CoefBigTermRecorder.h"
+#include "BinaryIOHandler.h"
+#include "IOHandler.h"
+#include "InputConsumer.h"
+#include "ElementDeleter.h"
+#include "Scanner.h"
+#include "ActionPrinter.h"
+#include "error.h"
+
+#include <atomic>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+  const char* const Header = "frobby result cache 1\n";
+
+  std::atomic<size_t> hitCount(0);
+  std::atomic<size_t> missCount(0);
+
+  /** Passes an ideal on to a consumer and to a recorder. */
+  class IdealTee : public BigTermConsumer {
+  public:
+    IdealTee(BigTermConsumer& consumer, unique_ptr<BigTermConsumer> recorder):
+      _consumer(consumer),
+      _recorder(std::move(recorder)) {
+    }
+
+    virtual void consumeRing(const VarNames& names) {
+      _consumer.consumeRing(names);
+      _recorder->consumeRing(names);
+    }
+
+    virtual void beginConsumingList() {
+      _consumer.beginConsumingList();
+      _recorder->beginConsumingList();
+    }
+
+    virtual void beginConsuming() {
+      _consumer.beginConsuming();
+      _recorder->beginConsuming();
+    }
+
+    virtual void consume(const Term& term) {
+      _consumer.consume(term);
+      _recorder->consume(term);
+    }
+
+    virtual void consume(const Term& term, const TermTranslator& translator) {
+      _consumer.consume(term, translator);
+      _recorder->consume(term, translator);
+    }
+
+    virtual void consume(const vector<mpz_class>& term) {
+      _consumer.consume(term);
+      _recorder->consume(term);
+    }
+
+    virtual void consume(const BigIdeal& ideal) {
+      _consumer.consume(ideal);
+      _recorder->consume(ideal);
+    }
+
+    virtual void doneConsuming() {
+      _consumer.doneConsuming();
+      _recorder->doneConsuming();
+    }
+
+    virtual void doneConsumingList() {
+      _consumer.doneConsumingList();
+      _recorder->doneConsumingList();
+    }
+
+  private:
+    BigTermConsumer& _consumer;
+    unique_ptr<BigTermConsumer> _recorder;
+  };
+
+  /** Passes a polynomial on to a consumer and to a recorder. */
+  class PolynomialTee : public CoefBigTermConsumer {
+  public:
+    PolynomialTee(CoefBigTermConsumer& consumer,
+                  unique_ptr<CoefBigTermConsumer> recorder):
+      _consumer(consumer),
+      _recorder(std::move(recorder)) {
+    }
+
+    virtual void consumeRing(const VarNames& names) {
+      _consumer.consumeRing(names);
+      _recorder->consumeRing(names);
+    }
+
+    virtual void beginConsuming() {
+      _consumer.beginConsuming();
+      _recorder->beginConsuming();
+    }
+
+    virtual void consume(const mpz_class& coef, const Term& term) {
+      _consumer.consume(coef, term);
+      _recorder->consume(coef, term);
+    }
+
+    virtual void consume(const mpz_class& coef,
+                         const Term& term,
+                         const TermTranslator& translator) {
+      _consumer.consume(coef, term, translator);
+      _recorder->consume(coef, term, translator);
+    }
+
+    virtual void consume(const mpz_class& coef, const vector<mpz_class>& term) {
+      _consumer.consume(coef, term);
+      _recorder->consume(coef, term);
+    }
+
+    virtual void consume(const BigPolynomial& poly) {
+      _consumer.consume(poly);
+      _recorder->consume(poly);
+    }
+
+    virtual void doneConsuming() {
+      _consumer.doneConsuming();
+      _recorder->doneConsuming();
+    }
+
+  private:
+    CoefBigTermConsumer& _consumer;
+    unique_ptr<CoefBigTermConsumer> _recorder;
+  };
+
+  unique_ptr<IOHandler> createBinaryHandler() {
+    return createIOHandler(IO::BinaryIOHandler::staticGetName());
+  }
+}
+
+ResultCache::ResultCache(const string& directory,
+                         bool printActions,
+                         bool printStatistics):
+  _directory(directory),
+  _printActions(printActions),
+  _printStatistics(printStatistics),
+  _storeFile(0) {
+  if (isOn() && mkdir(_directory.c_str(), 0777) != 0 && errno != EEXIST)
+    reportError("Could not create result cache directory \"" +
+                _directory + "\": " + strerror(errno) + '.');
+}
+
+ResultCache::~ResultCache() {
+  if (_storeFile != 0) {
+    fclose(_storeFile);
+    remove(_storePath.c_str());
+  }
+}
+
+void ResultCache::setKey(const string& computation,
+                         const Ideal& ideal,
+                         const TermTranslator& translator) {
+  ASSERT(isOn());
+  ASSERT(ideal.getVarCount() == translator.getVarCount());
+  ASSERT(_storeFile == 0);
+
+  // Sorting makes the key independent of the order of the
+  // generators, and writing out the exponents makes it independent
+  // of how the translator encodes them.
+  Ideal sorted(ideal);
+  sorted.sortLex();
+
+  const VarNames& names = translator.getNames();
+  _key = computation;
+  _key += '\n';
+  for (size_t var = 0; var < names.getVarCount(); ++var) {
+    _key += names.getName(var);
+    _key += ' ';
+  }
+  _key += '\n';
+  Ideal::const_iterator stop = sorted.end();
+  for (Ideal::const_iterator it = sorted.begin(); it != stop; ++it) {
+    for (size_t var = 0; var < sorted.getVarCount(); ++var) {
+      _key += translator.getExponent(var, (*it)[var]).get_str();
+      _key += ' ';
+    }
+    _key += '\n';
+  }
+
+  // The 64 bit FNV-1a hash.
+  unsigned long long hash = 14695981039346656037ULL;
+  for (size_t i = 0; i < _key.size(); ++i) {
+    hash ^= static_cast<unsigned char>(_key[i]);
+    hash *= 1099511628211ULL;
+  }
+  char name[32];
+  snprintf(name, sizeof(name), "%016llx.cache", hash);
+  _path = _directory + '/' + name;
+}
+
+bool ResultCache::lookup(BigTermConsumer& consumer, bool outputIsList) {
+  ActionPrinter printer(_printActions, "Looking up result in cache.");
+  FILE* file = openResult();
+  if (file == 0) {
+    printer.endAction();
+    reportLookup(false);
+    return false;
+  }
+
+  InputConsumer recorder;
+  try {
+    Scanner in(IO::BinaryIOHandler::staticGetName(), file);
+    if (outputIsList)
+      createBinaryHandler()->readIdeals(in, recorder);
+    else
+      createBinaryHandler()->readIdeal(in, recorder);
+    in.expectEOF();
+  } catch (const FrobbyException&) {
+    fclose(file);
+    printer.endAction();
+    reportLookup(false);
+    return false;
+  }
+  fclose(file);
+  printer.endAction();
+  reportLookup(true);
+
+  if (outputIsList) {
+    vector<BigIdeal*> ideals;
+    ElementDeleter<vector<BigIdeal*> > idealsDeleter(ideals);
+    const VarNames names = recorder.getRing();
+    while (!recorder.empty())
+      exceptionSafePushBack(ideals, recorder.releaseBigIdeal());
+
+    consumer.consumeRing(names);
+    consumer.beginConsumingList();
+    for (size_t i = 0; i < ideals.size(); ++i)
+      consumer.consume(*ideals[i]);
+    consumer.doneConsumingList();
+  } else
+    consumer.consume(recorder.releaseBigIdeal());
+  return true;
+}
+
+bool ResultCache::lookup(CoefBigTermConsumer& consumer) {
+  ActionPrinter printer(_printActions, "Looking up result in cache.");
+  FILE* file = openResult();
+  if (file == 0) {
+    printer.endAction();
+    reportLookup(false);
+    return false;
+  }
+
+  BigPolynomial polynomial;
+  try {
+    Scanner in(IO::BinaryIOHandler::staticGetName(), file);
+    CoefBigTermRecorder recorder(&polynomial);
+    createBinaryHandler()->readPolynomial(in, recorder);
+    in.expectEOF();
+  } catch (const FrobbyException&) {
+    fclose(file);
+    printer.endAction();
+    reportLookup(false);
+    return false;
+  }
+  fclose(file);
+  printer.endAction();
+  reportLookup(true);
+
+  consumer.consume(polynomial);
+  return true;
+}
+
+bool ResultCache::lookup(mpz_class& value) {
+  ActionPrinter printer(_printActions, "Looking up result in cache.");
+  FILE* file = openResult();
+  bool hit = false;
+  if (file != 0) {
+    char line[256];
+    string number;
+    while (fgets(line, sizeof(line), file) != 0)
+      number += line;
+    hit = !ferror(file) && !number.empty() &&
+      number[number.size() - 1] == '\n';
+    if (hit) {
+      number.resize(number.size() - 1);
+      hit = value.set_str(number, 10) == 0;
+    }
+    fclose(file);
+  }
+  printer.endAction();
+  reportLookup(hit);
+  return hit;
+}
+
+unique_ptr<BigTermConsumer> ResultCache::makeRecorder
+(BigTermConsumer& consumer) {
+  unique_ptr<BigTermConsumer> writer =
+    createBinaryHandler()->createIdealListWriter(beginStore());
+  return unique_ptr<BigTermConsumer>(new IdealTee(consumer, std::move(writer)));
+}
+
+unique_ptr<CoefBigTermConsumer> ResultCache::makeRecorder
+(CoefBigTermConsumer& consumer) {
+  unique_ptr<CoefBigTermConsumer> writer =
+    createBinaryHandler()->createPolynomialWriter(beginStore());
+  return unique_ptr<CoefBigTermConsumer>
+    (new PolynomialTee(consumer, std::move(writer)));
+}
+
+void ResultCache::store() {
+  endStore();
+}
+
+void ResultCache::store(const mpz_class& value) {
+  FILE* file = beginStore();
+  gmp_fprintf(file, "%Zd\n", value.get_mpz_t());
+  endStore();
+}
+
+size_t ResultCache::getHitCount() {
+  return hitCount;
+}
+
+size_t ResultCache::getMissCount() {
+  return missCount;
+}
+
+FILE* ResultCache::openResult() {
+  ASSERT(!_key.empty());
+  FILE* file = fopen(_path.c_str(), "rb");
+  if (file == 0)
+    return 0;
+
+  char line[64];
+  size_t keySize;
+  if (fgets(line, sizeof(line), file) == 0 || strcmp(line, Header) != 0 ||
+      fgets(line, sizeof(line), file) == 0 ||
+      sscanf(line, "%zu", &keySize) != 1 || keySize != _key.size()) {
+    fclose(file);
+    return 0;
+  }
+
+  // A different key with the same hash is a miss.
+  char buffer[4096];
+  for (size_t pos = 0; pos < keySize; ) {
+    const size_t size = std::min(sizeof(buffer), keySize - pos);
+    if (fread(buffer, 1, size, file) != size ||
+        memcmp(buffer, _key.data() + pos, size) != 0) {
+      fclose(file);
+      return 0;
+    }
+    pos += size;
+  }
+  return file;
+}
+
+FILE* ResultCache::beginStore() {
+  ASSERT(!_key.empty());
+  ASSERT(_storeFile == 0);
+
+  vector<char> path(_path.begin(), _path.end());
+  const char* suffix = ".XXXXXX";
+  path.insert(path.end(), suffix, suffix + strlen(suffix) + 1);
+  const int fd = mkstemp(&path.front());
+  FILE* file = fd == -1 ? 0 : fdopen(fd, "wb");
+  if (file == 0) {
+    if (fd != -1) {
+      close(fd);
+      remove(&path.front());
+    }
+    reportError("Could not create a file in result cache directory \"" +
+                _directory + "\": " + strerror(errno) + '.');
+  }
+  _storeFile = file;
+  _storePath = &path.front();
+
+  fputs(Header, _storeFile);
+  fprintf(_storeFile, "%lu\n", static_cast<unsigned long>(_key.size()));
+  fwrite(_key.data(), 1, _key.size(), _storeFile);
+  return _storeFile;
+}
+
+void ResultCache::endStore() {
+  ASSERT(_storeFile != 0);
+  FILE* file = _storeFile;
+  _storeFile = 0;
+
+  bool stored = fflush(file) == 0 && !ferror(file);
+  stored = fclose(file) == 0 && stored;
+  stored = stored && rename(_storePath.c_str(), _path.c_str()) == 0;
+  if (!stored) {
+    const int error = errno;
+    remove(_storePath.c_str());
+    reportError("Could not store result in result cache directory \"" +
+                _directory + "\": " + strerror(error) + '.');
+  }
+}
+
+void ResultCache::reportLookup(bool hit) {
+  if (hit)
+    ++hitCount;
+  else
+    ++missCount;
+
+  if (_printActions || _printStatistics) {
+    fprintf(stderr, "Result cache %s. %lu hits and %lu misses so far.\n",
+            hit ? "hit" : "miss",
+            static_cast<unsigned long>(hitCount),
+            static_cast<unsigned long>(missCount));
+    fflush(stderr);
+  }
+}
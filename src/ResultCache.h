@@ -0,0 +1,121 @@
+/* Frobby: Software for monomial ideal computations.
+   Copyright (C) 2007 Bjarke Hammersholt Roune (www.broune.com)
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see http://www.gnu.org/licenses/.
+*/
+#ifndef RESULT_CACHE_GUARD
+#define RESULT_CACHE_GUARD
+
+#include <string>
+#include <cstdio>
+
+class Ideal;
+class TermTranslator;
+class BigTermConsumer;
+class CoefBigTermConsumer;
+
+/** Stores the results of computations in a directory, so that doing
+ a computation that has been done before turns into reading its
+ result from a file. This is the implementation of the -cache option.
+
+ A result is identified by a key that consists of the name of the
+ computation, including any parameters that affect the result, and
+ the input ideal in a canonical form where the generators are sorted
+ and every exponent is written out in full. The file that a result is
+ stored in is named by a hash of the key. The file also contains the
+ key itself, so a hash collision is a cache miss rather than a wrong
+ result. Ideals and polynomials are stored in the binary format.
+
+ A result is written to a temporary file that is renamed into place
+ once it is complete, so processes and threads that share a cache
+ directory never see a partial result. A result file that cannot be
+ read is treated as a miss and is replaced. */
+class ResultCache {
+ public:
+  /** Caching is off if directory is empty. The directory is created
+   if it does not exist. Lookups are timed if printActions is true,
+   and the hit and miss counts are printed to standard error after
+   each lookup if printActions or printStatistics is true. */
+  ResultCache(const string& directory,
+              bool printActions,
+              bool printStatistics);
+  ~ResultCache();
+
+  bool isOn() const {return !_directory.empty();}
+
+  /** Sets the key to computation on ideal as translated by
+   translator. The ideal must be minimally generated. */
+  void setKey(const string& computation,
+              const Ideal& ideal,
+              const TermTranslator& translator);
+
+  /** If the result for the key is in the cache, then writes it to
+   consumer and returns true. Otherwise returns false. Set
+   outputIsList if the result is a list of ideals. */
+  bool lookup(BigTermConsumer& consumer, bool outputIsList);
+  bool lookup(CoefBigTermConsumer& consumer);
+  bool lookup(mpz_class& value);
+
+  /** Returns a consumer that passes what it consumes on to consumer
+   and also records it, so that store() can store it as the result
+   for the key. The returned consumer must not outlive this object. */
+  unique_ptr<BigTermConsumer> makeRecorder(BigTermConsumer& consumer);
+  unique_ptr<CoefBigTermConsumer> makeRecorder(CoefBigTermConsumer& consumer);
+
+  /** Stores what the recorder has recorded as the result for the
+   key. The recorder must have consumed a complete result. */
+  void store();
+
+  /** Stores value as the result for the key. */
+  void store(const mpz_class& value);
+
+  /** Returns the number of lookups in this process that found their
+   result in the cache. */
+  static size_t getHitCount();
+
+  /** Returns the number of lookups in this process that did not find
+   their result in the cache. */
+  static size_t getMissCount();
+
+ private:
+  /** Returns the file of the result for the key positioned just
+   after the key, or null if there is no such result. */
+  FILE* openResult();
+
+  /** Opens a temporary file for the result for the key and writes
+   the key to it. */
+  FILE* beginStore();
+
+  /** Moves the temporary file into place as the result for the
+   key. */
+  void endStore();
+
+  void reportLookup(bool hit);
+
+  const string _directory;
+  const bool _printActions;
+  const bool _printStatistics;
+
+  string _key;
+  string _path;
+
+  /** The file that a result is being stored to and its path. */
+  FILE* _storeFile;
+  string _storePath;
+
+  ResultCache(const ResultCache&); // not available
+  ResultCache& operator=(const ResultCache&); // not available
+};
+
+#endif
@@ -22,6 +22,8 @@
 #include "error.h"
 #include "FrobbyStringStream.h"
 #include <limits>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 static const size_t BufferSize = 10024;
 
@@ -33,12 +35,52 @@ Scanner::Scanner(const string& formatName, FILE* in):
   _tmpStringCapacity(16),
   _formatName(formatName),
   _buffer(BufferSize),
-  _bufferPos(_buffer.end()) {
+  _bufferPos(0),
+  _bufferEnd(0),
+  _mapped(0),
+  _mappedSize(0) {
+  mapFile();
   if (getFormat() == getFormatNameIndicatingToGuessTheInputFormat())
     setFormat(autoDetectFormat(*this));
   _tmpString = new char[16];
 }
 
+Scanner::~Scanner() {
+  delete[] _tmpString;
+  if (_mapped != 0)
+    munmap(_mapped, _mappedSize);
+}
+
+void Scanner::mapFile() {
+  ASSERT(_mapped == 0);
+  if (_in == 0)
+    return;
+
+  // Input that stdio has already read from _in starts at offset, so
+  // that is where the mapping is read from too.
+  const long offset = ftell(_in);
+  struct stat status;
+  if (offset < 0 || fstat(fileno(_in), &status) != 0 ||
+      !S_ISREG(status.st_mode) || status.st_size <= offset)
+    return;
+
+  const size_t size = static_cast<size_t>(status.st_size);
+  void* mapped = mmap(0, size, PROT_READ, MAP_PRIVATE, fileno(_in), 0);
+  if (mapped == MAP_FAILED)
+    return;
+  madvise(mapped, size, MADV_SEQUENTIAL);
+
+  _mapped = static_cast<char*>(mapped);
+  _mappedSize = size;
+  _bufferPos = _mapped + offset;
+  _bufferEnd = _mapped + size;
+
+  // Load the first character so that _char is always the character
+  // just before _bufferPos.
+  _char = static_cast<unsigned char>(*_bufferPos);
+  ++_bufferPos;
+}
+
 unique_ptr<IOHandler> Scanner::createIOHandler() const {
   return ::createIOHandler(getFormat());
 }
@@ -147,6 +189,73 @@ size_t Scanner::readIntegerStringNoSign() {
   return size;
 }
 
+bool Scanner::readIntegerNoSign(unsigned long& word, mpz_class& big) {
+  eatWhite();
+  const char* begin = getTokenBegin();
+  if (begin != 0) {
+    const size_t maxSize = numeric_limits<unsigned long>::digits10;
+    const char* end = begin;
+    unsigned long w = 0;
+    while (end != _bufferEnd && ScannerChars::isDigit(*end)) {
+      w = 10 * w + (*end - '0');
+      ++end;
+    }
+    const size_t size = end - begin;
+    if (size != 0 && size <= maxSize && isTokenEnd(end)) {
+      word = w;
+      skipToken(end);
+      return true;
+    }
+  }
+
+  const size_t size = readIntegerStringNoSign();
+
+  // An integer with at most digits10 digits is less than the largest
+  // unsigned long, so we can calculate it directly.
+  if (size <= static_cast<size_t>(numeric_limits<unsigned long>::digits10)) {
+    unsigned long w = 0;
+    for (size_t i = 0; i < size; ++i)
+      w = 10 * w + (_tmpString[i] - '0');
+    word = w;
+    return true;
+  }
+
+  mpz_set_str(big.get_mpz_t(), _tmpString, 10);
+  if (big.fits_ulong_p() &&
+      big.get_ui() != numeric_limits<unsigned long>::max()) {
+    word = big.get_ui();
+    return true;
+  }
+  return false;
+}
+
+bool Scanner::readIntegerInPlace(mpz_class& integer) {
+  eatWhite();
+  const char* begin = getTokenBegin();
+  if (begin == 0)
+    return false;
+
+  const char* digits = begin;
+  if (*digits == '-' || *digits == '+')
+    ++digits;
+  const char* end = digits;
+  signed long l = 0;
+  while (end != _bufferEnd && ScannerChars::isDigit(*end)) {
+    l = 10 * l + (*end - '0');
+    ++end;
+  }
+
+  // 9 digits always fit in a 32 bit signed long.
+  const size_t size = end - digits;
+  if (size == 0 || size > 9 || !isTokenEnd(end))
+    return false;
+  if (*begin == '-')
+    l = -l;
+  integer = l;
+  skipToken(end);
+  return true;
+}
+
 void Scanner::parseInteger(mpz_class& integer, size_t size) {
   // This code has a fast path for small integers and a slower path
   // for longer integers. The largest number representable in 32 bits
@@ -271,6 +380,41 @@ const char* Scanner::readIdentifier() {
   return _tmpString;
 }
 
+const char* Scanner::readBytes(size_t size) {
+  // The bytes can be returned in place unless reading them would
+  // cause the buffer to be refilled.
+  const char* begin = getTokenBegin();
+  if (begin != 0) {
+    const size_t left = _bufferEnd - begin;
+    if (size < left || (size == left && isMapped())) {
+      skipToken(begin + size);
+      return begin;
+    }
+  }
+
+  if (hasFewerBytesThan(size))
+    reportErrorUnexpectedToken("more input", EOF);
+
+  // size comes from the input, so the string is grown as bytes
+  // arrive rather than all at once.
+  for (size_t i = 0; i < size; ++i) {
+    if (peek() == EOF)
+      reportErrorUnexpectedToken("more input", EOF);
+    if (i == _tmpStringCapacity)
+      growTmpString();
+    _tmpString[i] = static_cast<char>(getChar());
+  }
+  return _tmpString;
+}
+
+bool Scanner::hasFewerBytesThan(size_t size) const {
+  if (!isMapped())
+    return false;
+  const char* begin = getTokenBegin();
+  const size_t left = begin == 0 ? 0 : _bufferEnd - begin;
+  return left < size;
+}
+
 void Scanner::errorReadIdentifier() {
   reportErrorUnexpectedToken("an identifier", "");
 }
@@ -302,15 +446,18 @@ void Scanner::reportErrorUnexpectedToken
 }
 
 int Scanner::readBuffer() {
+  if (_mapped != 0)
+    return EOF;
   if (_buffer.size() < _buffer.capacity() && (feof(_in) || ferror(_in)))
     return EOF;
   _buffer.resize(_buffer.capacity());
   size_t read = fread(&_buffer[0], 1, _buffer.capacity(), _in);
   _buffer.resize(read);
-  _bufferPos = _buffer.begin();
+  _bufferPos = _buffer.data();
+  _bufferEnd = _bufferPos + read;
   if (read == 0)
     return EOF;
-  char c = *_bufferPos;
+  unsigned char c = *_bufferPos;
   ++_bufferPos;
   return c;
 }
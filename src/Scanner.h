@@ -28,6 +28,10 @@ class IOHandler;
  error messages. Only one Scanner should be reading from a given
  FILE*, since otherwise the line numbers will be inaccurate.
 
+ If the FILE* refers to a regular file, then the Scanner maps the
+ rest of that file into memory instead of reading it through a
+ buffer. Integers and identifiers are then parsed in place.
+
  All input methods whose documentation does not specifically say
  otherwise skip whitespace as defined by the standard isspace()
  method.
@@ -56,7 +60,7 @@ public:
    @param in The file to read input from.
    */
   Scanner(const string& formatName, FILE* in);
-  ~Scanner() {delete[] _tmpString;}
+  ~Scanner();
 
   const string& getFormat() const {return _formatName;}
   void setFormat(const string& format) {_formatName = format;}
@@ -100,6 +104,12 @@ public:
     /** Read an arbitrary-precision integer. */
   void readIntegerNoSign(mpz_class& str);
 
+  /** Read a non-negative integer. If it is less than the largest
+      unsigned long, then word is set to it and the return value is
+      true. Otherwise big is set to it and the return value is
+      false. This avoids GMP for the integers that fit in a word. */
+  bool readIntegerNoSign(unsigned long& word, mpz_class& big);
+
   /** Read an integer and set it to zero if it is negative. This is
       more efficient because the sign can be detected before the
       integer is read. */
@@ -147,6 +157,22 @@ public:
   /** Returns the next character or EOF. Does not skip whitespace. */
   int peek() {return _char;}
 
+  /** Reads the next size bytes without interpreting them. The
+      returned pointer points to those bytes and is only valid until
+      the next method on this object gets called. Does not skip
+      whitespace. Reports an error if fewer than size bytes remain.
+      Memory is only allocated for bytes that are actually read, so a
+      size that is too large does not cause a large allocation. */
+  const char* readBytes(size_t size);
+
+  /** Returns true if the input has been mapped into memory. */
+  bool isMapped() const {return _mapped != 0;}
+
+  /** Returns true if fewer than size bytes of input remain. That is
+      only known when the input is mapped, so this returns false for
+      input that is not. Does not skip whitespace. */
+  bool hasFewerBytesThan(size_t size) const;
+
   /** Reads past any whitespace, where whitespace is defined by the
       standard function isspace(). */
   inline void eatWhite();
@@ -160,6 +186,11 @@ private:
 
   void parseInteger(mpz_class& integer, size_t size);
 
+  /** Reads an integer with few enough digits to fit in a signed long
+      directly from the buffer if possible. Returns false and reads
+      nothing if not. */
+  bool readIntegerInPlace(mpz_class& integer);
+
   void errorExpectTwo(char a, char b, int got);
   void errorExpectOne(char expected, int got);
   void errorReadVariable(const char* name);
@@ -172,6 +203,24 @@ private:
   void growTmpString();
   int readBuffer();
 
+  /** Maps the rest of _in into memory if it is a regular file. */
+  void mapFile();
+
+  /** Returns the start of the token that begins with the current
+      character, or 0 if that token cannot be parsed in place. */
+  inline const char* getTokenBegin() const;
+
+  /** Returns true if a token in the buffer that ends at end can be
+      parsed in place, which is so unless the token might continue
+      past the end of the buffer. */
+  bool isTokenEnd(const char* end) const {
+    return end != _bufferEnd || isMapped();
+  }
+
+  /** Skips past the token that begins with the current character
+      and ends at end. Newlines in the token are not counted. */
+  inline void skipToken(const char* end);
+
   mpz_class _integer;
   FILE* _in;
   unsigned long _lineNumber;
@@ -179,19 +228,46 @@ private:
 
   char* _tmpString;
   size_t _tmpStringCapacity;
+  string _identifier;
 
   string _formatName;
 
   vector<char> _buffer;
-  vector<char>::iterator _bufferPos;
+  const char* _bufferPos;
+  const char* _bufferEnd;
+
+  char* _mapped;
+  size_t _mappedSize;
 };
 
+namespace ScannerChars {
+  inline bool isDigit(char c) {
+    return static_cast<unsigned char>(c - '0') < 10;
+  }
+
+  inline bool isIdentifierChar(char c) {
+    return isDigit(c) || c == '_' ||
+      static_cast<unsigned char>((c | 0x20) - 'a') < 26;
+  }
+}
+
 
 
 inline void Scanner::readIdentifier(string& str) {
   eatWhite();
   if (!isalpha(peek()))
     errorReadIdentifier();
+  const char* begin = getTokenBegin();
+  if (begin != 0) {
+    const char* end = begin + 1;
+    while (end != _bufferEnd && ScannerChars::isIdentifierChar(*end))
+      ++end;
+    if (isTokenEnd(end)) {
+      str.assign(begin, end);
+      skipToken(end);
+      return;
+    }
+  }
   str.clear();
   do {
     str += static_cast<char>(getChar());
@@ -199,10 +275,10 @@ inline void Scanner::readIdentifier(string& str) {
 }
 
 inline size_t Scanner::readVariable(const VarNames& names) {
-  const char* name = readIdentifier();
-  size_t var = names.getIndex(name);
+  readIdentifier(_identifier);
+  size_t var = names.getIndex(_identifier);
   if (var == VarNames::invalidIndex)
-    errorReadVariable(name);
+    errorReadVariable(_identifier.c_str());
   return var;
 }
 
@@ -236,6 +312,8 @@ inline void Scanner::expect(char expected) {
 }
 
 inline void Scanner::readInteger(mpz_class& integer) {
+  if (readIntegerInPlace(integer))
+    return;
   size_t size = readIntegerString();
   parseInteger(integer, size);
 }
@@ -273,13 +351,35 @@ inline int Scanner::getChar() {
   if (_char == '\n')
     ++_lineNumber;
   int oldChar = _char;
-  if (_bufferPos == _buffer.end())
+  if (_bufferPos == _bufferEnd)
     _char = readBuffer();
   else {
-    _char = *_bufferPos;
+    _char = static_cast<unsigned char>(*_bufferPos);
     ++_bufferPos;
   }
   return oldChar;
 }
 
+inline const char* Scanner::getTokenBegin() const {
+  // Apart from EOF and the initial space before anything has been
+  // read from _in, _char is always the character just before
+  // _bufferPos.
+  if (_char == EOF || _bufferPos == 0)
+    return 0;
+  ASSERT(static_cast<unsigned char>(_bufferPos[-1]) == _char);
+  return _bufferPos - 1;
+}
+
+inline void Scanner::skipToken(const char* end) {
+  ASSERT(isTokenEnd(end));
+  ASSERT(getTokenBegin() != 0 && getTokenBegin() <= end);
+  if (end == _bufferEnd) {
+    _bufferPos = end;
+    _char = readBuffer();
+  } else {
+    _char = static_cast<unsigned char>(*end);
+    _bufferPos = end + 1;
+  }
+}
+
 #endif
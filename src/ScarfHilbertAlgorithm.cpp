@@ -59,12 +59,19 @@ public:
     _deformer.undeform(_tmp);
 
     if (_univar) {
-      if (_tmp.getVarCount() == 0)
-        _tdeg = 0;
-      else
-        _tdeg = _translator.getExponent(0, _tmp);
-      for (size_t var = 1; var < _tmp.getVarCount(); ++var)
-        _tdeg += _translator.getExponent(var, _tmp);
+      computeDegree();
+      _uniPoly.add(coef, _tdeg);
+    } else
+      _poly.add(coef, _tmp);
+  }
+
+  virtual void consume(long coef, const Term& term) {
+    ASSERT(term.getVarCount() == _tmp.getVarCount());
+    _tmp = term;
+    _deformer.undeform(_tmp);
+
+    if (_univar) {
+      computeDegree();
       _uniPoly.add(coef, _tdeg);
     } else
       _poly.add(coef, _tmp);
@@ -78,6 +85,16 @@ public:
   }
 
 private:
+  /** Sets _tdeg to the total degree of _tmp. */
+  void computeDegree() {
+    if (_tmp.getVarCount() == 0)
+      _tdeg = 0;
+    else
+      _tdeg = _translator.getExponent(0, _tmp);
+    for (size_t var = 1; var < _tmp.getVarCount(); ++var)
+      _tdeg += _translator.getExponent(var, _tmp);
+  }
+
   bool _univar;
   Term _tmp;
   Deformer _deformer;
@@ -38,7 +38,8 @@ namespace IO {
 
   class SingularIdealWriter : public IdealWriter {
   public:
-    SingularIdealWriter(FILE* out): IdealWriter(out) {
+    SingularIdealWriter(FILE* out, size_t threadCount):
+      IdealWriter(out, threadCount) {
     }
 
   private:
@@ -73,7 +74,8 @@ namespace IO {
 
   class SingularPolyWriter : public PolyWriter {
   public:
-    SingularPolyWriter(FILE* out): PolyWriter(out) {
+    SingularPolyWriter(FILE* out, size_t threadCount):
+      PolyWriter(out, threadCount) {
     }
 
     virtual void doWriteHeader() {
@@ -117,13 +119,14 @@ namespace IO {
     return "singular";
   }
 
-  BigTermConsumer* SingularIOHandler::doCreateIdealWriter(FILE* out) {
-    return new SingularIdealWriter(out);
+  BigTermConsumer* SingularIOHandler::
+  doCreateIdealWriter(FILE* out, size_t threadCount) {
+    return new SingularIdealWriter(out, threadCount);
   }
 
   CoefBigTermConsumer* SingularIOHandler::
-  doCreatePolynomialWriter(FILE* out) {
-    return new SingularPolyWriter(out);
+  doCreatePolynomialWriter(FILE* out, size_t threadCount) {
+    return new SingularPolyWriter(out, threadCount);
   }
 
   void SingularIOHandler::doWriteTerm(const vector<mpz_class>& term,
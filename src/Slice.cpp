@@ -20,12 +20,14 @@
 #include "Projection.h"
 #include "TaskEngine.h"
 #include "SliceStrategy.h"
+#include "ProgressReporter.h"
 
 // The lcm is technically correct, but _lcmUpdated defaulting to false
 // is still a sensible choice.
 Slice::Slice(SliceStrategy& strategy):
   _varCount(0),
   _lcmUpdated(false),
+  _supportCountsUpdated(false),
   _lowerBoundHint(0),
   _strategy(strategy) {
 }
@@ -38,6 +40,9 @@ Slice::Slice(SliceStrategy& strategy,
   _varCount(multiply.getVarCount()),
   _lcm(multiply.getVarCount()),
   _lcmUpdated(false),
+  _lcmCounts(multiply.getVarCount()),
+  _supportCounts(multiply.getVarCount()),
+  _supportCountsUpdated(false),
   _lowerBoundHint(0),
   _strategy(strategy) {
   ASSERT(multiply.getVarCount() == ideal.getVarCount());
@@ -55,16 +60,109 @@ const Term& Slice::getLcm() const {
     Term tmp(_varCount);
     _ideal.getLcm(tmp);
     ASSERT(tmp == _lcm);
+
+    Term counts(_varCount);
+    Ideal::const_iterator stop = _ideal.end();
+    for (Ideal::const_iterator it = _ideal.begin(); it != stop; ++it)
+      for (size_t var = 0; var < _varCount; ++var)
+        if ((*it)[var] == _lcm[var] && _lcm[var] > 0)
+          ++counts[var];
+    ASSERT(counts == _lcmCounts);
   }
 #endif
 
-  if (!_lcmUpdated) {
-    getIdeal().getLcm(_lcm);
-    _lcmUpdated = true;
-  }
+  if (!_lcmUpdated)
+    computeLcmAndCounts();
   return _lcm;
 }
 
+const Term& Slice::getSupportCounts() const {
+#ifdef DEBUG
+  if (_supportCountsUpdated) {
+    Term tmp(_varCount);
+    _ideal.getSupportCounts(tmp);
+    ASSERT(tmp == _supportCounts);
+  }
+#endif
+
+  if (!_supportCountsUpdated)
+    computeLcmAndCounts();
+  return _supportCounts;
+}
+
+void Slice::computeLcmAndCounts() const {
+  _lcm.setToIdentity();
+  _lcmCounts.setToIdentity();
+  _supportCounts.setToIdentity();
+
+  Ideal::const_iterator stop = _ideal.end();
+  for (Ideal::const_iterator it = _ideal.begin(); it != stop; ++it) {
+    const Exponent* term = *it;
+    for (size_t var = 0; var < _varCount; ++var) {
+      if (term[var] == 0)
+        continue;
+      _supportCounts[var] += 1;
+      if (term[var] > _lcm[var]) {
+        _lcm[var] = term[var];
+        _lcmCounts[var] = 1;
+      } else if (term[var] == _lcm[var])
+        _lcmCounts[var] += 1;
+    }
+  }
+
+  _lcmUpdated = true;
+  _supportCountsUpdated = true;
+}
+
+void Slice::noteRemoval(const Exponent* term) {
+  for (size_t var = 0; var < _varCount; ++var) {
+    if (term[var] == 0)
+      continue;
+    if (_supportCountsUpdated) {
+      ASSERT(_supportCounts[var] > 0);
+      _supportCounts[var] -= 1;
+    }
+    if (_lcmUpdated && term[var] == _lcm[var]) {
+      ASSERT(_lcmCounts[var] > 0);
+      _lcmCounts[var] -= 1;
+      if (_lcmCounts[var] == 0)
+        _lcmUpdated = false;
+    }
+  }
+}
+
+void Slice::noteColon(const Term& pivot) {
+  if (_lcmUpdated) {
+    for (size_t var = 0; var < _varCount; ++var) {
+      if (pivot[var] == 0)
+        continue;
+      // The generators that raised var to the lcm still do so, as
+      // their exponents all went down by the same amount.
+      if (_lcm[var] > pivot[var])
+        _lcm[var] -= pivot[var];
+      else {
+        _lcm[var] = 0;
+        _lcmCounts[var] = 0;
+      }
+    }
+  }
+
+  if (_supportCountsUpdated) {
+    // Only the generators divisible by a variable in the support of
+    // pivot can have lost support.
+    Ideal::const_iterator stop = _ideal.end();
+    for (size_t var = 0; var < _varCount; ++var) {
+      if (pivot[var] == 0 || _supportCounts[var] == 0)
+        continue;
+      Exponent count = 0;
+      for (Ideal::const_iterator it = _ideal.begin(); it != stop; ++it)
+        if ((*it)[var] > 0)
+          ++count;
+      _supportCounts[var] = count;
+    }
+  }
+}
+
 void Slice::print(FILE* file) const {
   fputs("Slice (multiply: ", file);
   _multiply.print(file);
@@ -81,6 +179,9 @@ Slice& Slice::operator=(const Slice& slice) {
   _multiply = slice._multiply;
   _lcm = slice._lcm;
   _lcmUpdated = slice._lcmUpdated;
+  _lcmCounts = slice._lcmCounts;
+  _supportCounts = slice._supportCounts;
+  _supportCountsUpdated = slice._supportCountsUpdated;
   _lowerBoundHint = slice._lowerBoundHint;
 
   return *this;
@@ -93,6 +194,9 @@ void Slice::resetAndSetVarCount(size_t varCount) {
   _multiply.reset(varCount);
   _lcm.reset(varCount);
   _lcmUpdated = false;
+  _lcmCounts.reset(varCount);
+  _supportCounts.reset(varCount);
+  _supportCountsUpdated = false;
   _lowerBoundHint = 0;
 }
 
@@ -100,6 +204,7 @@ void Slice::clearIdealAndSubtract() {
   _ideal.clear();
   _subtract.clear();
   _lcmUpdated = false;
+  _supportCountsUpdated = false;
   _lowerBoundHint = 0;
 }
 
@@ -107,6 +212,22 @@ void Slice::singleDegreeSortIdeal(size_t var) {
   _ideal.singleDegreeSort(var);
 }
 
+// Helper class for outerSlice() and normalize().
+class StrictMultiplePredicate {
+public:
+  StrictMultiplePredicate(const Exponent* term, size_t varCount):
+    _term(term), _varCount(varCount) {
+  }
+
+  bool operator()(const Exponent* term) {
+    return Term::strictlyDivides(_term, term, _varCount);
+  }
+
+private:
+  const Exponent* _term;
+  size_t _varCount;
+};
+
 bool Slice::innerSlice(const Term& pivot) {
   ASSERT(getVarCount() == pivot.getVarCount());
 
@@ -114,6 +235,13 @@ bool Slice::innerSlice(const Term& pivot) {
 
   _multiply.product(_multiply, pivot);
   bool idealChanged = _ideal.colonReminimize(pivot);
+  if (_ideal.getGeneratorCount() == count)
+    noteColon(pivot);
+  else {
+    _lcmUpdated = false;
+    _supportCountsUpdated = false;
+  }
+
   bool subtractChanged = _subtract.colonReminimize(pivot);
   bool changed = idealChanged || subtractChanged;
   if (changed) {
@@ -121,21 +249,13 @@ bool Slice::innerSlice(const Term& pivot) {
     _lowerBoundHint = pivot.getFirstNonZeroExponent();
   }
 
-  if (_ideal.getGeneratorCount() == count)
-    _lcm.colon(_lcm, pivot);
-  else
-    _lcmUpdated = false;
-
   return changed;
 }
 
 void Slice::outerSlice(const Term& pivot) {
   ASSERT(getVarCount() == pivot.getVarCount());
 
-  size_t count = getIdeal().getGeneratorCount();
-  _ideal.removeStrictMultiples(pivot);
-  if (getIdeal().getGeneratorCount() != count)
-    _lcmUpdated = false;
+  removeFromIdealIf(StrictMultiplePredicate(pivot, _varCount));
 
   if (pivot.getSizeOfSupport() > 1)
     getSubtract().insertReminimize(pivot);
@@ -143,22 +263,6 @@ void Slice::outerSlice(const Term& pivot) {
   _lowerBoundHint = pivot.getFirstNonZeroExponent();
 }
 
-// Helper class for normalize().
-class StrictMultiplePredicate {
-public:
-  StrictMultiplePredicate(const Exponent* term, size_t varCount):
-    _term(term), _varCount(varCount) {
-  }
-
-  bool operator()(const Exponent* term) {
-    return Term::strictlyDivides(_term, term, _varCount);
-  }
-
-private:
-  const Exponent* _term;
-  size_t _varCount;
-};
-
 bool Slice::adjustMultiply() {
   bool changed = false;
   while (true) {
@@ -192,10 +296,8 @@ bool Slice::normalize() {
   Ideal::const_iterator stop = _subtract.end();
   for (Ideal::const_iterator it = _subtract.begin(); it != stop; ++it) {
     StrictMultiplePredicate pred(*it, _varCount);
-    if (_ideal.removeIf(pred)) {
+    if (removeFromIdealIf(pred))
       removedAny = true;
-      _lcmUpdated = false;
-    }
   }
 
   return removedAny;
@@ -211,6 +313,11 @@ bool Slice::simplify() {
   ASSERT(!pruneSubtract());
   ASSERT(!applyLowerBound());
 
+  // The split that made this slice and the simplification may have
+  // removed most of the generators, so get rid of the gaps they left.
+  _ideal.compactIfProfitable();
+  _subtract.compactIfProfitable();
+
   return lowerBoundChange || pruneSubtractChange;
 }
 
@@ -241,12 +348,21 @@ void Slice::setToProjOf
     }
   }
 
+  // The generators that were left out are not divisible by any
+  // variable in the range of projection, so the lcm and the counts
+  // project along with the generators.
   projection.project(getMultiply(), slice.getMultiply());
   if (slice._lcmUpdated) {
     projection.project(_lcm, slice._lcm);
+    projection.project(_lcmCounts, slice._lcmCounts);
     _lcmUpdated = true;
   } else
     _lcmUpdated = false;
+  if (slice._supportCountsUpdated) {
+    projection.project(_supportCounts, slice._supportCounts);
+    _supportCountsUpdated = true;
+  } else
+    _supportCountsUpdated = false;
 }
 
 void Slice::swap(Slice& slice) {
@@ -254,6 +370,9 @@ void Slice::swap(Slice& slice) {
   _multiply.swap(slice._multiply);
   _lcm.swap(slice._lcm);
   std::swap(_lcmUpdated, slice._lcmUpdated);
+  _lcmCounts.swap(slice._lcmCounts);
+  _supportCounts.swap(slice._supportCounts);
+  std::swap(_supportCountsUpdated, slice._supportCountsUpdated);
   _ideal.swap(slice._ideal);
   _subtract.swap(slice._subtract);
   std::swap(_lowerBoundHint, slice._lowerBoundHint);
@@ -319,9 +438,15 @@ bool Slice::applyLowerBound() {
 }
 
 void Slice::run(TaskEngine& tasks) {
-  _strategy.processSlice(tasks, unique_ptr<Slice>(this));
+  const bool isBaseCase =
+    _strategy.processSlice(tasks, unique_ptr<Slice>(this));
+  ProgressReporter::noteSlice(isBaseCase);
 }
 
 void Slice::dispose() {
   _strategy.freeSlice(unique_ptr<Slice>(this));
 }
+
+size_t Slice::getSizeEstimate() const {
+  return getIdeal().getGeneratorCount() + getSubtract().getGeneratorCount();
+}
@@ -116,13 +116,23 @@ class Slice : public Task {
   const Term& getMultiply() const {return _multiply;}
 
   /** Returns the least common multiple of the generators of
-   getIdeal(). The lcm is stored and is only recomputed once after
-   each time the ideal changes. The lcm is always needed after each
-   change, e.g. to detect if the slice is a base case slice, so
-   calling this method should be regarded as an inexpensive operation.
+   getIdeal(). The lcm is stored and updated along with the ideal, and
+   it is only recomputed when a change removes every generator that
+   raises some variable to the power of the lcm. The lcm is always
+   needed after each change, e.g. to detect if the slice is a base
+   case slice, so calling this method should be regarded as an
+   inexpensive operation.
   */
   const Term& getLcm() const;
 
+  /** Returns the number of generators of getIdeal() that are
+   divisible by each variable, as Ideal::getSupportCounts would. The
+   counts are stored like the lcm, and they are kept up to date as
+   generators are removed or the ideal is replaced by a colon, so
+   the split strategies can consult them without rescanning the
+   ideal. */
+  const Term& getSupportCounts() const;
+
   /** Write a text representation of this object to file in a format
    appropriate for debugging. */
   void print(FILE* file) const;
@@ -217,6 +227,10 @@ class Slice : public Task {
   virtual void run(TaskEngine& tasks);
   virtual void dispose();
 
+  /** Returns the number of generators of the ideal and the
+   subtract. */
+  virtual size_t getSizeEstimate() const;
+
  protected:
   /** Set this object to be the projection of slice according to
    projection. I.e. each of getIdeal(), getSubtract() and
@@ -237,6 +251,13 @@ class Slice : public Task {
   */
   bool pruneSubtract();
 
+  /** Removes those generators of getIdeal() for which pred returns
+   true and updates the stored lcm and support counts to match
+   without recomputing them. Returns true if any generators were
+   removed. */
+  template<class Predicate>
+  bool removeFromIdealIf(Predicate pred);
+
   /** Calculates a lower bound on the content of the slice using
    getLowerBound() and calls innerSlice with that lower bound. Note
    that this does not change the content of the slice. This is
@@ -292,6 +313,20 @@ class Slice : public Task {
   */
   mutable bool _lcmUpdated;
 
+  /** For each variable, the number of generators of getIdeal() whose
+   exponent of that variable equals the lcm. This is valid when
+   _lcmUpdated is true. It lets the lcm stay valid when removing
+   generators that do not raise any variable to the power of the lcm.
+  */
+  mutable Term _lcmCounts;
+
+  /** The support counts of getIdeal() if _supportCountsUpdated is
+   true, and otherwise the value is undefined. */
+  mutable Term _supportCounts;
+
+  /** Indicates whether _supportCounts is correct. */
+  mutable bool _supportCountsUpdated;
+
   /** A hint that starting simplification through a lower bound at the
    variable indicated by _lowerBoundHint is likely to yield a
    simplification, or at least more likely than a random other
@@ -301,6 +336,45 @@ class Slice : public Task {
   size_t _lowerBoundHint;
 
   SliceStrategy& _strategy;
+
+ private:
+  /** Recomputes the lcm and the counts in a single pass over
+   getIdeal(). */
+  void computeLcmAndCounts() const;
+
+  /** Updates the stored lcm and support counts to reflect that term
+   is about to be removed from getIdeal(). */
+  void noteRemoval(const Exponent* term);
+
+  /** Updates the stored lcm and support counts to reflect that
+   getIdeal() has been replaced by its colon by pivot without any
+   generators being removed. */
+  void noteColon(const Term& pivot);
+
+  /** Calls noteRemoval on each term that pred accepts, so that
+   removeFromIdealIf can pass it to Ideal::removeIf. */
+  template<class Predicate>
+  class RemovalPredicate {
+  public:
+    RemovalPredicate(Slice& slice, Predicate pred):
+      _slice(slice), _pred(pred) {}
+
+    bool operator()(const Exponent* term) {
+      if (!_pred(term))
+        return false;
+      _slice.noteRemoval(term);
+      return true;
+    }
+
+  private:
+    Slice& _slice;
+    Predicate _pred;
+  };
 };
 
+template<class Predicate>
+inline bool Slice::removeFromIdealIf(Predicate pred) {
+  return _ideal.removeIf(RemovalPredicate<Predicate>(*this, pred));
+}
+
 #endif
@@ -39,11 +39,13 @@
 #include "CanonicalTermConsumer.h"
 #include "VarSorter.h"
 #include "StatisticsStrategy.h"
+#include "TaskSchedule.h"
 #include "IrreducibleIdealSplitter.h"
 #include "SizeMaxIndepSetAlg.h"
 #include "SliceParams.h"
 #include "error.h"
 #include "display.h"
+#include "FrobbyStringStream.h"
 
 #include <iterator>
 
@@ -77,6 +79,8 @@ SliceFacade::~SliceFacade() {
 
 void SliceFacade::computeMultigradedHilbertSeries() {
   ASSERT(isFirstComputation());
+  if (_common.lookupCachedPolynomial("multigraded Hilbert-Poincare series"))
+    return;
   beginAction("Computing multigraded Hilbert-Poincare series.");
 
   unique_ptr<CoefTermConsumer> consumer = _common.makeTranslatedPolyConsumer();
@@ -84,14 +88,18 @@ void SliceFacade::computeMultigradedHilbertSeries() {
   consumer->consumeRing(_common.getNames());
   consumer->beginConsuming();
   HilbertStrategy strategy(consumer.get(), _split.get());
+  strategy.setMemoSize(_params.getMemoSize() * 1024 * 1024);
   runSliceAlgorithmWithOptions(strategy);
   consumer->doneConsuming();
 
   endAction();
+  _common.storeCachedResult();
 }
 
 void SliceFacade::computeUnivariateHilbertSeries() {
   ASSERT(isFirstComputation());
+  if (_common.lookupCachedPolynomial("univariate Hilbert-Poincare series"))
+    return;
   beginAction("Computing univariate Hilbert-Poincare series.");
 
   unique_ptr<CoefTermConsumer> consumer =
@@ -100,15 +108,25 @@ void SliceFacade::computeUnivariateHilbertSeries() {
   consumer->consumeRing(_common.getNames());
   consumer->beginConsuming();
   HilbertStrategy strategy(consumer.get(), _split.get());
+  strategy.setMemoSize(_params.getMemoSize() * 1024 * 1024);
   runSliceAlgorithmWithOptions(strategy);
   consumer->doneConsuming();
 
   endAction();
+  _common.storeCachedResult();
 }
 
 void SliceFacade::computeIrreducibleDecomposition(bool encode) {
   ASSERT(isFirstComputation());
+  if (encode) {
+    if (_common.lookupCachedIdeal("encoded irreducible decomposition"))
+      return;
+  } else {
+    if (_common.lookupCachedIdeal("irreducible decomposition", true))
+      return;
+  }
   produceEncodedIrrDecom(*_common.makeTranslatedIdealConsumer(!encode));
+  _common.storeCachedResult();
 }
 
 mpz_class SliceFacade::computeDimension(bool codimension) {
@@ -122,6 +140,11 @@ mpz_class SliceFacade::computeDimension(bool codimension) {
       return -1;
   }
 
+  const char* computation = codimension ? "codimension" : "dimension";
+  mpz_class result;
+  if (_common.lookupCachedNumber(computation, result))
+    return result;
+
   // todo: inline?
   takeRadical();
 
@@ -142,13 +165,17 @@ mpz_class SliceFacade::computeDimension(bool codimension) {
   ASSERT(hasComponents);
 
   if (codimension)
-    return -minusCodimension;
+    result = -minusCodimension;
   else
-    return v.size() + minusCodimension;
+    result = v.size() + minusCodimension;
+  _common.storeCachedNumber(result);
+  return result;
 }
 
 void SliceFacade::computePrimaryDecomposition() {
   ASSERT(isFirstComputation());
+  if (_common.lookupCachedIdeal("primary decomposition", true))
+    return;
 
   size_t varCount = _common.getIdeal().getVarCount();
 
@@ -224,27 +251,27 @@ void SliceFacade::computePrimaryDecomposition() {
   consumer->doneConsumingList();
 
   endAction();
+  _common.storeCachedResult();
 }
 
 void SliceFacade::computeMaximalStaircaseMonomials() {
   ASSERT(isFirstComputation());
-  beginAction("Computing maximal staircase monomials.");
-
-  unique_ptr<TermConsumer> consumer = _common.makeTranslatedIdealConsumer();
-  consumer->consumeRing(_common.getNames());
-  MsmStrategy strategy(consumer.get(), _split.get());
-  runSliceAlgorithmWithOptions(strategy);
-
-  endAction();
+  if (_common.lookupCachedIdeal("maximal staircase monomials"))
+    return;
+  produceMaximalStaircaseMonomials();
+  _common.storeCachedResult();
 }
 
 void SliceFacade::computeMaximalStandardMonomials() {
   ASSERT(isFirstComputation());
+  if (_common.lookupCachedIdeal("maximal standard monomials"))
+    return;
 
   beginAction("Preparing to compute maximal standard monomials.");
   _common.getTranslator().decrement();
   endAction();
-  computeMaximalStaircaseMonomials();
+  produceMaximalStaircaseMonomials();
+  _common.storeCachedResult();
 }
 
 void SliceFacade::computeAlexanderDual(const vector<mpz_class>& point) {
@@ -265,11 +292,19 @@ void SliceFacade::computeAlexanderDual(const vector<mpz_class>& point) {
   }
   endAction();
 
+  FrobbyStringStream computation;
+  computation << "Alexander dual on";
+  for (size_t var = 0; var < point.size(); ++var)
+    computation << ' ' << point[var];
+  if (_common.lookupCachedIdeal(computation.str()))
+    return;
+
   beginAction("Preparing to compute Alexander dual.");
   _common.getTranslator().dualize(point);
   endAction();
 
   produceEncodedIrrDecom(*_common.makeTranslatedIdealConsumer());
+  _common.storeCachedResult();
 }
 
 void SliceFacade::computeAlexanderDual() {
@@ -285,6 +320,8 @@ void SliceFacade::computeAlexanderDual() {
 
 void SliceFacade::computeAssociatedPrimes() {
   ASSERT(isFirstComputation());
+  if (_common.lookupCachedIdeal("associated primes"))
+    return;
 
   size_t varCount = _common.getIdeal().getVarCount();
 
@@ -331,6 +368,7 @@ void SliceFacade::computeAssociatedPrimes() {
   consumer->doneConsuming();
 
   endAction();
+  _common.storeCachedResult();
 }
 
 bool SliceFacade::solveIrreducibleDecompositionProgram
@@ -372,6 +410,17 @@ void SliceFacade::produceEncodedIrrDecom(TermConsumer& consumer) {
   endAction();
 }
 
+void SliceFacade::produceMaximalStaircaseMonomials() {
+  beginAction("Computing maximal staircase monomials.");
+
+  unique_ptr<TermConsumer> consumer = _common.makeTranslatedIdealConsumer();
+  consumer->consumeRing(_common.getNames());
+  MsmStrategy strategy(consumer.get(), _split.get());
+  runSliceAlgorithmWithOptions(strategy);
+
+  endAction();
+}
+
 bool SliceFacade::solveProgram(const vector<mpz_class>& grading,
                                mpz_class& optimalValue,
                                bool reportAllSolutions) {
@@ -385,6 +434,28 @@ bool SliceFacade::solveProgram(const vector<mpz_class>& grading,
     _params.useIndependenceSplits(false);
   }
 
+  if (_params.getThreadCount() > 1) {
+    displayNote
+      ("Using a single thread as parallel computation is not supported\n"
+       "for optimization.");
+    _params.setThreadCount(1);
+  }
+
+  if (_params.getProcessCount() > 1) {
+    displayNote
+      ("Using a single process as computation on several processes is\n"
+       "not supported for optimization.");
+    _params.setProcessCount(1);
+  }
+
+  if (!_params.getCheckpoint().empty()) {
+    displayNote
+      ("Turning off checkpoints as they are not supported for\n"
+       "optimization.");
+    _params.setCheckpoint("");
+    _params.setResume(false);
+  }
+
   if (_params.getUseBoundSimplification() &&
       !_params.getUseBoundElimination()) {
     displayNote
@@ -468,6 +539,21 @@ void SliceFacade::runSliceAlgorithmWithOptions(SliceStrategy& strategy) {
   ASSERT(isFirstComputation());
   strategy.setUseIndependence(_params.getUseIndependenceSplits());
   strategy.setUseSimplification(_params.getUseSimplification());
+  strategy.setThreadCount(_params.getThreadCount());
+  strategy.setSchedule(TaskSchedule::createSchedule
+                       (_params.getSchedule(), _params.getScheduleLimit()));
+  if (_params.getResume() && _params.getCheckpoint().empty())
+    reportError("Option -resume requires a file given by -checkpoint.");
+  if (!_params.getCheckpoint().empty() && _params.getProcessCount() > 1) {
+    displayNote
+      ("Using a single process as checkpoints are not supported for\n"
+       "computation on several processes.");
+    _params.setProcessCount(1);
+  }
+  strategy.setProcessCount(_params.getProcessCount());
+  strategy.setCheckpoint(_params.getCheckpoint(),
+                         _params.getCheckpointInterval(),
+                         _params.getResume());
 
   SliceStrategy* strategyWithOptions = &strategy;
 
@@ -208,6 +208,8 @@ class SliceFacade : public Facade {
  private:
   void produceEncodedIrrDecom(TermConsumer& consumer);
 
+  void produceMaximalStaircaseMonomials();
+
   bool solveProgram(const vector<mpz_class>& grading,
                     mpz_class& optimalValue,
                     bool reportAllSolutions);
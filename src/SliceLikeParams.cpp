@@ -19,19 +19,47 @@
 #include "SliceLikeParams.h"
 
 #include "CliParams.h"
+#include "IntegerParameter.h"
 
 SliceLikeParams::SliceLikeParams():
-  _useSimplification(true) {
+  _useSimplification(true),
+  _memoSize(0),
+  _schedule("dfs"),
+  _scheduleLimit(0) {
 }
 
 namespace {
   static const char* UseSimplificationName = "simplify";
+  static const char* MemoSizeName = "memo";
+  static const char* ScheduleName = "schedule";
+  static const char* ScheduleLimitName = "scheduleLimit";
 }
 
 void addSliceLikeParams(CliParams& params) {
 }
 
+void addHilbertMemoParam(CliParams& params) {
+  ASSERT(!params.hasParam(MemoSizeName));
+  params.add
+    (unique_ptr<Parameter>
+     (new IntegerParameter
+      (MemoSizeName,
+       "Use up to this many megabytes of memory to keep the results of\n"
+       "sub-computations, so that a sub-computation that comes up again\n"
+       "in another branch of the computation does not have to be done\n"
+       "again. This is effective for ideals with a lot of symmetry, since\n"
+       "results are reused also when the variables are permuted. Zero\n"
+       "turns this off. The slice and bigatti algorithms only.",
+       0)));
+}
+
 void extractCliValues(SliceLikeParams& slice, const CliParams& cli) {
   extractCliValues(static_cast<CommonParams&>(slice), cli);
   slice.useSimplification(getBool(cli, UseSimplificationName));
+  if (cli.hasParam(MemoSizeName))
+    slice.setMemoSize(getInt(cli, MemoSizeName));
+  if (cli.hasParam(ScheduleName))
+    slice.setSchedule(getString(cli, ScheduleName));
+  if (cli.hasParam(ScheduleLimitName))
+    slice.setScheduleLimit(getInt(cli, ScheduleLimitName));
 }
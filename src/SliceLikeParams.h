@@ -19,6 +19,7 @@
 #define SLICE_LIKE_PARAMS
 
 #include "CommonParams.h"
+#include <string>
 
 class CliParams;
 
@@ -32,11 +33,31 @@ class SliceLikeParams : public CommonParams {
   bool getUseSimplification() const {return _useSimplification;}
   void useSimplification(bool value) {_useSimplification = value;}
 
+  /** The number of megabytes of memory to use for keeping the
+      results of sub-computations of a Hilbert-Poincare series
+      computation, so that they can be reused if the same
+      sub-computation comes up again. Zero turns this off. */
+  size_t getMemoSize() const {return _memoSize;}
+  void setMemoSize(size_t value) {_memoSize = value;}
+
+  /** The name of the schedule that determines the order in which
+      pending sub-computations are processed. See TaskSchedule. */
+  const string& getSchedule() const {return _schedule;}
+  void setSchedule(const string& name) {_schedule = name;}
+
+  /** The parameter of the schedule. Zero selects the default. */
+  size_t getScheduleLimit() const {return _scheduleLimit;}
+  void setScheduleLimit(size_t value) {_scheduleLimit = value;}
+
  private:
   bool _useSimplification;
+  size_t _memoSize;
+  string _schedule;
+  size_t _scheduleLimit;
 };
 
 void addSliceLikeParams(CliParams& params);
+void addHilbertMemoParam(CliParams& params);
 void extractCliValues(SliceLikeParams& slice, const CliParams& cli);
 
 #endif
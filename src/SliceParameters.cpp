@@ -91,7 +91,68 @@ SliceParameters::SliceParameters(bool exposeBoundParam,
    "The split selection strategy to use. Slice options are maxlabel, minlabel,\n"
    "varlabel, minimum, median, maximum, mingen, indep and gcd. Optimization\n"
    "computations support the specialized strategy degree as well.",
-   "median") {
+   "median"),
+
+  _threadCount
+  ("threads",
+   "The number of threads to use. The output is the same for any number of\n"
+   "threads, though the order of the output can differ unless -canon is on.",
+   1),
+
+  _schedule
+  ("schedule",
+   "The order in which to process pending sub-computations. The options are\n"
+   "dfs, bfs, best and hybrid. The option dfs is depth-first, which keeps the\n"
+   "fewest sub-computations in memory. The option bfs is breadth-first down\n"
+   "to the depth given by -scheduleLimit and depth-first below that. The\n"
+   "option best processes the smallest sub-computation first. The option\n"
+   "hybrid is breadth-first until -scheduleLimit sub-computations are\n"
+   "pending and depth-first after that. Use -stats to see the most\n"
+   "sub-computations that were pending at once.",
+   "dfs"),
+
+  _scheduleLimit
+  ("scheduleLimit",
+   "The depth for -schedule bfs and the number of pending sub-computations\n"
+   "for -schedule hybrid. Zero selects a default of 10 for bfs and 1000\n"
+   "for hybrid.",
+   0),
+
+  _processCount
+  ("processes",
+   "The number of local processes to use. The computation is split into\n"
+   "work units that worker processes take on one at a time, each using\n"
+   "the number of threads given by -threads. The output is the same for\n"
+   "any number of processes. The output of the units is written in the\n"
+   "order of the units, and output that comes early is held in memory\n"
+   "until the units before it are done. So the order of the output is\n"
+   "the same from run to run if -threads is 1, though it can differ from\n"
+   "that of a single process unless -canon is on.",
+   1),
+
+  _checkpoint
+  ("checkpoint",
+   "A file to write checkpoints of the computation to, so that it can be\n"
+   "continued with -resume if it is interrupted. The computation is split\n"
+   "into work units that are run one after the other, and the output of\n"
+   "the units that are done is appended to the file. The file is removed\n"
+   "once the computation is done. There are no checkpoints if this is\n"
+   "empty.",
+   ""),
+
+  _checkpointInterval
+  ("checkpointInterval",
+   "The least number of seconds between writes to the file of -checkpoint.\n"
+   "The output of units that are done in between is kept in memory until\n"
+   "the next write, and is lost if the computation is interrupted.",
+   600),
+
+  _resume
+  ("resume",
+   "Continue the computation from the file of -checkpoint instead of\n"
+   "starting over. The input and the options that affect the output must\n"
+   "be the same as for the computation that wrote the file.",
+   false) {
   addParameter(&_minimal);
   addParameter(&_split);
   addParameter(&_printStatistics);
@@ -104,6 +165,13 @@ SliceParameters::SliceParameters(bool exposeBoundParam,
     addParameter(&_useBoundElimination);
   }
   addParameter(&_canonical);
+  addParameter(&_threadCount);
+  addParameter(&_schedule);
+  addParameter(&_scheduleLimit);
+  addParameter(&_processCount);
+  addParameter(&_checkpoint);
+  addParameter(&_checkpointInterval);
+  addParameter(&_resume);
 
   if (supportBigattiAlgorithm) {
     addParameter(&_useBigattiGeneric);
@@ -115,6 +183,12 @@ SliceParameters::SliceParameters(bool exposeBoundParam,
       (" Slice algorithm only.");
     _useIndependence.appendToDescription
       (" Slice algorithm only.");
+    _processCount.appendToDescription
+      ("\nSlice algorithm only.");
+    _checkpoint.appendToDescription
+      ("\nSlice algorithm only.");
+    _resume.appendToDescription
+      ("\nSlice algorithm only.");
     _minimal.appendToDescription
       ("\nSlice algorithm only.");
     _canonical.appendToDescription
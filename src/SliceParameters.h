@@ -20,6 +20,7 @@
 #include "ParameterGroup.h"
 #include "BoolParameter.h"
 #include "StringParameter.h"
+#include "IntegerParameter.h"
 
 class SliceFacade;
 class BigattiFacade;
@@ -103,6 +104,13 @@ class SliceParameters : public ParameterGroup {
   BoolParameter _widenPivot;
 
   StringParameter _split;
+  IntegerParameter _threadCount;
+  StringParameter _schedule;
+  IntegerParameter _scheduleLimit;
+  IntegerParameter _processCount;
+  StringParameter _checkpoint;
+  IntegerParameter _checkpointInterval;
+  BoolParameter _resume;
 };
 
 #endif
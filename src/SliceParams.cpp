@@ -26,14 +26,20 @@ SliceParams::SliceParams():
   _split("median"),
   _useIndependence(true),
   _useBoundElimination(true),
-  _useBoundSimplification(true) {
+  _useBoundSimplification(true),
+  _processCount(1),
+  _checkpointInterval(600),
+  _resume(false) {
 }
 
 SliceParams::SliceParams(const CliParams& cli):
   _split("median"),
   _useIndependence(true),
   _useBoundElimination(true),
-  _useBoundSimplification(true) {
+  _useBoundSimplification(true),
+  _processCount(1),
+  _checkpointInterval(600),
+  _resume(false) {
   extractCliValues(*this, cli);
 }
 
@@ -42,6 +48,10 @@ namespace {
   const char* UseIndependenceName = "independence";
   const char* UseBoundElimination = "bound";
   const char* UseBoundSimplification = "boundSimplify";
+  const char* ProcessCountName = "processes";
+  const char* CheckpointName = "checkpoint";
+  const char* CheckpointIntervalName = "checkpointInterval";
+  const char* ResumeName = "resume";
 }
 
 void addSliceParams(CliParams& params) {
@@ -56,6 +66,14 @@ void extractCliValues(SliceParams& slice, const CliParams& cli) {
     slice.useBoundElimination(getBool(cli, UseBoundElimination));
   if (cli.hasParam(UseBoundSimplification))
     slice.useBoundElimination(getBool(cli, UseBoundSimplification));
+  if (cli.hasParam(ProcessCountName))
+    slice.setProcessCount(getInt(cli, ProcessCountName));
+  if (cli.hasParam(CheckpointName))
+    slice.setCheckpoint(getString(cli, CheckpointName));
+  if (cli.hasParam(CheckpointIntervalName))
+    slice.setCheckpointInterval(getInt(cli, CheckpointIntervalName));
+  if (cli.hasParam(ResumeName))
+    slice.setResume(getBool(cli, ResumeName));
 }
 
 void validateSplit(const SliceParams& params,
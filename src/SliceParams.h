@@ -30,6 +30,24 @@ class SliceParams : public SliceLikeParams {
   const string& getSplit() const {return _split;}
   void setSplit(const string& name) {_split = name;}
 
+  /** The number of local processes to run the computation on. */
+  size_t getProcessCount() const {return _processCount;}
+  void setProcessCount(size_t value) {_processCount = value;}
+
+  /** The file to write checkpoints to. There are no checkpoints if
+   this is empty. */
+  const string& getCheckpoint() const {return _checkpoint;}
+  void setCheckpoint(const string& path) {_checkpoint = path;}
+
+  /** The least number of seconds between writes of checkpoints. */
+  size_t getCheckpointInterval() const {return _checkpointInterval;}
+  void setCheckpointInterval(size_t value) {_checkpointInterval = value;}
+
+  /** Returns whether to continue from the checkpoint instead of
+   starting over. */
+  bool getResume() const {return _resume;}
+  void setResume(bool value) {_resume = value;}
+
   bool getUseIndependenceSplits() const {return _useIndependence;}
   void useIndependenceSplits(bool value) {_useIndependence = value;}
 
@@ -49,6 +67,10 @@ class SliceParams : public SliceLikeParams {
   bool _useIndependence;
   bool _useBoundElimination;
   bool _useBoundSimplification;
+  size_t _processCount;
+  string _checkpoint;
+  size_t _checkpointInterval;
+  bool _resume;
 };
 
 void addIdealParams(CliParams& params);
@@ -19,3 +19,6 @@
 
 SliceStrategy::~SliceStrategy() {
 }
+
+void SliceStrategy::printStatistics(FILE* out) const {
+}
@@ -22,6 +22,7 @@ class Term;
 class SliceEvent;
 class Ideal;
 class TaskEngine;
+class TaskSchedule;
 
 /** This class describes the interface of a strategy object for the
  Slice Algorithm. It determines what goes on when the algorithm runs,
@@ -49,12 +50,45 @@ class SliceStrategy {
 
   virtual bool getUseSimplification() const = 0;
 
+  /** Run the algorithm on threadCount threads. The output is the same
+   for any thread count, though its order can differ when the thread
+   count is more than one. This method should only be called before
+   calling run(). */
+  virtual void setThreadCount(size_t threadCount) = 0;
+
+  /** Process pending slices in the order determined by schedule. The
+   output is the same for any schedule, though its order can
+   differ. This method should only be called before calling run(). */
+  virtual void setSchedule(unique_ptr<TaskSchedule> schedule) = 0;
+
+  /** Run the algorithm on processCount local processes, each of which
+   uses the thread count of threads. The output is the same for any
+   process count, though its order can differ when the process count
+   is more than one. This method should only be called before calling
+   run(). */
+  virtual void setProcessCount(size_t processCount) = 0;
+
+  /** Write checkpoints of the computation to the file at path at most
+   once every intervalSeconds seconds, so that the computation can be
+   resumed if it is interrupted. There are no checkpoints if path is
+   empty. If resume is true, then the computation continues from the
+   checkpoint in the file instead of starting over. This method
+   should only be called before calling run(). */
+  virtual void setCheckpoint(const string& path,
+                             size_t intervalSeconds,
+                             bool resume) = 0;
+
   /** It is allowed to delete returned slices directly, but it is
    better to use freeSlice. freeSlice can only be called on slices
    obtained from a method of the same strategy. This allows caching of
    slices to avoid frequent allocation and deallocation.
   */
   virtual void freeSlice(unique_ptr<Slice> slice) = 0;
+
+  /** Print statistics that the strategy keeps on its own to out. This
+   is called by StatisticsStrategy once the algorithm has run. The
+   default implementation prints nothing. */
+  virtual void printStatistics(FILE* out) const;
 };
 
 #endif
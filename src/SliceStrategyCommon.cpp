@@ -18,21 +18,74 @@
 #include "SliceStrategyCommon.h"
 #include "ElementDeleter.h"
 #include "TaskEngine.h"
+#include "TaskSchedule.h"
+#include "WorkerProcesses.h"
+#include "Checkpoint.h"
 
 #include "Slice.h"
 
+#include <cstring>
+
+namespace {
+  /** The number of work units to split a slice into for each process
+   when running on several processes. There is more than one unit per
+   process since the units can take very different amounts of time. */
+  const size_t UnitsPerProcess = 8;
+
+  /** The number of work units to split a slice into when writing
+   checkpoints. At most the units that were done since the last
+   checkpoint and the unit that was running are lost if the
+   computation is interrupted, so there are many small units. */
+  const size_t CheckpointUnitCount = 256;
+
+  void appendIdeal(string& unit, const Ideal& ideal) {
+    const size_t generatorCount = ideal.getGeneratorCount();
+    unit.append(reinterpret_cast<const char*>(&generatorCount),
+                sizeof(generatorCount));
+    const size_t termSize = ideal.getVarCount() * sizeof(Exponent);
+    Ideal::const_iterator stop = ideal.end();
+    for (Ideal::const_iterator it = ideal.begin(); it != stop; ++it)
+      unit.append(reinterpret_cast<const char*>(*it), termSize);
+  }
+
+  const char* readIdeal(const char* pos, Ideal& ideal, Term& tmp) {
+    size_t generatorCount;
+    memcpy(&generatorCount, pos, sizeof(generatorCount));
+    pos += sizeof(generatorCount);
+
+    const size_t termSize = tmp.getVarCount() * sizeof(Exponent);
+    ideal.clearAndSetVarCount(tmp.getVarCount());
+    for (size_t gen = 0; gen < generatorCount; ++gen) {
+      if (termSize > 0)
+        memcpy(tmp.begin(), pos, termSize);
+      pos += termSize;
+      ideal.insert(tmp);
+    }
+    return pos;
+  }
+}
+
 SliceStrategyCommon::SliceStrategyCommon(const SplitStrategy* splitStrategy):
   _split(splitStrategy),
   _useIndependence(true),
-  _useSimplification(true) {
+  _useSimplification(true),
+  _processCount(1),
+  _checkpointInterval(0),
+  _resume(false) {
   ASSERT(splitStrategy != 0);
+  unique_ptr<WorkerState> state(new WorkerState());
+  exceptionSafePushBack(_workerStates, std::move(state));
 }
 
 SliceStrategyCommon::~SliceStrategyCommon() {
-  // TODO: use ElementDeleter instead
-  while (!_sliceCache.empty()) {
-    delete _sliceCache.back();
-    _sliceCache.pop_back();
+  for (size_t worker = 0; worker < _workerStates.size(); ++worker) {
+    // TODO: use ElementDeleter instead
+    vector<Slice*>& sliceCache = _workerStates[worker]->sliceCache;
+    while (!sliceCache.empty()) {
+      delete sliceCache.back();
+      sliceCache.pop_back();
+    }
+    delete _workerStates[worker];
   }
 }
 
@@ -41,7 +94,7 @@ void SliceStrategyCommon::freeSlice(unique_ptr<Slice> slice) {
   ASSERT(debugIsValidSlice(slice.get()));
 
   slice->clearIdealAndSubtract(); // To preserve memory.
-  noThrowPushBack(_sliceCache, std::move(slice));
+  noThrowPushBack(getWorkerState().sliceCache, std::move(slice));
 }
 
 void SliceStrategyCommon::setUseIndependence(bool use) {
@@ -52,6 +105,36 @@ void SliceStrategyCommon::setUseSimplification(bool use) {
   _useSimplification = use;
 }
 
+void SliceStrategyCommon::setThreadCount(size_t threadCount) {
+  _tasks.setThreadCount(threadCount);
+  _workerStates.reserve(_tasks.getThreadCount());
+  while (_workerStates.size() < _tasks.getThreadCount()) {
+    unique_ptr<WorkerState> state(new WorkerState());
+    exceptionSafePushBack(_workerStates, std::move(state));
+  }
+}
+
+void SliceStrategyCommon::setSchedule(unique_ptr<TaskSchedule> schedule) {
+  _tasks.setSchedule(std::move(schedule));
+}
+
+void SliceStrategyCommon::setProcessCount(size_t processCount) {
+  _processCount = processCount == 0 ? 1 : processCount;
+}
+
+void SliceStrategyCommon::setCheckpoint(const string& path,
+                                        size_t intervalSeconds,
+                                        bool resume) {
+  _checkpointPath = path;
+  _checkpointInterval = intervalSeconds;
+  _resume = resume;
+}
+
+void SliceStrategyCommon::printStatistics(FILE* out) const {
+  fprintf(out, "|-at most %lu slices pending at once\n",
+          (unsigned long)_tasks.getMaxPendingTasks());
+}
+
 bool SliceStrategyCommon::simplify(Slice& slice) {
   if (getUseSimplification())
     return slice.simplify();
@@ -63,10 +146,11 @@ bool SliceStrategyCommon::simplify(Slice& slice) {
 }
 
 unique_ptr<Slice> SliceStrategyCommon::newSlice() {
+  vector<Slice*>& sliceCache = getWorkerState().sliceCache;
   unique_ptr<Slice> slice;
-  if (!_sliceCache.empty()) {
-    slice.reset(_sliceCache.back());
-    _sliceCache.pop_back();
+  if (!sliceCache.empty()) {
+    slice.reset(sliceCache.back());
+    sliceCache.pop_back();
   } else
     slice = allocateSlice();
 
@@ -77,23 +161,33 @@ unique_ptr<Slice> SliceStrategyCommon::newSlice() {
 void SliceStrategyCommon::pivotSplit(unique_ptr<Slice> slice) {
   ASSERT(slice.get() != 0);
 
-  _pivotTmp.reset(slice->getVarCount());
-  getPivot(_pivotTmp, *slice);
+  Term& pivot = getWorkerState().pivotTmp;
+  pivot.reset(slice->getVarCount());
+  getPivot(pivot, *slice);
+
+  unique_ptr<Slice> slice2 = splitOnPivot(slice, pivot);
+  _tasks.addTask(slice2.release());
+  _tasks.addTask(slice.release());
+}
+
+unique_ptr<Slice> SliceStrategyCommon::splitOnPivot(unique_ptr<Slice>& slice,
+                                                    const Term& pivot) {
+  ASSERT(slice.get() != 0);
 
   // Assert valid pivot.
-  ASSERT(_pivotTmp.getVarCount() == slice->getVarCount());
-  ASSERT(!_pivotTmp.isIdentity());
-  ASSERT(!slice->getIdeal().contains(_pivotTmp));
-  ASSERT(!slice->getSubtract().contains(_pivotTmp));
+  ASSERT(pivot.getVarCount() == slice->getVarCount());
+  ASSERT(!pivot.isIdentity());
+  ASSERT(!slice->getIdeal().contains(pivot));
+  ASSERT(!slice->getSubtract().contains(pivot));
 
   // Set slice2 to the inner slice.
   unique_ptr<Slice> slice2 = newSlice();
   *slice2 = *slice;
-  slice2->innerSlice(_pivotTmp);
+  slice2->innerSlice(pivot);
   simplify(*slice2);
 
   // Set slice to the outer slice.
-  slice->outerSlice(_pivotTmp);
+  slice->outerSlice(pivot);
   simplify(*slice);
 
   // Process the smaller slice first to preserve memory.
@@ -106,8 +200,132 @@ void SliceStrategyCommon::pivotSplit(unique_ptr<Slice> slice) {
     slice = std::move(tmp);
   }
 
-  _tasks.addTask(slice2.release());
-  _tasks.addTask(slice.release());
+  return slice2;
+}
+
+void SliceStrategyCommon::runInProcesses(unique_ptr<Slice> slice) {
+  ASSERT(slice.get() != 0);
+
+  vector<string> units;
+  splitIntoUnits(std::move(slice), UnitsPerProcess * _processCount, units);
+
+  WorkerProcesses processes(_processCount);
+  processes.run
+    (units,
+     [this, &processes](const string& unit) {
+      runUnit(unit, [&processes](const char* result, size_t size) {
+        processes.sendResult(result, size);
+      });
+    },
+     [this](const char* result, size_t size) {
+      consumeUnitResult(result, size);
+    });
+}
+
+void SliceStrategyCommon::runWithCheckpoints(unique_ptr<Slice> slice,
+                                             const string& computation) {
+  ASSERT(slice.get() != 0);
+  ASSERT(usesCheckpoints());
+
+  // The units are computed on resume as well, since base cases that
+  // come up while splitting are output directly rather than through
+  // the checkpoint. Comparing the units to those of the checkpoint
+  // also checks that the checkpoint is for the same input.
+  vector<string> units;
+  splitIntoUnits(std::move(slice), CheckpointUnitCount, units);
+
+  Checkpoint checkpoint(_checkpointPath, _checkpointInterval);
+  vector<bool> isDone(units.size());
+  if (_resume) {
+    checkpoint.resume(computation, units, isDone,
+                      [this](const char* result, size_t size) {
+                        consumeUnitResult(result, size);
+                      });
+  } else
+    checkpoint.create(computation, units);
+
+  for (size_t unit = 0; unit < units.size(); ++unit) {
+    if (isDone[unit])
+      continue;
+    runUnit(units[unit],
+            [this, &checkpoint](const char* result, size_t size) {
+              consumeUnitResult(result, size);
+              checkpoint.addResult(result, size);
+            });
+    checkpoint.unitDone(unit);
+  }
+  checkpoint.remove();
+}
+
+void SliceStrategyCommon::encodeSlice(string& unit, const Slice& slice) {
+  const size_t varCount = slice.getVarCount();
+  unit.clear();
+  unit.append(reinterpret_cast<const char*>(&varCount), sizeof(varCount));
+  appendIdeal(unit, slice.getIdeal());
+  appendIdeal(unit, slice.getSubtract());
+  unit.append(reinterpret_cast<const char*>(slice.getMultiply().begin()),
+              varCount * sizeof(Exponent));
+}
+
+void SliceStrategyCommon::decodeSlice(const string& unit,
+                                      Ideal& ideal,
+                                      Ideal& subtract,
+                                      Term& multiply) {
+  const char* pos = unit.data();
+  size_t varCount;
+  memcpy(&varCount, pos, sizeof(varCount));
+  pos += sizeof(varCount);
+
+  multiply.reset(varCount);
+  pos = readIdeal(pos, ideal, multiply);
+  pos = readIdeal(pos, subtract, multiply);
+  if (varCount > 0)
+    memcpy(multiply.begin(), pos, varCount * sizeof(Exponent));
+  ASSERT(pos + varCount * sizeof(Exponent) == unit.data() + unit.size());
+}
+
+void SliceStrategyCommon::splitIntoUnits(unique_ptr<Slice> slice,
+                                         size_t unitCount,
+                                         vector<string>& units) {
+  // Only pivot splits are used, since the output of an independence
+  // split is not the union of the outputs of its slices. If the split
+  // strategy is a label split, then the median pivot is used instead.
+  unique_ptr<SplitStrategy> medianSplit;
+  if (!_split->isPivotSplit())
+    medianSplit = SplitStrategy::createStrategy("median");
+
+  // The slices are split breadth-first, so that the units are of
+  // about the same depth. The slices before next have been split.
+  vector<Slice*> pending;
+  ElementDeleter<vector<Slice*> > pendingDeleter(pending);
+  exceptionSafePushBack(pending, std::move(slice));
+  size_t next = 0;
+
+  Term& pivot = getWorkerState().pivotTmp;
+  while (next < pending.size() && pending.size() - next < unitCount) {
+    unique_ptr<Slice> current(pending[next]);
+    pending[next] = 0;
+    ++next;
+
+    if (current->baseCase(getUseSimplification())) {
+      freeSlice(std::move(current));
+      continue;
+    }
+
+    pivot.reset(current->getVarCount());
+    if (medianSplit.get() != 0)
+      medianSplit->getPivot(pivot, *current);
+    else
+      getPivot(pivot, *current);
+
+    unique_ptr<Slice> other = splitOnPivot(current, pivot);
+    exceptionSafePushBack(pending, std::move(current));
+    exceptionSafePushBack(pending, std::move(other));
+  }
+
+  units.resize(pending.size() - next);
+  for (size_t unit = 0; unit < units.size(); ++unit)
+    encodeSlice(units[unit], *pending[next + unit]);
 }
 
 bool SliceStrategyCommon::getUseIndependence() const {
@@ -20,13 +20,16 @@
 #include "SliceStrategy.h"
 #include "SplitStrategy.h"
 #include "TaskEngine.h"
+#include "IndependenceSplitter.h"
 
 #include <vector>
 #include <string>
+#include <functional>
 #include "Term.h"
 
 class Slice;
 class SplitStrategy;
+class Ideal;
 
 /** This class adds code to the SliceStrategy base class that is
  useful for derived classes. The public interface is unchanged.
@@ -40,6 +43,18 @@ class SliceStrategyCommon : public SliceStrategy {
 
   virtual void setUseIndependence(bool use);
   virtual void setUseSimplification(bool use);
+  virtual void setThreadCount(size_t threadCount);
+  virtual void setSchedule(unique_ptr<TaskSchedule> schedule);
+  virtual void setProcessCount(size_t processCount);
+  virtual void setCheckpoint(const string& path,
+                             size_t intervalSeconds,
+                             bool resume);
+
+  /** Prints the most slices that were pending at once. */
+  virtual void printStatistics(FILE* out) const;
+
+  /** Sends a result of a work unit. See runUnit(). */
+  typedef std::function<void(const char* result, size_t size)> ResultSender;
 
  protected:
   /** Simplifies slice and returns true if it changed. */
@@ -69,6 +84,53 @@ class SliceStrategyCommon : public SliceStrategy {
   /** Used by pivotSplit to obtain a pivot. */
   virtual void getPivot(Term& pivot, Slice& slice) = 0;
 
+  /** Sets slice to the inner and outer slice of pivot, simplifies
+   both and returns the one with more generators. The other one is
+   left in slice, since processing it first preserves memory. */
+  unique_ptr<Slice> splitOnPivot(unique_ptr<Slice>& slice, const Term& pivot);
+
+  /** Returns the number of local processes to run the algorithm on. */
+  size_t getProcessCount() const {return _processCount;}
+
+  /** Computes the output of slice on the worker processes. The slice
+   is split into work units by pivot splits, and each unit is
+   encoded and run by runUnit() in a worker process, which sends its
+   output back through the processes. This process passes that output
+   on to consumeUnitResult(). Base cases that come up while splitting
+   the slice into units are processed in this process. */
+  void runInProcesses(unique_ptr<Slice> slice);
+
+  /** Returns true if checkpoints of the computation are written. */
+  bool usesCheckpoints() const {return !_checkpointPath.empty();}
+
+  /** Computes the output of slice in this process while writing
+   checkpoints. The slice is split into work units as for
+   runInProcesses(), and the units are run by runUnit() one after the
+   other. The output of each unit is passed on to consumeUnitResult()
+   and recorded in the checkpoint. Computation identifies the
+   computation in the checkpoint. If resuming, then the recorded
+   output of the units that are done according to the checkpoint is
+   passed on instead of running them. */
+  void runWithCheckpoints(unique_ptr<Slice> slice, const string& computation);
+
+  /** Computes the output of the slice encoded in unit and sends it
+   through sendResult. This is called in a worker process unless
+   checkpoints are being written. sendResult is not safe to call from
+   several threads at once. */
+  virtual void runUnit(const string& unit, const ResultSender& sendResult) = 0;
+
+  /** Outputs a result that runUnit() sent. */
+  virtual void consumeUnitResult(const char* result, size_t size) = 0;
+
+  /** Writes the ideal, subtract and multiply of slice to unit. */
+  static void encodeSlice(string& unit, const Slice& slice);
+
+  /** Reads what encodeSlice() wrote to unit. */
+  static void decodeSlice(const string& unit,
+                          Ideal& ideal,
+                          Ideal& subtract,
+                          Term& multiply);
+
   /** Returns true if independence splits should be performed when
    possible.
   */
@@ -77,6 +139,16 @@ class SliceStrategyCommon : public SliceStrategy {
   /** Returns true if slices should be simplified. */
   bool getUseSimplification() const;
 
+  /** Returns true if the slices are processed by more than one
+   thread. Consumers of output from slices then have to be safe to
+   call concurrently. */
+  bool isParallel() const {return _tasks.getThreadCount() > 1;}
+
+  /** Returns the independence splitter of the calling worker. */
+  IndependenceSplitter& getIndependenceSplitter() {
+    return getWorkerState().indep;
+  }
+
   const SplitStrategy* _split;
 
   /** This keeps track of pending tasks to process. These are slices
@@ -86,15 +158,39 @@ class SliceStrategyCommon : public SliceStrategy {
  private:
   bool _useIndependence;
   bool _useSimplification;
-
-  /** This is the cache maintained through newSlice and freeSlice. It
-   would make more sense with a stack, but that class has
-   (surprisingly!) proven to have too high overhead, even when it seems
-   to be implemented in terms of vector.
-  */
-  vector<Slice*> _sliceCache;
-
-  Term _pivotTmp;
+  size_t _processCount;
+
+  string _checkpointPath;
+  size_t _checkpointInterval;
+  bool _resume;
+
+  /** Splits slice into about unitCount slices whose outputs together
+   are the output of slice and sets units to their encodings. */
+  void splitIntoUnits(unique_ptr<Slice> slice,
+                      size_t unitCount,
+                      vector<string>& units);
+
+  /** The state that each worker of _tasks keeps to itself, so that
+   the workers do not have to lock to use it. */
+  struct WorkerState {
+    /** This is the cache maintained through newSlice and freeSlice. It
+     would make more sense with a stack, but that class has
+     (surprisingly!) proven to have too high overhead, even when it
+     seems to be implemented in terms of vector.
+    */
+    vector<Slice*> sliceCache;
+
+    Term pivotTmp;
+    IndependenceSplitter indep;
+  };
+
+  WorkerState& getWorkerState() {
+    ASSERT(_tasks.getCurrentWorker() < _workerStates.size());
+    return *_workerStates[_tasks.getCurrentWorker()];
+  }
+
+  /** Has an entry for each thread of _tasks. */
+  vector<WorkerState*> _workerStates;
 };
 
 #endif
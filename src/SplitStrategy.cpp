@@ -24,6 +24,7 @@
 #include "TermGrader.h"
 #include "error.h"
 #include "display.h"
+#include "RandomSource.h"
 
 SplitStrategy::SplitStrategy() {
 }
@@ -74,11 +75,8 @@ protected:
   // Returns the variable that divides the most minimal generators of
   // those where some minimal generator is divisible by the square of
   // that variable.
-  mutable Term coVariableForGetBestVar;
   size_t getBestVar(const Slice& slice) const {
-    Term& co = coVariableForGetBestVar;
-    co.reset(slice.getVarCount());
-    slice.getIdeal().getSupportCounts(co);
+    Term co(slice.getSupportCounts());
 
     const Term& lcm = slice.getLcm();
     for (size_t var = 0; var < slice.getVarCount(); ++var)
@@ -101,19 +99,18 @@ protected:
 
 class LabelSplit : public SplitStrategyCommon {
 protected:
-  mutable Term _counts;
-  void setCounts(const Slice& slice) const {
-    _counts.reset(slice.getVarCount());
-    slice.getIdeal().getSupportCounts(_counts);
+  // The counts are written to a term owned by the caller, rather than
+  // to a field, so that slices can be split on several threads at once.
+  void setCounts(Term& counts, const Slice& slice) const {
+    counts = slice.getSupportCounts();
   }
 
-  mutable Term _oneCounts;
-  void setOneCounts(const Slice& slice) const {
+  void setOneCounts(Term& oneCounts, const Slice& slice) const {
     ASSERT(!const_cast<Slice&>(slice).adjustMultiply());
     ASSERT(!const_cast<Slice&>(slice).baseCase(false));
     // For each variable, count number of terms with exponent equal to 1,
     // not counting pure powers.
-    _oneCounts.reset(slice.getVarCount());
+    oneCounts.reset(slice.getVarCount());
 
     Ideal::const_iterator end = slice.getIdeal().end();
     for (Ideal::const_iterator it = slice.getIdeal().begin();
@@ -122,7 +119,7 @@ protected:
         continue; // Not counting pure powers.
       for (size_t var = 0; var < slice.getVarCount(); ++var)
         if ((*it)[var] == 1)
-          _oneCounts[var] += 1;
+          oneCounts[var] += 1;
     }
   }
 
@@ -143,8 +140,9 @@ public:
   }
 
   virtual size_t getLabelSplitVariable(const Slice& slice) const {
-    setCounts(slice);
-    return _counts.getFirstMaxExponent();
+    Term counts;
+    setCounts(counts, slice);
+    return counts.getFirstMaxExponent();
   }
 };
 
@@ -160,10 +158,11 @@ public:
   }
 
   virtual size_t getLabelSplitVariable(const Slice& slice) const {
-    setOneCounts(slice);
+    Term oneCounts;
+    setOneCounts(oneCounts, slice);
     for (size_t var = 0; ; ++var) {
         ASSERT(var < slice.getVarCount());
-        if (_oneCounts[var] > 0)
+        if (oneCounts[var] > 0)
           return var;
       }
     }
@@ -182,21 +181,23 @@ public:
   }
 
   virtual size_t getLabelSplitVariable(const Slice& slice) const {
-    setCounts(slice);
-    setOneCounts(slice);
+    Term counts;
+    Term oneCounts;
+    setCounts(counts, slice);
+    setOneCounts(oneCounts, slice);
 
-    // Zero those variables of _counts that have more than the least number
+    // Zero those variables of counts that have more than the least number
     // of exponent 1 minimal generators.
     size_t mostGeneric = 0;
     for (size_t var = 1; var < slice.getVarCount(); ++var)
       if (mostGeneric == 0 ||
-          (mostGeneric > _oneCounts[var] && _oneCounts[var] > 0))
-        mostGeneric = _oneCounts[var];
+          (mostGeneric > oneCounts[var] && oneCounts[var] > 0))
+        mostGeneric = oneCounts[var];
     for (size_t var = 0; var < slice.getVarCount(); ++var)
-      if (_oneCounts[var] != mostGeneric)
-        _counts[var] = 0;
+      if (oneCounts[var] != mostGeneric)
+        counts[var] = 0;
 
-    return _counts.getFirstMaxExponent();
+    return counts.getFirstMaxExponent();
   }
 };
 
@@ -279,8 +280,8 @@ public:
 
     for (int attempts = 0; attempts < 10; ++attempts) {
       // Pick two distinct variables.
-      size_t var1 = rand() % slice.getVarCount();
-      size_t var2 = rand() % (slice.getVarCount() - 1);
+      size_t var1 = RandomSource::getRandom() % slice.getVarCount();
+      size_t var2 = RandomSource::getRandom() % (slice.getVarCount() - 1);
       if (var2 >= var1)
         ++var2;
 
@@ -331,7 +332,7 @@ public:
         ++nonDivisibleCount;
 
     for (int i = 0; i < 3; ++i) {
-      size_t selected = rand() % nonDivisibleCount;
+      size_t selected = RandomSource::getRandom() % nonDivisibleCount;
       for (Ideal::const_iterator it = slice.getIdeal().begin(); ; ++it) {
         ASSERT(it != end);
         if ((*it)[var] < 2)
@@ -370,7 +371,7 @@ public:
       if (!Term::isSquareFree(*it, slice.getVarCount()))
         ++nonSquareFreeCount;
 
-    size_t selected = rand() % nonSquareFreeCount;
+    size_t selected = RandomSource::getRandom() % nonSquareFreeCount;
     for (Ideal::const_iterator it = slice.getIdeal().begin(); ; ++it) {
       ASSERT(it != end);
       if (Term::isSquareFree(*it, slice.getVarCount()))
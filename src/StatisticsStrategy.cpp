@@ -18,6 +18,7 @@
 #include "StatisticsStrategy.h"
 
 #include "Slice.h"
+#include "TaskSchedule.h"
 
 #include <cmath>
 
@@ -38,6 +39,7 @@ void StatisticsStrategy::run(const Ideal& ideal) {
   fputs("**** Slice Algorithm Statistics ****\n", _out);
   _internalTracker.printReport(_out);
   _leafTracker.printReport(_out);
+  _strategy->printStatistics(_out);
 }
 
 bool StatisticsStrategy::processSlice
@@ -67,10 +69,32 @@ bool StatisticsStrategy::getUseSimplification() const {
   return _strategy->getUseSimplification();
 }
 
+void StatisticsStrategy::setThreadCount(size_t threadCount) {
+  _strategy->setThreadCount(threadCount);
+}
+
+void StatisticsStrategy::setSchedule(unique_ptr<TaskSchedule> schedule) {
+  _strategy->setSchedule(std::move(schedule));
+}
+
+void StatisticsStrategy::setProcessCount(size_t processCount) {
+  _strategy->setProcessCount(processCount);
+}
+
+void StatisticsStrategy::setCheckpoint(const string& path,
+                                       size_t intervalSeconds,
+                                       bool resume) {
+  _strategy->setCheckpoint(path, intervalSeconds, resume);
+}
+
 void StatisticsStrategy::freeSlice(unique_ptr<Slice> slice) {
   _strategy->freeSlice(std::move(slice));
 }
 
+void StatisticsStrategy::printStatistics(FILE* out) const {
+  _strategy->printStatistics(out);
+}
+
 StatisticsStrategy::StatTracker::StatTracker(const string& title):
   _title(title) {
 }
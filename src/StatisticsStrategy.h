@@ -38,9 +38,17 @@ class StatisticsStrategy : public SliceStrategy {
   virtual void setUseIndependence(bool use);
   virtual void setUseSimplification(bool use);
   virtual bool getUseSimplification() const;
+  virtual void setThreadCount(size_t threadCount);
+  virtual void setSchedule(unique_ptr<TaskSchedule> schedule);
+  virtual void setProcessCount(size_t processCount);
+  virtual void setCheckpoint(const string& path,
+                             size_t intervalSeconds,
+                             bool resume);
 
   virtual void freeSlice(unique_ptr<Slice> slice);
 
+  virtual void printStatistics(FILE* out) const;
+
  private:
   SliceStrategy* _strategy;
   FILE* _out;
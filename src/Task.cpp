@@ -20,3 +20,7 @@
 
 Task::~Task() {
 }
+
+size_t Task::getSizeEstimate() const {
+  return 0;
+}
@@ -39,6 +39,12 @@ class Task {
    circumstances.
   */
   virtual void dispose() = 0;
+
+  /** Returns an estimate of the amount of work that it takes to run
+   this task. This is used by schedules that run small tasks first.
+   The default implementation returns zero.
+  */
+  virtual size_t getSizeEstimate() const;
 };
 
 #endif
@@ -19,46 +19,307 @@
 #include "TaskEngine.h"
 
 #include "Task.h"
+#include "TaskSchedule.h"
+#include "ProgressReporter.h"
 #include "display.h"
+#include "RandomSource.h"
+
+#include <deque>
+#include <set>
+#include <functional>
+#include <thread>
+
+/** A Group keeps track of a task that has been added through
+ addTask(Task*, Task*) and of the tasks that it transitively adds. The
+ continuation is scheduled when pending reaches zero. */
+struct TaskEngine::Group {
+  Group(Task* continuationParam, Group* parentParam, size_t depthParam):
+    pending(1),
+    continuation(continuationParam),
+    parent(parentParam),
+    depth(depthParam) {
+  }
+
+  std::atomic<size_t> pending;
+  Task* continuation;
+  Group* parent;
+
+  /** The depth that the continuation is scheduled at. */
+  size_t depth;
+};
+
+/** A pending task in parallel mode. */
+struct TaskEngine::Entry {
+  Task* task;
+  Group* group;
+  size_t depth;
+};
+
+/** The state of one thread in parallel mode. The queues are protected
+ by mutex since other workers steal from them. */
+struct TaskEngine::Worker {
+  Worker(TaskEngine& engineParam, size_t indexParam):
+    engine(engineParam),
+    index(indexParam),
+    group(0),
+    depth(0),
+    sequence(0),
+    random(0) {
+  }
+
+  /** Removes the task that this worker should run next and returns
+   true, or returns false if there are no pending tasks. */
+  bool popOwn(Entry& entry) {
+    if (!scheduled.empty()) {
+      entry = scheduled.begin()->entry;
+      scheduled.erase(scheduled.begin());
+      return true;
+    }
+    if (!queue.empty()) {
+      entry = queue.back();
+      queue.pop_back();
+      return true;
+    }
+    return false;
+  }
+
+  /** Removes the task that another worker should steal and returns
+   true, or returns false if there are no pending tasks. */
+  bool popSteal(Entry& entry) {
+    if (!scheduled.empty()) {
+      std::set<Scheduled>::iterator last = scheduled.end();
+      --last;
+      entry = last->entry;
+      scheduled.erase(last);
+      return true;
+    }
+    if (!queue.empty()) {
+      entry = queue.front();
+      queue.pop_front();
+      return true;
+    }
+    return false;
+  }
+
+  TaskEngine& engine;
+  const size_t index;
+
+  /** The group and depth of the task that this worker is currently
+   running. Tasks added by that task become members of the same
+   group one level deeper. */
+  Group* group;
+  size_t depth;
+
+  std::mutex mutex;
+
+  /** The pending tasks when there is no schedule. The most recently
+   added task is at the back. */
+  std::deque<Entry> queue;
+
+  /** A pending task when there is a schedule. Tasks are ordered so
+   that the task to run next is first. */
+  struct Scheduled {
+    size_t priority;
+    size_t sequence;
+    Entry entry;
+
+    bool operator<(const Scheduled& scheduled) const {
+      if (priority != scheduled.priority)
+        return priority < scheduled.priority;
+      return sequence > scheduled.sequence;
+    }
+  };
+
+  /** The pending tasks when there is a schedule. */
+  std::set<Scheduled> scheduled;
+
+  /** The number of tasks that have been added to scheduled. */
+  size_t sequence;
+
+  /** The random source of the thread of this worker, unless it is
+   the thread that called run, which keeps its current source. */
+  RandomSource random;
+};
+
+thread_local TaskEngine::Worker* TaskEngine::_currentWorker = 0;
 
 TaskEngine::TaskEngine():
-  _totalTasksEver(0) {
+  _totalTasksEver(0),
+  _maxPending(0),
+  _threadCount(1),
+  _unfinished(0),
+  _queued(0),
+  _sleepers(0),
+  _aborting(false) {
 }
 
 TaskEngine::~TaskEngine() {
   while (!_tasks.empty()) {
     dispose(_tasks.back());
     _tasks.pop_back();
+    ProgressReporter::noteTaskRemoved();
   }
+  disposeAllQueued();
+  for (size_t i = 0; i < _workers.size(); ++i)
+    delete _workers[i];
+}
+
+void TaskEngine::setThreadCount(size_t threadCount) {
+  ASSERT(_tasks.empty());
+  ASSERT(_queued == 0);
+
+  if (threadCount == 0)
+    threadCount = 1;
+  _threadCount = threadCount;
+  updateWorkers();
+}
+
+void TaskEngine::setSchedule(unique_ptr<TaskSchedule> schedule) {
+  ASSERT(_tasks.empty());
+  ASSERT(_queued == 0);
+
+  if (schedule.get() != 0 && schedule->isDepthFirst())
+    schedule.reset();
+  _schedule = std::move(schedule);
+  updateWorkers();
+}
+
+void TaskEngine::updateWorkers() {
+  // A schedule is implemented by the workers, so there has to be
+  // workers if there is a schedule even if there is only one thread.
+  size_t workerCount = _threadCount;
+  if (workerCount == 1 && _schedule.get() == 0)
+    workerCount = 0;
+  if (workerCount == _workers.size())
+    return;
+
+  for (size_t i = 0; i < _workers.size(); ++i)
+    delete _workers[i];
+  _workers.clear();
+
+  _workers.reserve(workerCount);
+  for (size_t i = 0; i < workerCount; ++i)
+    _workers.push_back(new Worker(*this, i));
+}
+
+void TaskEngine::notePending(size_t pending) {
+  size_t maxPending = _maxPending.load(std::memory_order_relaxed);
+  while (pending > maxPending &&
+         !_maxPending.compare_exchange_weak
+         (maxPending, pending, std::memory_order_relaxed))
+    ;
 }
 
 void TaskEngine::addTask(Task* task) {
   ASSERT(task != 0);
 
+  if (_workers.empty()) {
+    try {
+      _tasks.push_back(task);
+    } catch (...) {
+      // We should only get an exception if insertion failed.
+      ASSERT(_tasks.empty() || _tasks.back() != task);
+      dispose(task);
+      throw;
+    }
+    if (_tasks.size() > _maxPending.load(std::memory_order_relaxed))
+      _maxPending.store(_tasks.size(), std::memory_order_relaxed);
+    ProgressReporter::noteTaskAdded();
+  } else {
+    Group* group = 0;
+    size_t depth = 0;
+    if (_currentWorker != 0 && &_currentWorker->engine == this) {
+      group = _currentWorker->group;
+      depth = _currentWorker->depth + 1;
+    }
+    if (group != 0)
+      ++group->pending;
+    ++_unfinished;
+    try {
+      pushToWorker(task, group, depth);
+    } catch (...) {
+      dispose(task);
+      finishGroup(group, false);
+      taskFinished();
+      throw;
+    }
+  }
+
+  ++_totalTasksEver;
+}
+
+void TaskEngine::addTask(Task* task, Task* continuation) {
+  ASSERT(task != 0);
+  ASSERT(continuation != 0);
+
+  if (_workers.empty()) {
+    try {
+      addTask(continuation);
+    } catch (...) {
+      dispose(task);
+      throw;
+    }
+    addTask(task);
+    return;
+  }
+
+  Group* parent = 0;
+  size_t depth = 0;
+  if (_currentWorker != 0 && &_currentWorker->engine == this) {
+    parent = _currentWorker->group;
+    depth = _currentWorker->depth + 1;
+  }
+
+  Group* group;
   try {
-    _tasks.push_back(task);
+    group = new Group(continuation, parent, depth);
   } catch (...) {
-    // We should only get an exception if insertion failed.
-    ASSERT(_tasks.empty() || _tasks.back() != task);
     dispose(task);
+    dispose(continuation);
     throw;
   }
 
+  // The continuation is counted as pending in the parent group and as
+  // unfinished from now on, even though it is not queued until the
+  // group is done.
+  if (parent != 0)
+    ++parent->pending;
+  ++_unfinished;
+  ++_totalTasksEver;
+
+  ++_unfinished;
+  try {
+    pushToWorker(task, group, depth);
+  } catch (...) {
+    dispose(task);
+    finishGroup(group, false);
+    taskFinished();
+    throw;
+  }
   ++_totalTasksEver;
 }
 
 bool TaskEngine::runNextTask() {
+  ASSERT(_workers.empty());
   if (_tasks.empty())
     return false;
 
   Task* task = _tasks.back();
   _tasks.pop_back();
+  ProgressReporter::noteTaskRemoved();
   task->run(*this);
 
   return true;
 }
 
 void TaskEngine::runTasks() {
+  if (!_workers.empty()) {
+    if (_schedule.get() != 0)
+      _schedule->reset();
+    runParallel();
+    return;
+  }
+
   while (runNextTask())
     ;
 }
@@ -67,6 +328,16 @@ size_t TaskEngine::getTotalTasksEver() {
   return _totalTasksEver;
 }
 
+size_t TaskEngine::getCurrentWorker() const {
+  if (_currentWorker != 0 && &_currentWorker->engine == this)
+    return _currentWorker->index;
+  return 0;
+}
+
+bool TaskEngine::wantsMoreTasks() const {
+  return _workers.size() > 1 && _queued.load() < _workers.size();
+}
+
 void TaskEngine::dispose(Task* task) {
   ASSERT(task != 0);
 
@@ -78,3 +349,190 @@ void TaskEngine::dispose(Task* task) {
     throw; // Lesser evil compared to ignoring the exception.
   }
 }
+
+void TaskEngine::runParallel() {
+  ASSERT(!_workers.empty());
+
+  _aborting = false;
+  _exception = std::exception_ptr();
+
+  vector<std::thread> threads;
+  threads.reserve(_workers.size() - 1);
+  for (size_t i = 1; i < _workers.size(); ++i) {
+    // Seed from the source of the caller, so that a seed set through
+    // Frobby::Context also affects the choices of the other threads.
+    _workers[i]->random.setSeed
+      (static_cast<unsigned int>(RandomSource::getRandom()));
+    try {
+      threads.push_back
+        (std::thread(&TaskEngine::workerLoop, this, std::ref(*_workers[i])));
+    } catch (...) {
+      // Run with the threads that we did get. Workers that never
+      // start simply have empty queues.
+      break;
+    }
+  }
+
+  workerLoop(*_workers[0]);
+  for (size_t i = 0; i < threads.size(); ++i)
+    threads[i].join();
+
+  if (_aborting) {
+    disposeAllQueued();
+    _aborting = false;
+    std::exception_ptr exception = _exception;
+    _exception = std::exception_ptr();
+    std::rethrow_exception(exception);
+  }
+  ASSERT(_unfinished == 0);
+  ASSERT(_queued == 0);
+}
+
+void TaskEngine::workerLoop(Worker& worker) {
+  Worker* previousWorker = _currentWorker;
+  _currentWorker = &worker;
+  RandomSource* previousRandom = 0;
+  if (worker.index != 0)
+    previousRandom = RandomSource::setThreadSource(&worker.random);
+
+  while (!_aborting) {
+    Entry entry;
+    if (popOwnOrSteal(worker, entry)) {
+      runFromWorker(worker, entry);
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(_idleMutex);
+    ++_sleepers;
+    while (_queued == 0 && _unfinished != 0 && !_aborting)
+      _idleCondition.wait(lock);
+    --_sleepers;
+    if (_unfinished == 0)
+      break;
+  }
+
+  if (worker.index != 0)
+    RandomSource::setThreadSource(previousRandom);
+  _currentWorker = previousWorker;
+}
+
+void TaskEngine::pushToWorker(Task* task, Group* group, size_t depth) {
+  ASSERT(!_workers.empty());
+
+  Worker* worker = _workers[0];
+  if (_currentWorker != 0 && &_currentWorker->engine == this)
+    worker = _currentWorker;
+
+  Entry entry = {task, group, depth};
+  if (_schedule.get() == 0) {
+    std::lock_guard<std::mutex> lock(worker->mutex);
+    worker->queue.push_back(entry);
+  } else {
+    Worker::Scheduled scheduled;
+    scheduled.priority = _schedule->getPriority(*task, depth, _queued);
+    scheduled.entry = entry;
+
+    std::lock_guard<std::mutex> lock(worker->mutex);
+    scheduled.sequence = worker->sequence++;
+    worker->scheduled.insert(scheduled);
+  }
+  notePending(++_queued);
+  ProgressReporter::noteTaskAdded();
+
+  if (_sleepers > 0) {
+    std::lock_guard<std::mutex> lock(_idleMutex);
+    _idleCondition.notify_one();
+  }
+}
+
+bool TaskEngine::popOwnOrSteal(Worker& worker, Entry& entry) {
+  {
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.popOwn(entry)) {
+      --_queued;
+      ProgressReporter::noteTaskRemoved();
+      return true;
+    }
+  }
+
+  // Steal the task of some other worker that is run last, which is
+  // the oldest one if there is no schedule, starting the search at the
+  // next worker so that not every thief targets the same victim.
+  const size_t workerCount = _workers.size();
+  for (size_t offset = 1; offset < workerCount; ++offset) {
+    Worker& victim = *_workers[(worker.index + offset) % workerCount];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (victim.popSteal(entry)) {
+      --_queued;
+      ProgressReporter::noteTaskRemoved();
+      return true;
+    }
+  }
+  return false;
+}
+
+void TaskEngine::runFromWorker(Worker& worker, const Entry& entry) {
+  Group* previousGroup = worker.group;
+  size_t previousDepth = worker.depth;
+  worker.group = entry.group;
+  worker.depth = entry.depth;
+  try {
+    entry.task->run(*this);
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(_idleMutex);
+    if (!_aborting) {
+      _exception = std::current_exception();
+      _aborting = true;
+    }
+    _idleCondition.notify_all();
+  }
+  worker.group = previousGroup;
+  worker.depth = previousDepth;
+
+  finishGroup(entry.group, true);
+  taskFinished();
+}
+
+void TaskEngine::finishGroup(Group* group, bool schedule) {
+  while (group != 0 && --group->pending == 0) {
+    Task* continuation = group->continuation;
+    Group* parent = group->parent;
+    const size_t depth = group->depth;
+    delete group;
+
+    if (schedule && !_aborting) {
+      try {
+        pushToWorker(continuation, parent, depth);
+        return;
+      } catch (...) {
+        // Fall through to disposing the continuation.
+      }
+    }
+
+    dispose(continuation);
+    taskFinished();
+    group = parent;
+  }
+}
+
+void TaskEngine::taskFinished() {
+  if (--_unfinished == 0) {
+    std::lock_guard<std::mutex> lock(_idleMutex);
+    _idleCondition.notify_all();
+  }
+}
+
+void TaskEngine::disposeAllQueued() {
+  for (size_t i = 0; i < _workers.size(); ++i) {
+    Worker& worker = *_workers[i];
+    Entry entry;
+    while (worker.popOwn(entry)) {
+      --_queued;
+      ProgressReporter::noteTaskRemoved();
+
+      dispose(entry.task);
+      finishGroup(entry.group, false);
+      taskFinished();
+    }
+  }
+}
@@ -19,8 +19,13 @@
 #define TASK_ENGINE_GUARD
 
 #include <vector>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
 
 class Task;
+class TaskSchedule;
 
 /** TaskEngine handles a list of tasks that are to be carried out.
 
@@ -33,15 +38,49 @@ class Task;
  that stack overflow does not occur. The maximum number of pending
  tasks is limited only by the size of the memory.
 
- TaskEngine is also the first step towards an implementation where
- sub-computations can be run in parallel. At that time TaskEngine will
- need support for specifying dependencies among tasks.
+ If the thread count is set to more than one, then runTasks() runs
+ the pending tasks on that many threads. Each thread is a worker with
+ its own double-ended queue of pending tasks. A worker adds and
+ removes tasks at the back of its own queue, so each worker on its
+ own still proceeds in last-in-first-out order. A worker whose queue
+ is empty steals the oldest task from the front of the queue of
+ another worker. For a tree-shaped computation the oldest task is
+ the one closest to the root, so a steal tends to move a large part
+ of the remaining work to the idle worker at once.
+
+ If a schedule is set, then each worker runs the pending task in its
+ queue that the schedule gives the lowest priority, and a worker that
+ steals takes the task with the highest priority. This is also so if
+ the thread count is one.
+
+ Tasks cannot depend on the order in which they are run if the thread
+ count is more than one or a schedule is set, except as specified
+ through addTask(Task*, Task*). Tasks that are run in parallel mode
+ must also be safe to run concurrently with each other.
 */
 class TaskEngine {
  public:
   TaskEngine();
   ~TaskEngine();
 
+  /** Sets the number of threads that runTasks() uses. The default is
+   one thread, in which case all tasks are run on the thread that
+   calls runTasks(). This method must not be called while runTasks()
+   is running. A thread count of zero is interpreted as one.
+  */
+  void setThreadCount(size_t threadCount);
+
+  /** Returns the number of threads that runTasks() uses. */
+  size_t getThreadCount() const {return _workers.empty() ? 1 : _workers.size();}
+
+  /** Sets the schedule that determines the order in which pending
+   tasks are run. The default is no schedule, in which case tasks are
+   run in last-in-first-out order. A schedule that is depth-first is
+   the same as no schedule. This method must not be called while
+   runTasks() is running or while there are pending tasks.
+  */
+  void setSchedule(unique_ptr<TaskSchedule> schedule);
+
   /** Add a task at the head of the list of pending tasks.
 
    TaskEngine guarantees to call either run() or dispose() on the task
@@ -51,16 +90,31 @@ class TaskEngine {
   */
   void addTask(Task* task);
 
+  /** Add task at the head of the list of pending tasks, and run
+   continuation once task and every task that it transitively adds
+   have been run. If the thread count is one this is the same as
+   adding continuation and then adding task, so the dependency is
+   only needed to get the same behavior in parallel mode.
+
+   TaskEngine guarantees to call either run() or dispose() on both
+   task and continuation at some point.
+  */
+  void addTask(Task* task, Task* continuation);
+
   /** Run the most recently added task that has not been run yet.
 
    Returns true if a task has been run. Returns false if there are no
-   pending tasks.
+   pending tasks. This method must only be called when the thread
+   count is one and there is no schedule.
   */
   bool runNextTask();
 
   /** Runs all pending tasks.
 
-   If a task adds new tasks, those are run as well.
+   If a task adds new tasks, those are run as well. If a task throws
+   an exception in parallel mode, then the remaining tasks are
+   disposed and the first such exception is rethrown once every
+   thread has stopped.
   */
   void runTasks();
 
@@ -70,14 +124,87 @@ class TaskEngine {
   */
   size_t getTotalTasksEver();
 
+  /** Returns the largest number of tasks that have been pending at
+   the same time. Pending tasks are tasks that have been added but
+   that have not started running yet. This shows how much memory a
+   schedule spends on holding on to tasks.
+  */
+  size_t getMaxPendingTasks() const {return _maxPending;}
+
+  /** Returns the index of the worker of this engine that is running
+   on the calling thread. The index is in the range [0,
+   getThreadCount()). Returns 0 if the calling thread is not a worker
+   of this engine. This allows tasks to keep per-worker caches and
+   scratch space that need no locking.
+  */
+  size_t getCurrentWorker() const;
+
+  /** Returns true if there are fewer tasks waiting in the queues of
+   the workers than there are workers. A running task can use this to
+   decide whether to split off part of its work as a separate task
+   that another worker can steal, or to do the work itself. Always
+   returns false if the thread count is one. The value is only a hint
+   since the other workers keep running while it is computed.
+  */
+  bool wantsMoreTasks() const;
+
  private:
+  struct Group;
+  struct Entry;
+  struct Worker;
+
   void dispose(Task* task);
 
+  /** Makes _workers match the thread count and the schedule. */
+  void updateWorkers();
+  void notePending(size_t pending);
+
+  void runParallel();
+  void workerLoop(Worker& worker);
+  void pushToWorker(Task* task, Group* group, size_t depth);
+  bool popOwnOrSteal(Worker& worker, Entry& entry);
+  void runFromWorker(Worker& worker, const Entry& entry);
+  void finishGroup(Group* group, bool schedule);
+  void taskFinished();
+  void disposeAllQueued();
+
   /** This is used for statistics so that it is not a disaster if this
    overflows for very long-running computations. */
-  size_t _totalTasksEver;
+  std::atomic<size_t> _totalTasksEver;
+
+  /** The largest number of pending tasks there has been. */
+  std::atomic<size_t> _maxPending;
 
   vector<Task*> _tasks;
+
+  size_t _threadCount;
+
+  /** Null if there is no schedule. */
+  unique_ptr<TaskSchedule> _schedule;
+
+  /** The workers of parallel mode. Empty if the thread count is one
+   and there is no schedule. */
+  vector<Worker*> _workers;
+
+  /** The number of tasks that have been added but that have not yet
+   finished running or been disposed, in parallel mode. */
+  std::atomic<size_t> _unfinished;
+
+  /** The number of tasks that are sitting in a queue of a worker. */
+  std::atomic<size_t> _queued;
+
+  /** The number of workers that are waiting for a task to appear. */
+  std::atomic<size_t> _sleepers;
+
+  /** Set when a task has thrown an exception in parallel mode. */
+  std::atomic<bool> _aborting;
+  std::exception_ptr _exception;
+
+  std::mutex _idleMutex;
+  std::condition_variable _idleCondition;
+
+  /** The worker that is running on the calling thread, if any. */
+  static thread_local Worker* _currentWorker;
 };
 
 #endif
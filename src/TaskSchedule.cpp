@@ -0,0 +1,193 @@
+/* Frobby: Software for monomial ideal computations.
+   Copyright (C) 2007 Bjarke Hammersholt Roune (www.broune.com)
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see http://www.gnu.org/licenses/.
+*/
+#include "stdinc.h"
+#include "TaskSchedule.h"
+
+#include "Task.h"
+#include "NameFactory.h"
+
+#include <atomic>
+
+TaskSchedule::TaskSchedule() {
+}
+
+TaskSchedule::~TaskSchedule() {
+}
+
+bool TaskSchedule::isDepthFirst() const {
+  return false;
+}
+
+void TaskSchedule::setLimit(size_t limit) {
+}
+
+void TaskSchedule::reset() {
+}
+
+namespace {
+  /** Runs the most recently added task first. This is what TaskEngine
+   does without a schedule. */
+  class DepthFirstSchedule : public TaskSchedule {
+  public:
+    virtual size_t getPriority(const Task& task,
+                               size_t depth,
+                               size_t pendingCount) {
+      return 0;
+    }
+
+    virtual bool isDepthFirst() const {
+      return true;
+    }
+
+    virtual const char* getName() const {
+      return staticGetName();
+    }
+
+    static const char* staticGetName() {
+      return "dfs";
+    }
+  };
+
+  /** Runs the tasks of each depth before those of the next depth until
+   the limit depth, and then runs each task at the limit depth
+   depth-first. So the tree of tasks is expanded into a frontier of
+   up to one task per node at the limit depth first. */
+  class BreadthFirstSchedule : public TaskSchedule {
+  public:
+    BreadthFirstSchedule():
+      _limit(DefaultLimit) {
+    }
+
+    virtual size_t getPriority(const Task& task,
+                               size_t depth,
+                               size_t pendingCount) {
+      return depth < _limit ? depth : _limit;
+    }
+
+    virtual void setLimit(size_t limit) {
+      if (limit == 0)
+        limit = DefaultLimit;
+      _limit = limit;
+    }
+
+    virtual const char* getName() const {
+      return staticGetName();
+    }
+
+    static const char* staticGetName() {
+      return "bfs";
+    }
+
+  private:
+    static const size_t DefaultLimit = 10;
+    size_t _limit;
+  };
+
+  /** Runs the task with the smallest size estimate first. The tasks
+   that a task adds are usually smaller than it, so this mostly
+   proceeds depth-first and keeps the number of pending tasks
+   down. In parallel mode the largest tasks are left to be stolen by
+   other workers. */
+  class BestFirstSchedule : public TaskSchedule {
+  public:
+    virtual size_t getPriority(const Task& task,
+                               size_t depth,
+                               size_t pendingCount) {
+      return task.getSizeEstimate();
+    }
+
+    virtual const char* getName() const {
+      return staticGetName();
+    }
+
+    static const char* staticGetName() {
+      return "best";
+    }
+  };
+
+  /** Runs tasks breadth-first until the number of pending tasks
+   reaches the limit and then switches to depth-first for the rest
+   of the run. This builds up a frontier of tasks early in the
+   computation while bounding the memory that pending tasks take
+   up. */
+  class HybridSchedule : public TaskSchedule {
+  public:
+    HybridSchedule():
+      _limit(DefaultLimit),
+      _depthFirst(false) {
+    }
+
+    virtual size_t getPriority(const Task& task,
+                               size_t depth,
+                               size_t pendingCount) {
+      if (!_depthFirst) {
+        if (pendingCount < _limit)
+          return depth;
+        _depthFirst = true;
+      }
+
+      // Tasks added from now on run before the frontier that is
+      // already pending, and the most recently added first.
+      return 0;
+    }
+
+    virtual void setLimit(size_t limit) {
+      if (limit == 0)
+        limit = DefaultLimit;
+      _limit = limit;
+    }
+
+    virtual void reset() {
+      _depthFirst = false;
+    }
+
+    virtual const char* getName() const {
+      return staticGetName();
+    }
+
+    static const char* staticGetName() {
+      return "hybrid";
+    }
+
+  private:
+    static const size_t DefaultLimit = 1000;
+    size_t _limit;
+    std::atomic<bool> _depthFirst;
+  };
+
+  typedef NameFactory<TaskSchedule> ScheduleFactory;
+
+  ScheduleFactory getScheduleFactory() {
+    ScheduleFactory factory("task schedule");
+
+    nameFactoryRegister<DepthFirstSchedule>(factory);
+    nameFactoryRegister<BreadthFirstSchedule>(factory);
+    nameFactoryRegister<BestFirstSchedule>(factory);
+    nameFactoryRegister<HybridSchedule>(factory);
+
+    return factory;
+  }
+}
+
+unique_ptr<TaskSchedule> TaskSchedule::createSchedule(const string& prefix,
+                                                      size_t limit) {
+  unique_ptr<TaskSchedule> schedule =
+    createWithPrefix(getScheduleFactory(), prefix);
+  ASSERT(schedule.get() != 0);
+  schedule->setLimit(limit);
+  return schedule;
+}
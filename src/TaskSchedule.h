@@ -0,0 +1,81 @@
+/* Frobby: Software for monomial ideal computations.
+   Copyright (C) 2007 Bjarke Hammersholt Roune (www.broune.com)
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see http://www.gnu.org/licenses/.
+*/
+#ifndef TASK_SCHEDULE_GUARD
+#define TASK_SCHEDULE_GUARD
+
+#include <string>
+
+class Task;
+
+/** A TaskSchedule determines the order in which a TaskEngine runs
+ pending tasks. Without a schedule, TaskEngine runs pending tasks in
+ last-in-first-out order, which is a depth-first traversal of a tree
+ of tasks. That keeps the number of pending tasks low, but it never
+ builds up a frontier of independent tasks that could be spread out
+ over several threads early in a computation.
+
+ A schedule assigns a priority to each task as it is added. The task
+ with the lowest priority is run first, and among tasks of equal
+ priority the most recently added one is run first. So a schedule
+ that gives every task the same priority is depth-first.
+
+ Priorities are computed from several threads at once in parallel
+ mode, so getPriority() must be safe to call concurrently. */
+class TaskSchedule {
+ public:
+  virtual ~TaskSchedule();
+
+  /** Returns the priority of task, which is being added at the given
+   depth, when there are pendingCount pending tasks. Tasks that are
+   added from outside of a running task have depth zero, and a task
+   that is added by a task of depth d has depth d + 1. */
+  virtual size_t getPriority(const Task& task,
+                             size_t depth,
+                             size_t pendingCount) = 0;
+
+  /** Returns true if this schedule always gives tasks the same
+   priority, so that TaskEngine can run tasks in last-in-first-out
+   order without consulting the schedule. */
+  virtual bool isDepthFirst() const;
+
+  /** Sets the parameter of the schedule. What that means depends on
+   the schedule, and some schedules have no parameter. Zero selects
+   the default. This must not be called while the schedule is in
+   use. */
+  virtual void setLimit(size_t limit);
+
+  /** Prepares the schedule for a new run of TaskEngine::runTasks(). */
+  virtual void reset();
+
+  /** Returns the name of the schedule. */
+  virtual const char* getName() const = 0;
+
+  /** Returns the schedule whose name has the given prefix with its
+   parameter set to limit. Reports an error if there is no such
+   schedule. */
+  static unique_ptr<TaskSchedule> createSchedule(const string& prefix,
+                                                 size_t limit);
+
+ protected:
+  TaskSchedule();
+
+ private:
+  TaskSchedule(const TaskSchedule&); // not available
+  TaskSchedule& operator=(const TaskSchedule&); // not available
+};
+
+#endif
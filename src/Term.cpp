@@ -21,6 +21,10 @@
 #include <sstream>
 #include <vector>
 
+#ifdef FROBBY_X86_KERNELS
+#include <immintrin.h>
+#endif
+
 const unsigned int PoolCount = 50;
 const unsigned int ObjectPoolSize = 1000;
 
@@ -40,6 +44,9 @@ Term::Term(const string& str):
 }
 
 namespace {
+  /** Each thread has its own pools so that Term objects can be
+   allocated without locking. Memory can move between the pools of
+   different threads, which is fine since it is freed with delete[]. */
   struct ObjectPool {
     ObjectPool(): objectsStored(0), objects(0) {}
 
@@ -53,7 +60,9 @@ namespace {
     }
 
     bool canStoreMore() const {
-      return objectsStored < ObjectPoolSize;
+      // objects can be null if this thread has only freed terms that
+      // were allocated on other threads.
+      return objects != 0 && objectsStored < ObjectPoolSize;
     }
 
     Exponent* removeObject() {
@@ -80,7 +89,301 @@ namespace {
 
     unsigned int objectsStored;
     Exponent** objects;
-  } pools[PoolCount];
+  };
+  thread_local ObjectPool pools[PoolCount];
+}
+
+namespace {
+  // ** Scalar kernels. These work on any platform.
+
+  bool scalarDivides(const Exponent* a, const Exponent* b, size_t varCount) {
+    for (size_t var = 0; var < varCount; ++var)
+      if (a[var] > b[var])
+        return false;
+    return true;
+  }
+
+  bool scalarStrictlyDivides(const Exponent* a, const Exponent* b,
+                             size_t varCount) {
+    bool bIsIdentity = true;
+    for (size_t var = 0; var < varCount; ++var) {
+      if (a[var] >= b[var] && a[var] != 0)
+        return false;
+      if (b[var] != 0)
+        bIsIdentity = false;
+    }
+    return !bIsIdentity;
+  }
+
+  void scalarLcm(Exponent* res, const Exponent* a, const Exponent* b,
+                 size_t varCount) {
+    for (size_t var = 0; var < varCount; ++var)
+      res[var] = a[var] > b[var] ? a[var] : b[var];
+  }
+
+  void scalarGcd(Exponent* res, const Exponent* a, const Exponent* b,
+                 size_t varCount) {
+    for (size_t var = 0; var < varCount; ++var)
+      res[var] = a[var] < b[var] ? a[var] : b[var];
+  }
+
+  void scalarColon(Exponent* res, const Exponent* a, const Exponent* b,
+                   size_t varCount) {
+    for (size_t var = 0; var < varCount; ++var)
+      res[var] = a[var] > b[var] ? a[var] - b[var] : 0;
+  }
+
+  const Term::KernelTable scalarKernels = {
+    scalarDivides,
+    scalarStrictlyDivides,
+    scalarLcm,
+    scalarGcd,
+    scalarColon
+  };
+
+#ifdef FROBBY_X86_KERNELS
+  // The vector kernels below compare exponents as unsigned 32 bit
+  // integers.
+  static_assert(sizeof(Exponent) == 4 && Exponent(-1) > 0,
+                "The vector kernels assume 32 bit unsigned exponents.");
+
+  // ** AVX2 kernels. These handle 8 exponents per instruction and
+  // the remaining exponents with the scalar kernels. The result may
+  // alias an operand exactly since each vector is loaded before the
+  // corresponding result is stored.
+
+#define FROBBY_AVX2 __attribute__((target("avx2")))
+
+  FROBBY_AVX2 inline __m256i avx2Load(const Exponent* a) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a));
+  }
+
+  FROBBY_AVX2 inline void avx2Store(Exponent* a, __m256i value) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(a), value);
+  }
+
+  FROBBY_AVX2 bool avx2Divides(const Exponent* a, const Exponent* b,
+                               size_t varCount) {
+    size_t var = 0;
+    for (; var + 8 <= varCount; var += 8) {
+      __m256i va = avx2Load(a + var);
+      __m256i vb = avx2Load(b + var);
+      // a[var] <= b[var] if and only if max(a[var], b[var]) == b[var].
+      __m256i le = _mm256_cmpeq_epi32(_mm256_max_epu32(va, vb), vb);
+      if (_mm256_movemask_epi8(le) != -1)
+        return false;
+    }
+    return scalarDivides(a + var, b + var, varCount - var);
+  }
+
+  FROBBY_AVX2 bool avx2StrictlyDivides(const Exponent* a, const Exponent* b,
+                                       size_t varCount) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i bSupport = zero;
+    size_t var = 0;
+    for (; var + 8 <= varCount; var += 8) {
+      __m256i va = avx2Load(a + var);
+      __m256i vb = avx2Load(b + var);
+      __m256i ge = _mm256_cmpeq_epi32(_mm256_max_epu32(va, vb), va);
+      __m256i aIsZero = _mm256_cmpeq_epi32(va, zero);
+      if (!_mm256_testc_si256(aIsZero, ge))
+        return false; // a[var] >= b[var] and a[var] != 0 for some var.
+      bSupport = _mm256_or_si256(bSupport, vb);
+    }
+
+    bool bIsIdentity = _mm256_testz_si256(bSupport, bSupport);
+    for (; var < varCount; ++var) {
+      if (a[var] >= b[var] && a[var] != 0)
+        return false;
+      if (b[var] != 0)
+        bIsIdentity = false;
+    }
+    return !bIsIdentity;
+  }
+
+  FROBBY_AVX2 void avx2Lcm(Exponent* res, const Exponent* a,
+                           const Exponent* b, size_t varCount) {
+    size_t var = 0;
+    for (; var + 8 <= varCount; var += 8)
+      avx2Store(res + var,
+                _mm256_max_epu32(avx2Load(a + var), avx2Load(b + var)));
+    scalarLcm(res + var, a + var, b + var, varCount - var);
+  }
+
+  FROBBY_AVX2 void avx2Gcd(Exponent* res, const Exponent* a,
+                           const Exponent* b, size_t varCount) {
+    size_t var = 0;
+    for (; var + 8 <= varCount; var += 8)
+      avx2Store(res + var,
+                _mm256_min_epu32(avx2Load(a + var), avx2Load(b + var)));
+    scalarGcd(res + var, a + var, b + var, varCount - var);
+  }
+
+  FROBBY_AVX2 void avx2Colon(Exponent* res, const Exponent* a,
+                             const Exponent* b, size_t varCount) {
+    size_t var = 0;
+    for (; var + 8 <= varCount; var += 8) {
+      // a - min(a, b) is a - b if a > b and zero otherwise.
+      __m256i va = avx2Load(a + var);
+      __m256i vb = avx2Load(b + var);
+      avx2Store(res + var, _mm256_sub_epi32(va, _mm256_min_epu32(va, vb)));
+    }
+    scalarColon(res + var, a + var, b + var, varCount - var);
+  }
+
+#undef FROBBY_AVX2
+
+  const Term::KernelTable avx2Kernels = {
+    avx2Divides,
+    avx2StrictlyDivides,
+    avx2Lcm,
+    avx2Gcd,
+    avx2Colon
+  };
+
+  // ** AVX-512 kernels. These handle 16 exponents per instruction,
+  // and the last partial vector is handled with masked loads and
+  // stores instead of a scalar loop.
+
+#define FROBBY_AVX512 __attribute__((target("avx512f")))
+
+  FROBBY_AVX512 inline __mmask16 avx512TailMask(size_t count) {
+    ASSERT(count < 16);
+    return static_cast<__mmask16>((1u << count) - 1);
+  }
+
+  FROBBY_AVX512 bool avx512Divides(const Exponent* a, const Exponent* b,
+                                   size_t varCount) {
+    size_t var = 0;
+    for (; var + 16 <= varCount; var += 16)
+      if (_mm512_cmpgt_epu32_mask(_mm512_loadu_si512(a + var),
+                                  _mm512_loadu_si512(b + var)) != 0)
+        return false;
+    const __mmask16 mask = avx512TailMask(varCount - var);
+    return _mm512_cmpgt_epu32_mask
+      (_mm512_maskz_loadu_epi32(mask, a + var),
+       _mm512_maskz_loadu_epi32(mask, b + var)) == 0;
+  }
+
+  FROBBY_AVX512 bool avx512StrictlyDivides
+  (const Exponent* a, const Exponent* b, size_t varCount) {
+    __mmask16 bSupport = 0;
+    size_t var = 0;
+    while (true) {
+      __m512i va;
+      __m512i vb;
+      if (var + 16 <= varCount) {
+        va = _mm512_loadu_si512(a + var);
+        vb = _mm512_loadu_si512(b + var);
+      } else {
+        const __mmask16 mask = avx512TailMask(varCount - var);
+        va = _mm512_maskz_loadu_epi32(mask, a + var);
+        vb = _mm512_maskz_loadu_epi32(mask, b + var);
+      }
+
+      // Compare a >= b only where a is not zero.
+      const __mmask16 aSupport = _mm512_test_epi32_mask(va, va);
+      if (_mm512_mask_cmpge_epu32_mask(aSupport, va, vb) != 0)
+        return false;
+      bSupport |= _mm512_test_epi32_mask(vb, vb);
+
+      var += 16;
+      if (var >= varCount)
+        return bSupport != 0;
+    }
+  }
+
+  FROBBY_AVX512 void avx512Lcm(Exponent* res, const Exponent* a,
+                               const Exponent* b, size_t varCount) {
+    size_t var = 0;
+    for (; var + 16 <= varCount; var += 16)
+      _mm512_storeu_si512(res + var,
+                          _mm512_max_epu32(_mm512_loadu_si512(a + var),
+                                           _mm512_loadu_si512(b + var)));
+    const __mmask16 mask = avx512TailMask(varCount - var);
+    _mm512_mask_storeu_epi32
+      (res + var, mask,
+       _mm512_max_epu32(_mm512_maskz_loadu_epi32(mask, a + var),
+                        _mm512_maskz_loadu_epi32(mask, b + var)));
+  }
+
+  FROBBY_AVX512 void avx512Gcd(Exponent* res, const Exponent* a,
+                               const Exponent* b, size_t varCount) {
+    size_t var = 0;
+    for (; var + 16 <= varCount; var += 16)
+      _mm512_storeu_si512(res + var,
+                          _mm512_min_epu32(_mm512_loadu_si512(a + var),
+                                           _mm512_loadu_si512(b + var)));
+    const __mmask16 mask = avx512TailMask(varCount - var);
+    _mm512_mask_storeu_epi32
+      (res + var, mask,
+       _mm512_min_epu32(_mm512_maskz_loadu_epi32(mask, a + var),
+                        _mm512_maskz_loadu_epi32(mask, b + var)));
+  }
+
+  FROBBY_AVX512 void avx512Colon(Exponent* res, const Exponent* a,
+                                 const Exponent* b, size_t varCount) {
+    size_t var = 0;
+    for (; var + 16 <= varCount; var += 16) {
+      __m512i va = _mm512_loadu_si512(a + var);
+      __m512i vb = _mm512_loadu_si512(b + var);
+      _mm512_storeu_si512
+        (res + var, _mm512_sub_epi32(va, _mm512_min_epu32(va, vb)));
+    }
+    const __mmask16 mask = avx512TailMask(varCount - var);
+    __m512i va = _mm512_maskz_loadu_epi32(mask, a + var);
+    __m512i vb = _mm512_maskz_loadu_epi32(mask, b + var);
+    _mm512_mask_storeu_epi32
+      (res + var, mask, _mm512_sub_epi32(va, _mm512_min_epu32(va, vb)));
+  }
+
+#undef FROBBY_AVX512
+
+  const Term::KernelTable avx512Kernels = {
+    avx512Divides,
+    avx512StrictlyDivides,
+    avx512Lcm,
+    avx512Gcd,
+    avx512Colon
+  };
+#endif
+
+  KernelSet currentKernelSet = ScalarKernels;
+
+  // Selects the best kernels during static initialization. Until
+  // then the scalar kernels are used, which is also correct.
+  const bool kernelsInitialized = Term::setKernelSet(getBestKernelSet());
+}
+
+Term::KernelTable Term::_kernels = {
+  scalarDivides,
+  scalarStrictlyDivides,
+  scalarLcm,
+  scalarGcd,
+  scalarColon
+};
+
+KernelSet Term::getKernelSet() {
+  return currentKernelSet;
+}
+
+bool Term::setKernelSet(KernelSet set) {
+  if (!isKernelSetSupported(set))
+    return false;
+  _kernels = getKernelTable(set);
+  currentKernelSet = set;
+  return true;
+}
+
+const Term::KernelTable& Term::getKernelTable(KernelSet set) {
+  ASSERT(isKernelSetSupported(set));
+#ifdef FROBBY_X86_KERNELS
+  if (set == Avx2Kernels)
+    return avx2Kernels;
+  if (set == Avx512Kernels)
+    return avx512Kernels;
+#endif
+  return scalarKernels;
 }
 
 Exponent* Term::allocate(size_t size) {
@@ -17,6 +17,8 @@
 #ifndef TERM_GUARD
 #define TERM_GUARD
 
+#include "KernelSet.h"
+
 #include <ostream>
 
 /** Term represents a product of variables which does not include a
@@ -50,6 +52,15 @@ class Term {
  public:
  Term(): _exponents(0), _varCount(0) {}
   Term(const Term& term) {initialize(term._exponents, term._varCount);}
+
+  /** Takes over the exponents of term, which becomes a term with no
+   variables. This lets containers such as HashMap move terms around
+   without allocating. */
+  Term(Term&& term) noexcept:
+    _exponents(term._exponents), _varCount(term._varCount) {
+    term._exponents = 0;
+    term._varCount = 0;
+  }
   Term(const Exponent* exponents, size_t varCount) {
     initialize(exponents, varCount);
   }
@@ -142,16 +153,56 @@ class Term {
     return (*this) = term._exponents;
   }
 
+  Term& operator=(Term&& term) noexcept {
+    swap(term);
+    return *this;
+  }
+
   Term& operator=(const Exponent* exponents) {
     IF_DEBUG(if (_varCount > 0)) // avoid copy asserting on null pointer
     copy(exponents, exponents + _varCount, _exponents);
     return *this;
   }
 
+  /** Function pointers to the implementations of the operations on
+   exponent vectors that are used for terms with many variables. The
+   static methods below call these once there are at least
+   MinKernelVarCount variables, so that terms with few variables do
+   not pay for the indirect call. */
+  struct KernelTable {
+    bool (*divides)(const Exponent* a, const Exponent* b, size_t varCount);
+    bool (*strictlyDivides)(const Exponent* a, const Exponent* b,
+                            size_t varCount);
+    void (*lcm)(Exponent* res, const Exponent* a, const Exponent* b,
+                size_t varCount);
+    void (*gcd)(Exponent* res, const Exponent* a, const Exponent* b,
+                size_t varCount);
+    void (*colon)(Exponent* res, const Exponent* a, const Exponent* b,
+                  size_t varCount);
+  };
+
+  /** Terms with at least this many variables are handled by kernels. */
+  static const size_t MinKernelVarCount = 16;
+
+  /** Returns the kernel set that is currently in use. It is set to
+   the best kernels that the CPU supports before main() is entered. */
+  static KernelSet getKernelSet();
+
+  /** Switches to the given kernel set and returns true if it is
+   supported. Otherwise does nothing and returns false. This is for
+   benchmarks and tests, and it must not be called while another
+   thread could be using terms. */
+  static bool setKernelSet(KernelSet set);
+
+  /** Returns the table of kernels for set, which must be supported. */
+  static const KernelTable& getKernelTable(KernelSet set);
+
   /** Returns whether a divides b. */
   inline static bool divides(const Exponent* a, const Exponent* b, size_t varCount) {
     ASSERT(a != 0 || varCount == 0);
     ASSERT(b != 0 || varCount == 0);
+    if (varCount >= MinKernelVarCount)
+      return _kernels.divides(a, b, varCount);
     for (size_t var = 0; var < varCount; ++var)
       if (a[var] > b[var])
         return false;
@@ -173,6 +224,8 @@ class Term {
                                size_t varCount) {
     ASSERT(a != 0 || varCount == 0);
     ASSERT(b != 0 || varCount == 0);
+    if (varCount >= MinKernelVarCount)
+      return _kernels.divides(b, a, varCount);
     for (size_t var = 0; var < varCount; ++var)
       if (a[var] < b[var])
         return false;
@@ -197,6 +250,8 @@ class Term {
                                      size_t varCount) {
     ASSERT(a != 0 || varCount == 0);
     ASSERT(b != 0 || varCount == 0);
+    if (varCount >= MinKernelVarCount)
+      return _kernels.strictlyDivides(a, b, varCount);
     bool bIsIdentity = true;
     for (size_t var = 0; var < varCount; ++var) {
       if (a[var] >= b[var] && a[var] != 0)
@@ -224,6 +279,10 @@ class Term {
     ASSERT(res != 0 || varCount == 0);
     ASSERT(a != 0 || varCount == 0);
     ASSERT(b != 0 || varCount == 0);
+    if (varCount >= MinKernelVarCount) {
+      _kernels.lcm(res, a, b, varCount);
+      return;
+    }
     for (size_t var = 0; var < varCount; ++var) {
       if (a[var] > b[var])
         res[var] = a[var];
@@ -258,6 +317,10 @@ class Term {
     ASSERT(res != 0 || varCount == 0);
     ASSERT(a != 0 || varCount == 0);
     ASSERT(b != 0 || varCount == 0);
+    if (varCount >= MinKernelVarCount) {
+      _kernels.gcd(res, a, b, varCount);
+      return;
+    }
     for (size_t var = 0; var < varCount; ++var) {
       if (a[var] < b[var])
         res[var] = a[var];
@@ -479,6 +542,10 @@ class Term {
     ASSERT(res != 0 || varCount == 0);
     ASSERT(a != 0 || varCount == 0);
     ASSERT(b != 0 || varCount == 0);
+    if (varCount >= MinKernelVarCount) {
+      _kernels.colon(res, a, b, varCount);
+      return;
+    }
     for (size_t var = 0; var < varCount; ++var) {
       if (a[var] > b[var])
         res[var] = a[var] - b[var];
@@ -584,6 +651,8 @@ class Term {
   static Exponent* allocate(size_t size);
   static void deallocate(Exponent* p, size_t size);
 
+  static KernelTable _kernels;
+
   void initialize(const Exponent* exponents, size_t varCount) {
     if (varCount > 0) {
       ASSERT(exponents != 0);
@@ -21,6 +21,20 @@
 #include "TermTranslator.h"
 #include "Term.h"
 
+#include <limits>
+
+namespace {
+  /** Returns value clamped to the range of long. Every word grade is
+   strictly inside that range, so comparing a word grade to the
+   clamped value gives the same answer as comparing to value. */
+  long clampToWord(const mpz_class& value) {
+    if (value.fits_slong_p())
+      return value.get_si();
+    return value > 0 ?
+      std::numeric_limits<long>::max() : std::numeric_limits<long>::min();
+  }
+}
+
 TermGrader::TermGrader(const vector<mpz_class>& varDegrees,
                        const TermTranslator& translator):
   _grades(varDegrees.size()) {
@@ -42,6 +56,28 @@ TermGrader::TermGrader(const vector<mpz_class>& varDegrees,
     for (Exponent e = 0; e <= maxId; ++e)
       _grades[var][e] = varDegrees[var] * translator.getExponent(var, e);
   }
+
+  // Use machine integers if the sum over the variables of the largest
+  // absolute value of a grade is less than the largest long. Then no
+  // sum of grades can overflow.
+  mpz_class maxSum = 0;
+  for (size_t var = 0; var < _grades.size(); ++var) {
+    mpz_class maxAbs = 0;
+    for (size_t e = 0; e < _grades[var].size(); ++e)
+      if (abs(_grades[var][e]) > maxAbs)
+        maxAbs = abs(_grades[var][e]);
+    maxSum += maxAbs;
+  }
+  _hasWordGrades = maxSum < std::numeric_limits<long>::max();
+
+  if (_hasWordGrades) {
+    _wordGrades.resize(_grades.size());
+    for (size_t var = 0; var < _grades.size(); ++var) {
+      _wordGrades[var].resize(_grades[var].size());
+      for (size_t e = 0; e < _grades[var].size(); ++e)
+        _wordGrades[var][e] = _grades[var][e].get_si();
+    }
+  }
 }
 
 mpz_class TermGrader::getDegree(const Term& term) const {
@@ -52,6 +88,11 @@ mpz_class TermGrader::getDegree(const Term& term) const {
 
 void TermGrader::getDegree(const Term& term, mpz_class& degree) const {
   ASSERT(term.getVarCount() == _grades.size());
+  if (_hasWordGrades) {
+    degree = getWordDegree(term);
+    return;
+  }
+
   degree = 0;
   for (size_t var = 0; var < term.getVarCount(); ++var)
     degree += getGrade(var, term[var]);
@@ -61,11 +102,29 @@ void TermGrader::getDegree(const Term& term,
                            const Projection& projection,
                            mpz_class& degree) const {
   ASSERT(term.getVarCount() == projection.getRangeVarCount());
+  if (_hasWordGrades) {
+    long sum = 0;
+    for (size_t var = 0; var < term.getVarCount(); ++var)
+      sum += getWordGrade(projection.inverseProjectVar(var), term[var]);
+    degree = sum;
+    return;
+  }
+
   degree = 0;
   for (size_t var = 0; var < term.getVarCount(); ++var)
     degree += getGrade(projection.inverseProjectVar(var), term[var]);
 }
 
+long TermGrader::getWordDegree(const Term& term) const {
+  ASSERT(_hasWordGrades);
+  ASSERT(term.getVarCount() == _grades.size());
+
+  long degree = 0;
+  for (size_t var = 0; var < term.getVarCount(); ++var)
+    degree += getWordGrade(var, term[var]);
+  return degree;
+}
+
 void TermGrader::getUpperBound(const Term& divisor,
                                const Term& dominator,
                                mpz_class& bound) const {
@@ -73,45 +132,70 @@ void TermGrader::getUpperBound(const Term& divisor,
   ASSERT(dominator.getVarCount() == getVarCount());
   ASSERT(divisor.divides(dominator));
 
+  if (_hasWordGrades) {
+    bound = getWordUpperBound(divisor, dominator);
+    return;
+  }
+
   bound = 0;
   size_t varCount = getVarCount();
   for (size_t var = 0; var < varCount; ++var) {
-    int sign = getGradeSign(var);
-    if (sign == 0)
+    if (getGradeSign(var) == 0)
       continue;
+    Exponent e = getUpperBoundExponent(var, divisor[var], dominator[var]);
+    bound += getGrade(var, e);
+  }
+}
 
-    Exponent div = divisor[var];
-    Exponent dom = dominator[var];
-
-    Exponent optimalExponent;
-    if (div == dom)
-      optimalExponent = div; // Nothing to decide in this case.
-    else if (sign > 0) {
-      // In this case we normally prefer a high exponent.
-      //
-      // When computing irreducible decomposition or Alexander dual,
-      // we add pure powers of maximal degree that map to zero, in
-      // which case we want to avoid using that degree. This happens
-      // for dom == getMaxExponent(var).
-      if (dom == getMaxExponent(var)) {
-        ASSERT(getGrade(var, dom - 1) > getGrade(var, dom));
-        optimalExponent = dom - 1; // OK as div < dom.
-      } else
-        optimalExponent = dom;
-    } else {
-      ASSERT(sign < 0);
-
-      // In this case we normally prefer a low exponent. However, as
-      // above, we need to consider that the highest exponent could
-      // map to zero, which may be better.
-      if (dom == getMaxExponent(var)) {
-        ASSERT(getGrade(var, dom) > getGrade(var, div));
-        optimalExponent = dom;
-      } else
-        optimalExponent = div;
-    }
+long TermGrader::getWordUpperBound(const Term& divisor,
+                                   const Term& dominator) const {
+  ASSERT(_hasWordGrades);
+  ASSERT(divisor.getVarCount() == getVarCount());
+  ASSERT(dominator.getVarCount() == getVarCount());
+  ASSERT(divisor.divides(dominator));
 
-    bound += getGrade(var, optimalExponent);
+  long bound = 0;
+  size_t varCount = getVarCount();
+  for (size_t var = 0; var < varCount; ++var) {
+    if (getGradeSign(var) == 0)
+      continue;
+    Exponent e = getUpperBoundExponent(var, divisor[var], dominator[var]);
+    bound += getWordGrade(var, e);
+  }
+  return bound;
+}
+
+Exponent TermGrader::getUpperBoundExponent(size_t var,
+                                           Exponent div,
+                                           Exponent dom) const {
+  int sign = getGradeSign(var);
+  ASSERT(sign != 0);
+
+  if (div == dom)
+    return div; // Nothing to decide in this case.
+  else if (sign > 0) {
+    // In this case we normally prefer a high exponent.
+    //
+    // When computing irreducible decomposition or Alexander dual,
+    // we add pure powers of maximal degree that map to zero, in
+    // which case we want to avoid using that degree. This happens
+    // for dom == getMaxExponent(var).
+    if (dom == getMaxExponent(var)) {
+      ASSERT(getGrade(var, dom - 1) > getGrade(var, dom));
+      return dom - 1; // OK as div < dom.
+    } else
+      return dom;
+  } else {
+    ASSERT(sign < 0);
+
+    // In this case we normally prefer a low exponent. However, as
+    // above, we need to consider that the highest exponent could
+    // map to zero, which may be better.
+    if (dom == getMaxExponent(var)) {
+      ASSERT(getGrade(var, dom) > getGrade(var, div));
+      return dom;
+    } else
+      return div;
   }
 }
 
@@ -135,6 +219,18 @@ bool TermGrader::getMinIndexLessThan
   if (from > to)
     return false;
 
+  if (_hasWordGrades) {
+    const long wordMaxDegree = clampToWord(maxDegree);
+    for (Exponent e = from; ; ++e) {
+      if (getWordGrade(var, e) <= wordMaxDegree) {
+        index = e;
+        return true;
+      }
+      if (e == to)
+        return false;
+    }
+  }
+
   Exponent e = from;
   while (true) {
     const mpz_class& exp = _grades[var][e];
@@ -162,6 +258,18 @@ bool TermGrader::getMaxIndexLessThan
   if (from > to)
     return false;
 
+  if (_hasWordGrades) {
+    const long wordMaxDegree = clampToWord(maxDegree);
+    for (Exponent e = to; ; --e) {
+      if (getWordGrade(var, e) <= wordMaxDegree) {
+        index = e;
+        return true;
+      }
+      if (e == from)
+        return false;
+    }
+  }
+
   Exponent e = to;
   while (true) {
     const mpz_class& exp = _grades[var][e];
@@ -184,6 +292,18 @@ Exponent TermGrader::getLargestLessThan2
   bool first = true;
   size_t best = 0;
 
+  if (_hasWordGrades) {
+    const long wordValue = clampToWord(value);
+    for (size_t e = 1; e < _wordGrades[var].size(); ++e) {
+      long exp = _wordGrades[var][e];
+      if (exp <= wordValue && (first || exp > _wordGrades[var][best])) {
+        best = e;
+        first = false;
+      }
+    }
+    return best;
+  }
+
   for (size_t e = 1; e < _grades[var].size(); ++e) {
     const mpz_class& exp = _grades[var][e];
 
@@ -213,6 +333,9 @@ Exponent TermGrader::getLargestLessThan2(size_t var, Exponent from, Exponent to,
   Exponent low = from;
   Exponent high = to;
 
+  // The comparisons below use long when the grades fit in one.
+  const long wordValue = _hasWordGrades ? clampToWord(value) : 0;
+
   // We carry on as though strict is true, and adjust the value
   // below. The invariant is that degree(low) <= value < degree(high +
   // 1), if that is true to begin with. You can check that both the
@@ -242,7 +365,15 @@ Exponent TermGrader::getLargestLessThan2(size_t var, Exponent from, Exponent to,
     ASSERT(low < pivot);
     ASSERT(pivot <= high);
 
-    if (positive ? getGrade(var, pivot) <= value : getGrade(var, pivot) >= value) {
+    bool pivotAtMost;
+    if (_hasWordGrades) {
+      long grade = getWordGrade(var, pivot);
+      pivotAtMost = positive ? grade <= wordValue : grade >= wordValue;
+    } else {
+      const mpz_class& grade = getGrade(var, pivot);
+      pivotAtMost = positive ? grade <= value : grade >= value;
+    }
+    if (pivotAtMost) {
       low = pivot;
     }
     else {
@@ -267,6 +398,14 @@ void TermGrader::getIncrementedDegree(const Term& term,
                                       const Projection& projection,
                                       mpz_class& degree) const {
   ASSERT(term.getVarCount() == projection.getRangeVarCount());
+  if (_hasWordGrades) {
+    long sum = 0;
+    for (size_t var = 0; var < term.getVarCount(); ++var)
+      sum += getWordGrade(projection.inverseProjectVar(var), term[var] + 1);
+    degree = sum;
+    return;
+  }
+
   degree = 0;
   for (size_t var = 0; var < term.getVarCount(); ++var)
     degree += getGrade(projection.inverseProjectVar(var), term[var] + 1);
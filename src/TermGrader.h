@@ -23,7 +23,13 @@ class Projection;
 class Term;
 class TermTranslator;
 
-/** A TermGrader assigns a value, the degree, to each monomial. */
+/** A TermGrader assigns a value, the degree, to each monomial.
+
+ The grades are stored as mpz_class, and also as long when every sum
+ of grades is small enough to fit in a long. In that case the degrees
+ and bounds are computed using machine integers, and the overloads
+ that return a long can be used to avoid GMP arithmetic entirely.
+*/
 class TermGrader {
 public:
   TermGrader(const vector<mpz_class>& varDegrees,
@@ -59,6 +65,17 @@ public:
   mpz_class getUpperBound(const Term& divisor,
                           const Term& dominator) const;
 
+  /** Returns true if the grades fit in a long in such a way that no
+   degree or bound can overflow. The methods that use long require
+   this to be true. */
+  bool hasWordGrades() const {return _hasWordGrades;}
+
+  /** As getDegree, but computed using machine integers. */
+  long getWordDegree(const Term& term) const;
+
+  /** As getUpperBound, but computed using machine integers. */
+  long getWordUpperBound(const Term& divisor, const Term& dominator) const;
+
   /** Returns the index of the largest stored exponent of var that is
    less than value. If strict is true, then it is strictly less than,
    otherwise it is less than or equal to. If no such exponent exists,
@@ -103,6 +120,13 @@ public:
 
   const mpz_class& getGrade(size_t var, Exponent exponent) const;
 
+  long getWordGrade(size_t var, Exponent exponent) const {
+    ASSERT(_hasWordGrades);
+    ASSERT(var < _wordGrades.size());
+    ASSERT(exponent < _wordGrades[var].size());
+    return _wordGrades[var][exponent];
+  }
+
   Exponent getMaxExponent(size_t var) const;
 
   size_t getVarCount() const;
@@ -116,8 +140,17 @@ public:
   int getGradeSign(size_t var) const;
 
 private:
+  /** Returns the exponent of var of the largest term v such that
+   div divides v and v divides dom in that variable. */
+  Exponent getUpperBoundExponent(size_t var, Exponent div, Exponent dom) const;
+
   vector<vector<mpz_class> > _grades;
   vector<int> _signs;
+
+  /** The same as _grades, but as long. This is empty if
+   _hasWordGrades is false. */
+  vector<vector<long> > _wordGrades;
+  bool _hasWordGrades;
 };
 
 ostream& operator<<(ostream& out, const TermGrader& grader);
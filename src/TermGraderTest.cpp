@@ -45,6 +45,55 @@ TEST(TermGrader, getUpperBound) {
     ASSERT_EQ(grader.getUpperBound(Term("1 1 1"), Term("9 9 9")), 80);
 }
 
+TEST(TermGrader, WordGrades) {
+  vector<mpz_class> v(3);
+  v[0] = -10;
+  v[1] = 0;
+  v[2] = 10;
+  TermGrader small(v, TermTranslator(3, 9));
+  ASSERT_TRUE(small.hasWordGrades());
+  ASSERT_EQ(small.getWordDegree(Term("1 2 3")), 20);
+  ASSERT_EQ(small.getDegree(Term("1 2 3")), 20);
+  ASSERT_EQ(small.getWordUpperBound(Term("1 1 1"), Term("9 9 9")), 80);
+
+  // A sum of grades could overflow a long, so GMP must be used.
+  mpz_class big;
+  mpz_ui_pow_ui(big.get_mpz_t(), 2, 8 * sizeof(long) - 4);
+  v[0] = -big;
+  v[2] = big;
+  TermGrader large(v, TermTranslator(3, 9));
+  ASSERT_FALSE(large.hasWordGrades());
+  ASSERT_EQ(large.getDegree(Term("1 2 3")), 2 * big);
+  ASSERT_EQ(large.getUpperBound(Term("1 1 1"), Term("9 9 9")), 8 * big);
+}
+
+TEST(TermGrader, WordGradesWithLargeBound) {
+  vector<mpz_class> v(2);
+  v[0] = 10;
+  v[1] = -10;
+  TermGrader grader(v, TermTranslator(2, 9));
+  ASSERT_TRUE(grader.hasWordGrades());
+
+  // The bound does not fit in a long, but the word grades must still
+  // be compared correctly to it.
+  mpz_class big;
+  mpz_ui_pow_ui(big.get_mpz_t(), 2, 8 * sizeof(long) + 4);
+  Exponent index = 0;
+  ASSERT_TRUE(grader.getMaxIndexLessThan(0, 1, 8, index, big));
+  ASSERT_EQ(index, 8u);
+  ASSERT_TRUE(grader.getMinIndexLessThan(1, 1, 8, index, big));
+  ASSERT_EQ(index, 1u);
+  ASSERT_FALSE(grader.getMaxIndexLessThan(0, 1, 8, index, -big));
+  ASSERT_FALSE(grader.getMinIndexLessThan(1, 1, 8, index, -big));
+
+  ASSERT_EQ(grader.getLargestLessThan2(0, big), 8u);
+  ASSERT_EQ(grader.getLargestLessThan2(0, 1, 8, big), 8u);
+  ASSERT_EQ(grader.getLargestLessThan2(0, 1, 8, -big), 1u);
+  ASSERT_EQ(grader.getLargestLessThan2(0, mpz_class(35)), 3u);
+  ASSERT_EQ(grader.getLargestLessThan2(0, 1, 8, mpz_class(35)), 3u);
+  ASSERT_EQ(grader.getLargestLessThan2(1, 1, 8, mpz_class(-35)), 3u);
+}
+
 #define MIN_INDEX_TEST(from, to, maxDegree, strict, expectFind, expectedIndex) \
   { \
     Exponent foundIndex = 0; \
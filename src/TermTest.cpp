@@ -18,6 +18,8 @@
 #include "Term.h"
 #include "tests.h"
 
+#include <algorithm>
+
 TEST_SUITE(Term)
 
 TEST(Term, ParseStringConstructorNull) {
@@ -37,3 +39,68 @@ TEST(Term, ShareNonZeroExponent) {
   ASSERT_TRUE(Term("0 1 2").sharesNonZeroExponent(Term("2 1 0")));
   ASSERT_FALSE(Term("0 1 2").sharesNonZeroExponent(Term("0 2 1")));
 }
+
+TEST(Term, Kernels) {
+  ASSERT_TRUE(isKernelSetSupported(Term::getKernelSet()));
+  const Term::KernelTable& scalar = Term::getKernelTable(ScalarKernels);
+
+  // Compare every supported kernel set to the scalar kernels. Small
+  // exponents make ties and zeroes common, and the large exponents
+  // check that exponents are compared as unsigned integers.
+  const Exponent large = static_cast<Exponent>(-1);
+  unsigned long seed = 1;
+  for (int set = 0; set < KernelSetCount; ++set) {
+    if (!isKernelSetSupported(static_cast<KernelSet>(set)))
+      continue;
+    const Term::KernelTable& kernel =
+      Term::getKernelTable(static_cast<KernelSet>(set));
+    for (size_t varCount = 0; varCount < 40; ++varCount) {
+      for (size_t round = 0; round < 12; ++round) {
+        vector<Exponent> buffer(4 * varCount + 1);
+        for (size_t i = 0; i < buffer.size(); ++i) {
+          seed = seed * 1103515245 + 12345;
+          buffer[i] = (seed >> 16) % 4;
+          if (round % 4 == 3 && (seed >> 20) % 3 == 0)
+            buffer[i] = large - buffer[i];
+        }
+        Exponent* a = &buffer[0];
+        Exponent* b = a + varCount;
+        Exponent* res = b + varCount;
+        Exponent* expected = res + varCount;
+        if (round % 4 == 1) {
+          // Make a divide b.
+          for (size_t var = 0; var < varCount; ++var)
+            b[var] = a[var] + b[var] % 2;
+        } else if (round % 4 == 2) {
+          // Make a strictly divide b unless b is the identity.
+          for (size_t var = 0; var < varCount; ++var)
+            b[var] = a[var] == 0 ? b[var] % 2 : a[var] + 1;
+        }
+
+        ASSERT_EQ(kernel.divides(a, b, varCount),
+                  scalar.divides(a, b, varCount));
+        ASSERT_EQ(kernel.divides(b, a, varCount),
+                  scalar.divides(b, a, varCount));
+        ASSERT_EQ(kernel.strictlyDivides(a, b, varCount),
+                  scalar.strictlyDivides(a, b, varCount));
+
+        scalar.lcm(expected, a, b, varCount);
+        kernel.lcm(res, a, b, varCount);
+        ASSERT_TRUE(std::equal(res, res + varCount, expected));
+
+        scalar.gcd(expected, a, b, varCount);
+        kernel.gcd(res, a, b, varCount);
+        ASSERT_TRUE(std::equal(res, res + varCount, expected));
+
+        scalar.colon(expected, a, b, varCount);
+        kernel.colon(res, a, b, varCount);
+        ASSERT_TRUE(std::equal(res, res + varCount, expected));
+
+        // The exponent after the result must not be touched.
+        Exponent after = res[varCount];
+        kernel.lcm(res, res, a, varCount);
+        ASSERT_EQ(res[varCount], after);
+      }
+    }
+  }
+}
@@ -20,6 +20,7 @@
 #include "Term.h"
 #include "Ideal.h"
 #include "BigIdeal.h"
+#include "CompactBigIdeal.h"
 #include "VarNames.h"
 #include "FrobbyStringStream.h"
 #include "ElementDeleter.h"
@@ -67,6 +68,79 @@ TermTranslator::TermTranslator(const vector<BigIdeal*>& bigIdeals,
   idealsDeleter.release();
 }
 
+TermTranslator::TermTranslator(const CompactBigIdeal& compactIdeal,
+                               Ideal& ideal):
+  _exponents(compactIdeal.getVarCount()),
+  _names(compactIdeal.getNames()) {
+  const size_t varCount = compactIdeal.getVarCount();
+  const size_t genCount = compactIdeal.getGeneratorCount();
+
+  ideal.clearAndSetVarCount(varCount);
+  Term identity(varCount);
+  for (size_t term = 0; term < genCount; ++term)
+    ideal.insert(identity);
+
+  // The IDs are assigned one variable at a time in the same way as
+  // extractExponents does it. The exponents that fit in a word come
+  // before those that do not, so the order is preserved by putting
+  // the IDs of the big exponents after those of the word exponents.
+  vector<unsigned long> words;
+  vector<mpz_class> bigs;
+  vector<Exponent> wordToId;
+  for (size_t var = 0; var < varCount; ++var) {
+    words.clear();
+    words.reserve(genCount + 1);
+    words.push_back(0); // 0 must be included
+    bigs.clear();
+    for (size_t term = 0; term < genCount; ++term) {
+      if (compactIdeal.isWordExponent(term, var))
+        words.push_back(compactIdeal.getWordExponent(term, var));
+      else
+        bigs.push_back(compactIdeal.getBigExponent(term, var));
+    }
+
+    std::sort(words.begin(), words.end());
+    words.erase(std::unique(words.begin(), words.end()), words.end());
+    std::sort(bigs.begin(), bigs.end());
+    bigs.erase(std::unique(bigs.begin(), bigs.end()), bigs.end());
+
+    vector<mpz_class>& exponents = _exponents[var];
+    exponents.reserve(words.size() + bigs.size() + 1);
+    for (size_t i = 0; i < words.size(); ++i)
+      exponents.push_back(words[i]);
+    exponents.insert(exponents.end(), bigs.begin(), bigs.end());
+    exponents.push_back(0);
+
+    // Look IDs up in a table if the exponents are not too spread out,
+    // and otherwise use a binary search.
+    const unsigned long maxWord = words.back();
+    const bool useTable = maxWord < 4 * (genCount + 256);
+    if (useTable) {
+      wordToId.resize(maxWord + 1);
+      for (size_t i = 0; i < words.size(); ++i)
+        wordToId[words[i]] = static_cast<Exponent>(i);
+    }
+
+    Ideal::iterator it = ideal.begin();
+    for (size_t term = 0; term < genCount; ++term, ++it) {
+      size_t id;
+      if (!compactIdeal.isWordExponent(term, var)) {
+        const mpz_class& e = compactIdeal.getBigExponent(term, var);
+        id = words.size() +
+          (std::lower_bound(bigs.begin(), bigs.end(), e) - bigs.begin());
+      } else {
+        const unsigned long e = compactIdeal.getWordExponent(term, var);
+        if (useTable)
+          id = wordToId[e];
+        else
+          id = std::lower_bound(words.begin(), words.end(), e) -
+            words.begin();
+      }
+      (*it)[var] = static_cast<Exponent>(id);
+    }
+  }
+}
+
 // Helper function for extractExponents.
 bool mpzClassPointerLess(const mpz_class* a, const mpz_class* b) {
   return *a < *b;
@@ -416,6 +490,13 @@ getExponentString(size_t variable, Exponent exponent) const {
   return _stringExponents[variable][exponent];
 }
 
+void TermTranslator::prepareStrings() const {
+  if (_stringVarExponents.empty())
+    makeStrings(true);
+  if (_stringExponents.empty())
+    makeStrings(false);
+}
+
 const mpz_class& TermTranslator::
 getExponent(size_t variable, const Term& term) const {
   return getExponent(variable, term[variable]);
@@ -23,6 +23,7 @@
 #include <ostream>
 
 class BigIdeal;
+class CompactBigIdeal;
 class Ideal;
 class Term;
 
@@ -58,6 +59,13 @@ public:
   */
   TermTranslator(const vector<BigIdeal*>& bigIdeals, vector<Ideal*>& ideals);
 
+  /** Translates compactIdeal into ideal, and construct a translator
+   to translate back. The order of the variables is kept. This gives
+   the same result as going through a BigIdeal with sortVars false,
+   but it only uses GMP for the exponents that do not fit in a word.
+  */
+  TermTranslator(const CompactBigIdeal& compactIdeal, Ideal& ideal);
+
   TermTranslator(const TermTranslator& translator);
   ~TermTranslator();
 
@@ -82,6 +90,11 @@ public:
   */
   const char* getExponentString(size_t variable, Exponent exponent) const;
 
+  /** Makes the strings returned by getVarExponentString and
+   getExponentString now instead of on first use. Those methods can
+   then be called from several threads at the same time. */
+  void prepareStrings() const;
+
   /** The assigned IDs are those in the range [0, getMaxId(var)]. As a
       special case, getMaxId(var) maps to the same exponent as 0
       does. */
@@ -18,6 +18,11 @@
 #include "TermTranslator.h"
 #include "tests.h"
 
+#include "BigIdeal.h"
+#include "CompactBigIdeal.h"
+#include "Ideal.h"
+#include <limits>
+
 TEST_SUITE(TermTranslator)
 
 TEST(TermTranslator, IdentityConstructor) {
@@ -29,3 +34,47 @@ TEST(TermTranslator, IdentityConstructor) {
             " var 3: 0 1 2 3 4 5 6 7 8 9 0\n"
             ")\n");
 }
+
+TEST(TermTranslator, CompactIdealConstructor) {
+  // The same ideal as a BigIdeal and as a CompactBigIdeal, with
+  // spread out exponents and exponents that do not fit in a word.
+  VarNames names;
+  names.addVar("a");
+  names.addVar("b");
+  names.addVar("c");
+  BigIdeal bigIdeal(names);
+  CompactBigIdeal compactIdeal(names);
+
+  mpz_class huge("123456789012345678901234567890");
+  mpz_class wordMax(numeric_limits<unsigned long>::max());
+  mpz_class exponents[][3] = {
+    {3, 0, huge},
+    {1000000, 7, 0},
+    {0, wordMax, huge + 1},
+    {3, 7, 1},
+    {wordMax - 1, 0, huge}
+  };
+  for (size_t term = 0; term < 5; ++term) {
+    bigIdeal.newLastTerm();
+    compactIdeal.newLastTerm();
+    for (size_t var = 0; var < 3; ++var) {
+      bigIdeal.getLastTermExponentRef(var) = exponents[term][var];
+      if (exponents[term][var] != 0)
+        compactIdeal.setLastTermExponent(var, exponents[term][var]);
+    }
+  }
+  ASSERT_FALSE(compactIdeal.isWordExponent(0, 2));
+  ASSERT_FALSE(compactIdeal.isWordExponent(2, 1));
+  ASSERT_TRUE(compactIdeal.isWordExponent(4, 0));
+
+  BigIdeal roundTrip(names);
+  roundTrip.insert(compactIdeal);
+  ASSERT_EQ(roundTrip, bigIdeal);
+
+  Ideal fromBig;
+  TermTranslator bigTranslator(bigIdeal, fromBig, false);
+  Ideal fromCompact;
+  TermTranslator compactTranslator(compactIdeal, fromCompact);
+  ASSERT_EQ(compactTranslator.toString(), bigTranslator.toString());
+  ASSERT_EQ(fromCompact, fromBig);
+}
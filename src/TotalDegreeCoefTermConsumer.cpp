@@ -51,12 +51,23 @@ void TotalDegreeCoefTermConsumer::consume(const mpz_class& coef,
   if (coef == 0)
     return;
 
-  // Compute total degree using _tmp.
+  computeDegree(term);
+  _poly.add(coef, _tmp);
+}
+
+void TotalDegreeCoefTermConsumer::consume(long coef, const Term& term) {
+  ASSERT(term.getVarCount() == _translator.getVarCount());
+  if (coef == 0)
+    return;
+
+  computeDegree(term);
+  _poly.add(coef, _tmp);
+}
+
+void TotalDegreeCoefTermConsumer::computeDegree(const Term& term) {
   _tmp = 0;
   for (size_t var = 0; var < term.getVarCount(); ++var)
     _tmp += _translator.getExponent(var, term);
-
-  _poly.add(coef, _tmp);
 }
 
 void TotalDegreeCoefTermConsumer::doneConsuming() {
@@ -43,9 +43,13 @@ class TotalDegreeCoefTermConsumer : public CoefTermConsumer {
 
   virtual void beginConsuming();
   virtual void consume(const mpz_class& coef, const Term& term);
+  virtual void consume(long coef, const Term& term);
   virtual void doneConsuming();
 
  private:
+  /** Sets _tmp to the total degree of term. */
+  void computeDegree(const Term& term);
+
   CoefBigTermConsumer& _consumer;
   unique_ptr<CoefBigTermConsumer> _consumerOwner;
   const TermTranslator& _translator;
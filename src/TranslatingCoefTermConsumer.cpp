@@ -59,6 +59,12 @@ consume(const mpz_class& coef, const Term& term) {
   _consumer.consume(coef, term, _translator);
 }
 
+void TranslatingCoefTermConsumer::consume(long coef, const Term& term) {
+  ASSERT(term.getVarCount() == _translator.getVarCount());
+  _coef = coef;
+  _consumer.consume(_coef, term, _translator);
+}
+
 void TranslatingCoefTermConsumer::doneConsuming() {
   _consumer.doneConsuming();
 }
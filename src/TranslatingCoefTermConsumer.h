@@ -34,6 +34,7 @@ class TranslatingCoefTermConsumer : public CoefBigTermConsumer {
 
   virtual void beginConsuming();
   virtual void consume(const mpz_class& coef, const Term& term);
+  virtual void consume(long coef, const Term& term);
   virtual void consume(const mpz_class& coef,
                        const Term& term,
                        const TermTranslator& translator);
@@ -47,6 +48,10 @@ class TranslatingCoefTermConsumer : public CoefBigTermConsumer {
   const TermTranslator& _translator;
   CoefBigTermConsumer& _consumer;
   unique_ptr<CoefBigTermConsumer> _consumerOwner;
+
+  /** Small coefficients are passed on in this, so that passing them
+   on does not allocate. */
+  mpz_class _coef;
 };
 
 #endif
@@ -50,6 +50,22 @@ void UniHashPolynomial::add(const mpz_class& coef, const mpz_class& exponent) {
     _terms.erase(exponent);
 }
 
+void UniHashPolynomial::add(long coef, const mpz_class& exponent) {
+  if (coef == 0)
+    return;
+  mpz_class& ref = _terms[exponent];
+  ref += coef;
+  if (ref == 0)
+    _terms.erase(exponent);
+}
+
+void UniHashPolynomial::add(const UniHashPolynomial& poly) {
+  TermMap::const_iterator termsEnd = poly._terms.end();
+  TermMap::const_iterator it = poly._terms.begin();
+  for (; it != termsEnd; ++it)
+    add(it->second, it->first);
+}
+
 namespace {
   /** Helper class for feedTo. */
   class RefCompare {
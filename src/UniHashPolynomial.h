@@ -50,6 +50,12 @@ class UniHashPolynomial {
   /** Add coef*t^exponent to the polynomial. */
   void add(const mpz_class& coef, const mpz_class& exponent);
 
+  /** Add coef*t^exponent to the polynomial. */
+  void add(long coef, const mpz_class& exponent);
+
+  /** Add poly to this polynomial. */
+  void add(const UniHashPolynomial& poly);
+
   void feedTo(CoefBigTermConsumer& consumer, bool inCanonicalOrder = false) const;
 
   size_t getTermCount() const;
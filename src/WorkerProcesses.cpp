@@ -0,0 +1,389 @@
+/* Frobby: Software for monomial ideal computations.
+   Copyright (C) 2007 Bjarke Hammersholt Roune (www.broune.com)
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see http://www.gnu.org/licenses/.
+*/
+#include "stdinc.h"
+#include "WorkerProcesses.h"
+
+#include "error.h"
+#include "display.h"
+
+#include <cerrno>
+#include <cstring>
+#include <csignal>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/wait.h>
+
+namespace {
+  /** Messages on the pipes between the processes consist of a type,
+   the size of the payload and then the payload. */
+  enum MessageType {
+    UnitMessage = 'U',
+    QuitMessage = 'Q',
+    ResultMessage = 'R',
+    DoneMessage = 'D'
+  };
+
+  const size_t HeaderSize = 1 + sizeof(size_t);
+
+  /** Results are written to the pipe once there are this many bytes
+   of them. */
+  const size_t ResultBufferSize = 64 * 1024;
+
+  void appendMessage(string& buffer, char type,
+                     const char* payload, size_t size) {
+    buffer += type;
+    buffer.append(reinterpret_cast<const char*>(&size), sizeof(size));
+    if (size > 0)
+      buffer.append(payload, size);
+  }
+
+  void writeAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+      ssize_t written = write(fd, data, size);
+      if (written < 0) {
+        if (errno == EINTR)
+          continue;
+        reportError(string("Could not write to pipe of worker process: ") +
+                    strerror(errno));
+      }
+      data += written;
+      size -= written;
+    }
+  }
+
+  /** Reads exactly size bytes into data. Returns false if the pipe is
+   closed before any byte is read. */
+  bool readAll(int fd, char* data, size_t size) {
+    size_t done = 0;
+    while (done < size) {
+      ssize_t got = read(fd, data + done, size - done);
+      if (got < 0) {
+        if (errno == EINTR)
+          continue;
+        reportError(string("Could not read from pipe of worker process: ") +
+                    strerror(errno));
+      }
+      if (got == 0) {
+        if (done == 0)
+          return false;
+        reportError("Pipe of worker process closed in the middle of a unit.");
+      }
+      done += got;
+    }
+    return true;
+  }
+}
+
+struct WorkerProcesses::Worker {
+  pid_t pid;
+
+  /** The write end of the pipe that units are sent on. */
+  int unitFd;
+
+  /** The read end of the pipe that results are sent on. */
+  int resultFd;
+
+  /** The index of the unit that the worker is running. */
+  size_t unit;
+
+  /** Bytes read from resultFd that do not yet make up a whole
+   message. */
+  string buffer;
+
+  /** True once the worker has been told to quit. */
+  bool quitting;
+};
+
+WorkerProcesses::WorkerProcesses(size_t processCount):
+  _processCount(processCount == 0 ? 1 : processCount),
+  _nextUnit(0),
+  _outputUnit(0),
+  _resultFd(-1) {
+}
+
+WorkerProcesses::~WorkerProcesses() {
+  for (size_t i = 0; i < _workers.size(); ++i)
+    kill(_workers[i]->pid, SIGKILL);
+  stopWorkers();
+}
+
+void WorkerProcesses::run(const vector<string>& units,
+                          const UnitRunner& runUnit,
+                          const ResultConsumer& consumeResult) {
+  ASSERT(_workers.empty());
+  if (units.empty())
+    return;
+
+  // A worker that fails closes its pipes, and writing to a closed
+  // pipe should then be an error rather than kill this process.
+  void (*previousHandler)(int) = signal(SIGPIPE, SIG_IGN);
+
+  try {
+    startWorkers(std::min(_processCount, units.size()), runUnit);
+
+    _nextUnit = 0;
+    _outputUnit = 0;
+    _heldResults.clear();
+    _heldResults.resize(units.size());
+    _isUnitDone.assign(units.size(), false);
+    for (size_t i = 0; i < _workers.size(); ++i)
+      sendNextUnit(*_workers[i], units);
+
+    vector<pollfd> fds;
+    vector<Worker*> polled;
+    while (true) {
+      fds.clear();
+      polled.clear();
+      for (size_t i = 0; i < _workers.size(); ++i) {
+        if (_workers[i]->resultFd == -1)
+          continue;
+        pollfd fd = {_workers[i]->resultFd, POLLIN, 0};
+        fds.push_back(fd);
+        polled.push_back(_workers[i]);
+      }
+      if (fds.empty())
+        break;
+
+      if (poll(&fds.front(), fds.size(), -1) < 0) {
+        if (errno == EINTR)
+          continue;
+        reportError(string("Could not wait for worker processes: ") +
+                    strerror(errno));
+      }
+
+      for (size_t i = 0; i < fds.size(); ++i) {
+        if (fds[i].revents == 0)
+          continue;
+        if (!readResults(*polled[i], consumeResult, units)) {
+          close(polled[i]->resultFd);
+          polled[i]->resultFd = -1;
+          if (!polled[i]->quitting)
+            reportError("A worker process stopped before it was done.");
+        }
+      }
+    }
+  } catch (...) {
+    for (size_t i = 0; i < _workers.size(); ++i)
+      kill(_workers[i]->pid, SIGKILL);
+    stopWorkers();
+    signal(SIGPIPE, previousHandler);
+    throw;
+  }
+
+  signal(SIGPIPE, previousHandler);
+  if (!stopWorkers())
+    reportError("A worker process failed.");
+}
+
+void WorkerProcesses::sendResult(const char* result, size_t size) {
+  ASSERT(_resultFd != -1);
+  appendMessage(_resultBuffer, ResultMessage, result, size);
+  if (_resultBuffer.size() >= ResultBufferSize)
+    flushResults();
+}
+
+void WorkerProcesses::startWorkers(size_t workerCount,
+                                   const UnitRunner& runUnit) {
+  // Output that is buffered in this process would otherwise be
+  // written again by each worker.
+  fflush(0);
+
+  _workers.reserve(workerCount);
+  for (size_t i = 0; i < workerCount; ++i) {
+    int unitPipe[2];
+    int resultPipe[2];
+    if (pipe(unitPipe) != 0)
+      reportError(string("Could not create pipe: ") + strerror(errno));
+    if (pipe(resultPipe) != 0) {
+      close(unitPipe[0]);
+      close(unitPipe[1]);
+      reportError(string("Could not create pipe: ") + strerror(errno));
+    }
+
+    pid_t pid = fork();
+    if (pid < 0) {
+      close(unitPipe[0]);
+      close(unitPipe[1]);
+      close(resultPipe[0]);
+      close(resultPipe[1]);
+      reportError(string("Could not start worker process: ") +
+                  strerror(errno));
+    }
+
+    if (pid == 0) {
+      // The pipes of the other workers have to be closed here, or a
+      // worker that fails would not close its pipes.
+      for (size_t w = 0; w < _workers.size(); ++w) {
+        close(_workers[w]->unitFd);
+        close(_workers[w]->resultFd);
+      }
+      close(unitPipe[1]);
+      close(resultPipe[0]);
+      runWorker(unitPipe[0], resultPipe[1], runUnit);
+    }
+
+    close(unitPipe[0]);
+    close(resultPipe[1]);
+
+    Worker* worker = new Worker();
+    worker->pid = pid;
+    worker->unitFd = unitPipe[1];
+    worker->resultFd = resultPipe[0];
+    worker->quitting = false;
+    _workers.push_back(worker);
+  }
+}
+
+void WorkerProcesses::runWorker(int unitFd,
+                                int resultFd,
+                                const UnitRunner& runUnit) {
+  int status = 0;
+  try {
+    // The workers belong to the calling process.
+    _workers.clear();
+    _resultFd = resultFd;
+
+    char header[HeaderSize];
+    string unit;
+    while (readAll(unitFd, header, HeaderSize) &&
+           header[0] == UnitMessage) {
+      size_t size;
+      memcpy(&size, header + 1, sizeof(size));
+      unit.resize(size);
+      if (size > 0 && !readAll(unitFd, &unit[0], size))
+        reportError("Pipe of worker process closed in the middle of a unit.");
+
+      runUnit(unit);
+      appendMessage(_resultBuffer, DoneMessage, 0, 0);
+      flushResults();
+    }
+  } catch (const std::exception& exception) {
+    displayException(exception);
+    status = 1;
+  } catch (...) {
+    status = 1;
+  }
+
+  // The worker must not return into the code that called run(), and
+  // it must not run the exit handlers of the calling process.
+  fflush(0);
+  _exit(status);
+}
+
+void WorkerProcesses::sendNextUnit(Worker& worker,
+                                   const vector<string>& units) {
+  string message;
+  if (_nextUnit < units.size()) {
+    const string& unit = units[_nextUnit];
+    worker.unit = _nextUnit;
+    ++_nextUnit;
+    appendMessage(message, UnitMessage, unit.data(), unit.size());
+  } else {
+    appendMessage(message, QuitMessage, 0, 0);
+    worker.quitting = true;
+  }
+  writeAll(worker.unitFd, message.data(), message.size());
+}
+
+bool WorkerProcesses::readResults(Worker& worker,
+                                  const ResultConsumer& consumeResult,
+                                  const vector<string>& units) {
+  char data[ResultBufferSize];
+  ssize_t got;
+  do {
+    got = read(worker.resultFd, data, sizeof(data));
+  } while (got < 0 && errno == EINTR);
+  if (got < 0)
+    reportError(string("Could not read from pipe of worker process: ") +
+                strerror(errno));
+  if (got == 0)
+    return false;
+  worker.buffer.append(data, got);
+
+  size_t pos = 0;
+  while (worker.buffer.size() - pos >= HeaderSize) {
+    size_t size;
+    memcpy(&size, worker.buffer.data() + pos + 1, sizeof(size));
+    if (worker.buffer.size() - pos - HeaderSize < size)
+      break;
+
+    const char type = worker.buffer[pos];
+    const char* payload = worker.buffer.data() + pos + HeaderSize;
+    pos += HeaderSize + size;
+
+    if (type == ResultMessage) {
+      if (worker.unit == _outputUnit)
+        consumeResult(payload, size);
+      else
+        appendMessage(_heldResults[worker.unit], type, payload, size);
+    } else {
+      ASSERT(type == DoneMessage);
+      unitDone(worker.unit, consumeResult);
+      sendNextUnit(worker, units);
+    }
+  }
+  worker.buffer.erase(0, pos);
+  return true;
+}
+
+void WorkerProcesses::unitDone(size_t unit,
+                               const ResultConsumer& consumeResult) {
+  ASSERT(unit < _isUnitDone.size());
+  ASSERT(!_isUnitDone[unit]);
+  _isUnitDone[unit] = true;
+
+  while (_outputUnit < _isUnitDone.size() && _isUnitDone[_outputUnit]) {
+    ++_outputUnit;
+    if (_outputUnit == _isUnitDone.size())
+      break;
+
+    // The results that were held for the new output unit go first,
+    // and the rest of its results are consumed as they arrive.
+    string held;
+    held.swap(_heldResults[_outputUnit]);
+    for (size_t pos = 0; pos < held.size();) {
+      size_t size;
+      memcpy(&size, held.data() + pos + 1, sizeof(size));
+      consumeResult(held.data() + pos + HeaderSize, size);
+      pos += HeaderSize + size;
+    }
+  }
+}
+
+void WorkerProcesses::flushResults() {
+  writeAll(_resultFd, _resultBuffer.data(), _resultBuffer.size());
+  _resultBuffer.clear();
+}
+
+bool WorkerProcesses::stopWorkers() {
+  bool succeeded = true;
+  for (size_t i = 0; i < _workers.size(); ++i) {
+    Worker* worker = _workers[i];
+    close(worker->unitFd);
+    if (worker->resultFd != -1)
+      close(worker->resultFd);
+
+    int status;
+    while (waitpid(worker->pid, &status, 0) < 0 && errno == EINTR)
+      ;
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+      succeeded = false;
+    delete worker;
+  }
+  _workers.clear();
+  return succeeded;
+}
@@ -0,0 +1,113 @@
+/* Frobby: Software for monomial ideal computations.
+   Copyright (C) 2007 Bjarke Hammersholt Roune (www.broune.com)
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see http://www.gnu.org/licenses/.
+*/
+#ifndef WORKER_PROCESSES_GUARD
+#define WORKER_PROCESSES_GUARD
+
+#include <vector>
+#include <string>
+#include <functional>
+#include <sys/types.h>
+
+/** Runs work units in worker processes that are forked from the
+ calling process and that are connected to it by pipes. Units and
+ results are strings of bytes whose meaning is up to the caller.
+
+ Workers pull units. A worker is sent one unit at a time and sends
+ back the results of the unit while it runs. Once the unit is done,
+ the worker is sent the next unit that no worker has run yet. The
+ results are passed on in the order of the units no matter which
+ worker finishes first, so the results of a unit are held in memory
+ until the units before it are done. Since
+ the workers are forked, each starts out with a copy of the memory of
+ the calling process, so a unit only has to hold what differs
+ between units.
+
+ This is for computations that need more memory than one process can
+ get, or that should not be able to take down the calling process
+ by running out of memory. */
+class WorkerProcesses {
+ public:
+  /** Runs units on up to processCount worker processes. */
+  WorkerProcesses(size_t processCount);
+
+  /** Kills any worker processes that are still running. */
+  ~WorkerProcesses();
+
+  typedef std::function<void(const string& unit)> UnitRunner;
+  typedef std::function<void(const char* result, size_t size)>
+    ResultConsumer;
+
+  /** Runs each of units by calling runUnit on it in a worker process,
+   and calls consumeResult in the calling process on each result that
+   runUnit sends through sendResult(). The results are consumed in the
+   order of units, and the results of each unit in the order they were
+   sent. Returns once every unit is done and every worker process has
+   exited. Reports an error if a worker process fails. */
+  void run(const vector<string>& units,
+           const UnitRunner& runUnit,
+           const ResultConsumer& consumeResult);
+
+  /** Sends result to the process that called run(). This must only be
+   called from runUnit in a worker process, and not from several
+   threads at once. Results are buffered, so they do not each take a
+   system call. */
+  void sendResult(const char* result, size_t size);
+
+ private:
+  struct Worker;
+
+  void startWorkers(size_t workerCount, const UnitRunner& runUnit);
+  /** Runs the units that are sent on unitFd and exits the process. */
+  void runWorker(int unitFd, int resultFd, const UnitRunner& runUnit);
+  void sendNextUnit(Worker& worker, const vector<string>& units);
+  bool readResults(Worker& worker, const ResultConsumer& consumeResult,
+                   const vector<string>& units);
+  /** Marks unit as done and consumes the held results of the units
+   that are now next in order. */
+  void unitDone(size_t unit, const ResultConsumer& consumeResult);
+  void flushResults();
+
+  /** Waits for the workers to exit. Returns false if one of them
+   failed. */
+  bool stopWorkers();
+
+  const size_t _processCount;
+
+  /** The workers of the current call to run() in the calling process. */
+  vector<Worker*> _workers;
+
+  /** The index of the next unit to send to a worker. */
+  size_t _nextUnit;
+
+  /** The results of the unit with index _outputUnit are consumed as
+   they arrive, since every unit before it is done. The results of
+   the units after it are held in _heldResults as messages until
+   then. */
+  size_t _outputUnit;
+  vector<string> _heldResults;
+  vector<bool> _isUnitDone;
+
+  /** In a worker process, the pipe that results are sent on and the
+   results that have not been written to it yet. */
+  int _resultFd;
+  string _resultBuffer;
+
+  WorkerProcesses(const WorkerProcesses&); // not available
+  WorkerProcesses& operator=(const WorkerProcesses&); // not available
+};
+
+#endif
@@ -26,6 +26,8 @@
 #include "CoefBigTermConsumer.h"
 #include "IdealFacade.h"
 #include "SliceParams.h"
+#include "Arena.h"
+#include "RandomSource.h"
 
 const char* const frobby_version = "0.9.5";
 
@@ -192,6 +194,86 @@ namespace FrobbyImpl {
   };
 }
 
+namespace FrobbyImpl {
+  class FrobbyContextHelper {
+  public:
+    FrobbyContextHelper():
+      _random(1),
+      _threadCount(1) {
+    }
+
+    static FrobbyContextHelper& getHelper(Frobby::Context& context) {
+      return *context._data;
+    }
+
+    Arena& getArena() {return _arena;}
+    RandomSource& getRandomSource() {return _random;}
+    size_t getThreadCount() const {return _threadCount;}
+
+  private:
+    friend class Frobby::Context;
+
+    Arena _arena;
+    RandomSource _random;
+    size_t _threadCount;
+  };
+}
+
+namespace {
+  /** Makes the scratch arena and the random source of a context the
+   current ones of the calling thread for as long as this object
+   exists, and then restores the previous ones. Other threads that
+   TaskEngine starts keep their own arena and seed their random
+   source from that of the context. */
+  class ContextScope {
+  public:
+    ContextScope(Frobby::Context& context):
+      _context(FrobbyImpl::FrobbyContextHelper::getHelper(context)) {
+      _previousArena = Arena::setThreadArena(&_context.getArena());
+      _previousRandom =
+        RandomSource::setThreadSource(&_context.getRandomSource());
+    }
+
+    ~ContextScope() {
+      Arena::setThreadArena(_previousArena);
+      RandomSource::setThreadSource(_previousRandom);
+    }
+
+    /** Sets up params to use the number of threads of the context. */
+    void setParams(SliceParams& params) const {
+      params.setThreadCount(_context.getThreadCount());
+    }
+
+  private:
+    FrobbyImpl::FrobbyContextHelper& _context;
+    Arena* _previousArena;
+    RandomSource* _previousRandom;
+  };
+
+  /** Returns the context that the functions that do not take a
+   context use on the calling thread. */
+  Frobby::Context& getThreadContext() {
+    static thread_local Frobby::Context context;
+    return context;
+  }
+}
+
+Frobby::Context::Context() {
+  _data = new FrobbyImpl::FrobbyContextHelper();
+}
+
+Frobby::Context::~Context() {
+  delete _data;
+}
+
+void Frobby::Context::setRandomSeed(unsigned int seed) {
+  _data->_random.setSeed(seed);
+}
+
+void Frobby::Context::setThreadCount(size_t threadCount) {
+  _data->_threadCount = threadCount == 0 ? 1 : threadCount;
+}
+
 Frobby::Ideal::Ideal(size_t variableCount) {
   _data = new FrobbyImpl::FrobbyIdealHelper(variableCount);
 }
@@ -244,12 +326,22 @@ void Frobby::Ideal::addExponent(unsigned int exponent) {
 bool Frobby::alexanderDual(const Ideal& ideal,
                            const mpz_t* reflectionMonomial,
                            IdealConsumer& consumer) {
+  return alexanderDual(getThreadContext(), ideal,
+                       reflectionMonomial, consumer);
+}
+
+bool Frobby::alexanderDual(Context& context,
+                           const Ideal& ideal,
+                           const mpz_t* reflectionMonomial,
+                           IdealConsumer& consumer) {
+  ContextScope scope(context);
   const BigIdeal& bigIdeal = FrobbyImpl::FrobbyIdealHelper::getIdeal(ideal);
 
   ExternalIdealConsumerWrapper wrappedConsumer
     (&consumer, bigIdeal.getVarCount());
 
   SliceParams params;
+  scope.setParams(params);
   SliceFacade facade(params, bigIdeal, wrappedConsumer);
 
   if (reflectionMonomial == 0)
@@ -277,6 +369,14 @@ bool Frobby::alexanderDual(const Ideal& ideal,
 bool Frobby::alexanderDual(const Ideal& ideal,
                            const Ideal& reflectionMonomial,
                            IdealConsumer& consumer) {
+  return alexanderDual(getThreadContext(), ideal,
+                       reflectionMonomial, consumer);
+}
+
+bool Frobby::alexanderDual(Context& context,
+                           const Ideal& ideal,
+                           const Ideal& reflectionMonomial,
+                           IdealConsumer& consumer) {
   const BigIdeal& bigIdeal = FrobbyImpl::FrobbyIdealHelper::getIdeal(ideal);
   const BigIdeal& reflectionIdeal =
     FrobbyImpl::FrobbyIdealHelper::getIdeal(reflectionMonomial);
@@ -291,16 +391,24 @@ bool Frobby::alexanderDual(const Ideal& ideal,
   if (reflectionIdeal.getVarCount() > 0)
     monomialPtr = (const mpz_t*)&(monomial[0]);
 
-  return alexanderDual(ideal, monomialPtr, consumer);
+  return alexanderDual(context, ideal, monomialPtr, consumer);
 }
 
 void Frobby::multigradedHilbertPoincareSeries(const Ideal& ideal,
                                               PolynomialConsumer& consumer) {
+  multigradedHilbertPoincareSeries(getThreadContext(), ideal, consumer);
+}
+
+void Frobby::multigradedHilbertPoincareSeries(Context& context,
+                                              const Ideal& ideal,
+                                              PolynomialConsumer& consumer) {
+  ContextScope scope(context);
   const BigIdeal& bigIdeal = FrobbyImpl::FrobbyIdealHelper::getIdeal(ideal);
 
   ExternalPolynomialConsumerWrapper wrappedConsumer
     (&consumer, bigIdeal.getVarCount());
   SliceParams params;
+  scope.setParams(params);
   SliceFacade facade(params, bigIdeal, wrappedConsumer);
 
   facade.computeMultigradedHilbertSeries();
@@ -308,10 +416,18 @@ void Frobby::multigradedHilbertPoincareSeries(const Ideal& ideal,
 
 void Frobby::univariateHilbertPoincareSeries(const Ideal& ideal,
                                              PolynomialConsumer& consumer) {
+  univariateHilbertPoincareSeries(getThreadContext(), ideal, consumer);
+}
+
+void Frobby::univariateHilbertPoincareSeries(Context& context,
+                                             const Ideal& ideal,
+                                             PolynomialConsumer& consumer) {
+  ContextScope scope(context);
   const BigIdeal& bigIdeal = FrobbyImpl::FrobbyIdealHelper::getIdeal(ideal);
 
   ExternalPolynomialConsumerWrapper wrappedConsumer(&consumer, 1);
   SliceParams params;
+  scope.setParams(params);
   SliceFacade facade(params, bigIdeal, wrappedConsumer);
 
   facade.computeUnivariateHilbertSeries();
@@ -368,8 +484,14 @@ private:
 
 void Frobby::irreducibleDecompositionAsIdeals(const Ideal& ideal,
                                               IdealConsumer& consumer) {
+  irreducibleDecompositionAsIdeals(getThreadContext(), ideal, consumer);
+}
+
+void Frobby::irreducibleDecompositionAsIdeals(Context& context,
+                                              const Ideal& ideal,
+                                              IdealConsumer& consumer) {
   IrreducibleIdealDecoder wrappedConsumer(&consumer);
-  if (!irreducibleDecompositionAsMonomials(ideal, wrappedConsumer)) {
+  if (!irreducibleDecompositionAsMonomials(context, ideal, wrappedConsumer)) {
     const BigIdeal& bigIdeal = FrobbyImpl::FrobbyIdealHelper::getIdeal(ideal);
     consumer.idealBegin(bigIdeal.getVarCount());
     consumer.idealEnd();
@@ -378,6 +500,14 @@ void Frobby::irreducibleDecompositionAsIdeals(const Ideal& ideal,
 
 bool Frobby::irreducibleDecompositionAsMonomials(const Ideal& ideal,
                                                  IdealConsumer& consumer) {
+  return irreducibleDecompositionAsMonomials
+    (getThreadContext(), ideal, consumer);
+}
+
+bool Frobby::irreducibleDecompositionAsMonomials(Context& context,
+                                                 const Ideal& ideal,
+                                                 IdealConsumer& consumer) {
+  ContextScope scope(context);
   const BigIdeal& bigIdeal = FrobbyImpl::FrobbyIdealHelper::getIdeal(ideal);
   if (bigIdeal.getGeneratorCount() == 0)
     return false;
@@ -385,6 +515,7 @@ bool Frobby::irreducibleDecompositionAsMonomials(const Ideal& ideal,
   ExternalIdealConsumerWrapper wrappedConsumer
     (&consumer, bigIdeal.getVarCount());
   SliceParams params;
+  scope.setParams(params);
   SliceFacade facade(params, bigIdeal, wrappedConsumer);
 
   facade.computeIrreducibleDecomposition(true);
@@ -392,12 +523,20 @@ bool Frobby::irreducibleDecompositionAsMonomials(const Ideal& ideal,
 }
 
 void Frobby::primaryDecomposition(const Ideal& ideal,
-								  IdealConsumer& consumer) {
+                                  IdealConsumer& consumer) {
+  primaryDecomposition(getThreadContext(), ideal, consumer);
+}
+
+void Frobby::primaryDecomposition(Context& context,
+                                  const Ideal& ideal,
+                                  IdealConsumer& consumer) {
+  ContextScope scope(context);
   const BigIdeal& bigIdeal = FrobbyImpl::FrobbyIdealHelper::getIdeal(ideal);
 
   ExternalIdealConsumerWrapper wrappedConsumer
     (&consumer, bigIdeal.getVarCount());
   SliceParams params;
+  scope.setParams(params);
   SliceFacade facade(params, bigIdeal, wrappedConsumer);
 
   facade.computePrimaryDecomposition();
@@ -405,11 +544,19 @@ void Frobby::primaryDecomposition(const Ideal& ideal,
 
 void Frobby::maximalStandardMonomials(const Ideal& ideal,
                                       IdealConsumer& consumer) {
+  maximalStandardMonomials(getThreadContext(), ideal, consumer);
+}
+
+void Frobby::maximalStandardMonomials(Context& context,
+                                      const Ideal& ideal,
+                                      IdealConsumer& consumer) {
+  ContextScope scope(context);
   const BigIdeal& bigIdeal = FrobbyImpl::FrobbyIdealHelper::getIdeal(ideal);
 
   ExternalIdealConsumerWrapper wrappedConsumer
     (&consumer, bigIdeal.getVarCount());
   SliceParams params;
+  scope.setParams(params);
   SliceFacade facade(params, bigIdeal, wrappedConsumer);
 
   facade.computeMaximalStandardMonomials();
@@ -418,6 +565,14 @@ void Frobby::maximalStandardMonomials(const Ideal& ideal,
 bool Frobby::solveStandardMonomialProgram(const Ideal& ideal,
                                           const mpz_t* l,
                                           IdealConsumer& consumer) {
+  return solveStandardMonomialProgram(getThreadContext(), ideal, l, consumer);
+}
+
+bool Frobby::solveStandardMonomialProgram(Context& context,
+                                          const Ideal& ideal,
+                                          const mpz_t* l,
+                                          IdealConsumer& consumer) {
+  ContextScope scope(context);
   ASSERT(l != 0);
 
   const BigIdeal& bigIdeal = FrobbyImpl::FrobbyIdealHelper::getIdeal(ideal);
@@ -429,6 +584,7 @@ bool Frobby::solveStandardMonomialProgram(const Ideal& ideal,
   ExternalIdealConsumerWrapper wrappedConsumer
     (&consumer, bigIdeal.getVarCount());
   SliceParams params;
+  scope.setParams(params);
   params.useIndependenceSplits(false); // not supported
   SliceFacade facade(params, bigIdeal, wrappedConsumer);
 
@@ -437,12 +593,21 @@ bool Frobby::solveStandardMonomialProgram(const Ideal& ideal,
 }
 
 void Frobby::codimension(const Ideal& ideal, mpz_t codim) {
+  codimension(getThreadContext(), ideal, codim);
+}
+
+void Frobby::codimension(Context& context, const Ideal& ideal, mpz_t codim) {
   const BigIdeal& bigIdeal = FrobbyImpl::FrobbyIdealHelper::getIdeal(ideal);
-  dimension(ideal, codim);
+  dimension(context, ideal, codim);
   mpz_ui_sub(codim, bigIdeal.getVarCount(), codim);
 }
 
 void Frobby::dimension(const Ideal& ideal, mpz_t dim) {
+  dimension(getThreadContext(), ideal, dim);
+}
+
+void Frobby::dimension(Context& context, const Ideal& ideal, mpz_t dim) {
+  ContextScope scope(context);
   const BigIdeal& bigIdeal = FrobbyImpl::FrobbyIdealHelper::getIdeal(ideal);
 
   IdealFacade facade(false);
@@ -451,12 +616,20 @@ void Frobby::dimension(const Ideal& ideal, mpz_t dim) {
 }
 
 void Frobby::associatedPrimes(const Ideal& ideal, IdealConsumer& consumer) {
+  associatedPrimes(getThreadContext(), ideal, consumer);
+}
+
+void Frobby::associatedPrimes(Context& context,
+                              const Ideal& ideal,
+                              IdealConsumer& consumer) {
+  ContextScope scope(context);
   const BigIdeal& bigIdeal = FrobbyImpl::FrobbyIdealHelper::getIdeal(ideal);
   IrreducibleIdealDecoder decodingConsumer(&consumer);
 
   ExternalIdealConsumerWrapper wrappedConsumer
     (&decodingConsumer, bigIdeal.getVarCount());
   SliceParams params;
+  scope.setParams(params);
   SliceFacade facade(params, bigIdeal, wrappedConsumer);
 
   facade.computeAssociatedPrimes();
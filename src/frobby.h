@@ -28,6 +28,7 @@ extern "C" const char* const frobby_version;
 */
 namespace FrobbyImpl {
   class FrobbyIdealHelper;
+  class FrobbyContextHelper;
 }
 
 /** The namespace Frobby contains the public interface of Frobby. */
@@ -137,6 +138,47 @@ namespace Frobby {
     virtual void polynomialEnd();
   };
 
+  /** A context holds the state that Frobby uses while it computes:
+   the scratch memory, the pseudo-random numbers that some
+   algorithms use to make choices and the number of threads to use.
+
+   Each of the functions below has an overload that takes a context
+   as its first parameter. A context may only be used by one call at
+   a time, while calls that use different contexts can run at the
+   same time on different threads. The overloads that do not take a
+   context use a context that belongs to the calling thread, so they
+   can also be called from several threads at once.
+
+   Only the calling thread uses the scratch memory of the context.
+   When a call uses more than one thread, the other threads use
+   scratch memory of their own and draw pseudo-random numbers from
+   sources that are seeded from that of the context.
+  */
+  class Context {
+  public:
+    Context();
+    ~Context();
+
+    /** Seeds the pseudo-random numbers of this context. Calls with a
+     context that has the same seed and a thread count of one make
+     the same choices.
+    */
+    void setRandomSeed(unsigned int seed);
+
+    /** Sets the number of threads that each call using this context
+     may use. A thread count of zero is interpreted as one, which is
+     also the default.
+    */
+    void setThreadCount(size_t threadCount);
+
+  private:
+    Context(const Context&); // unavailable
+    Context& operator=(const Context&); // unavailable
+
+    friend class FrobbyImpl::FrobbyContextHelper;
+    FrobbyImpl::FrobbyContextHelper* _data;
+  };
+
   /** Compute the Alexander dual of ideal using the point
    reflectionMonomial. The minimal generators of the dual are provided
    to the consumer in some arbitrary order. If reflectionMonomial is
@@ -314,6 +356,44 @@ namespace Frobby {
 
    The prime ideals are passed to the consumer in arbitrary order. */
   void associatedPrimes(const Ideal& ideal, IdealConsumer& consumer);
+
+  // These overloads do the same as the functions above, using the
+  // state of context. See Context.
+  bool alexanderDual(Context& context,
+                     const Ideal& ideal,
+                     const mpz_t* reflectionMonomial,
+                     IdealConsumer& consumer);
+  bool alexanderDual(Context& context,
+                     const Ideal& ideal,
+                     const Ideal& reflectionMonomial,
+                     IdealConsumer& consumer);
+  void multigradedHilbertPoincareSeries(Context& context,
+                                        const Ideal& ideal,
+                                        PolynomialConsumer& consumer);
+  void univariateHilbertPoincareSeries(Context& context,
+                                       const Ideal& ideal,
+                                       PolynomialConsumer& consumer);
+  void irreducibleDecompositionAsIdeals(Context& context,
+                                        const Ideal& ideal,
+                                        IdealConsumer& consumer);
+  bool irreducibleDecompositionAsMonomials(Context& context,
+                                           const Ideal& ideal,
+                                           IdealConsumer& consumer);
+  void maximalStandardMonomials(Context& context,
+                                const Ideal& ideal,
+                                IdealConsumer& consumer);
+  bool solveStandardMonomialProgram(Context& context,
+                                    const Ideal& ideal,
+                                    const mpz_t* l,
+                                    IdealConsumer& consumer);
+  void codimension(Context& context, const Ideal& ideal, mpz_t codim);
+  void dimension(Context& context, const Ideal& ideal, mpz_t dim);
+  void primaryDecomposition(Context& context,
+                            const Ideal& ideal,
+                            IdealConsumer& consumer);
+  void associatedPrimes(Context& context,
+                        const Ideal& ideal,
+                        IdealConsumer& consumer);
 }
 
 #endif
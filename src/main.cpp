@@ -18,6 +18,8 @@
 #include "main.h"
 
 #include "Action.h"
+#include "BatchRunner.h"
+#include "ProgressReporter.h"
 #include "DebugAllocator.h"
 #include "error.h"
 #include "display.h"
@@ -42,7 +44,14 @@ int frobbyMain(int argc, const char** argv) {
 
   const unique_ptr<Action> action(Action::createActionWithPrefix(prefix));
   action->parseCommandLine(argc - 1, argv + 1);
-  action->perform();
+  ProgressReporter progress(action->getProgressInterval(),
+                            action->getProgressFile());
+  if (action->getBatchThreadCount() == 0)
+    action->perform();
+  else {
+    BatchRunner runner(*action, argc - 1, argv + 1);
+    runner.run(action->getBatchThreadCount(), stdin, stdout);
+  }
 
   return ExitCodeSuccess;
 }